@@ -312,6 +312,35 @@ TlsShutdown (
   IN     VOID  *Tls
   );
 
+/**
+  Release a TLS session object returned by TlsGetSession().
+
+  If Session is NULL, nothing is done.
+
+  @param[in]  Session    Pointer to the TLS session object to be freed.
+
+**/
+VOID
+EFIAPI
+TlsSessionFree (
+  IN     VOID  *Session
+  );
+
+/**
+  Checks if the TLS handshake resumed a previous session.
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @retval  TRUE     The handshake resumed the session set by TlsSetSession().
+  @retval  FALSE    A full handshake was performed, or the handshake is not done.
+
+**/
+BOOLEAN
+EFIAPI
+TlsSessionReused (
+  IN     VOID  *Tls
+  );
+
 /**
   Set a new TLS/SSL method for a particular TLS object.
 
@@ -474,6 +503,29 @@ TlsSetSessionId (
   IN     UINT16  SessionIdLen
   );
 
+/**
+  Sets a TLS/SSL session to be resumed during TLS/SSL connect.
+
+  This function offers a session returned by TlsGetSession() for an earlier
+  connection to the same server, so that the handshake can be abbreviated if
+  the server accepts it.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the TLS session object to be resumed.
+
+  @retval  EFI_SUCCESS           Session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_PROTOCOL_ERROR    The session can't be used by this TLS object.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetSession (
+  IN     VOID  *Tls,
+  IN     VOID  *Session
+  );
+
 /**
   Adds the CA to the cert store when requesting Server or Client authentication.
 
@@ -787,6 +839,29 @@ TlsGetSessionId (
   IN OUT UINT16  *SessionIdLen
   );
 
+/**
+  Gets the TLS/SSL session of the connection for later resumption.
+
+  This function returns a reference to the session negotiated by the TLS object.
+  The session can be offered to a later connection to the same server through
+  TlsSetSession(), and must be released with TlsSessionFree().
+
+  @param[in]   Tls             Pointer to the TLS object.
+  @param[out]  Session         Pointer to the returned TLS session object.
+
+  @retval  EFI_SUCCESS           The session was returned successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_NOT_FOUND         The connection has no resumable session.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsGetSession (
+  IN     VOID  *Tls,
+  OUT    VOID  **Session
+  );
+
 /**
   Gets the client random data used in the specified TLS connection.
 
@@ -310,6 +310,8 @@ typedef struct {
       UINT8    Read           : 1;
       UINT8    Write          : 1;
       UINT8    Shutdown       : 1;
+      UINT8    SessionFree    : 1;
+      UINT8    SessionReused  : 1;
     } Services;
     UINT32    Family;
   } Tls;
@@ -331,6 +333,7 @@ typedef struct {
       UINT8    EcCurve            : 1;
       UINT8    ServerName         : 1;
       UINT8    SecurityLevel      : 1;
+      UINT8    Session            : 1;
     } Services;
     UINT32    Family;
   } TlsSet;
@@ -350,6 +353,7 @@ typedef struct {
       UINT8    HostPrivateKey       : 1;
       UINT8    CertRevocationList   : 1;
       UINT8    ExportKey            : 1;
+      UINT8    Session              : 1;
     } Services;
     UINT32    Family;
   } TlsGet;
@@ -3984,6 +3984,23 @@ TlsFree (
   CALL_VOID_CRYPTO_SERVICE (TlsFree, (Tls));
 }
 
+/**
+  Release a TLS session object returned by TlsGetSession().
+
+  If Session is NULL, nothing is done.
+
+  @param[in]  Session    Pointer to the TLS session object to be freed.
+
+**/
+VOID
+EFIAPI
+TlsSessionFree (
+  IN     VOID  *Session
+  )
+{
+  CALL_VOID_CRYPTO_SERVICE (TlsSessionFree, (Session));
+}
+
 /**
   Create a new TLS object for a connection.
 
@@ -4026,6 +4043,24 @@ TlsInHandshake (
   CALL_CRYPTO_SERVICE (TlsInHandshake, (Tls), FALSE);
 }
 
+/**
+  Checks if the TLS handshake resumed a previous session.
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @retval  TRUE     The handshake resumed the session set by TlsSetSession().
+  @retval  FALSE    A full handshake was performed, or the handshake is not done.
+
+**/
+BOOLEAN
+EFIAPI
+TlsSessionReused (
+  IN     VOID  *Tls
+  )
+{
+  CALL_CRYPTO_SERVICE (TlsSessionReused, (Tls), FALSE);
+}
+
 /**
   Perform a TLS/SSL handshake.
 
@@ -4443,6 +4478,32 @@ TlsSetSessionId (
   CALL_CRYPTO_SERVICE (TlsSetSessionId, (Tls, SessionId, SessionIdLen), EFI_UNSUPPORTED);
 }
 
+/**
+  Sets a TLS/SSL session to be resumed during TLS/SSL connect.
+
+  This function offers a session returned by TlsGetSession() for an earlier
+  connection to the same server, so that the handshake can be abbreviated if
+  the server accepts it.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the TLS session object to be resumed.
+
+  @retval  EFI_SUCCESS           Session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_PROTOCOL_ERROR    The session can't be used by this TLS object.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetSession (
+  IN     VOID  *Tls,
+  IN     VOID  *Session
+  )
+{
+  CALL_CRYPTO_SERVICE (TlsSetSession, (Tls, Session), EFI_UNSUPPORTED);
+}
+
 /**
   Adds the CA to the cert store when requesting Server or Client authentication.
 
@@ -4799,6 +4860,32 @@ TlsGetSessionId (
   CALL_CRYPTO_SERVICE (TlsGetSessionId, (Tls, SessionId, SessionIdLen), EFI_UNSUPPORTED);
 }
 
+/**
+  Gets the TLS/SSL session of the connection for later resumption.
+
+  This function returns a reference to the session negotiated by the TLS object.
+  The session can be offered to a later connection to the same server through
+  TlsSetSession(), and must be released with TlsSessionFree().
+
+  @param[in]   Tls             Pointer to the TLS object.
+  @param[out]  Session         Pointer to the returned TLS session object.
+
+  @retval  EFI_SUCCESS           The session was returned successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_NOT_FOUND         The connection has no resumable session.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsGetSession (
+  IN     VOID  *Tls,
+  OUT    VOID  **Session
+  )
+{
+  CALL_CRYPTO_SERVICE (TlsGetSession, (Tls, Session), EFI_UNSUPPORTED);
+}
+
 /**
   Gets the client random data used in the specified TLS connection.
 
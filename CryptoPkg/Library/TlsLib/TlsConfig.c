@@ -678,6 +678,44 @@ TlsSetSessionId (
   return EFI_SUCCESS;
 }
 
+/**
+  Sets a TLS/SSL session to be resumed during TLS/SSL connect.
+
+  This function offers a session returned by TlsGetSession() for an earlier
+  connection to the same server, so that the handshake can be abbreviated if
+  the server accepts it.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the TLS session object to be resumed.
+
+  @retval  EFI_SUCCESS           Session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_PROTOCOL_ERROR    The session can't be used by this TLS object.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetSession (
+  IN     VOID  *Tls,
+  IN     VOID  *Session
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+
+  TlsConn = (TLS_CONNECTION *)Tls;
+
+  if ((TlsConn == NULL) || (TlsConn->Ssl == NULL) || (Session == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (SSL_set_session (TlsConn->Ssl, (SSL_SESSION *)Session) != 1) {
+    return EFI_PROTOCOL_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Adds the CA to the cert store when requesting Server or Client authentication.
 
@@ -1437,6 +1475,57 @@ TlsGetSessionId (
   return EFI_SUCCESS;
 }
 
+/**
+  Gets the TLS/SSL session of the connection for later resumption.
+
+  This function returns a reference to the session negotiated by the TLS object.
+  The session can be offered to a later connection to the same server through
+  TlsSetSession(), and must be released with TlsSessionFree().
+
+  @param[in]   Tls             Pointer to the TLS object.
+  @param[out]  Session         Pointer to the returned TLS session object.
+
+  @retval  EFI_SUCCESS           The session was returned successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_NOT_FOUND         The connection has no resumable session.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsGetSession (
+  IN     VOID  *Tls,
+  OUT    VOID  **Session
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+  SSL_SESSION     *SslSession;
+
+  TlsConn = (TLS_CONNECTION *)Tls;
+
+  if ((TlsConn == NULL) || (TlsConn->Ssl == NULL) || (Session == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  SslSession = SSL_get1_session (TlsConn->Ssl);
+  if (SslSession == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // A session is not resumable before the handshake completes, or before the
+  // server has sent a ticket for it.
+  //
+  if (SSL_SESSION_is_resumable (SslSession) != 1) {
+    SSL_SESSION_free (SslSession);
+    return EFI_NOT_FOUND;
+  }
+
+  *Session = SslSession;
+
+  return EFI_SUCCESS;
+}
+
 /**
   Gets the client random data used in the specified TLS connection.
 
@@ -141,6 +141,27 @@ TlsFree (
   OPENSSL_free (Tls);
 }
 
+/**
+  Release a TLS session object returned by TlsGetSession().
+
+  If Session is NULL, nothing is done.
+
+  @param[in]  Session    Pointer to the TLS session object to be freed.
+
+**/
+VOID
+EFIAPI
+TlsSessionFree (
+  IN     VOID  *Session
+  )
+{
+  if (Session == NULL) {
+    return;
+  }
+
+  SSL_SESSION_free ((SSL_SESSION *)Session);
+}
+
 /**
   Create a new TLS object for a connection.
 
@@ -42,6 +42,31 @@ TlsInHandshake (
   return !SSL_is_init_finished (TlsConn->Ssl);
 }
 
+/**
+  Checks if the TLS handshake resumed a previous session.
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @retval  TRUE     The handshake resumed the session set by TlsSetSession().
+  @retval  FALSE    A full handshake was performed, or the handshake is not done.
+
+**/
+BOOLEAN
+EFIAPI
+TlsSessionReused (
+  IN     VOID  *Tls
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+
+  TlsConn = (TLS_CONNECTION *)Tls;
+  if ((TlsConn == NULL) || (TlsConn->Ssl == NULL)) {
+    return FALSE;
+  }
+
+  return (BOOLEAN)(SSL_session_reused (TlsConn->Ssl) == 1);
+}
+
 /**
   Perform a TLS/SSL handshake.
 
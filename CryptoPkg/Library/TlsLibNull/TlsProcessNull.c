@@ -31,6 +31,25 @@ TlsInHandshake (
   return FALSE;
 }
 
+/**
+  Checks if the TLS handshake resumed a previous session.
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @retval  TRUE     The handshake resumed the session set by TlsSetSession().
+  @retval  FALSE    A full handshake was performed, or the handshake is not done.
+
+**/
+BOOLEAN
+EFIAPI
+TlsSessionReused (
+  IN     VOID  *Tls
+  )
+{
+  ASSERT (FALSE);
+  return FALSE;
+}
+
 /**
   Perform a TLS/SSL handshake.
 
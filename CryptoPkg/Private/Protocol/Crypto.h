@@ -21,7 +21,7 @@
 /// the EDK II Crypto Protocol is extended, this version define must be
 /// increased.
 ///
-#define EDKII_CRYPTO_VERSION  27
+#define EDKII_CRYPTO_VERSION  28
 
 ///
 /// EDK II Crypto Protocol forward declaration
@@ -4377,6 +4377,81 @@ EFI_STATUS
   IN     UINTN                    KeyBufferLen
   );
 
+/**
+  Release a TLS session object returned by TlsGetSession().
+
+  If Session is NULL, nothing is done.
+
+  @param[in]  Session    Pointer to the TLS session object to be freed.
+
+**/
+typedef
+VOID
+(EFIAPI *EDKII_CRYPTO_TLS_SESSION_FREE)(
+  IN     VOID                     *Session
+  );
+
+/**
+  Checks if the TLS handshake resumed a previous session.
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @retval  TRUE     The handshake resumed the session set by TlsSetSession().
+  @retval  FALSE    A full handshake was performed, or the handshake is not done.
+
+**/
+typedef
+BOOLEAN
+(EFIAPI *EDKII_CRYPTO_TLS_SESSION_REUSED)(
+  IN     VOID                     *Tls
+  );
+
+/**
+  Sets a TLS/SSL session to be resumed during TLS/SSL connect.
+
+  This function offers a session returned by TlsGetSession() for an earlier
+  connection to the same server, so that the handshake can be abbreviated if
+  the server accepts it.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the TLS session object to be resumed.
+
+  @retval  EFI_SUCCESS           Session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_PROTOCOL_ERROR    The session can't be used by this TLS object.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_CRYPTO_TLS_SET_SESSION)(
+  IN     VOID                     *Tls,
+  IN     VOID                     *Session
+  );
+
+/**
+  Gets the TLS/SSL session of the connection for later resumption.
+
+  This function returns a reference to the session negotiated by the TLS object.
+  The session can be offered to a later connection to the same server through
+  TlsSetSession(), and must be released with TlsSessionFree().
+
+  @param[in]   Tls             Pointer to the TLS object.
+  @param[out]  Session         Pointer to the returned TLS session object.
+
+  @retval  EFI_SUCCESS           The session was returned successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_NOT_FOUND         The connection has no resumable session.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_CRYPTO_TLS_GET_SESSION)(
+  IN     VOID                     *Tls,
+  OUT    VOID                     **Session
+  );
+
 /**
   Gets the CA-supplied certificate revocation list data set in the specified
   TLS object.
@@ -7098,6 +7173,13 @@ struct _EDKII_CRYPTO_PROTOCOL {
   EDKII_CRYPTO_SLH_DSA_GET_PRIVATE_KEY_FROM_PEM       SlhDsaGetPrivateKeyFromPem;
   EDKII_CRYPTO_SLH_DSA_SIGN                           SlhDsaSign;
   EDKII_CRYPTO_SLH_DSA_VERIFY                         SlhDsaVerify;
+  /// TLS (Continued)
+  EDKII_CRYPTO_TLS_SESSION_FREE                       TlsSessionFree;
+  EDKII_CRYPTO_TLS_SESSION_REUSED                     TlsSessionReused;
+  /// TLS Set (Continued)
+  EDKII_CRYPTO_TLS_SET_SESSION                        TlsSetSession;
+  /// TLS Get (Continued)
+  EDKII_CRYPTO_TLS_GET_SESSION                        TlsGetSession;
 };
 
 extern GUID  gEdkiiCryptoProtocolGuid;
@@ -37,6 +37,7 @@ FatFreeODir (
     FatFreeDirEnt (DirEnt);
   }
 
+  FatFreeHashTable (ODir);
   FreePool (ODir);
 }
 
@@ -62,7 +63,12 @@ FatAllocateODir (
     //
     ODir->Signature = FAT_ODIR_SIGNATURE;
     InitializeListHead (&ODir->ChildList);
-    ODir->CurrentCursor = &ODir->ChildList;
+    ODir->CurrentCursor  = &ODir->ChildList;
+    ODir->FirstFitCursor = &ODir->ChildList;
+    if (EFI_ERROR (FatAllocateHashTable (ODir))) {
+      FreePool (ODir);
+      ODir = NULL;
+    }
   }
 
   return ODir;
@@ -93,17 +99,22 @@ FatDiscardODir (
     //
     ODir->DirCacheTag = OFile->FileCluster;
     InsertHeadList (&Volume->DirCacheList, &ODir->DirCacheLink);
-    if (Volume->DirCacheCount == FAT_MAX_DIR_CACHE_COUNT) {
-      //
-      // Replace the least recent used directory
-      //
+    Volume->DirCacheCount++;
+    Volume->DirCacheEntryCount += ODir->DirEntCount;
+    ODir                        = NULL;
+
+    //
+    // Replace the least recent used directories until the cache fits its
+    // limits again. A directory larger than the whole cache is not kept.
+    //
+    while ((Volume->DirCacheCount > FAT_MAX_DIR_CACHE_COUNT) ||
+           ((Volume->DirCacheCount > 0) && (Volume->DirCacheEntryCount > Volume->DirCacheMaxEntryCount)))
+    {
       ODir = ODIR_FROM_DIRCACHELINK (Volume->DirCacheList.BackLink);
       RemoveEntryList (&ODir->DirCacheLink);
-    } else {
-      //
-      // No need to find a replace
-      //
-      Volume->DirCacheCount++;
+      Volume->DirCacheCount--;
+      Volume->DirCacheEntryCount -= ODir->DirEntCount;
+      FatFreeODir (ODir);
       ODir = NULL;
     }
   }
@@ -149,7 +160,8 @@ FatRequestODir (
     if (CurrentODir->DirCacheTag == DirCacheTag) {
       RemoveEntryList (&CurrentODir->DirCacheLink);
       Volume->DirCacheCount--;
-      ODir = CurrentODir;
+      Volume->DirCacheEntryCount -= CurrentODir->DirEntCount;
+      ODir                        = CurrentODir;
       break;
     }
   }
@@ -164,6 +176,70 @@ FatRequestODir (
   OFile->ODir = ODir;
 }
 
+/**
+
+  Size the directory cache of the volume according to the free memory.
+
+  @param  Volume                - FAT file system volume.
+
+**/
+VOID
+FatInitializeODirCache (
+  IN FAT_VOLUME  *Volume
+  )
+{
+  EFI_STATUS             Status;
+  EFI_MEMORY_DESCRIPTOR  *MemoryMap;
+  EFI_MEMORY_DESCRIPTOR  *Entry;
+  UINTN                  MemoryMapSize;
+  UINTN                  MapKey;
+  UINTN                  DescriptorSize;
+  UINT32                 DescriptorVersion;
+  UINT64                 FreePages;
+  UINT64                 MaxEntryCount;
+
+  Volume->DirCacheMaxEntryCount = FAT_MIN_DIR_CACHE_ENTRY_COUNT;
+
+  MemoryMapSize = 0;
+  MemoryMap     = NULL;
+  Status        = gBS->GetMemoryMap (&MemoryMapSize, MemoryMap, &MapKey, &DescriptorSize, &DescriptorVersion);
+  if (Status != EFI_BUFFER_TOO_SMALL) {
+    return;
+  }
+
+  //
+  // Add room for the descriptors our own allocation may create
+  //
+  MemoryMapSize += 2 * DescriptorSize;
+  MemoryMap      = AllocatePool (MemoryMapSize);
+  if (MemoryMap == NULL) {
+    return;
+  }
+
+  Status = gBS->GetMemoryMap (&MemoryMapSize, MemoryMap, &MapKey, &DescriptorSize, &DescriptorVersion);
+  if (!EFI_ERROR (Status)) {
+    FreePages = 0;
+    for (Entry = MemoryMap;
+         (UINT8 *)Entry < (UINT8 *)MemoryMap + MemoryMapSize;
+         Entry = NEXT_MEMORY_DESCRIPTOR (Entry, DescriptorSize)
+         )
+    {
+      if (Entry->Type == EfiConventionalMemory) {
+        FreePages += Entry->NumberOfPages;
+      }
+    }
+
+    MaxEntryCount = DivU64x32 (
+                      RShiftU64 (LShiftU64 (FreePages, EFI_PAGE_SHIFT), FAT_DIR_CACHE_MEMORY_SHIFT),
+                      (UINT32)FAT_DIR_CACHE_ENTRY_SIZE
+                      );
+    MaxEntryCount                 = MIN (MaxEntryCount, FAT_MAX_DIR_CACHE_ENTRY_COUNT);
+    Volume->DirCacheMaxEntryCount = (UINTN)MAX (MaxEntryCount, FAT_MIN_DIR_CACHE_ENTRY_COUNT);
+  }
+
+  FreePool (MemoryMap);
+}
+
 /**
 
   Clean up all the cached directory structures when the volume is going to be abandoned.
@@ -184,4 +260,6 @@ FatCleanupODirCache (
     FatFreeODir (ODir);
     Volume->DirCacheCount--;
   }
+
+  Volume->DirCacheEntryCount = 0;
 }
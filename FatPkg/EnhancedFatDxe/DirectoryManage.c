@@ -787,6 +787,17 @@ FatFirstFitInsertDirEnt (
   UINT32      NewEntryPos;
   UINT16      EntryCount;
   FAT_DIRENT  LabelDirEnt;
+  BOOLEAN     Packed;
+
+  //
+  // Nothing has been removed from the directory since the search
+  // failed for this many entries or less, so it would fail again
+  //
+  ODir       = OFile->ODir;
+  EntryCount = DirEnt->EntryCount;
+  if ((ODir->FirstFitFailCount != 0) && (EntryCount >= ODir->FirstFitFailCount)) {
+    return EFI_VOLUME_FULL;
+  }
 
   LabelPos = 0;
   if (OFile->Parent == NULL) {
@@ -800,16 +811,29 @@ FatFirstFitInsertDirEnt (
     }
   }
 
-  EntryCount  = DirEnt->EntryCount;
-  NewEntryPos = EntryCount;
-  CurrentPos  = 0;
-  ODir        = OFile->ODir;
-  for (CurrentEntry = ODir->ChildList.ForwardLink;
+  //
+  // Skip the leading directory entries that have no free entry between them
+  //
+  CurrentPos = 0;
+  if (ODir->FirstFitCursor != &ODir->ChildList) {
+    CurrentDirEnt = DIRENT_FROM_LINK (ODir->FirstFitCursor);
+    CurrentPos    = CurrentDirEnt->EntryPos;
+  }
+
+  NewEntryPos = CurrentPos + EntryCount;
+  Packed      = TRUE;
+  for (CurrentEntry = ODir->FirstFitCursor->ForwardLink;
        CurrentEntry != &ODir->ChildList;
        CurrentEntry = CurrentEntry->ForwardLink
        )
   {
     CurrentDirEnt = DIRENT_FROM_LINK (CurrentEntry);
+    if (Packed && (CurrentDirEnt->EntryPos <= CurrentPos + CurrentDirEnt->EntryCount)) {
+      ODir->FirstFitCursor = CurrentEntry;
+    } else {
+      Packed = FALSE;
+    }
+
     if (NewEntryPos + CurrentDirEnt->EntryCount <= CurrentDirEnt->EntryPos) {
       if ((LabelPos > NewEntryPos) || (LabelPos <= CurrentPos)) {
         //
@@ -824,6 +848,10 @@ FatFirstFitInsertDirEnt (
   }
 
   if (NewEntryPos >= ODir->CurrentEndPos) {
+    if ((ODir->FirstFitFailCount == 0) || (EntryCount < ODir->FirstFitFailCount)) {
+      ODir->FirstFitFailCount = (UINT8)EntryCount;
+    }
+
     return EFI_VOLUME_FULL;
   }
 
@@ -1103,7 +1131,8 @@ FatRemoveDirEnt (
   IN FAT_DIRENT  *DirEnt
   )
 {
-  FAT_ODIR  *ODir;
+  FAT_ODIR    *ODir;
+  FAT_DIRENT  *CursorDirEnt;
 
   ODir = OFile->ODir;
   if (ODir->CurrentCursor == &DirEnt->Link) {
@@ -1113,6 +1142,16 @@ FatRemoveDirEnt (
     ODir->CurrentCursor = ODir->CurrentCursor->BackLink;
   }
 
+  if (ODir->FirstFitCursor != &ODir->ChildList) {
+    CursorDirEnt = DIRENT_FROM_LINK (ODir->FirstFitCursor);
+    if (DirEnt->EntryPos <= CursorDirEnt->EntryPos) {
+      //
+      // The entries of DirEnt become free, so the first fit search restarts before them
+      //
+      ODir->FirstFitCursor = DirEnt->Link.BackLink;
+    }
+  }
+
   //
   // Remove from directory entry list
   //
@@ -1121,6 +1160,7 @@ FatRemoveDirEnt (
   // Remove from hash table
   //
   FatDeleteFromHashTable (ODir, DirEnt);
+  ODir->FirstFitFailCount   = 0;
   DirEnt->Entry.FileName[0] = DELETE_ENTRY_MARK;
   DirEnt->Invalid           = TRUE;
   return FatStoreDirEnt (OFile, DirEnt);
@@ -1234,6 +1274,7 @@ FatCloseDirEnt (
     RemoveEntryList (&OFile->ChildLink);
   }
 
+  FatFreeExtentMap (OFile);
   FreePool (OFile);
   DirEnt->OFile = NULL;
   if (DirEnt->Invalid == TRUE) {
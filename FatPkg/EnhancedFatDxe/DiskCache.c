@@ -404,6 +404,30 @@ FatGetCachePage (
   return Status;
 }
 
+/**
+
+  Check whether a page is currently loaded in the cache.
+
+  @param  DiskCache             - The disk cache to check.
+  @param  PageNo                - PageNo to match with the cache.
+
+  @retval TRUE                  - The page is loaded in the cache.
+  @retval FALSE                 - The page is not loaded in the cache.
+
+**/
+STATIC
+BOOLEAN
+FatIsCachePageLoaded (
+  IN DISK_CACHE  *DiskCache,
+  IN UINTN       PageNo
+  )
+{
+  CACHE_TAG  *CacheTag;
+
+  CacheTag = &DiskCache->CacheTag[PageNo & DiskCache->GroupMask];
+  return (BOOLEAN)((CacheTag->RealSize > 0) && (CacheTag->PageNo == PageNo));
+}
+
 /**
 
   Read Length bytes from the position of Offset into Buffer, or
@@ -475,6 +499,10 @@ FatAccessUnalignedCachePage (
      The access data will be divided into UnderRun data, Aligned data and OverRun data;
      The UnderRun data and OverRun data will be accessed by the Data cache,
      but the Aligned data will be accessed with disk directly.
+     A read spanning at least one page only passes through its UnderRun and OverRun
+     pages, so they are also read from disk directly unless they are already cached.
+     This keeps large sequential reads from evicting the cache, and lets the whole
+     read of EFI_FILE_PROTOCOL.ReadEx() be issued as non-blocking disk requests.
 
   @param  Volume                - FAT file system volume.
   @param  CacheDataType         - The type of cache: CACHE_DATA or CACHE_FAT.
@@ -512,6 +540,7 @@ FatAccessCache (
   DISK_CACHE  *DiskCache;
   UINT64      EntryPos;
   UINT8       PageAlignment;
+  BOOLEAN     Bypass;
 
   ASSERT (Volume->CacheBuffer != NULL);
 
@@ -522,6 +551,7 @@ FatAccessCache (
   PageSize      = (UINTN)1 << PageAlignment;
   PageNo        = (UINTN)RShiftU64 (EntryPos, PageAlignment);
   UnderRun      = ((UINTN)EntryPos) & (PageSize - 1);
+  Bypass        = (BOOLEAN)((CacheDataType == CacheData) && (IoMode == ReadDisk) && (BufferSize >= PageSize));
 
   if (UnderRun > 0) {
     Length = PageSize - UnderRun;
@@ -529,7 +559,12 @@ FatAccessCache (
       Length = BufferSize;
     }
 
-    Status = FatAccessUnalignedCachePage (Volume, CacheDataType, IoMode, PageNo, UnderRun, Length, Buffer);
+    if (Bypass && !FatIsCachePageLoaded (DiskCache, PageNo)) {
+      Status = FatDiskIo (Volume, IoMode, Offset, Length, Buffer, Task);
+    } else {
+      Status = FatAccessUnalignedCachePage (Volume, CacheDataType, IoMode, PageNo, UnderRun, Length, Buffer);
+    }
+
     if (EFI_ERROR (Status)) {
       return Status;
     }
@@ -574,7 +609,12 @@ FatAccessCache (
     //
     // Last read is not a complete page
     //
-    Status = FatAccessUnalignedCachePage (Volume, CacheDataType, IoMode, OverRunPageNo, 0, OverRun, Buffer);
+    if (Bypass && !FatIsCachePageLoaded (DiskCache, OverRunPageNo)) {
+      EntryPos = DiskCache->BaseAddress + LShiftU64 (OverRunPageNo, PageAlignment);
+      Status   = FatDiskIo (Volume, IoMode, EntryPos, OverRun, Buffer, Task);
+    } else {
+      Status = FatAccessUnalignedCachePage (Volume, CacheDataType, IoMode, OverRunPageNo, 0, OverRun, Buffer);
+    }
   }
 
   return Status;
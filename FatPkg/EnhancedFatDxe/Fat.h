@@ -116,8 +116,25 @@ STATIC_ASSERT ((((1 << FAT_DATACACHE_PAGE_MAX_ALIGNMENT) / (1 << MIN_BLOCK_ALIGN
 #define LC_ISO_639_2_ENTRY_SIZE  3
 #define MAX_LANG_CODE_SIZE       100
 
-#define FAT_MAX_DIR_CACHE_COUNT  8
+#define FAT_MAX_DIR_CACHE_COUNT  64
 #define FAT_MAX_DIRENTRY_COUNT   0xFFFF
+
+//
+// The directory cache may hold up to 1/(2^FAT_DIR_CACHE_MEMORY_SHIFT) of the
+// free memory, estimated with FAT_DIR_CACHE_ENTRY_SIZE bytes per directory entry
+//
+#define FAT_DIR_CACHE_MEMORY_SHIFT     6
+#define FAT_DIR_CACHE_ENTRY_SIZE       (sizeof (FAT_DIRENT) + 64)
+#define FAT_MIN_DIR_CACHE_ENTRY_COUNT  0x1000
+#define FAT_MAX_DIR_CACHE_ENTRY_COUNT  0x100000
+
+//
+// Limits of the per-OFile cluster extent map and the volume free cluster bitmap
+//
+#define FAT_EXTENT_MAP_MIN_COUNT        16
+#define FAT_EXTENT_MAP_MAX_COUNT        1024
+#define FAT_FREE_BITMAP_SCAN_THRESHOLD  1024
+#define FAT_FREE_BITMAP_MAX_SIZE        SIZE_4MB
 typedef CHAR8 LC_ISO_639_2;
 
 //
@@ -174,10 +191,13 @@ typedef struct {
 } DISK_CACHE;
 
 //
-// Hash table size
+// Hash table size. The table of a directory starts with HASH_TABLE_SIZE
+// buckets and doubles when the directory has more than
+// HASH_TABLE_LOAD_FACTOR entries per bucket.
 //
-#define HASH_TABLE_SIZE  0x400
-#define HASH_TABLE_MASK  (HASH_TABLE_SIZE - 1)
+#define HASH_TABLE_SIZE         0x400
+#define HASH_TABLE_MAX_SIZE     0x10000
+#define HASH_TABLE_LOAD_FACTOR  2
 
 //
 // The directory entry for opened directory
@@ -197,6 +217,8 @@ struct _FAT_DIRENT {
   FAT_OFILE              *OFile;                // The OFile of the corresponding directory entry
   FAT_DIRENT             *ShortNameForwardLink; // Hash successor link for short filename
   FAT_DIRENT             *LongNameForwardLink;  // Hash successor link for long filename
+  UINT32                 ShortNameHash;         // Hash value of the short filename
+  UINT32                 LongNameHash;          // Hash value of the upper cased long filename
   LIST_ENTRY             Link;                  // Connection of every directory entry
   FAT_DIRECTORY_ENTRY    Entry;                 // The physical directory entry stored in disk
 };
@@ -210,8 +232,12 @@ struct _FAT_ODIR {
   BOOLEAN       EndOfDir;                     // Indicate whether we have reached the end of the directory
   LIST_ENTRY    DirCacheLink;                 // Linked in Volume->DirCacheList when discarded
   UINTN         DirCacheTag;                  // The identification of the directory when in directory cache
-  FAT_DIRENT    *LongNameHashTable[HASH_TABLE_SIZE];
-  FAT_DIRENT    *ShortNameHashTable[HASH_TABLE_SIZE];
+  LIST_ENTRY    *FirstFitCursor;              // No free entry precedes this directory entry, first fit search starts after it
+  UINT8         FirstFitFailCount;            // Smallest entry count the first fit search failed for, 0 if none
+  UINTN         DirEntCount;                  // Number of directory entries in the hash table
+  UINTN         HashTableSize;                // Number of buckets in each hash table
+  FAT_DIRENT    **LongNameHashTable;
+  FAT_DIRENT    **ShortNameHashTable;
 };
 
 typedef struct {
@@ -243,6 +269,15 @@ typedef struct {
   LIST_ENTRY            Link;
 } FAT_SUBTASK;
 
+//
+// A run of physically consecutive clusters of an opened file
+//
+typedef struct {
+  UINTN    FileCluster;                       // Index of the first cluster of the run within the file
+  UINTN    DiskCluster;                       // The first cluster of the run on the disk
+  UINTN    Count;                             // Number of clusters in the run
+} FAT_EXTENT;
+
 //
 // FAT_OFILE - Each opened file
 //
@@ -286,6 +321,14 @@ struct _FAT_OFILE {
   UINT64        PosDisk;        // on the disk
   UINTN         PosRem;         // remaining in this disk run
   //
+  // Map of the cluster runs of the first ExtentClusters
+  // clusters of the file, built while the chain is walked
+  //
+  FAT_EXTENT    *Extents;
+  UINTN         ExtentCount;
+  UINTN         ExtentMax;
+  UINTN         ExtentClusters;
+  //
   // The opened parent, full path length and currently opened child files
   //
   FAT_OFILE     *Parent;
@@ -349,6 +392,7 @@ struct _FAT_VOLUME {
   FAT_INFO_SECTOR                    FatInfoSector;  // Free cluster info
   UINTN                              FreeInfoPos;    // Pos with the free cluster info
   BOOLEAN                            FreeInfoValid;  // If free cluster info is valid
+  UINT8                              *FreeBitmap;    // One bit per cluster, set if the cluster is free
   //
   // Unpacked Fat BPB info
   //
@@ -383,6 +427,8 @@ struct _FAT_VOLUME {
   //
   LIST_ENTRY                         DirCacheList;
   UINTN                              DirCacheCount;
+  UINTN                              DirCacheEntryCount;    // Directory entries held by the cached directories
+  UINTN                              DirCacheMaxEntryCount; // Limit of DirCacheEntryCount
 
   //
   // Disk Cache for this volume
@@ -991,6 +1037,18 @@ FatOFilePosition (
   IN UINTN      PosLimit
   );
 
+/**
+
+  Free the cluster extent map of the open file.
+
+  @param  OFile                 - The open file.
+
+**/
+VOID
+FatFreeExtentMap (
+  IN FAT_OFILE  *OFile
+  );
+
 /**
 
   Update the free cluster info of FatInfoSector of the volume.
@@ -1843,6 +1901,33 @@ FatShortNameHashSearch (
   IN CHAR8     *ShortNameString
   );
 
+/**
+
+  Allocate the hash tables of the directory.
+
+  @param  ODir                  - The directory.
+
+  @retval EFI_SUCCESS           - The hash tables are allocated.
+  @retval EFI_OUT_OF_RESOURCES  - Not enough memory to allocate the hash tables.
+
+**/
+EFI_STATUS
+FatAllocateHashTable (
+  IN FAT_ODIR  *ODir
+  );
+
+/**
+
+  Free the hash tables of the directory.
+
+  @param  ODir                  - The directory.
+
+**/
+VOID
+FatFreeHashTable (
+  IN FAT_ODIR  *ODir
+  );
+
 /**
 
   Insert directory entry to hash table.
@@ -2037,6 +2122,18 @@ FatRequestODir (
   IN FAT_OFILE  *OFile
   );
 
+/**
+
+  Size the directory cache of the volume according to the free memory.
+
+  @param  Volume                - FAT file system volume.
+
+**/
+VOID
+FatInitializeODirCache (
+  IN FAT_VOLUME  *Volume
+  );
+
 /**
 
   Clean up all the cached directory structures when the volume is going to be abandoned.
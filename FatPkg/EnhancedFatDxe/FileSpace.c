@@ -222,9 +222,132 @@ FatSetFatEntry (
              &Volume->FatEntryBuffer,
              NULL
              );
+
+  //
+  // Keep the free cluster bitmap in sync with the FAT. It's only updated once
+  // the entry is written, so a failed write can't hand out a used cluster or
+  // hide a free one.
+  //
+  if (!EFI_ERROR (Status) && (Volume->FreeBitmap != NULL) && (Index <= Volume->MaxCluster + 1)) {
+    if (Value == FAT_CLUSTER_FREE) {
+      Volume->FreeBitmap[Index / 8] |= (UINT8)(1 << (Index % 8));
+    } else {
+      Volume->FreeBitmap[Index / 8] &= (UINT8) ~(1 << (Index % 8));
+    }
+  }
+
   return Status;
 }
 
+/**
+
+  Check whether the cluster is free, using the free cluster bitmap
+  when it has been built.
+
+  @param  Volume                - FAT file system volume.
+  @param  Index                 - The cluster to check.
+
+  @retval TRUE                  - The cluster is free.
+  @retval FALSE                 - The cluster is in use.
+
+**/
+STATIC
+BOOLEAN
+FatIsClusterFree (
+  IN FAT_VOLUME  *Volume,
+  IN UINTN       Index
+  )
+{
+  if (Volume->FreeBitmap != NULL) {
+    return (BOOLEAN)((Volume->FreeBitmap[Index / 8] & (1 << (Index % 8))) != 0);
+  }
+
+  return (BOOLEAN)(FatGetFatEntry (Volume, Index) == FAT_CLUSTER_FREE);
+}
+
+/**
+
+  Build the in-memory free cluster bitmap of the volume with one pass
+  over the FAT. Once built, the bitmap is kept up to date by FatSetFatEntry,
+  so allocations no longer have to read the FAT to skip used clusters.
+  The bitmap is not built if it would be too large or on a disk error.
+
+  @param  Volume                - FAT file system volume.
+
+**/
+STATIC
+VOID
+FatBuildFreeBitmap (
+  IN FAT_VOLUME  *Volume
+  )
+{
+  UINTN  Size;
+  UINTN  Index;
+
+  Size = (Volume->MaxCluster + 2 + 7) / 8;
+  if ((Volume->FreeBitmap != NULL) || (Size > FAT_FREE_BITMAP_MAX_SIZE)) {
+    return;
+  }
+
+  Volume->FreeBitmap = AllocateZeroPool (Size);
+  if (Volume->FreeBitmap == NULL) {
+    return;
+  }
+
+  for (Index = FAT_MIN_CLUSTER; Index <= Volume->MaxCluster + 1; Index++) {
+    if (Volume->DiskError) {
+      break;
+    }
+
+    if (FatGetFatEntry (Volume, Index) == FAT_CLUSTER_FREE) {
+      Volume->FreeBitmap[Index / 8] |= (UINT8)(1 << (Index % 8));
+    }
+  }
+
+  if (Volume->DiskError) {
+    FreePool (Volume->FreeBitmap);
+    Volume->FreeBitmap = NULL;
+  }
+}
+
+/**
+
+  Find the first free cluster at or after Start in the free cluster bitmap.
+
+  @param  Volume                - FAT file system volume.
+  @param  Start                 - The cluster to start looking at.
+
+  @return The index of the free cluster, or MaxCluster + 2 if there is none.
+
+**/
+STATIC
+UINTN
+FatFindFreeCluster (
+  IN FAT_VOLUME  *Volume,
+  IN UINTN       Start
+  )
+{
+  UINTN  Index;
+  UINT8  *Bitmap;
+
+  Bitmap = Volume->FreeBitmap;
+  for (Index = Start; Index <= Volume->MaxCluster + 1; Index++) {
+    //
+    // Skip a whole byte of used clusters at once
+    //
+    if (((Index % 8) == 0) && (Bitmap[Index / 8] == 0)) {
+      Index += 7;
+      continue;
+    }
+
+    if ((Bitmap[Index / 8] & (1 << (Index % 8))) != 0) {
+      return Index;
+    }
+  }
+
+  return Volume->MaxCluster + 2;
+}
+
 /**
 
   Free the cluster chain.
@@ -275,6 +398,7 @@ FatAllocateCluster (
   )
 {
   UINTN  Cluster;
+  UINTN  Skipped;
 
   //
   // Start looking at FatFreePos for the next unallocated cluster
@@ -283,7 +407,15 @@ FatAllocateCluster (
     return (UINTN)FAT_CLUSTER_LAST;
   }
 
+  Skipped = 0;
   for ( ; ;) {
+    if (Volume->FreeBitmap != NULL) {
+      Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32)FatFindFreeCluster (
+                                                             Volume,
+                                                             Volume->FatInfoSector.FreeInfo.NextCluster
+                                                             );
+    }
+
     //
     // If the end of the list, return no available cluster
     //
@@ -298,6 +430,10 @@ FatAllocateCluster (
       }
     }
 
+    if (Volume->FreeBitmap != NULL) {
+      break;
+    }
+
     Cluster = FatGetFatEntry (Volume, Volume->FatInfoSector.FreeInfo.NextCluster);
     if (Cluster == FAT_CLUSTER_FREE) {
       break;
@@ -307,6 +443,15 @@ FatAllocateCluster (
     // Try the next cluster
     //
     Volume->FatInfoSector.FreeInfo.NextCluster += 1;
+
+    //
+    // The volume is getting full, build the free cluster bitmap so that
+    // this and later allocations don't have to walk the used clusters
+    //
+    Skipped += 1;
+    if (Skipped == FAT_FREE_BITMAP_SCAN_THRESHOLD) {
+      FatBuildFreeBitmap (Volume);
+    }
   }
 
   Cluster                                     = Volume->FatInfoSector.FreeInfo.NextCluster;
@@ -341,6 +486,165 @@ FatSizeToClusters (
   return Clusters;
 }
 
+/**
+
+  Record that cluster ClusterIndex of the open file is Cluster on the disk.
+  The map only covers a prefix of the file, so the cluster is recorded only
+  if it immediately follows the mapped clusters.
+
+  @param  OFile                 - The open file.
+  @param  ClusterIndex          - The index of the cluster within the file.
+  @param  Cluster               - The cluster on the disk.
+
+**/
+STATIC
+VOID
+FatExtentMapAppend (
+  IN FAT_OFILE  *OFile,
+  IN UINTN      ClusterIndex,
+  IN UINTN      Cluster
+  )
+{
+  FAT_EXTENT  *Extent;
+  FAT_EXTENT  *NewExtents;
+  UINTN       NewMax;
+
+  if (ClusterIndex != OFile->ExtentClusters) {
+    return;
+  }
+
+  if (OFile->ExtentCount != 0) {
+    Extent = &OFile->Extents[OFile->ExtentCount - 1];
+    if (Extent->DiskCluster + Extent->Count == Cluster) {
+      Extent->Count         += 1;
+      OFile->ExtentClusters += 1;
+      return;
+    }
+  }
+
+  if (OFile->ExtentCount == OFile->ExtentMax) {
+    //
+    // Once the map is full, the rest of the file is reached by running the chain
+    //
+    if (OFile->ExtentMax >= FAT_EXTENT_MAP_MAX_COUNT) {
+      return;
+    }
+
+    NewMax     = (OFile->ExtentMax == 0) ? FAT_EXTENT_MAP_MIN_COUNT : OFile->ExtentMax * 2;
+    NewExtents = ReallocatePool (
+                   OFile->ExtentMax * sizeof (FAT_EXTENT),
+                   NewMax * sizeof (FAT_EXTENT),
+                   OFile->Extents
+                   );
+    if (NewExtents == NULL) {
+      return;
+    }
+
+    OFile->Extents   = NewExtents;
+    OFile->ExtentMax = NewMax;
+  }
+
+  Extent                 = &OFile->Extents[OFile->ExtentCount];
+  Extent->FileCluster    = ClusterIndex;
+  Extent->DiskCluster    = Cluster;
+  Extent->Count          = 1;
+  OFile->ExtentCount    += 1;
+  OFile->ExtentClusters += 1;
+}
+
+/**
+
+  Find the extent that maps cluster ClusterIndex of the open file.
+
+  @param  OFile                 - The open file.
+  @param  ClusterIndex          - The index of the cluster within the file.
+
+  @return The extent containing the cluster, or NULL if the cluster is not mapped.
+
+**/
+STATIC
+FAT_EXTENT *
+FatExtentMapLookup (
+  IN FAT_OFILE  *OFile,
+  IN UINTN      ClusterIndex
+  )
+{
+  UINTN  Low;
+  UINTN  High;
+  UINTN  Mid;
+
+  if (ClusterIndex >= OFile->ExtentClusters) {
+    return NULL;
+  }
+
+  Low  = 0;
+  High = OFile->ExtentCount - 1;
+  while (Low < High) {
+    Mid = (Low + High + 1) / 2;
+    if (OFile->Extents[Mid].FileCluster <= ClusterIndex) {
+      Low = Mid;
+    } else {
+      High = Mid - 1;
+    }
+  }
+
+  return &OFile->Extents[Low];
+}
+
+/**
+
+  Drop the clusters at and after ClusterCount from the extent map of the open file.
+
+  @param  OFile                 - The open file.
+  @param  ClusterCount          - The number of clusters left in the file.
+
+**/
+STATIC
+VOID
+FatExtentMapTruncate (
+  IN FAT_OFILE  *OFile,
+  IN UINTN      ClusterCount
+  )
+{
+  FAT_EXTENT  *Extent;
+
+  while ((OFile->ExtentCount != 0) && (OFile->Extents[OFile->ExtentCount - 1].FileCluster >= ClusterCount)) {
+    OFile->ExtentCount -= 1;
+  }
+
+  OFile->ExtentClusters = 0;
+  if (OFile->ExtentCount != 0) {
+    Extent = &OFile->Extents[OFile->ExtentCount - 1];
+    if (Extent->FileCluster + Extent->Count > ClusterCount) {
+      Extent->Count = ClusterCount - Extent->FileCluster;
+    }
+
+    OFile->ExtentClusters = Extent->FileCluster + Extent->Count;
+  }
+}
+
+/**
+
+  Free the cluster extent map of the open file.
+
+  @param  OFile                 - The open file.
+
+**/
+VOID
+FatFreeExtentMap (
+  IN FAT_OFILE  *OFile
+  )
+{
+  if (OFile->Extents != NULL) {
+    FreePool (OFile->Extents);
+  }
+
+  OFile->Extents        = NULL;
+  OFile->ExtentCount    = 0;
+  OFile->ExtentMax      = 0;
+  OFile->ExtentClusters = 0;
+}
+
 /**
 
   Shrink the end of the open file base on the file size.
@@ -366,6 +670,7 @@ FatShrinkEof (
   ASSERT_VOLUME_LOCKED (Volume);
 
   NewSize = FatSizeToClusters (Volume, OFile->FileSize);
+  FatExtentMapTruncate (OFile, NewSize);
 
   //
   // Find the address of the last cluster
@@ -570,6 +875,9 @@ FatOFilePosition (
   UINTN       Cluster;
   UINTN       StartPos;
   UINTN       Run;
+  UINTN       ClusterIndex;
+  UINTN       Remaining;
+  FAT_EXTENT  *Extent;
 
   Volume      = OFile->Volume;
   ClusterSize = Volume->ClusterSize;
@@ -584,39 +892,64 @@ FatOFilePosition (
     OFile->PosDisk = Volume->RootPos + Position;
     Run            = OFile->FileSize - Position;
   } else {
-    //
-    // Run the file's cluster chain to find the current position
-    // If possible, run from the current cluster rather than
-    // start from beginning
-    // Assumption: OFile->Position is always consistent with
-    // OFile->FileCurrentCluster.
-    // OFile->Position is not modified outside this function;
-    // OFile->FileCurrentCluster is modified outside this function
-    // to be the same as OFile->FileCluster
-    // when OFile->FileCluster is updated, so make a check of this
-    // and invalidate the original OFile->Position in this case
-    //
-    Cluster  = OFile->FileCurrentCluster;
-    StartPos = OFile->Position;
-    if ((Position < StartPos) || (OFile->FileCluster == Cluster)) {
-      StartPos = 0;
-      Cluster  = OFile->FileCluster;
-    }
+    ClusterIndex = Position >> Volume->ClusterAlignment;
+    Extent       = FatExtentMapLookup (OFile, ClusterIndex);
+    if (Extent != NULL) {
+      //
+      // The cluster has been mapped already, no need to run the chain
+      //
+      StartPos = ClusterIndex << Volume->ClusterAlignment;
+      Cluster  = Extent->DiskCluster + ClusterIndex - Extent->FileCluster;
+    } else {
+      //
+      // Run the file's cluster chain to find the current position
+      // If possible, run from the current cluster rather than
+      // start from beginning
+      // Assumption: OFile->Position is always consistent with
+      // OFile->FileCurrentCluster.
+      // OFile->Position is not modified outside this function;
+      // OFile->FileCurrentCluster is modified outside this function
+      // to be the same as OFile->FileCluster
+      // when OFile->FileCluster is updated, so make a check of this
+      // and invalidate the original OFile->Position in this case
+      //
+      Cluster  = OFile->FileCurrentCluster;
+      StartPos = OFile->Position;
+      if ((Position < StartPos) || (OFile->FileCluster == Cluster)) {
+        StartPos = 0;
+        Cluster  = OFile->FileCluster;
+      }
 
-    while (StartPos + ClusterSize <= Position) {
-      StartPos += ClusterSize;
-      if ((Cluster == FAT_CLUSTER_FREE) || (Cluster >= FAT_CLUSTER_SPECIAL)) {
-        DEBUG ((DEBUG_INIT | DEBUG_ERROR, "FatOFilePosition:" " cluster chain corrupt\n"));
-        return EFI_VOLUME_CORRUPTED;
+      //
+      // Resume from the last mapped cluster if that is further along
+      //
+      if (OFile->ExtentCount != 0) {
+        Extent = &OFile->Extents[OFile->ExtentCount - 1];
+        if (((OFile->ExtentClusters - 1) << Volume->ClusterAlignment) > StartPos) {
+          StartPos = (OFile->ExtentClusters - 1) << Volume->ClusterAlignment;
+          Cluster  = Extent->DiskCluster + Extent->Count - 1;
+        }
       }
 
-      Cluster = FatGetFatEntry (Volume, Cluster);
+      while (StartPos + ClusterSize <= Position) {
+        if ((Cluster == FAT_CLUSTER_FREE) || (Cluster >= FAT_CLUSTER_SPECIAL)) {
+          DEBUG ((DEBUG_INIT | DEBUG_ERROR, "FatOFilePosition:" " cluster chain corrupt\n"));
+          return EFI_VOLUME_CORRUPTED;
+        }
+
+        FatExtentMapAppend (OFile, StartPos >> Volume->ClusterAlignment, Cluster);
+        StartPos += ClusterSize;
+        Cluster   = FatGetFatEntry (Volume, Cluster);
+      }
     }
 
     if ((Cluster < FAT_MIN_CLUSTER) || (Cluster > Volume->MaxCluster + 1)) {
       return EFI_VOLUME_CORRUPTED;
     }
 
+    ClusterIndex = StartPos >> Volume->ClusterAlignment;
+    FatExtentMapAppend (OFile, ClusterIndex, Cluster);
+
     OFile->PosDisk = Volume->FirstClusterPos +
                      LShiftU64 (Cluster - FAT_MIN_CLUSTER, Volume->ClusterAlignment) +
                      Position - StartPos;
@@ -627,10 +960,27 @@ FatOFilePosition (
     // Compute the number of consecutive clusters in the file
     //
     Run = StartPos + ClusterSize - Position;
+
+    //
+    // The rest of a mapped run is known to be consecutive
+    //
+    Extent = FatExtentMapLookup (OFile, ClusterIndex);
+    if (Extent != NULL) {
+      Remaining = Extent->FileCluster + Extent->Count - 1 - ClusterIndex;
+      while ((Remaining != 0) && (Run < PosLimit)) {
+        Run          += ClusterSize;
+        Cluster      += 1;
+        ClusterIndex += 1;
+        Remaining    -= 1;
+      }
+    }
+
     if (!FAT_END_OF_FAT_CHAIN (Cluster)) {
       while ((FatGetFatEntry (Volume, Cluster) == Cluster + 1) && Run < PosLimit) {
-        Run     += ClusterSize;
-        Cluster += 1;
+        Run          += ClusterSize;
+        Cluster      += 1;
+        ClusterIndex += 1;
+        FatExtentMapAppend (OFile, ClusterIndex, Cluster);
       }
     }
   }
@@ -734,7 +1084,7 @@ FatComputeFreeInfo (
         break;
       }
 
-      if (FatGetFatEntry (Volume, Index) == FAT_CLUSTER_FREE) {
+      if (FatIsClusterFree (Volume, Index)) {
         Volume->FatInfoSector.FreeInfo.ClusterCount += 1;
         Volume->FatInfoSector.FreeInfo.NextCluster   = (UINT32)Index;
       }
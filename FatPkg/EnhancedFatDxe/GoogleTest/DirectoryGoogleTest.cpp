@@ -0,0 +1,469 @@
+/** @file
+  Tests and open/create benchmark for the directory management of EnhancedFatDxe.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+#include <chrono>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/MemoryAllocationLib.h>
+  #include <Library/PrintLib.h>
+  #include "../Fat.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define TEST_CLUSTER_SIZE  SIZE_4KB
+#define TEST_DIR_MAX_SIZE  ((FAT_MAX_DIRENTRY_COUNT + 1) * sizeof (FAT_DIRECTORY_ENTRY))
+
+//
+// A FAT directory holds at most FAT_MAX_DIRENTRY_COUNT entries. A long name
+// takes two or more of them, so a 50000 file directory has 8.3 names.
+//
+#define TEST_BENCH_FILE_COUNT  50000
+#define TEST_BENCH_HOLE_STEP   64
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// These are not directly under test - but required to compile
+////////////////////////////////////////////////////////////////////////
+
+//
+// Content of the directory under test
+//
+STATIC UINT8  *mDirectory;
+
+EFI_STATUS
+FatAccessOFile (
+  IN FAT_OFILE  *OFile,
+  IN IO_MODE    IoMode,
+  IN UINTN      Position,
+  IN UINTN      *DataBufferSize,
+  IN UINT8      *UserBuffer,
+  IN FAT_TASK   *Task
+  )
+{
+  if (Position + *DataBufferSize > OFile->FileSize) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (IoMode == ReadData) {
+    CopyMem (UserBuffer, mDirectory + Position, *DataBufferSize);
+  } else {
+    CopyMem (mDirectory + Position, UserBuffer, *DataBufferSize);
+  }
+
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+FatExpandOFile (
+  IN FAT_OFILE  *OFile,
+  IN UINT64     ExpandedSize
+  )
+{
+  if (ExpandedSize > TEST_DIR_MAX_SIZE) {
+    return EFI_VOLUME_FULL;
+  }
+
+  ZeroMem (mDirectory + OFile->FileSize, (UINTN)ExpandedSize - OFile->FileSize);
+  OFile->FileSize = (UINTN)ExpandedSize;
+  return EFI_SUCCESS;
+}
+
+VOID
+FatFreeDirEnt (
+  IN FAT_DIRENT  *DirEnt
+  )
+{
+  if (DirEnt->FileString != NULL) {
+    FreePool (DirEnt->FileString);
+  }
+
+  FreePool (DirEnt);
+}
+
+VOID
+FatGetCurrentFatTime (
+  OUT FAT_DATE_TIME  *FatTime
+  )
+{
+  ZeroMem (FatTime, sizeof (FAT_DATE_TIME));
+}
+
+VOID
+FatFatTimeToEfiTime (
+  IN  FAT_DATE_TIME  *FTime,
+  OUT EFI_TIME       *ETime
+  )
+{
+  ZeroMem (ETime, sizeof (EFI_TIME));
+}
+
+//
+// ASCII only versions of the UnicodeCollation.c helpers
+//
+BOOLEAN
+FatStrToFat (
+  IN  CHAR16  *String,
+  IN  UINTN   FatSize,
+  OUT CHAR8   *Fat
+  )
+{
+  BOOLEAN       SpecialCharExist;
+  CONST CHAR16  *Invalid;
+
+  SpecialCharExist = FALSE;
+  while ((*String != 0) && (FatSize != 0)) {
+    if ((*String != '.') && (*String != ' ')) {
+      for (Invalid = (CHAR16 *)L"\"*+,/:;<=>?[\\]|"; (*Invalid != 0) && (*Invalid != *String); Invalid++) {
+      }
+
+      if ((*String > ' ') && (*String < 0x7F) && (*Invalid == 0)) {
+        *Fat = (CHAR8)(((*String >= 'a') && (*String <= 'z')) ? *String - 'a' + 'A' : *String);
+      } else {
+        *Fat             = '_';
+        SpecialCharExist = TRUE;
+      }
+
+      Fat++;
+      FatSize--;
+    }
+
+    String++;
+  }
+
+  return SpecialCharExist;
+}
+
+VOID
+FatFatToStr (
+  IN  UINTN   FatSize,
+  IN  CHAR8   *Fat,
+  OUT CHAR16  *String
+  )
+{
+  while ((*Fat != 0) && (FatSize != 0)) {
+    *String++ = *Fat++;
+    FatSize--;
+  }
+
+  *String = 0;
+}
+
+VOID
+FatStrUpr (
+  IN CHAR16  *Str
+  )
+{
+  for ( ; *Str != 0; Str++) {
+    if ((*Str >= 'a') && (*Str <= 'z')) {
+      *Str = *Str - 'a' + 'A';
+    }
+  }
+}
+
+VOID
+FatStrLwr (
+  IN CHAR16  *Str
+  )
+{
+  for ( ; *Str != 0; Str++) {
+    if ((*Str >= 'A') && (*Str <= 'Z')) {
+      *Str = *Str - 'A' + 'a';
+    }
+  }
+}
+
+INTN
+FatStriCmp (
+  IN CHAR16  *Str1,
+  IN CHAR16  *Str2
+  )
+{
+  CHAR16  Char1;
+  CHAR16  Char2;
+
+  do {
+    Char1 = ((*Str1 >= 'a') && (*Str1 <= 'z')) ? *Str1 - 'a' + 'A' : *Str1;
+    Char2 = ((*Str2 >= 'a') && (*Str2 <= 'z')) ? *Str2 - 'a' + 'A' : *Str2;
+    Str1++;
+    Str2++;
+  } while ((Char1 != 0) && (Char1 == Char2));
+
+  return Char1 - Char2;
+}
+
+////////////////////////////////////////////////////////////////////////
+// Directory Tests
+////////////////////////////////////////////////////////////////////////
+
+class DirectoryTest : public ::testing::Test {
+protected:
+  FAT_VOLUME Volume;
+  FAT_OFILE Root;
+  FAT_OFILE Dir;
+  FAT_DIRENT DirDirEnt;
+
+  void
+  SetUp (
+    ) override
+  {
+    mDirectory = (UINT8 *)AllocateZeroPool (TEST_DIR_MAX_SIZE);
+    ASSERT_NE (mDirectory, nullptr);
+
+    ZeroMem (&Volume, sizeof (Volume));
+    Volume.FatType               = Fat32;
+    Volume.ClusterSize           = TEST_CLUSTER_SIZE;
+    Volume.DirCacheMaxEntryCount = FAT_MAX_DIR_CACHE_ENTRY_COUNT;
+    InitializeListHead (&Volume.CheckRef);
+    InitializeListHead (&Volume.DirCacheList);
+
+    //
+    // An empty subdirectory of the root directory
+    //
+    ZeroMem (&Root, sizeof (Root));
+    Root.Signature = FAT_OFILE_SIGNATURE;
+    Root.Volume    = &Volume;
+    InitializeListHead (&Root.Opens);
+    InitializeListHead (&Root.ChildHead);
+
+    ZeroMem (&DirDirEnt, sizeof (DirDirEnt));
+    DirDirEnt.Signature = FAT_DIRENT_SIGNATURE;
+    ZeroMem (&Dir, sizeof (Dir));
+    Dir.Signature   = FAT_OFILE_SIGNATURE;
+    Dir.Volume      = &Volume;
+    Dir.Parent      = &Root;
+    Dir.DirEnt      = &DirDirEnt;
+    Dir.FileCluster = 3;
+    InitializeListHead (&Dir.Opens);
+    InitializeListHead (&Dir.ChildHead);
+    FatRequestODir (&Dir);
+    ASSERT_NE (Dir.ODir, nullptr);
+  }
+
+  void
+  TearDown (
+    ) override
+  {
+    FatDiscardODir (&Dir);
+    FatCleanupODirCache (&Volume);
+    FreePool (mDirectory);
+    mDirectory = NULL;
+  }
+
+  //
+  // Close a file opened by FatLocateOFile(), the way FatCheckOFileRef() does.
+  //
+  VOID
+  CloseFile (
+    FAT_OFILE  *OFile
+    )
+  {
+    RemoveEntryList (&OFile->CheckLink);
+    FatCloseDirEnt (OFile->DirEnt);
+  }
+
+  //
+  // Create FileName in the directory the way FatOFileOpen() does.
+  //
+  EFI_STATUS
+  CreateFile (
+    CHAR16      *FileName,
+    FAT_DIRENT  **PtrDirEnt
+    )
+  {
+    EFI_STATUS  Status;
+    FAT_OFILE   *OFile;
+    CHAR16      NewFileName[EFI_PATH_STRING_LENGTH];
+
+    OFile  = &Dir;
+    Status = FatLocateOFile (&OFile, FileName, FAT_ATTRIBUTE_ARCHIVE, NewFileName);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (OFile != &Dir) {
+      CloseFile (OFile);
+      return EFI_ACCESS_DENIED;
+    }
+
+    return FatCreateDirEnt (&Dir, NewFileName, FAT_ATTRIBUTE_ARCHIVE, PtrDirEnt);
+  }
+
+  //
+  // Open and close FileName in the directory, and return its directory entry.
+  //
+  FAT_DIRENT *
+  OpenFile (
+    CHAR16  *FileName
+    )
+  {
+    FAT_OFILE   *OFile;
+    FAT_DIRENT  *DirEnt;
+    CHAR16      NewFileName[EFI_PATH_STRING_LENGTH];
+
+    OFile = &Dir;
+    if (EFI_ERROR (FatLocateOFile (&OFile, FileName, 0, NewFileName)) || (OFile == &Dir)) {
+      return NULL;
+    }
+
+    DirEnt = OFile->DirEnt;
+    CloseFile (OFile);
+    return DirEnt;
+  }
+
+  //
+  // Create the 8.3 names F<First>.LOG, F<First + 1>.LOG... until the directory
+  // has no free entry left, and return how many were created.
+  //
+  UINTN
+  FillDirectory (
+    UINTN  First
+    )
+  {
+    UINTN       Index;
+    CHAR16      FileName[16];
+    FAT_DIRENT  *DirEnt;
+
+    for (Index = First; ; Index++) {
+      UnicodeSPrint (FileName, sizeof (FileName), (CHAR16 *)L"F%07u.LOG", (UINT32)Index);
+      if (EFI_ERROR (CreateFile (FileName, &DirEnt))) {
+        return Index - First;
+      }
+    }
+  }
+};
+
+//
+// Every created long name gets a unique short name, and both names find it.
+//
+TEST_F (DirectoryTest, CreatedLongNamesShouldBeFound) {
+  UINTN       Index;
+  CHAR16      FileName[32];
+  CHAR16      ShortName[16];
+  FAT_DIRENT  *DirEnt;
+
+  for (Index = 0; Index < 2000; Index++) {
+    UnicodeSPrint (FileName, sizeof (FileName), (CHAR16 *)L"Capsule Log %u.bin", (UINT32)Index);
+    ASSERT_EQ (CreateFile (FileName, &DirEnt), EFI_SUCCESS);
+  }
+
+  for (Index = 0; Index < 2000; Index++) {
+    UnicodeSPrint (FileName, sizeof (FileName), (CHAR16 *)L"capsule log %u.BIN", (UINT32)Index);
+    DirEnt = OpenFile (FileName);
+    ASSERT_NE (DirEnt, nullptr) << Index;
+
+    FatNameToStr (DirEnt->Entry.FileName, FAT_MAIN_NAME_LEN, 0, ShortName);
+    if (DirEnt->Entry.FileName[FAT_MAIN_NAME_LEN] != ' ') {
+      StrCatS (ShortName, ARRAY_SIZE (ShortName), (CHAR16 *)L".");
+      FatNameToStr (DirEnt->Entry.FileName + FAT_MAIN_NAME_LEN, FAT_EXTEND_NAME_LEN, 0, ShortName + StrLen (ShortName));
+    }
+
+    EXPECT_EQ (OpenFile (ShortName), DirEnt) << Index;
+  }
+
+  EXPECT_EQ (CreateFile ((CHAR16 *)L"CAPSULE LOG 7.BIN", &DirEnt), EFI_ACCESS_DENIED);
+}
+
+//
+// Once the directory is full, creates reuse the freed entries in position order.
+//
+TEST_F (DirectoryTest, FirstFitShouldReuseFreedEntries) {
+  UINTN       Count;
+  UINTN       Index;
+  CHAR16      FileName[16];
+  FAT_DIRENT  *DirEnt;
+  UINT16      FreedPos[3];
+
+  Count = FillDirectory (0);
+  ASSERT_EQ (Count, (UINTN)FAT_MAX_DIRENTRY_COUNT + 1);
+
+  for (Index = 0; Index < ARRAY_SIZE (FreedPos); Index++) {
+    UnicodeSPrint (FileName, sizeof (FileName), (CHAR16 *)L"F%07u.LOG", (UINT32)(40000 - Index * 15000));
+    DirEnt = OpenFile (FileName);
+    ASSERT_NE (DirEnt, nullptr);
+    FreedPos[Index] = DirEnt->EntryPos;
+    ASSERT_EQ (FatRemoveDirEnt (&Dir, DirEnt), EFI_SUCCESS);
+    FatFreeDirEnt (DirEnt);
+  }
+
+  for (Index = ARRAY_SIZE (FreedPos); Index > 0; Index--) {
+    UnicodeSPrint (FileName, sizeof (FileName), (CHAR16 *)L"G%07u.LOG", (UINT32)Index);
+    ASSERT_EQ (CreateFile (FileName, &DirEnt), EFI_SUCCESS);
+    EXPECT_EQ (DirEnt->EntryPos, FreedPos[Index - 1]);
+  }
+
+  EXPECT_EQ (CreateFile ((CHAR16 *)L"H0000000.LOG", &DirEnt), EFI_VOLUME_FULL);
+  EXPECT_NE (OpenFile ((CHAR16 *)L"F0000001.LOG"), nullptr);
+  EXPECT_EQ (OpenFile ((CHAR16 *)L"F0040000.LOG"), nullptr);
+}
+
+//
+// Create and open TEST_BENCH_FILE_COUNT files in one directory. Then fill it,
+// free every TEST_BENCH_HOLE_STEP entry and create files in the freed entries.
+//
+TEST_F (DirectoryTest, OpenCreateBenchmark) {
+  UINTN       Index;
+  UINTN       Count;
+  UINTN       Holes;
+  CHAR16      FileName[16];
+  FAT_DIRENT  *DirEnt;
+  UINT64      CreateUs;
+  UINT64      OpenUs;
+  UINT64      FirstFitUs;
+
+  auto  Start = std::chrono::steady_clock::now ();
+
+  for (Index = 0; Index < TEST_BENCH_FILE_COUNT; Index++) {
+    UnicodeSPrint (FileName, sizeof (FileName), (CHAR16 *)L"F%07u.LOG", (UINT32)Index);
+    ASSERT_EQ (CreateFile (FileName, &DirEnt), EFI_SUCCESS);
+  }
+
+  auto  Created = std::chrono::steady_clock::now ();
+
+  for (Index = 0; Index < TEST_BENCH_FILE_COUNT; Index++) {
+    UnicodeSPrint (FileName, sizeof (FileName), (CHAR16 *)L"f%07u.log", (UINT32)Index);
+    ASSERT_NE (OpenFile (FileName), nullptr);
+  }
+
+  auto  Opened = std::chrono::steady_clock::now ();
+
+  Count = TEST_BENCH_FILE_COUNT + FillDirectory (TEST_BENCH_FILE_COUNT);
+  Holes = 0;
+  for (Index = TEST_BENCH_HOLE_STEP / 2; Index < Count; Index += TEST_BENCH_HOLE_STEP) {
+    UnicodeSPrint (FileName, sizeof (FileName), (CHAR16 *)L"F%07u.LOG", (UINT32)Index);
+    DirEnt = OpenFile (FileName);
+    ASSERT_NE (DirEnt, nullptr);
+    ASSERT_EQ (FatRemoveDirEnt (&Dir, DirEnt), EFI_SUCCESS);
+    FatFreeDirEnt (DirEnt);
+    Holes++;
+  }
+
+  auto  Removed = std::chrono::steady_clock::now ();
+
+  for (Index = 0; Index < Holes; Index++) {
+    UnicodeSPrint (FileName, sizeof (FileName), (CHAR16 *)L"G%07u.LOG", (UINT32)Index);
+    ASSERT_EQ (CreateFile (FileName, &DirEnt), EFI_SUCCESS);
+  }
+
+  auto  Refilled = std::chrono::steady_clock::now ();
+
+  CreateUs   = std::chrono::duration_cast<std::chrono::microseconds>(Created - Start).count ();
+  OpenUs     = std::chrono::duration_cast<std::chrono::microseconds>(Opened - Created).count ();
+  FirstFitUs = std::chrono::duration_cast<std::chrono::microseconds>(Refilled - Removed).count ();
+
+  RecordProperty ("CreateUsec", (int)CreateUs);
+  RecordProperty ("OpenUsec", (int)OpenUs);
+  RecordProperty ("FirstFitCreates", (int)Holes);
+  RecordProperty ("FirstFitCreateUsec", (int)FirstFitUs);
+  std::cout << "[ BENCH    ] " << TEST_BENCH_FILE_COUNT << " creates: " << CreateUs << " us, "
+            << TEST_BENCH_FILE_COUNT << " opens: " << OpenUs << " us\n";
+  std::cout << "[ BENCH    ] " << Holes << " first fit creates in a full directory: " << FirstFitUs << " us\n";
+}
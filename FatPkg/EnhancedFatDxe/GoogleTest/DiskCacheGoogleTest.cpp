@@ -0,0 +1,263 @@
+/** @file
+  Tests and read benchmark for DiskCache.c.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+#include <chrono>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/DebugLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/MemoryAllocationLib.h>
+  #include "../Fat.h"
+}
+
+#include "FatDiskIoStub.h"
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+//
+// A FAT32 volume with 4KB clusters, whose data region starts at 1MB.
+//
+#define TEST_VOLUME_SIZE     SIZE_64MB
+#define TEST_FAT_POS         0x4000
+#define TEST_FAT_SIZE        SIZE_128KB
+#define TEST_ROOT_POS        SIZE_1MB
+#define TEST_CLUSTER_SIZE    SIZE_4KB
+#define TEST_BLOCK_SIZE      512
+#define TEST_PAGE_SIZE       (1 << FAT_DATACACHE_PAGE_MAX_ALIGNMENT)
+#define TEST_FILE_SIZE       SIZE_32MB
+#define TEST_BENCH_PASSES    8
+#define TEST_BENCH_LARGE_IO  SIZE_1MB
+#define TEST_BENCH_SMALL_IO  SIZE_16KB
+
+////////////////////////////////////////////////////////////////////////
+// DiskCache Tests
+////////////////////////////////////////////////////////////////////////
+
+class DiskCacheTest : public ::testing::Test {
+protected:
+  FAT_VOLUME Volume;
+  EFI_BLOCK_IO_MEDIA Media;
+  EFI_BLOCK_IO_PROTOCOL BlockIo;
+  UINT8 *Buffer;
+
+  void
+  SetUp (
+    ) override
+  {
+    UINTN  Index;
+
+    mDiskSize = TEST_VOLUME_SIZE;
+    mDisk     = (UINT8 *)AllocatePool ((UINTN)mDiskSize);
+    ASSERT_NE (mDisk, nullptr);
+    for (Index = 0; Index < mDiskSize; Index++) {
+      mDisk[Index] = (UINT8)(Index * 7 + (Index >> 12));
+    }
+
+    Buffer = (UINT8 *)AllocatePool (TEST_FILE_SIZE);
+    ASSERT_NE (Buffer, nullptr);
+
+    ZeroMem (&Media, sizeof (Media));
+    Media.BlockSize = TEST_BLOCK_SIZE;
+    ZeroMem (&BlockIo, sizeof (BlockIo));
+    BlockIo.Media = &Media;
+
+    ZeroMem (&Volume, sizeof (Volume));
+    Volume.BlockIo     = &BlockIo;
+    Volume.FatType     = Fat32;
+    Volume.NumFats     = 2;
+    Volume.FatPos      = TEST_FAT_POS;
+    Volume.FatSize     = TEST_FAT_SIZE;
+    Volume.RootPos     = TEST_ROOT_POS;
+    Volume.VolumeSize  = TEST_VOLUME_SIZE;
+    Volume.ClusterSize = TEST_CLUSTER_SIZE;
+    ASSERT_EQ (FatInitializeDiskCache (&Volume), EFI_SUCCESS);
+
+    mDiskIoCount = 0;
+    mDiskIoBytes = 0;
+  }
+
+  void
+  TearDown (
+    ) override
+  {
+    if (Volume.CacheBuffer != NULL) {
+      FreePool (Volume.CacheBuffer);
+    }
+
+    FreePool (Buffer);
+    FreePool (mDisk);
+    mDisk     = NULL;
+    mDiskSize = 0;
+  }
+
+  //
+  // Number of data cache pages holding a disk page.
+  //
+  UINTN
+  LoadedDataPages (
+    )
+  {
+    UINTN  Index;
+    UINTN  Count;
+
+    Count = 0;
+    for (Index = 0; Index < FAT_DATACACHE_GROUP_COUNT; Index++) {
+      if (Volume.DiskCache[CacheData].CacheTag[Index].RealSize != 0) {
+        Count++;
+      }
+    }
+
+    return Count;
+  }
+
+  //
+  // Read the test file from its first cluster in requests of IoSize bytes,
+  // starting with an empty data cache, and return the elapsed time in
+  // microseconds.
+  //
+  UINT64
+  ReadFile (
+    UINTN  IoSize
+    )
+  {
+    UINTN  Position;
+    UINTN  Length;
+
+    FreePool (Volume.CacheBuffer);
+    ZeroMem (Volume.DiskCache, sizeof (Volume.DiskCache));
+    EXPECT_EQ (FatInitializeDiskCache (&Volume), EFI_SUCCESS);
+    mDiskIoCount = 0;
+    mDiskIoBytes = 0;
+
+    auto  Start = std::chrono::steady_clock::now ();
+
+    for (Position = 0; Position < TEST_FILE_SIZE; Position += Length) {
+      Length = MIN (IoSize, TEST_FILE_SIZE - Position);
+      EXPECT_EQ (
+        FatAccessCache (&Volume, CacheData, ReadDisk, TEST_ROOT_POS + TEST_CLUSTER_SIZE + Position, Length, Buffer + Position, NULL),
+        EFI_SUCCESS
+        );
+    }
+
+    auto  End = std::chrono::steady_clock::now ();
+
+    EXPECT_EQ (CompareMem (Buffer, mDisk + TEST_ROOT_POS + TEST_CLUSTER_SIZE, TEST_FILE_SIZE), 0);
+    return (UINT64)std::chrono::duration_cast<std::chrono::microseconds>(End - Start).count ();
+  }
+};
+
+//
+// A read spanning more than one page must transfer exactly the requested
+// bytes, in one head, one middle and one tail request, and leave the data
+// cache untouched.
+//
+TEST_F (DiskCacheTest, LargeReadShouldBypassCache) {
+  UINT64  Offset;
+  UINTN   Length;
+
+  Offset = TEST_ROOT_POS + TEST_CLUSTER_SIZE + 100;
+  Length = 3 * TEST_PAGE_SIZE + 1000;
+
+  ASSERT_EQ (FatAccessCache (&Volume, CacheData, ReadDisk, Offset, Length, Buffer, NULL), EFI_SUCCESS);
+  EXPECT_EQ (CompareMem (Buffer, mDisk + Offset, Length), 0);
+  EXPECT_EQ (mDiskIoCount, (UINTN)3);
+  EXPECT_EQ (mDiskIoBytes, (UINT64)Length);
+  EXPECT_EQ (LoadedDataPages (), (UINTN)0);
+}
+
+//
+// A read within one page still goes through the data cache.
+//
+TEST_F (DiskCacheTest, SmallReadShouldUseCache) {
+  UINT64  Offset;
+
+  Offset = TEST_ROOT_POS + TEST_CLUSTER_SIZE + 100;
+
+  ASSERT_EQ (FatAccessCache (&Volume, CacheData, ReadDisk, Offset, 100, Buffer, NULL), EFI_SUCCESS);
+  EXPECT_EQ (CompareMem (Buffer, mDisk + Offset, 100), 0);
+  EXPECT_EQ (mDiskIoBytes, (UINT64)TEST_PAGE_SIZE);
+  EXPECT_EQ (LoadedDataPages (), (UINTN)1);
+
+  ASSERT_EQ (FatAccessCache (&Volume, CacheData, ReadDisk, Offset + 200, 100, Buffer, NULL), EFI_SUCCESS);
+  EXPECT_EQ (CompareMem (Buffer, mDisk + Offset + 200, 100), 0);
+  EXPECT_EQ (mDiskIoCount, (UINTN)1);
+}
+
+//
+// A large read must return the data of dirty cache pages, whether they
+// hold its head, its middle or its tail.
+//
+TEST_F (DiskCacheTest, LargeReadShouldSeeDirtyPages) {
+  UINT64  Offset;
+  UINTN   Length;
+  UINT8   Data[64];
+  UINTN   Index;
+
+  Offset = TEST_ROOT_POS + 100;
+  Length = 4 * TEST_PAGE_SIZE + 1000;
+  SetMem (Data, sizeof (Data), 0xA5);
+
+  for (Index = 0; Index <= 4; Index++) {
+    ASSERT_EQ (
+      FatAccessCache (&Volume, CacheData, WriteDisk, TEST_ROOT_POS + Index * TEST_PAGE_SIZE + 200, sizeof (Data), Data, NULL),
+      EFI_SUCCESS
+      );
+  }
+
+  ASSERT_EQ (FatAccessCache (&Volume, CacheData, ReadDisk, Offset, Length, Buffer, NULL), EFI_SUCCESS);
+  for (Index = 0; Index <= 4; Index++) {
+    EXPECT_EQ (CompareMem (Buffer + Index * TEST_PAGE_SIZE + 100, Data, sizeof (Data)), 0) << "Page " << Index;
+  }
+}
+
+//
+// Read a 32MB file sequentially in 1MB requests, the way a loader reads a
+// large initrd, and in 16KB requests that go through the data cache.
+// Large reads must transfer only the requested bytes, and must not load
+// any page into the data cache.
+//
+TEST_F (DiskCacheTest, SequentialReadBenchmark) {
+  UINTN   Pass;
+  UINT64  LargeUs;
+  UINT64  SmallUs;
+  UINT64  LargeBytes;
+  UINT64  SmallBytes;
+  UINTN   LargeCount;
+  UINTN   SmallCount;
+  UINTN   LargePages;
+
+  LargeUs = 0;
+  SmallUs = 0;
+  for (Pass = 0; Pass < TEST_BENCH_PASSES; Pass++) {
+    LargeUs   += ReadFile (TEST_BENCH_LARGE_IO);
+    LargeCount = mDiskIoCount;
+    LargeBytes = mDiskIoBytes;
+    LargePages = LoadedDataPages ();
+
+    SmallUs   += ReadFile (TEST_BENCH_SMALL_IO);
+    SmallCount = mDiskIoCount;
+    SmallBytes = mDiskIoBytes;
+  }
+
+  EXPECT_EQ (LargeBytes, (UINT64)TEST_FILE_SIZE);
+  EXPECT_EQ (LargePages, (UINTN)0);
+
+  RecordProperty ("LargeReadDiskRequests", (int)LargeCount);
+  RecordProperty ("LargeReadDiskBytes", (int)LargeBytes);
+  RecordProperty ("LargeReadUsec", (int)(LargeUs / TEST_BENCH_PASSES));
+  RecordProperty ("LargeReadCachePages", (int)LargePages);
+  RecordProperty ("SmallReadDiskRequests", (int)SmallCount);
+  RecordProperty ("SmallReadDiskBytes", (int)SmallBytes);
+  RecordProperty ("SmallReadUsec", (int)(SmallUs / TEST_BENCH_PASSES));
+  std::cout << "[ BENCH    ] 1MB reads:  " << LargeCount << " disk requests, " << LargeBytes << " bytes, "
+            << LargeUs / TEST_BENCH_PASSES << " us, " << LargePages << " cache pages loaded\n";
+  std::cout << "[ BENCH    ] 16KB reads: " << SmallCount << " disk requests, " << SmallBytes << " bytes, "
+            << SmallUs / TEST_BENCH_PASSES << " us\n";
+}
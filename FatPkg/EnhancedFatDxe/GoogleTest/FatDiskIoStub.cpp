@@ -0,0 +1,85 @@
+/** @file
+  FatDiskIo() stub of the EnhancedFatDxe tests.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+}
+
+#include "FatDiskIoStub.h"
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// These are not directly under test - but required to compile
+////////////////////////////////////////////////////////////////////////
+
+EFI_LOCK  FatFsLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_CALLBACK);
+
+UINT32   mFat[TEST_MAX_CLUSTER + 2];
+BOOLEAN  mFailFatWrites;
+
+UINT8   *mDisk;
+UINT64  mDiskSize;
+UINTN   mDiskIoCount;
+UINT64  mDiskIoBytes;
+
+EFI_STATUS
+FatDiskIo (
+  IN     FAT_VOLUME  *Volume,
+  IN     IO_MODE     IoMode,
+  IN     UINT64      Offset,
+  IN     UINTN       BufferSize,
+  IN OUT VOID        *Buffer,
+  IN     FAT_TASK    *Task
+  )
+{
+  UINT8  *Fat;
+
+  if ((IoMode == ReadDisk) || (IoMode == WriteDisk)) {
+    if ((mDisk == NULL) || (Offset + BufferSize > mDiskSize)) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    mDiskIoCount++;
+    mDiskIoBytes += BufferSize;
+    if (IoMode == ReadDisk) {
+      CopyMem (Buffer, mDisk + Offset, BufferSize);
+    } else {
+      CopyMem (mDisk + Offset, Buffer, BufferSize);
+    }
+
+    return EFI_SUCCESS;
+  }
+
+  if ((Offset < Volume->FatPos) || (Offset - Volume->FatPos + BufferSize > sizeof (mFat))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Fat = (UINT8 *)mFat + (UINTN)(Offset - Volume->FatPos);
+  if (IoMode == ReadFat) {
+    CopyMem (Buffer, Fat, BufferSize);
+    return EFI_SUCCESS;
+  }
+
+  if (mFailFatWrites) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  CopyMem (Fat, Buffer, BufferSize);
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+FatAccessVolumeDirty (
+  IN FAT_VOLUME  *Volume,
+  IN IO_MODE     IoMode,
+  IN VOID        *DirtyValue
+  )
+{
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,31 @@
+/** @file
+  In-memory test volume behind the FatDiskIo() stub of the EnhancedFatDxe tests.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#ifndef FAT_DISK_IO_STUB_H_
+#define FAT_DISK_IO_STUB_H_
+
+extern "C" {
+  #include <Uefi.h>
+  #include "../Fat.h"
+}
+
+#define TEST_MAX_CLUSTER  4000
+
+//
+// The FAT of the test volume, accessed through the ReadFat and WriteFat modes.
+//
+extern UINT32   mFat[TEST_MAX_CLUSTER + 2];
+extern BOOLEAN  mFailFatWrites;
+
+//
+// The raw disk of the test volume, accessed through the ReadDisk and WriteDisk
+// modes, and the number of raw accesses and bytes transferred.
+//
+extern UINT8   *mDisk;
+extern UINT64  mDiskSize;
+extern UINTN   mDiskIoCount;
+extern UINT64  mDiskIoBytes;
+
+#endif
@@ -0,0 +1,290 @@
+/** @file
+  Tests for FileSpace.c.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/DebugLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/MemoryAllocationLib.h>
+  #include "../Fat.h"
+}
+
+#include "FatDiskIoStub.h"
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define TEST_CLUSTER_ALIGNMENT  9
+#define TEST_CLUSTER_SIZE       (1 << TEST_CLUSTER_ALIGNMENT)
+#define TEST_FIRST_CLUSTER_POS  0x100000
+#define TEST_FILE_CLUSTERS      300
+#define TEST_SEEK_COUNT         20000
+#define TEST_FAT32_EOC          FAT_CLUSTER_MASK_FAT32
+
+////////////////////////////////////////////////////////////////////////
+// FileSpace Tests
+////////////////////////////////////////////////////////////////////////
+
+class FileSpaceTest : public ::testing::Test {
+protected:
+  FAT_VOLUME Volume;
+  FAT_OFILE OFile;
+  UINTN Chain[TEST_FILE_CLUSTERS];
+  UINT32 Seed;
+
+  void
+  SetUp (
+    ) override
+  {
+    ZeroMem (mFat, sizeof (mFat));
+    mFailFatWrites = FALSE;
+    FatFsLock.Lock = EfiLockAcquired;
+
+    ZeroMem (&Volume, sizeof (Volume));
+    Volume.FatType                            = Fat32;
+    Volume.FatEntrySize                       = sizeof (UINT32);
+    Volume.MaxCluster                         = TEST_MAX_CLUSTER;
+    Volume.ClusterSize                        = TEST_CLUSTER_SIZE;
+    Volume.ClusterAlignment                   = TEST_CLUSTER_ALIGNMENT;
+    Volume.FirstClusterPos                    = TEST_FIRST_CLUSTER_POS;
+    Volume.FatDirty                           = TRUE;
+    Volume.FatInfoSector.FreeInfo.NextCluster = FAT_MIN_CLUSTER;
+
+    ZeroMem (&OFile, sizeof (OFile));
+    OFile.Volume = &Volume;
+
+    Seed = 1;
+  }
+
+  void
+  TearDown (
+    ) override
+  {
+    FatFreeExtentMap (&OFile);
+    if (Volume.FreeBitmap != NULL) {
+      FreePool (Volume.FreeBitmap);
+    }
+  }
+
+  UINT32
+  Random (
+    UINT32  Limit
+    )
+  {
+    Seed = Seed * 1103515245 + 12345;
+    return (UINT32)(((UINT64)Seed * Limit) >> 32);
+  }
+
+  //
+  // Lay out the test file in runs of 1 to 8 consecutive clusters
+  // separated by used clusters.
+  //
+  void
+  CreateFragmentedFile (
+    )
+  {
+    UINTN  Index;
+    UINTN  Cluster;
+    UINTN  Run;
+
+    Cluster = FAT_MIN_CLUSTER;
+    for (Index = 0; Index < TEST_FILE_CLUSTERS; ) {
+      for (Run = 1 + Random (8); Run != 0 && Index < TEST_FILE_CLUSTERS; Run--) {
+        Chain[Index++] = Cluster++;
+      }
+
+      mFat[Cluster++] = TEST_FAT32_EOC;
+    }
+
+    for (Index = 0; Index < TEST_FILE_CLUSTERS - 1; Index++) {
+      mFat[Chain[Index]] = (UINT32)Chain[Index + 1];
+    }
+
+    mFat[Chain[TEST_FILE_CLUSTERS - 1]] = TEST_FAT32_EOC;
+
+    OFile.FileCluster        = Chain[0];
+    OFile.FileCurrentCluster = Chain[0];
+    OFile.FileSize           = TEST_FILE_CLUSTERS * TEST_CLUSTER_SIZE - 100;
+  }
+
+  //
+  // Seek to Position and check the disk position and the run length
+  // against the cluster chain.
+  //
+  void
+  CheckPosition (
+    UINTN  Position,
+    UINTN  PosLimit,
+    UINTN  ClusterCount
+    )
+  {
+    UINTN  Index;
+    UINTN  Run;
+
+    ASSERT_EQ (FatOFilePosition (&OFile, Position, PosLimit), EFI_SUCCESS);
+
+    Index = Position >> TEST_CLUSTER_ALIGNMENT;
+    EXPECT_EQ (
+      OFile.PosDisk,
+      TEST_FIRST_CLUSTER_POS + ((UINT64)(Chain[Index] - FAT_MIN_CLUSTER) << TEST_CLUSTER_ALIGNMENT) + (Position & (TEST_CLUSTER_SIZE - 1))
+      );
+
+    Run = TEST_CLUSTER_SIZE - (Position & (TEST_CLUSTER_SIZE - 1));
+    while ((Index + 1 < ClusterCount) && (Chain[Index + 1] == Chain[Index] + 1) && (Run < PosLimit)) {
+      Run += TEST_CLUSTER_SIZE;
+      Index++;
+    }
+
+    EXPECT_EQ (OFile.PosRem, Run);
+  }
+
+  //
+  // Every cluster must be marked free in the bitmap exactly when
+  // its FAT entry is free.
+  //
+  void
+  CheckBitmap (
+    )
+  {
+    UINTN    Index;
+    BOOLEAN  Free;
+
+    ASSERT_NE (Volume.FreeBitmap, nullptr);
+    for (Index = FAT_MIN_CLUSTER; Index <= TEST_MAX_CLUSTER + 1; Index++) {
+      Free = (BOOLEAN)((Volume.FreeBitmap[Index / 8] & (1 << (Index % 8))) != 0);
+      EXPECT_EQ (Free, mFat[Index] == FAT_CLUSTER_FREE) << "Cluster " << Index;
+    }
+  }
+};
+
+//
+// Random seeks resolved through the extent map must match the cluster chain.
+//
+TEST_F (FileSpaceTest, RandomSeeksShouldMatchChain) {
+  UINTN  Index;
+
+  CreateFragmentedFile ();
+
+  for (Index = 0; Index < TEST_SEEK_COUNT; Index++) {
+    CheckPosition (
+      Random ((UINT32)OFile.FileSize),
+      1 + Random (16 * TEST_CLUSTER_SIZE),
+      TEST_FILE_CLUSTERS
+      );
+    if (HasFailure ()) {
+      return;
+    }
+  }
+
+  EXPECT_EQ (OFile.ExtentClusters, (UINTN)TEST_FILE_CLUSTERS);
+}
+
+//
+// Shrinking the file must drop the freed clusters from the extent map.
+//
+TEST_F (FileSpaceTest, ShrinkShouldTrimExtentMap) {
+  UINTN  Index;
+  UINTN  NewCount;
+
+  CreateFragmentedFile ();
+  CheckPosition (OFile.FileSize - 1, 1, TEST_FILE_CLUSTERS);
+  ASSERT_EQ (OFile.ExtentClusters, (UINTN)TEST_FILE_CLUSTERS);
+
+  NewCount       = TEST_FILE_CLUSTERS / 2 + 3;
+  OFile.FileSize = NewCount * TEST_CLUSTER_SIZE;
+  ASSERT_EQ (FatShrinkEof (&OFile), EFI_SUCCESS);
+  EXPECT_LE (OFile.ExtentClusters, NewCount);
+
+  for (Index = NewCount; Index < TEST_FILE_CLUSTERS; Index++) {
+    EXPECT_EQ (mFat[Chain[Index]], (UINT32)FAT_CLUSTER_FREE);
+  }
+
+  for (Index = 0; Index < TEST_SEEK_COUNT / 10; Index++) {
+    CheckPosition (Random ((UINT32)OFile.FileSize), 1 + Random (16 * TEST_CLUSTER_SIZE), NewCount);
+    if (HasFailure ()) {
+      return;
+    }
+  }
+}
+
+//
+// Growing the file must read the new clusters back through the map.
+//
+TEST_F (FileSpaceTest, GrowShouldExtendChain) {
+  UINTN  Index;
+  UINTN  Cluster;
+
+  ASSERT_EQ (FatGrowEof (&OFile, TEST_FILE_CLUSTERS * TEST_CLUSTER_SIZE), EFI_SUCCESS);
+
+  Cluster = OFile.FileCluster;
+  for (Index = 0; Index < TEST_FILE_CLUSTERS; Index++) {
+    ASSERT_GE (Cluster, (UINTN)FAT_MIN_CLUSTER);
+    ASSERT_LE (Cluster, (UINTN)TEST_MAX_CLUSTER + 1);
+    Chain[Index] = Cluster;
+    Cluster      = mFat[Cluster];
+  }
+
+  EXPECT_EQ (Cluster, (UINTN)TEST_FAT32_EOC);
+
+  for (Index = 0; Index < TEST_SEEK_COUNT / 10; Index++) {
+    CheckPosition (Random ((UINT32)OFile.FileSize), 1 + Random (16 * TEST_CLUSTER_SIZE), TEST_FILE_CLUSTERS);
+    if (HasFailure ()) {
+      return;
+    }
+  }
+}
+
+//
+// Allocating past a long run of used clusters builds the free cluster bitmap,
+// which must then follow every change of the FAT.
+//
+TEST_F (FileSpaceTest, BitmapShouldFollowFat) {
+  UINTN  Index;
+
+  for (Index = FAT_MIN_CLUSTER; Index < FAT_MIN_CLUSTER + FAT_FREE_BITMAP_SCAN_THRESHOLD + 100; Index++) {
+    mFat[Index] = TEST_FAT32_EOC;
+  }
+
+  ASSERT_EQ (FatGrowEof (&OFile, 4 * TEST_CLUSTER_SIZE), EFI_SUCCESS);
+  ASSERT_NE (Volume.FreeBitmap, nullptr);
+  CheckBitmap ();
+
+  ASSERT_EQ (FatGrowEof (&OFile, 8 * TEST_CLUSTER_SIZE), EFI_SUCCESS);
+  CheckBitmap ();
+
+  OFile.FileSize = 2 * TEST_CLUSTER_SIZE;
+  ASSERT_EQ (FatShrinkEof (&OFile), EFI_SUCCESS);
+  CheckBitmap ();
+}
+
+//
+// A FAT entry that fails to be written must not change the bitmap, or the
+// bitmap would hand out a used cluster or hide a free one.
+//
+TEST_F (FileSpaceTest, FailedWriteShouldKeepBitmap) {
+  UINTN  Index;
+
+  for (Index = FAT_MIN_CLUSTER; Index < FAT_MIN_CLUSTER + FAT_FREE_BITMAP_SCAN_THRESHOLD + 100; Index++) {
+    mFat[Index] = TEST_FAT32_EOC;
+  }
+
+  ASSERT_EQ (FatGrowEof (&OFile, 4 * TEST_CLUSTER_SIZE), EFI_SUCCESS);
+  ASSERT_NE (Volume.FreeBitmap, nullptr);
+
+  mFailFatWrites = TRUE;
+  FatGrowEof (&OFile, 8 * TEST_CLUSTER_SIZE);
+  mFailFatWrites = FALSE;
+  CheckBitmap ();
+
+  mFailFatWrites = TRUE;
+  OFile.FileSize = 0;
+  FatShrinkEof (&OFile);
+  mFailFatWrites = FALSE;
+  CheckBitmap ();
+}
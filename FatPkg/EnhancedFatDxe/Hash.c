@@ -34,7 +34,7 @@ FatHashLongName (
     );
   FatStrUpr (UpCasedLongFileName);
   gBS->CalculateCrc32 (UpCasedLongFileName, StrSize (UpCasedLongFileName), &HashValue);
-  return (HashValue & HASH_TABLE_MASK);
+  return HashValue;
 }
 
 /**
@@ -55,7 +55,110 @@ FatHashShortName (
   UINT32  HashValue;
 
   gBS->CalculateCrc32 (ShortNameString, FAT_NAME_LEN, &HashValue);
-  return (HashValue & HASH_TABLE_MASK);
+  return HashValue;
+}
+
+/**
+
+  Move the directory entries to new hash tables of NewSize buckets.
+  The directory keeps its current tables if the new ones can't be allocated.
+
+  @param  ODir                  - The directory.
+  @param  NewSize               - The number of buckets of the new hash tables.
+
+  @retval EFI_SUCCESS           - The hash tables are resized.
+  @retval EFI_OUT_OF_RESOURCES  - Not enough memory to allocate the new hash tables.
+
+**/
+STATIC
+EFI_STATUS
+FatResizeHashTable (
+  IN FAT_ODIR  *ODir,
+  IN UINTN     NewSize
+  )
+{
+  FAT_DIRENT  **LongNameHashTable;
+  FAT_DIRENT  **ShortNameHashTable;
+  FAT_DIRENT  *DirEnt;
+  UINTN       Index;
+  UINT32      HashTableIndex;
+
+  LongNameHashTable = AllocateZeroPool (2 * NewSize * sizeof (FAT_DIRENT *));
+  if (LongNameHashTable == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ShortNameHashTable = LongNameHashTable + NewSize;
+
+  //
+  // Relink the entries with their saved hash values
+  //
+  for (Index = 0; Index < ODir->HashTableSize; Index++) {
+    while (ODir->ShortNameHashTable[Index] != NULL) {
+      DirEnt                             = ODir->ShortNameHashTable[Index];
+      ODir->ShortNameHashTable[Index]    = DirEnt->ShortNameForwardLink;
+      HashTableIndex                     = DirEnt->ShortNameHash & (UINT32)(NewSize - 1);
+      DirEnt->ShortNameForwardLink       = ShortNameHashTable[HashTableIndex];
+      ShortNameHashTable[HashTableIndex] = DirEnt;
+    }
+
+    while (ODir->LongNameHashTable[Index] != NULL) {
+      DirEnt                            = ODir->LongNameHashTable[Index];
+      ODir->LongNameHashTable[Index]    = DirEnt->LongNameForwardLink;
+      HashTableIndex                    = DirEnt->LongNameHash & (UINT32)(NewSize - 1);
+      DirEnt->LongNameForwardLink       = LongNameHashTable[HashTableIndex];
+      LongNameHashTable[HashTableIndex] = DirEnt;
+    }
+  }
+
+  FatFreeHashTable (ODir);
+  ODir->LongNameHashTable  = LongNameHashTable;
+  ODir->ShortNameHashTable = ShortNameHashTable;
+  ODir->HashTableSize      = NewSize;
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Allocate the hash tables of the directory.
+
+  @param  ODir                  - The directory.
+
+  @retval EFI_SUCCESS           - The hash tables are allocated.
+  @retval EFI_OUT_OF_RESOURCES  - Not enough memory to allocate the hash tables.
+
+**/
+EFI_STATUS
+FatAllocateHashTable (
+  IN FAT_ODIR  *ODir
+  )
+{
+  ODir->HashTableSize = 0;
+  ODir->DirEntCount   = 0;
+  return FatResizeHashTable (ODir, HASH_TABLE_SIZE);
+}
+
+/**
+
+  Free the hash tables of the directory.
+
+  @param  ODir                  - The directory.
+
+**/
+VOID
+FatFreeHashTable (
+  IN FAT_ODIR  *ODir
+  )
+{
+  //
+  // Both tables share a single allocation
+  //
+  if (ODir->LongNameHashTable != NULL) {
+    FreePool (ODir->LongNameHashTable);
+  }
+
+  ODir->LongNameHashTable  = NULL;
+  ODir->ShortNameHashTable = NULL;
 }
 
 /**
@@ -75,13 +178,17 @@ FatLongNameHashSearch (
   )
 {
   FAT_DIRENT  **PreviousHashNode;
+  UINT32      HashValue;
 
-  for (PreviousHashNode   = &ODir->LongNameHashTable[FatHashLongName (LongNameString)];
+  HashValue = FatHashLongName (LongNameString);
+  for (PreviousHashNode   = &ODir->LongNameHashTable[HashValue & (ODir->HashTableSize - 1)];
        *PreviousHashNode != NULL;
        PreviousHashNode   = &(*PreviousHashNode)->LongNameForwardLink
        )
   {
-    if (FatStriCmp (LongNameString, (*PreviousHashNode)->FileString) == 0) {
+    if (((*PreviousHashNode)->LongNameHash == HashValue) &&
+        (FatStriCmp (LongNameString, (*PreviousHashNode)->FileString) == 0))
+    {
       break;
     }
   }
@@ -106,13 +213,17 @@ FatShortNameHashSearch (
   )
 {
   FAT_DIRENT  **PreviousHashNode;
+  UINT32      HashValue;
 
-  for (PreviousHashNode   = &ODir->ShortNameHashTable[FatHashShortName (ShortNameString)];
+  HashValue = FatHashShortName (ShortNameString);
+  for (PreviousHashNode   = &ODir->ShortNameHashTable[HashValue & (ODir->HashTableSize - 1)];
        *PreviousHashNode != NULL;
        PreviousHashNode   = &(*PreviousHashNode)->ShortNameForwardLink
        )
   {
-    if (CompareMem (ShortNameString, (*PreviousHashNode)->Entry.FileName, FAT_NAME_LEN) == 0) {
+    if (((*PreviousHashNode)->ShortNameHash == HashValue) &&
+        (CompareMem (ShortNameString, (*PreviousHashNode)->Entry.FileName, FAT_NAME_LEN) == 0))
+    {
       break;
     }
   }
@@ -137,17 +248,30 @@ FatInsertToHashTable (
   FAT_DIRENT  **HashTable;
   UINT32      HashTableIndex;
 
+  //
+  // Grow the hash tables to keep the chains short in large directories.
+  // If that fails, the entry goes to the current tables.
+  //
+  ODir->DirEntCount++;
+  if ((ODir->DirEntCount > ODir->HashTableSize * HASH_TABLE_LOAD_FACTOR) &&
+      (ODir->HashTableSize < HASH_TABLE_MAX_SIZE))
+  {
+    FatResizeHashTable (ODir, ODir->HashTableSize * 2);
+  }
+
   //
   // Insert hash table index for short name
   //
-  HashTableIndex               = FatHashShortName (DirEnt->Entry.FileName);
+  DirEnt->ShortNameHash        = FatHashShortName (DirEnt->Entry.FileName);
+  HashTableIndex               = DirEnt->ShortNameHash & (UINT32)(ODir->HashTableSize - 1);
   HashTable                    = ODir->ShortNameHashTable;
   DirEnt->ShortNameForwardLink = HashTable[HashTableIndex];
   HashTable[HashTableIndex]    = DirEnt;
   //
   // Insert hash table index for long name
   //
-  HashTableIndex              = FatHashLongName (DirEnt->FileString);
+  DirEnt->LongNameHash        = FatHashLongName (DirEnt->FileString);
+  HashTableIndex              = DirEnt->LongNameHash & (UINT32)(ODir->HashTableSize - 1);
   HashTable                   = ODir->LongNameHashTable;
   DirEnt->LongNameForwardLink = HashTable[HashTableIndex];
   HashTable[HashTableIndex]   = DirEnt;
@@ -167,6 +291,28 @@ FatDeleteFromHashTable (
   IN FAT_DIRENT  *DirEnt
   )
 {
-  *FatShortNameHashSearch (ODir, DirEnt->Entry.FileName) = DirEnt->ShortNameForwardLink;
-  *FatLongNameHashSearch (ODir, DirEnt->FileString)      = DirEnt->LongNameForwardLink;
+  FAT_DIRENT  **PreviousHashNode;
+
+  //
+  // Unlink the node itself rather than the first one with the same name
+  //
+  PreviousHashNode = &ODir->ShortNameHashTable[DirEnt->ShortNameHash & (ODir->HashTableSize - 1)];
+  while ((*PreviousHashNode != NULL) && (*PreviousHashNode != DirEnt)) {
+    PreviousHashNode = &(*PreviousHashNode)->ShortNameForwardLink;
+  }
+
+  if (*PreviousHashNode != NULL) {
+    *PreviousHashNode = DirEnt->ShortNameForwardLink;
+  }
+
+  PreviousHashNode = &ODir->LongNameHashTable[DirEnt->LongNameHash & (ODir->HashTableSize - 1)];
+  while ((*PreviousHashNode != NULL) && (*PreviousHashNode != DirEnt)) {
+    PreviousHashNode = &(*PreviousHashNode)->LongNameForwardLink;
+  }
+
+  if (*PreviousHashNode != NULL) {
+    *PreviousHashNode = DirEnt->LongNameForwardLink;
+  }
+
+  ODir->DirEntCount--;
 }
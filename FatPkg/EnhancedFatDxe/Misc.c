@@ -546,6 +546,13 @@ FatFreeVolume (
     FreePool (Volume->CacheBuffer);
   }
 
+  //
+  // Free the free cluster bitmap
+  //
+  if (Volume->FreeBitmap != NULL) {
+    FreePool (Volume->FreeBitmap);
+  }
+
   //
   // Free directory cache
   //
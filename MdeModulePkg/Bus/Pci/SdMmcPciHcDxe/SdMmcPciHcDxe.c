@@ -142,6 +142,11 @@ InitializeSdMmcPciHcDxe (
 /**
   Call back function when the timer event is signaled.
 
+  The TRBs in the async I/O queue are executed one after another. When the
+  first TRB completes, the next one is started right away instead of on the
+  next timer tick, so that a queue of requests (e.g. the CMD23 + CMD18/CMD25
+  pairs of a BlockIo2 transfer) keeps the bus busy.
+
   @param[in]  Event     The Event this notify function registered to.
   @param[in]  Context   Pointer to the context data registered to the
                         Event.
@@ -164,20 +169,19 @@ ProcessAsyncTaskList (
 
   Private = (SD_MMC_HC_PRIVATE_DATA *)Context;
 
-  //
-  // Check if the first entry in the async I/O queue is done or not.
-  //
-  Status = EFI_SUCCESS;
-  Trb    = NULL;
-  Link   = GetFirstNode (&Private->Queue);
-  if (!IsNull (&Private->Queue, Link)) {
+  while (TRUE) {
+    //
+    // Check if the first entry in the async I/O queue is done or not.
+    //
+    Link = GetFirstNode (&Private->Queue);
+    if (IsNull (&Private->Queue, Link)) {
+      return;
+    }
+
     Trb = SD_MMC_HC_TRB_FROM_THIS (Link);
     if (!Private->Slot[Trb->Slot].MediaPresent) {
       Status = EFI_NO_MEDIA;
-      goto Done;
-    }
-
-    if (!Trb->Started) {
+    } else if (!Trb->Started) {
       //
       // Check whether the cmd/data line is ready for transfer.
       //
@@ -185,39 +189,40 @@ ProcessAsyncTaskList (
       if (!EFI_ERROR (Status)) {
         Trb->Started = TRUE;
         Status       = SdMmcExecTrb (Private, Trb);
-        if (EFI_ERROR (Status)) {
-          goto Done;
+        if (!EFI_ERROR (Status)) {
+          Status = SdMmcCheckTrbResult (Private, Trb);
         }
-      } else {
-        goto Done;
       }
+    } else {
+      Status = SdMmcCheckTrbResult (Private, Trb);
     }
 
-    Status = SdMmcCheckTrbResult (Private, Trb);
-  }
+    if (Status == EFI_NOT_READY) {
+      Packet = Trb->Packet;
+      if (Packet->Timeout == 0) {
+        InfiniteWait = TRUE;
+      } else {
+        InfiniteWait = FALSE;
+      }
 
-Done:
-  if ((Trb != NULL) && (Status == EFI_NOT_READY)) {
-    Packet = Trb->Packet;
-    if (Packet->Timeout == 0) {
-      InfiniteWait = TRUE;
-    } else {
-      InfiniteWait = FALSE;
+      if ((!InfiniteWait) && (Trb->Timeout-- == 0)) {
+        RemoveEntryList (Link);
+        Trb->Packet->TransactionStatus = EFI_TIMEOUT;
+        TrbEvent                       = Trb->Event;
+        SdMmcFreeTrb (Trb);
+        DEBUG ((DEBUG_VERBOSE, "ProcessAsyncTaskList(): Signal Event %p EFI_TIMEOUT\n", TrbEvent));
+        gBS->SignalEvent (TrbEvent);
+      }
+
+      return;
     }
 
-    if ((!InfiniteWait) && (Trb->Timeout-- == 0)) {
-      RemoveEntryList (Link);
-      Trb->Packet->TransactionStatus = EFI_TIMEOUT;
-      TrbEvent                       = Trb->Event;
-      SdMmcFreeTrb (Trb);
-      DEBUG ((DEBUG_VERBOSE, "ProcessAsyncTaskList(): Signal Event %p EFI_TIMEOUT\n", TrbEvent));
-      gBS->SignalEvent (TrbEvent);
+    if ((Status == EFI_CRC_ERROR) && (Trb->Retries > 0)) {
+      Trb->Retries--;
+      Trb->Started = FALSE;
       return;
     }
-  } else if ((Trb != NULL) && (Status == EFI_CRC_ERROR) && (Trb->Retries > 0)) {
-    Trb->Retries--;
-    Trb->Started = FALSE;
-  } else if ((Trb != NULL)) {
+
     RemoveEntryList (Link);
     Trb->Packet->TransactionStatus = Status;
     TrbEvent                       = Trb->Event;
@@ -225,8 +230,6 @@ Done:
     DEBUG ((DEBUG_VERBOSE, "ProcessAsyncTaskList(): Signal Event %p with %r\n", TrbEvent, Status));
     gBS->SignalEvent (TrbEvent);
   }
-
-  return;
 }
 
 /**
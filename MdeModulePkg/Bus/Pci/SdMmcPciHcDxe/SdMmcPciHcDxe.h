@@ -151,6 +151,7 @@ typedef struct {
   VOID                                   *DataMap;
   SD_MMC_HC_TRANSFER_MODE                Mode;
   SD_MMC_HC_ADMA_LENGTH_MODE             AdmaLengthMode;
+  BOOLEAN                                Adma3;
 
   EFI_EVENT                              Event;
   BOOLEAN                                Started;
@@ -167,6 +168,9 @@ typedef struct {
   EFI_PHYSICAL_ADDRESS                   AdmaDescPhy;
   VOID                                   *AdmaMap;
   UINT32                                 AdmaPages;
+  SD_MMC_HC_ADMA3_CMD_DESC               *Adma3CmdDesc;
+  SD_MMC_HC_ADMA3_INTEGRATED_DESC_LINE   *Adma3IntDesc;
+  EFI_PHYSICAL_ADDRESS                   Adma3IntDescPhy;
 
   SD_MMC_HC_PRIVATE_DATA                 *Private;
 } SD_MMC_HC_TRB;
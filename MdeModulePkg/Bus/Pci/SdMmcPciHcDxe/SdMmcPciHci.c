@@ -1480,6 +1480,7 @@ BuildAdmaDescTable (
   UINT64                Remaining;
   UINT64                Address;
   UINTN                 TableSize;
+  UINTN                 BufferSize;
   EFI_PCI_IO_PROTOCOL   *PciIo;
   EFI_STATUS            Status;
   UINTN                 Bytes;
@@ -1540,13 +1541,22 @@ BuildAdmaDescTable (
   }
 
   Entries        = DivU64x32 ((DataLen + AdmaMaxDataPerLine - 1), AdmaMaxDataPerLine);
-  TableSize      = (UINTN)MultU64x32 (Entries, DescSize);
-  Trb->AdmaPages = (UINT32)EFI_SIZE_TO_PAGES (TableSize);
+  TableSize = (UINTN)MultU64x32 (Entries, DescSize);
+  //
+  // ADMA3 places the command descriptor right before the ADMA2 descriptor
+  // table and the integrated descriptor pointing to both right after it.
+  //
+  BufferSize = TableSize;
+  if (Trb->Adma3) {
+    BufferSize += sizeof (SD_MMC_HC_ADMA3_CMD_DESC) + sizeof (SD_MMC_HC_ADMA3_INTEGRATED_DESC_LINE);
+  }
+
+  Trb->AdmaPages = (UINT32)EFI_SIZE_TO_PAGES (BufferSize);
   Status         = PciIo->AllocateBuffer (
                             PciIo,
                             AllocateAnyPages,
                             EfiBootServicesData,
-                            EFI_SIZE_TO_PAGES (TableSize),
+                            EFI_SIZE_TO_PAGES (BufferSize),
                             (VOID **)&AdmaDesc,
                             0
                             );
@@ -1554,8 +1564,8 @@ BuildAdmaDescTable (
     return EFI_OUT_OF_RESOURCES;
   }
 
-  ZeroMem (AdmaDesc, TableSize);
-  Bytes  = TableSize;
+  ZeroMem (AdmaDesc, BufferSize);
+  Bytes  = BufferSize;
   Status = PciIo->Map (
                     PciIo,
                     EfiPciIoOperationBusMasterCommonBuffer,
@@ -1565,13 +1575,13 @@ BuildAdmaDescTable (
                     &Trb->AdmaMap
                     );
 
-  if (EFI_ERROR (Status) || (Bytes != TableSize)) {
+  if (EFI_ERROR (Status) || (Bytes != BufferSize)) {
     //
     // Map error or unable to map the whole RFis buffer into a contiguous region.
     //
     PciIo->FreeBuffer (
              PciIo,
-             EFI_SIZE_TO_PAGES (TableSize),
+             EFI_SIZE_TO_PAGES (BufferSize),
              AdmaDesc
              );
     return EFI_OUT_OF_RESOURCES;
@@ -1603,6 +1613,27 @@ BuildAdmaDescTable (
     Trb->Adma32Desc = AdmaDesc;
   } else if (Trb->Mode == SdMmcAdma64bV3Mode) {
     Trb->Adma64V3Desc = AdmaDesc;
+  } else if (Trb->Adma3) {
+    Trb->Adma3CmdDesc    = AdmaDesc;
+    Trb->Adma64V4Desc    = (SD_MMC_HC_ADMA_64_V4_DESC_LINE *)(Trb->Adma3CmdDesc + 1);
+    Trb->Adma3IntDesc    = (SD_MMC_HC_ADMA3_INTEGRATED_DESC_LINE *)((UINT8 *)Trb->Adma64V4Desc + TableSize);
+    Trb->Adma3IntDescPhy = Trb->AdmaDescPhy + sizeof (SD_MMC_HC_ADMA3_CMD_DESC) + TableSize;
+
+    Trb->Adma3CmdDesc->BlkCount.Valid     = 1;
+    Trb->Adma3CmdDesc->BlkCount.Act       = SD_MMC_HC_ADMA3_ACT_CMD;
+    Trb->Adma3CmdDesc->BlkSize.Valid      = 1;
+    Trb->Adma3CmdDesc->BlkSize.Act        = SD_MMC_HC_ADMA3_ACT_CMD;
+    Trb->Adma3CmdDesc->Argument.Valid     = 1;
+    Trb->Adma3CmdDesc->Argument.Act       = SD_MMC_HC_ADMA3_ACT_CMD;
+    Trb->Adma3CmdDesc->TransModeCmd.Valid = 1;
+    Trb->Adma3CmdDesc->TransModeCmd.End   = 1;
+    Trb->Adma3CmdDesc->TransModeCmd.Act   = SD_MMC_HC_ADMA3_ACT_CMD;
+
+    Trb->Adma3IntDesc->Valid        = 1;
+    Trb->Adma3IntDesc->End          = 1;
+    Trb->Adma3IntDesc->Act          = SD_MMC_HC_ADMA3_ACT_INTEGRATED;
+    Trb->Adma3IntDesc->LowerAddress = (UINT32)Trb->AdmaDescPhy;
+    Trb->Adma3IntDesc->UpperAddress = (UINT32)RShiftU64 (Trb->AdmaDescPhy, 32);
   } else {
     Trb->Adma64V4Desc = AdmaDesc;
   }
@@ -1762,6 +1793,7 @@ SdMmcPrintTrb (
   DEBUG ((DebugLevel, "DataMap: %p\n", Trb->DataMap));
   DEBUG ((DebugLevel, "Mode: %d\n", Trb->Mode));
   DEBUG ((DebugLevel, "AdmaLengthMode: %d\n", Trb->AdmaLengthMode));
+  DEBUG ((DebugLevel, "Adma3: %d\n", Trb->Adma3));
   DEBUG ((DebugLevel, "Event: %p\n", Trb->Event));
   DEBUG ((DebugLevel, "Started: %d\n", Trb->Started));
   DEBUG ((DebugLevel, "CommandComplete: %d\n", Trb->CommandComplete));
@@ -1772,6 +1804,8 @@ SdMmcPrintTrb (
   DEBUG ((DebugLevel, "Adma32Desc: %p\n", Trb->Adma32Desc));
   DEBUG ((DebugLevel, "Adma64V3Desc: %p\n", Trb->Adma64V3Desc));
   DEBUG ((DebugLevel, "Adma64V4Desc: %p\n", Trb->Adma64V4Desc));
+  DEBUG ((DebugLevel, "Adma3CmdDesc: %p\n", Trb->Adma3CmdDesc));
+  DEBUG ((DebugLevel, "Adma3IntDesc: %p\n", Trb->Adma3IntDesc));
   DEBUG ((DebugLevel, "AdmaMap: %p\n", Trb->AdmaMap));
   DEBUG ((DebugLevel, "AdmaPages: %X\n", Trb->AdmaPages));
 
@@ -1925,6 +1959,17 @@ SdMmcCreateTrb (
         Trb->AdmaLengthMode = SdMmcAdmaLen26b;
       }
 
+      //
+      // ADMA3 is only used with the 4.10 64b descriptor format.
+      //
+      if ((Trb->Mode == SdMmcAdma64bV4Mode) &&
+          (Private->ControllerVersion[Slot] >= SD_MMC_HC_CTRL_VER_410) &&
+          (Private->Capability[Slot].Adma3 != 0) &&
+          PcdGetBool (PcdSdMmcAdma3Enable))
+      {
+        Trb->Adma3 = TRUE;
+      }
+
       Status = SdMmcSetupMemoryForDmaTransfer (Private, Slot, Trb);
       if (EFI_ERROR (Status)) {
         goto Error;
@@ -1991,7 +2036,13 @@ SdMmcFreeTrb (
              );
   }
 
-  if (Trb->Adma64V4Desc != NULL) {
+  if (Trb->Adma3CmdDesc != NULL) {
+    PciIo->FreeBuffer (
+             PciIo,
+             Trb->AdmaPages,
+             Trb->Adma3CmdDesc
+             );
+  } else if (Trb->Adma64V4Desc != NULL) {
     PciIo->FreeBuffer (
              PciIo,
              Trb->AdmaPages,
@@ -2186,8 +2237,17 @@ SdMmcExecTrb (
   //
   // Set Host Control 1 register DMA Select field
   //
-  if ((Trb->Mode == SdMmcAdma32bMode) ||
-      (Trb->Mode == SdMmcAdma64bV4Mode))
+  if (Trb->Adma3) {
+    //
+    // With Host Version 4 Enable set, 11b selects ADMA3.
+    //
+    HostCtrl1 = BIT4|BIT3;
+    Status    = SdMmcHcOrMmio (PciIo, Trb->Slot, SD_MMC_HC_HOST_CTRL1, sizeof (HostCtrl1), &HostCtrl1);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  } else if ((Trb->Mode == SdMmcAdma32bMode) ||
+             (Trb->Mode == SdMmcAdma64bV4Mode))
   {
     HostCtrl1 = BIT4;
     Status    = SdMmcHcOrMmio (PciIo, Trb->Slot, SD_MMC_HC_HOST_CTRL1, sizeof (HostCtrl1), &HostCtrl1);
@@ -2222,9 +2282,10 @@ SdMmcExecTrb (
     if (EFI_ERROR (Status)) {
       return Status;
     }
-  } else if ((Trb->Mode == SdMmcAdma32bMode) ||
-             (Trb->Mode == SdMmcAdma64bV3Mode) ||
-             (Trb->Mode == SdMmcAdma64bV4Mode))
+  } else if (!Trb->Adma3 &&
+             ((Trb->Mode == SdMmcAdma32bMode) ||
+              (Trb->Mode == SdMmcAdma64bV3Mode) ||
+              (Trb->Mode == SdMmcAdma64bV4Mode)))
   {
     AdmaAddr = (UINT64)(UINTN)Trb->AdmaDescPhy;
     Status   = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_ADMA_SYS_ADDR, FALSE, sizeof (AdmaAddr), &AdmaAddr);
@@ -2241,11 +2302,6 @@ SdMmcExecTrb (
     BlkSize |= 0x7000;
   }
 
-  Status = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_BLK_SIZE, FALSE, sizeof (BlkSize), &BlkSize);
-  if (EFI_ERROR (Status)) {
-    return Status;
-  }
-
   BlkCount = 0;
   if (Trb->Mode != SdMmcNoData) {
     //
@@ -2254,21 +2310,7 @@ SdMmcExecTrb (
     BlkCount = (Trb->DataLen / Trb->BlockSize);
   }
 
-  if (Private->ControllerVersion[Trb->Slot] >= SD_MMC_HC_CTRL_VER_410) {
-    Status = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_SDMA_ADDR, FALSE, sizeof (UINT32), &BlkCount);
-  } else {
-    Status = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_BLK_COUNT, FALSE, sizeof (UINT16), &BlkCount);
-  }
-
-  if (EFI_ERROR (Status)) {
-    return Status;
-  }
-
   Argument = Packet->SdMmcCmdBlk->CommandArgument;
-  Status   = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_ARG1, FALSE, sizeof (Argument), &Argument);
-  if (EFI_ERROR (Status)) {
-    return Status;
-  }
 
   TransMode = 0;
   if (Trb->Mode != SdMmcNoData) {
@@ -2294,11 +2336,6 @@ SdMmcExecTrb (
     }
   }
 
-  Status = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_TRANS_MOD, FALSE, sizeof (TransMode), &TransMode);
-  if (EFI_ERROR (Status)) {
-    return Status;
-  }
-
   Cmd = (UINT16)LShiftU64 (Packet->SdMmcCmdBlk->CommandIndex, 8);
   if (Packet->SdMmcCmdBlk->CommandType == SdMmcCommandTypeAdtc) {
     Cmd |= BIT5;
@@ -2332,6 +2369,46 @@ SdMmcExecTrb (
     }
   }
 
+  if (Trb->Adma3) {
+    //
+    // The command descriptor loads the registers otherwise written below,
+    // writing the integrated descriptor address starts the transfer.
+    //
+    Trb->Adma3CmdDesc->BlkCount.Data     = BlkCount;
+    Trb->Adma3CmdDesc->BlkSize.Data      = BlkSize;
+    Trb->Adma3CmdDesc->Argument.Data     = Argument;
+    Trb->Adma3CmdDesc->TransModeCmd.Data = (UINT32)LShiftU64 (Cmd, 16) | TransMode;
+
+    AdmaAddr = (UINT64)(UINTN)Trb->Adma3IntDescPhy;
+    Status   = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_ADMA3_ID_ADDR, FALSE, sizeof (AdmaAddr), &AdmaAddr);
+    return Status;
+  }
+
+  Status = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_BLK_SIZE, FALSE, sizeof (BlkSize), &BlkSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (Private->ControllerVersion[Trb->Slot] >= SD_MMC_HC_CTRL_VER_410) {
+    Status = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_SDMA_ADDR, FALSE, sizeof (UINT32), &BlkCount);
+  } else {
+    Status = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_BLK_COUNT, FALSE, sizeof (UINT16), &BlkCount);
+  }
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_ARG1, FALSE, sizeof (Argument), &Argument);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_TRANS_MOD, FALSE, sizeof (TransMode), &TransMode);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   //
   // Execute cmd
   //
@@ -55,6 +55,7 @@
 #define SD_MMC_HC_ADMA_ERR_STS        0x54
 #define SD_MMC_HC_ADMA_SYS_ADDR       0x58
 #define SD_MMC_HC_PRESET_VAL          0x60
+#define SD_MMC_HC_ADMA3_ID_ADDR       0x78
 #define SD_MMC_HC_SHARED_BUS_CTRL     0xE0
 #define SD_MMC_HC_SLOT_INT_STS        0xFC
 #define SD_MMC_HC_CTRL_VER            0xFE
@@ -144,6 +145,49 @@ typedef struct {
   UINT32    Reserved1;
 } SD_MMC_HC_ADMA_64_V4_DESC_LINE;
 
+//
+// ADMA3 descriptor line attributes.
+//
+#define SD_MMC_HC_ADMA3_ACT_CMD         1
+#define SD_MMC_HC_ADMA3_ACT_INTEGRATED  7
+
+//
+// ADMA3 command descriptor line. Each line writes Data to one of the
+// Block Count, Block Size, Argument or Transfer Mode/Command registers.
+//
+typedef struct {
+  UINT32    Valid    : 1;
+  UINT32    End      : 1;
+  UINT32    Int      : 1;
+  UINT32    Act      : 3;
+  UINT32    Reserved : 26;
+  UINT32    Data;
+} SD_MMC_HC_ADMA3_CMD_DESC_LINE;
+
+//
+// ADMA3 command descriptor for SD mode.
+//
+typedef struct {
+  SD_MMC_HC_ADMA3_CMD_DESC_LINE    BlkCount;
+  SD_MMC_HC_ADMA3_CMD_DESC_LINE    BlkSize;
+  SD_MMC_HC_ADMA3_CMD_DESC_LINE    Argument;
+  SD_MMC_HC_ADMA3_CMD_DESC_LINE    TransModeCmd;
+} SD_MMC_HC_ADMA3_CMD_DESC;
+
+//
+// ADMA3 integrated descriptor line for 64b addressing.
+//
+typedef struct {
+  UINT32    Valid    : 1;
+  UINT32    End      : 1;
+  UINT32    Int      : 1;
+  UINT32    Act      : 3;
+  UINT32    Reserved : 26;
+  UINT32    LowerAddress;
+  UINT32    UpperAddress;
+  UINT32    Reserved1;
+} SD_MMC_HC_ADMA3_INTEGRATED_DESC_LINE;
+
 #define SD_MMC_SDMA_BOUNDARY  512 * 1024
 #define SD_MMC_SDMA_ROUND_UP(x, n)  (((x) + n) & ~(n - 1))
 
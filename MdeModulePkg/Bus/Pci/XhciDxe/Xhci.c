@@ -1810,6 +1810,10 @@ XhcCreateUsbHc (
   UINT32             PageSize;
   UINT16             ExtCapReg;
   UINT8              ReleaseNumber;
+  UINTN              Segment;
+  UINTN              Bus;
+  UINTN              Device;
+  UINTN              Function;
 
   Xhc = AllocateZeroPool (sizeof (USB_XHCI_INSTANCE));
 
@@ -1898,6 +1902,43 @@ XhcCreateUsbHc (
     goto ON_ERROR;
   }
 
+  if (FeaturePcdGet (PcdXhciPublishEndpointStats)) {
+    //
+    // Create the endpoint statistics publishing timer. It runs at TPL_CALLBACK
+    // because the statistics are published in a variable.
+    //
+    Status = gBS->CreateEvent (
+                    EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                    TPL_CALLBACK,
+                    XhcPublishEndpointStats,
+                    Xhc,
+                    &Xhc->StatsTimer
+                    );
+
+    if (EFI_ERROR (Status)) {
+      gBS->CloseEvent (Xhc->PollTimer);
+      goto ON_ERROR;
+    }
+
+    Status = PciIo->GetLocation (PciIo, &Segment, &Bus, &Device, &Function);
+    if (EFI_ERROR (Status)) {
+      Segment  = 0;
+      Bus      = 0;
+      Device   = 0;
+      Function = 0;
+    }
+
+    UnicodeSPrint (
+      Xhc->StatsVariableName,
+      sizeof (Xhc->StatsVariableName),
+      L"XhciStats_%04x_%02x_%02x_%x",
+      Segment,
+      Bus,
+      Device,
+      Function
+      );
+  }
+
   return Xhc;
 
 ON_ERROR:
@@ -1937,6 +1978,10 @@ XhcExitBootService (
     gBS->CloseEvent (Xhc->PollTimer);
   }
 
+  if (Xhc->StatsTimer != NULL) {
+    gBS->CloseEvent (Xhc->StatsTimer);
+  }
+
   XhcClearBiosOwnership (Xhc);
 
   //
@@ -2116,6 +2161,14 @@ XhcDriverBindingStart (
     goto FREE_POOL;
   }
 
+  //
+  // Start publishing the endpoint statistics, don't fail the start
+  // because of something for diagnostics.
+  //
+  if (Xhc->StatsTimer != NULL) {
+    gBS->SetTimer (Xhc->StatsTimer, TimerPeriodic, XHC_STATS_TIMER_INTERVAL);
+  }
+
   //
   // Create event to stop the HC when exit boot service.
   //
@@ -2166,6 +2219,10 @@ XhcDriverBindingStart (
 
 FREE_POOL:
   gBS->CloseEvent (Xhc->PollTimer);
+  if (Xhc->StatsTimer != NULL) {
+    gBS->CloseEvent (Xhc->StatsTimer);
+  }
+
   XhcFreeSched (Xhc);
   FreePool (Xhc);
 
@@ -2279,6 +2336,15 @@ XhcDriverBindingStop (
     gBS->CloseEvent (Xhc->PollTimer);
   }
 
+  if (Xhc->StatsTimer != NULL) {
+    gBS->CloseEvent (Xhc->StatsTimer);
+
+    //
+    // The statistics of the controller are gone with it
+    //
+    gRT->SetVariable (Xhc->StatsVariableName, &gEfiCallerIdGuid, 0, 0, NULL);
+  }
+
   if (Xhc->ExitBootServiceEvent != NULL) {
     gBS->CloseEvent (Xhc->ExitBootServiceEvent);
   }
@@ -22,12 +22,16 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/BaseMemoryLib.h>
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiLib.h>
 #include <Library/DebugLib.h>
 #include <Library/ReportStatusCodeLib.h>
 #include <Library/TimerLib.h>
 #include <Library/PcdLib.h>
+#include <Library/CpuLib.h>
+#include <Library/PrintLib.h>
+#include <Library/PerformanceLib.h>
 
 #include <IndustryStandard/Pci.h>
 
@@ -72,6 +76,16 @@ typedef struct _USB_DEV_CONTEXT    USB_DEV_CONTEXT;
 // The unit is 100us, takes 1ms as interval.
 //
 #define XHC_ASYNC_TIMER_INTERVAL  EFI_TIMER_PERIOD_MILLISECONDS(1)
+//
+// XHC endpoint statistics publishing interval.
+// The unit is 100ns, takes 1s as interval.
+//
+#define XHC_STATS_TIMER_INTERVAL  EFI_TIMER_PERIOD_SECONDS(1)
+//
+// Length of the name of the endpoint statistics variable,
+// "XhciStats_SSSS_BB_DD_F" and the terminating null.
+//
+#define XHC_STATS_VARIABLE_NAME_LENGTH  23
 
 //
 // XHC raises TPL to TPL_NOTIFY to serialize all its operations
@@ -136,6 +150,38 @@ typedef struct {
 } EFI_USB_HUB_DESCRIPTOR;
 #pragma pack()
 
+//
+// Transfer statistics of an endpoint, accumulated by XhcExecTransfer(),
+// published by XhcPublishEndpointStats() and reported when the device slot
+// is disabled.
+//
+typedef struct {
+  UINT64    Transfers;
+  UINT64    Errors;
+  UINT64    Bytes;
+  UINT64    Ticks;      ///< Total latency, in performance counter ticks.
+  UINT64    MaxTicks;   ///< Worst latency, in performance counter ticks.
+  UINT64    SleepTicks; ///< Part of Ticks spent with the CPU halted.
+} XHC_EP_STATS;
+
+//
+// Transfer statistics of an endpoint as published in the volatile
+// "XhciStats_SSSS_BB_DD_F" variable of gEfiCallerIdGuid, named after the PCI
+// location of the controller. The variable holds one record per endpoint
+// that has done a transfer and can be read with "dmpstore" in the Shell.
+//
+typedef struct {
+  UINT8     SlotId;
+  UINT8     Dci;
+  UINT8     Reserved[6];
+  UINT64    Transfers;
+  UINT64    Errors;
+  UINT64    Bytes;
+  UINT64    Microseconds;      ///< Total latency.
+  UINT64    MaxMicroseconds;   ///< Worst latency.
+  UINT64    SleepMicroseconds; ///< Part of Microseconds spent with the CPU halted.
+} XHC_EP_STATS_RECORD;
+
 struct _USB_DEV_CONTEXT {
   //
   // Whether this entry in UsbDevContext array is used or not.
@@ -198,6 +244,11 @@ struct _USB_DEV_CONTEXT {
   // Every interface has an active AlternateSetting.
   //
   UINT8                        *ActiveAlternateSetting;
+  //
+  // The transfer statistics for every endpoint, indexed like
+  // EndpointTransferRing.
+  //
+  XHC_EP_STATS                 EndpointStats[31];
 };
 
 struct _USB_XHCI_INSTANCE {
@@ -217,6 +268,14 @@ struct _USB_XHCI_INSTANCE {
   EFI_EVENT                   ExitBootServiceEvent;
   EFI_EVENT                   PollTimer;
   LIST_ENTRY                  AsyncIntTransfers;
+  //
+  // StatsTimer publishes the endpoint statistics in the StatsVariableName
+  // variable when StatsChanged is set. It is only created when
+  // PcdXhciPublishEndpointStats is TRUE.
+  //
+  EFI_EVENT                   StatsTimer;
+  BOOLEAN                     StatsChanged;
+  CHAR16                      StatsVariableName[XHC_STATS_VARIABLE_NAME_LENGTH];
 
   UINT8                       CapLength;  ///< Capability Register Length
   XHC_HCSPARAMS1              HcSParams1; ///< Structural Parameters 1
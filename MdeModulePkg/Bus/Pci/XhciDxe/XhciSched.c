@@ -247,11 +247,12 @@ XhcCreateTransferTrb (
     return EFI_DEVICE_ERROR;
   }
 
-  Urb->Finished  = FALSE;
-  Urb->StartDone = FALSE;
-  Urb->EndDone   = FALSE;
-  Urb->Completed = 0;
-  Urb->Result    = EFI_USB_NOERROR;
+  Urb->Finished     = FALSE;
+  Urb->StartDone    = FALSE;
+  Urb->EndDone      = FALSE;
+  Urb->Completed    = 0;
+  Urb->TrbAccounted = 0;
+  Urb->Result       = EFI_USB_NOERROR;
 
   Dci = XhcEndpointToDci (Urb->Ep.EpAddr, (UINT8)(Urb->Ep.Direction));
   ASSERT (Dci < 32);
@@ -394,15 +395,24 @@ XhcCreateTransferTrb (
 
     case ED_BULK_OUT:
     case ED_BULK_IN:
-      TotalLen = 0;
-      Len      = 0;
-      TrbNum   = 0;
-      TrbStart = (TRB *)(UINTN)EPRing->RingEnqueue;
+      //
+      // Queue the whole transfer as back-to-back TDs, so the controller can
+      // stream them without waiting for software. Only the last TD interrupts
+      // on completion; a short packet still generates an event through ISP.
+      // Since the first TD does not report, consider the start done already.
+      //
+      TotalLen       = 0;
+      Len            = 0;
+      TrbNum         = 0;
+      TrbStart       = (TRB *)(UINTN)EPRing->RingEnqueue;
+      Urb->StartDone = TRUE;
       while (TotalLen < Urb->DataLen) {
-        if ((TotalLen + 0x10000) >= Urb->DataLen) {
+        //
+        // A TRB data buffer must not span a 64KB boundary.
+        //
+        Len = 0x10000 - (((UINTN)Urb->DataPhy + TotalLen) & 0xFFFF);
+        if (Len > Urb->DataLen - TotalLen) {
           Len = Urb->DataLen - TotalLen;
-        } else {
-          Len = 0x10000;
         }
 
         TrbStart                      = (TRB *)(UINTN)EPRing->RingEnqueue;
@@ -412,7 +422,7 @@ XhcCreateTransferTrb (
         TrbStart->TrbNormal.TDSize    = 0;
         TrbStart->TrbNormal.IntTarget = 0;
         TrbStart->TrbNormal.ISP       = 1;
-        TrbStart->TrbNormal.IOC       = 1;
+        TrbStart->TrbNormal.IOC       = (TotalLen + Len == Urb->DataLen) ? 1 : 0;
         TrbStart->TrbNormal.Type      = TRB_TYPE_NORMAL;
         //
         // Update the cycle bit
@@ -1084,6 +1094,62 @@ IsTransferRingTrb (
   return FALSE;
 }
 
+/**
+  Compute the data length of the TRBs of a URB that completed without
+  generating a transfer event, because their IOC flag was clear.
+
+  The controller processes a transfer ring in order, hence all TRBs of the
+  URB that precede Trb, and have not been accounted for yet, have completed
+  successfully. Otherwise they would have reported an event themselves.
+
+  @param Xhc    The XHCI Instance.
+  @param Trb    The TRB that a transfer event has been received for.
+  @param Urb    The URB that Trb belongs to.
+
+  @return The number of bytes moved by the silently completed TRBs.
+
+**/
+STATIC
+UINTN
+XhcSilentTrbLength (
+  IN     USB_XHCI_INSTANCE  *Xhc,
+  IN     TRB_TEMPLATE       *Trb,
+  IN OUT URB                *Urb
+  )
+{
+  LINK_TRB              *LinkTrb;
+  TRB_TEMPLATE          *CheckedTrb;
+  UINTN                 Index;
+  UINTN                 Length;
+  UINT8                 TrbType;
+  EFI_PHYSICAL_ADDRESS  PhyAddr;
+
+  Length     = 0;
+  CheckedTrb = Urb->TrbStart;
+  for (Index = 0; Index < Urb->TrbNum; Index++) {
+    if (CheckedTrb == Trb) {
+      Urb->TrbAccounted = Index + 1;
+      break;
+    }
+
+    TrbType = (UINT8)CheckedTrb->Type;
+    if ((Index >= Urb->TrbAccounted) &&
+        ((TrbType == TRB_TYPE_DATA_STAGE) || (TrbType == TRB_TYPE_NORMAL)))
+    {
+      Length += ((TRANSFER_TRB_NORMAL *)CheckedTrb)->Length;
+    }
+
+    CheckedTrb++;
+    if (CheckedTrb->Type == TRB_TYPE_LINK) {
+      LinkTrb    = (LINK_TRB *)CheckedTrb;
+      PhyAddr    = (EFI_PHYSICAL_ADDRESS)(LinkTrb->PtrLo | LShiftU64 ((UINT64)LinkTrb->PtrHi, 32));
+      CheckedTrb = (TRB_TEMPLATE *)(UINTN)UsbHcGetHostAddrForPciAddr (Xhc->MemPool, (VOID *)(UINTN)PhyAddr, sizeof (TRB_TEMPLATE), FALSE);
+    }
+  }
+
+  return Length;
+}
+
 /**
   Check if the Trb is a transaction of the URBs in XHCI's asynchronous transfer list.
 
@@ -1144,11 +1210,13 @@ XhcCheckUrbResult (
   UINT32                High;
   UINT32                Low;
   EFI_PHYSICAL_ADDRESS  PhyAddr;
+  TRB_TEMPLATE          *EventRingDequeue;
 
   ASSERT ((Xhc != NULL) && (Urb != NULL));
 
-  Status   = EFI_SUCCESS;
-  AsyncUrb = NULL;
+  Status           = EFI_SUCCESS;
+  AsyncUrb         = NULL;
+  EventRingDequeue = Xhc->EventRing.EventRingDequeue;
 
   if (Urb->Finished) {
     goto EXIT;
@@ -1207,6 +1275,15 @@ XhcCheckUrbResult (
       continue;
     }
 
+    //
+    // Whatever the completion code of the event, the TRBs of the URB that
+    // precede the event TRB have completed successfully without an event of
+    // their own. Account for their data before the URB may be finished.
+    //
+    if (EvtTrb->Type == TRB_TYPE_TRANS_EVENT) {
+      CheckedUrb->Completed += XhcSilentTrbLength (Xhc, TRBPtr, CheckedUrb);
+    }
+
     switch (EvtTrb->Completecode) {
       case TRB_COMPLETION_STALL_ERROR:
         CheckedUrb->Result  |= EFI_USB_ERR_STALL;
@@ -1287,6 +1364,14 @@ XhcCheckUrbResult (
 
 EXIT:
 
+  //
+  // If no event has been consumed, the dequeue pointer register is up to date
+  // already; spare the register accesses, which are costly on every poll.
+  //
+  if (Xhc->EventRing.EventRingDequeue == EventRingDequeue) {
+    return Urb->Finished;
+  }
+
   //
   // Advance event ring to last available entry
   //
@@ -1340,8 +1425,14 @@ XhcExecTransfer (
   UINT64      ElapsedTicks;
   UINT64      TicksDelta;
   UINT64      CurrentTick;
+  UINT64      StartTick;
+  UINT64      SleepThresholdTicks;
+  UINT64      SleepTicks;
+  BOOLEAN     Sleep;
   BOOLEAN     IndefiniteTimeout;
 
+  XHC_EP_STATS  *Stats;
+
   Status            = EFI_SUCCESS;
   Finished          = FALSE;
   IndefiniteTimeout = FALSE;
@@ -1363,6 +1454,7 @@ XhcExecTransfer (
     IndefiniteTimeout = TRUE;
   }
 
+  StartTick = GetPerformanceCounter ();
   XhcRingDoorBell (Xhc, SlotId, Dci);
 
   TimeoutTicks = XhcConvertTimeToTicks (
@@ -1370,6 +1462,12 @@ XhcExecTransfer (
                      Timeout * XHC_1_MILLISECOND
                      )
                    );
+  SleepThresholdTicks = XhcConvertTimeToTicks (
+                          XHC_MICROSECOND_TO_NANOSECOND (
+                            PcdGet32 (PcdXhciPollSleepThreshold)
+                            )
+                          );
+  SleepTicks   = 0;
   ElapsedTicks = 0;
   CurrentTick  = GetPerformanceCounter ();
 
@@ -1379,7 +1477,20 @@ XhcExecTransfer (
       break;
     }
 
-    gBS->Stall (XHC_1_MICROSECOND);
+    //
+    // Once the transfer has been pending for long, halt the CPU until the next
+    // interrupt instead of spinning. This requires interrupts to be enabled,
+    // otherwise the CPU would never wake up.
+    //
+    Sleep = (BOOLEAN)((SleepThresholdTicks != 0) &&
+                      (ElapsedTicks >= SleepThresholdTicks) &&
+                      GetInterruptState ());
+    if (Sleep) {
+      CpuSleep ();
+    } else {
+      gBS->Stall (XHC_1_MICROSECOND);
+    }
+
     TicksDelta = XhcGetElapsedTicks (&CurrentTick);
     // Ensure that ElapsedTicks is always incremented to avoid indefinite hangs
     if (TicksDelta == 0) {
@@ -1387,6 +1498,9 @@ XhcExecTransfer (
     }
 
     ElapsedTicks += TicksDelta;
+    if (Sleep) {
+      SleepTicks += TicksDelta;
+    }
   } while (IndefiniteTimeout || ElapsedTicks < TimeoutTicks);
 
   if (!Finished) {
@@ -1396,9 +1510,196 @@ XhcExecTransfer (
     Status = EFI_DEVICE_ERROR;
   }
 
+  if (!CmdTransfer) {
+    Stats              = &Xhc->UsbDevContext[SlotId].EndpointStats[Dci - 1];
+    TicksDelta         = XhcGetElapsedTicks (&StartTick);
+    Stats->Bytes      += Urb->Completed;
+    Stats->Ticks      += TicksDelta;
+    Stats->MaxTicks    = MAX (Stats->MaxTicks, TicksDelta);
+    Stats->SleepTicks += SleepTicks;
+    Stats->Transfers++;
+    if (EFI_ERROR (Status)) {
+      Stats->Errors++;
+    }
+
+    Xhc->StatsChanged = TRUE;
+
+    //
+    // Only transfers that stayed pending past the sleep threshold go to the
+    // performance log, so that short transfers do not fill up the FPDT buffer.
+    //
+    if ((SleepThresholdTicks != 0) && (ElapsedTicks >= SleepThresholdTicks)) {
+      PERF_START_EX (gImageHandle, "XhcTransfer", NULL, StartTick, PERF_INMODULE_START_ID);
+      PERF_END_EX (gImageHandle, "XhcTransfer", NULL, 0, PERF_INMODULE_END_ID);
+    }
+  }
+
   return Status;
 }
 
+/**
+  Convert the transfer statistics of an endpoint to the published format.
+
+  @param  Stats         The transfer statistics of the endpoint.
+  @param  SlotId        The slot id of the device.
+  @param  Dci           The device context index of the endpoint.
+  @param  Record        The converted statistics.
+
+**/
+STATIC
+VOID
+XhcGetEndpointStatsRecord (
+  IN  XHC_EP_STATS         *Stats,
+  IN  UINT8                SlotId,
+  IN  UINT8                Dci,
+  OUT XHC_EP_STATS_RECORD  *Record
+  )
+{
+  ZeroMem (Record, sizeof (XHC_EP_STATS_RECORD));
+  Record->SlotId            = SlotId;
+  Record->Dci               = Dci;
+  Record->Transfers         = Stats->Transfers;
+  Record->Errors            = Stats->Errors;
+  Record->Bytes             = Stats->Bytes;
+  Record->Microseconds      = DivU64x32 (GetTimeInNanoSecond (Stats->Ticks), 1000);
+  Record->MaxMicroseconds   = DivU64x32 (GetTimeInNanoSecond (Stats->MaxTicks), 1000);
+  Record->SleepMicroseconds = DivU64x32 (GetTimeInNanoSecond (Stats->SleepTicks), 1000);
+}
+
+/**
+  Report the transfer statistics of the endpoints of a device slot.
+
+  The report is emitted at DEBUG_INFO level, e.g. when the device is
+  disconnected from the Shell.
+
+  @param  Xhc           The XHCI Instance.
+  @param  SlotId        The slot id of the device.
+
+**/
+STATIC
+VOID
+XhcDumpEndpointStats (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              SlotId
+  )
+{
+  XHC_EP_STATS         *Stats;
+  XHC_EP_STATS_RECORD  Record;
+  UINT8                Dci;
+  UINT64               BytesPerMs;
+
+  for (Dci = 1; Dci <= 31; Dci++) {
+    Stats = &Xhc->UsbDevContext[SlotId].EndpointStats[Dci - 1];
+    if (Stats->Transfers == 0) {
+      continue;
+    }
+
+    XhcGetEndpointStatsRecord (Stats, SlotId, Dci, &Record);
+    BytesPerMs = 0;
+    if (Record.Microseconds != 0) {
+      BytesPerMs = DivU64x64Remainder (MultU64x32 (Record.Bytes, 1000), Record.Microseconds, NULL);
+    }
+
+    DEBUG ((
+      DEBUG_INFO,
+      "XhcDumpEndpointStats: Slot %d Dci %d: %Ld transfers, %Ld errors, %Ld bytes, avg %Ldus, max %Ldus, halted %Ldus, %Ld KB/s\n",
+      SlotId,
+      Dci,
+      Record.Transfers,
+      Record.Errors,
+      Record.Bytes,
+      DivU64x64Remainder (Record.Microseconds, Record.Transfers, NULL),
+      Record.MaxMicroseconds,
+      Record.SleepMicroseconds,
+      BytesPerMs
+      ));
+  }
+}
+
+/**
+  Publish the transfer statistics of the endpoints in a volatile variable,
+  so that they can be read from the Shell while the devices are attached.
+
+  The statistics of a device stay published after it is detached, until its
+  slot is enabled again for another device.
+
+  @param  Event                 The statistics timer event.
+  @param  Context               Pointer to USB_XHCI_INSTANCE.
+
+**/
+VOID
+EFIAPI
+XhcPublishEndpointStats (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  USB_XHCI_INSTANCE    *Xhc;
+  XHC_EP_STATS_RECORD  *Records;
+  XHC_EP_STATS         *Stats;
+  UINTN                Count;
+  UINTN                SlotId;
+  UINT8                Dci;
+  EFI_TPL              OldTpl;
+
+  Xhc     = (USB_XHCI_INSTANCE *)Context;
+  Records = NULL;
+  Count   = 0;
+
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+
+  if (!Xhc->StatsChanged) {
+    gBS->RestoreTPL (OldTpl);
+    return;
+  }
+
+  for (SlotId = 1; SlotId < ARRAY_SIZE (Xhc->UsbDevContext); SlotId++) {
+    for (Dci = 1; Dci <= 31; Dci++) {
+      if (Xhc->UsbDevContext[SlotId].EndpointStats[Dci - 1].Transfers != 0) {
+        Count++;
+      }
+    }
+  }
+
+  if (Count != 0) {
+    Records = AllocatePool (Count * sizeof (XHC_EP_STATS_RECORD));
+    if (Records == NULL) {
+      gBS->RestoreTPL (OldTpl);
+      return;
+    }
+
+    Count = 0;
+    for (SlotId = 1; SlotId < ARRAY_SIZE (Xhc->UsbDevContext); SlotId++) {
+      for (Dci = 1; Dci <= 31; Dci++) {
+        Stats = &Xhc->UsbDevContext[SlotId].EndpointStats[Dci - 1];
+        if (Stats->Transfers != 0) {
+          XhcGetEndpointStatsRecord (Stats, (UINT8)SlotId, Dci, &Records[Count]);
+          Count++;
+        }
+      }
+    }
+  }
+
+  Xhc->StatsChanged = FALSE;
+  gBS->RestoreTPL (OldTpl);
+
+  //
+  // SetVariable() can't be called at XHC_TPL, so the snapshot is written
+  // once the TPL is restored. An empty snapshot deletes the variable.
+  //
+  gRT->SetVariable (
+         Xhc->StatsVariableName,
+         &gEfiCallerIdGuid,
+         EFI_VARIABLE_BOOTSERVICE_ACCESS,
+         Count * sizeof (XHC_EP_STATS_RECORD),
+         Records
+         );
+
+  if (Records != NULL) {
+    FreePool (Records);
+  }
+}
+
 /**
   Delete a single asynchronous interrupt transfer for
   the device and endpoint.
@@ -2719,6 +3020,7 @@ XhcDisableSlotCmd (
   // Construct the disable slot command
   //
   DEBUG ((DEBUG_INFO, "Disable device slot %d!\n", SlotId));
+  XhcDumpEndpointStats (Xhc, SlotId);
 
   ZeroMem (&CmdTrbDisSlot, sizeof (CmdTrbDisSlot));
   CmdTrbDisSlot.CycleBit = 1;
@@ -2832,6 +3134,7 @@ XhcDisableSlotCmd64 (
   // Construct the disable slot command
   //
   DEBUG ((DEBUG_INFO, "Disable device slot %d!\n", SlotId));
+  XhcDumpEndpointStats (Xhc, SlotId);
 
   ZeroMem (&CmdTrbDisSlot, sizeof (CmdTrbDisSlot));
   CmdTrbDisSlot.CycleBit = 1;
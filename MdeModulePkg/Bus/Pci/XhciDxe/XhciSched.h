@@ -194,6 +194,12 @@ typedef struct _URB {
   TRB_TEMPLATE                       *TrbStart;
   TRB_TEMPLATE                       *TrbEnd;
   UINTN                              TrbNum;
+  //
+  // Number of leading TRBs whose data length has been accounted for in
+  // Completed. TRBs without IOC complete silently and are accounted for
+  // when the event of a later TRB arrives.
+  //
+  UINTN                              TrbAccounted;
   BOOLEAN                            StartDone;
   BOOLEAN                            EndDone;
   BOOLEAN                            Finished;
@@ -961,6 +967,21 @@ XhcMonitorAsyncRequests (
   IN VOID       *Context
   );
 
+/**
+  Publish the transfer statistics of the endpoints in a volatile variable,
+  so that they can be read from the Shell while the devices are attached.
+
+  @param  Event                 The statistics timer event.
+  @param  Context               Pointer to USB_XHCI_INSTANCE.
+
+**/
+VOID
+EFIAPI
+XhcPublishEndpointStats (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  );
+
 /**
   Monitor the port status change. Enable/Disable device slot if there is a device attached/detached.
 
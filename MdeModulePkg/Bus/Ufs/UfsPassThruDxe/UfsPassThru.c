@@ -933,6 +933,15 @@ UfsPassThruDriverBindingStart (
     goto Error;
   }
 
+  //
+  // The device is initialized in legacy single doorbell mode, switch to MCQ mode
+  // afterwards if possible. Keep going in legacy mode otherwise.
+  //
+  Status = UfsMcqInit (Private);
+  if (EFI_ERROR (Status) && (Status != EFI_UNSUPPORTED)) {
+    DEBUG ((DEBUG_WARN, "Failed to enable MCQ mode, use legacy mode, Status = %r\n", Status));
+  }
+
   if ((mUfsHcPlatform != NULL) &&
       ((mUfsHcPlatform->RefClkFreq == EdkiiUfsCardRefClkFreq19p2Mhz) ||
        (mUfsHcPlatform->RefClkFreq == EdkiiUfsCardRefClkFreq26Mhz) ||
@@ -1067,6 +1076,8 @@ Error:
       UfsHc->FreeBuffer (UfsHc, EFI_SIZE_TO_PAGES (Private->Nutrs * sizeof (UTP_TMRD)), Private->UtpTrlBase);
     }
 
+    UfsMcqFree (Private);
+
     if (Private->TimerEvent != NULL) {
       gBS->CloseEvent (Private->TimerEvent);
     }
@@ -1200,6 +1211,8 @@ UfsPassThruDriverBindingStop (
     UfsHc->FreeBuffer (UfsHc, EFI_SIZE_TO_PAGES (Private->Nutrs * sizeof (UTP_TMRD)), Private->UtpTrlBase);
   }
 
+  UfsMcqFree (Private);
+
   if (Private->TimerEvent != NULL) {
     gBS->CloseEvent (Private->TimerEvent);
   }
@@ -48,6 +48,25 @@ typedef struct {
   UINT16    Rsvd    : 4;
 } UFS_EXPOSED_LUNS;
 
+//
+// Number of entries of the submission and completion queue used in MCQ mode.
+// It is larger than the maximum number of transfer request slots (32) so that
+// neither queue can overflow.
+//
+#define UFS_MCQ_QUEUE_DEPTH  64
+
+typedef struct {
+  UTP_TRD    *SqBase;
+  VOID       *SqMapping;
+  UTP_CQE    *CqBase;
+  VOID       *CqMapping;
+  UINTN      QcfgOffset;            // Offset of the queue configuration registers
+  UINTN      SqOprOffset;           // Offset of the submission queue operation registers
+  UINTN      CqOprOffset;           // Offset of the completion queue operation registers
+  UINT32     SqTail;                // Index of the next free submission queue entry
+  UINT32     CqHead;                // Index of the next completion queue entry to consume
+} UFS_MCQ_QUEUE;
+
 typedef struct _UFS_PASS_THRU_PRIVATE_DATA {
   UINT32                                Signature;
   EFI_HANDLE                            Handle;
@@ -75,6 +94,22 @@ typedef struct _UFS_PASS_THRU_PRIVATE_DATA {
   //
   EFI_EVENT                             TimerEvent;
   LIST_ENTRY                            Queue;
+
+  //
+  // Transfer request slots owned by a request. A slot stays in use until its
+  // request is cleaned up, which is after the doorbell bit has been cleared.
+  //
+  UINT32                                SlotsInUse;
+
+  //
+  // Multi-Circular Queue mode (UFSHCI 4.0). A single submission/completion
+  // queue pair is used, the descriptors are still built in UtpTrlBase and
+  // copied to the submission queue when started.
+  //
+  BOOLEAN                               McqEnabled;
+  UINT32                                McqPending;   // Slots submitted and not completed
+  UINT32                                McqAborted;   // Slots timed out and not completed
+  UFS_MCQ_QUEUE                         Mcq;
 } UFS_PASS_THRU_PRIVATE_DATA;
 
 #define UFS_PASS_THRU_TRANS_REQ_SIG  SIGNATURE_32 ('U', 'F', 'S', 'T')
@@ -666,6 +701,32 @@ UfsControllerInit (
   IN  UFS_PASS_THRU_PRIVATE_DATA  *Private
   );
 
+/**
+  Switch the UFS host controller to Multi-Circular Queue mode.
+
+  @param[in] Private                 The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
+
+  @retval EFI_SUCCESS                The Ufs Host Controller is switched to MCQ mode successfully.
+  @retval EFI_UNSUPPORTED            MCQ mode is disabled or not supported by the Ufs Host Controller.
+  @retval Others                     A device error occurred while configuring the queues.
+
+**/
+EFI_STATUS
+UfsMcqInit (
+  IN  UFS_PASS_THRU_PRIVATE_DATA  *Private
+  );
+
+/**
+  Free the submission and completion queue used in MCQ mode.
+
+  @param[in] Private                 The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
+
+**/
+VOID
+UfsMcqFree (
+  IN  UFS_PASS_THRU_PRIVATE_DATA  *Private
+  );
+
 /**
   Stop the UFS host controller.
 
@@ -708,7 +708,12 @@ UfsCreateNopCommandDesc (
 }
 
 /**
-  Find out available slot in transfer list of a UFS device.
+  Find out available slot in transfer list of a UFS device and reserve it.
+
+  The slot is owned by the caller until UfsReleaseSlotInTrl() is called. A slot
+  cannot be picked from the doorbell register only: the doorbell bit of a
+  non-blocking request clears before ProcessAsyncTaskList() has consumed the
+  response stored in the command descriptor of that slot.
 
   @param[in]  Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
   @param[out] Slot          The available slot.
@@ -726,25 +731,265 @@ UfsFindAvailableSlotInTrl (
   UINT8       Nutrs;
   UINT8       Index;
   UINT32      Data;
+  UINT32      Doorbell;
+  EFI_TPL     OldTpl;
   EFI_STATUS  Status;
 
   ASSERT ((Private != NULL) && (Slot != NULL));
 
-  Status = UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, &Data);
-  if (EFI_ERROR (Status)) {
-    return Status;
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  Data = Private->SlotsInUse;
+  if (!Private->McqEnabled) {
+    Status = UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, &Doorbell);
+    if (EFI_ERROR (Status)) {
+      gBS->RestoreTPL (OldTpl);
+      return Status;
+    }
+
+    Data |= Doorbell;
   }
 
-  Nutrs = (UINT8)((Private->UfsHcInfo.Capabilities & UFS_HC_CAP_NUTRS) + 1);
+  Nutrs  = (UINT8)((Private->UfsHcInfo.Capabilities & UFS_HC_CAP_NUTRS) + 1);
+  Status = EFI_NOT_READY;
 
   for (Index = 0; Index < Nutrs; Index++) {
     if ((Data & (BIT0 << Index)) == 0) {
-      *Slot = Index;
-      return EFI_SUCCESS;
+      Private->SlotsInUse |= BIT0 << Index;
+      *Slot                = Index;
+      Status               = EFI_SUCCESS;
+      break;
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Release a slot reserved by UfsFindAvailableSlotInTrl().
+
+  A slot whose request timed out in MCQ mode stays reserved until the host
+  controller posts its completion, so that a late completion can not be taken
+  for the one of a new request using the same slot.
+
+  @param[in]  Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
+  @param[in]  Slot          The slot to be released.
+
+**/
+VOID
+UfsReleaseSlotInTrl (
+  IN  UFS_PASS_THRU_PRIVATE_DATA  *Private,
+  IN  UINT8                       Slot
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if ((Private->McqAborted & (BIT0 << Slot)) == 0) {
+    Private->SlotsInUse &= ~(BIT0 << Slot);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Copy the transfer request descriptor of the specified slot to the tail of the
+  submission queue and ring the submission queue tail doorbell.
+
+  @param[in]  Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
+  @param[in]  Slot          The slot to be submitted.
+
+  @retval EFI_SUCCESS       The request was submitted successfully.
+  @retval Others            The submission queue tail doorbell could not be written.
+
+**/
+EFI_STATUS
+UfsMcqSubmit (
+  IN  UFS_PASS_THRU_PRIVATE_DATA  *Private,
+  IN  UINT8                       Slot
+  )
+{
+  UFS_MCQ_QUEUE  *Mcq;
+  UINT32         Tail;
+  EFI_TPL        OldTpl;
+  EFI_STATUS     Status;
+
+  Mcq    = &Private->Mcq;
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  CopyMem (&Mcq->SqBase[Mcq->SqTail], ((UTP_TRD *)Private->UtpTrlBase) + Slot, sizeof (UTP_TRD));
+  Tail = (Mcq->SqTail + 1) % UFS_MCQ_QUEUE_DEPTH;
+
+  Status = UfsMmioWrite32 (Private, Mcq->SqOprOffset + UFS_HC_SQTP_OFFSET, Tail * sizeof (UTP_TRD));
+  if (!EFI_ERROR (Status)) {
+    Mcq->SqTail          = Tail;
+    Private->McqPending |= BIT0 << Slot;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Consume the entries posted to the completion queue since the last call.
+
+  The overall command status of each completion is copied back to the transfer
+  request descriptor of the slot it belongs to, and the slot is removed from the
+  pending slots.
+
+  @param[in]  Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
+
+  @retval EFI_SUCCESS       The completion queue was processed successfully.
+  @retval EFI_DEVICE_ERROR  The completion queue tail pointer is invalid.
+  @retval Others            The completion queue registers could not be accessed.
+
+**/
+EFI_STATUS
+UfsMcqProcessCompletions (
+  IN  UFS_PASS_THRU_PRIVATE_DATA  *Private
+  )
+{
+  UFS_MCQ_QUEUE  *Mcq;
+  UTP_CQE        *Cqe;
+  UTP_TRD        *Trd;
+  UINT32         Head;
+  UINT32         Tail;
+  UINT8          Index;
+  EFI_TPL        OldTpl;
+  EFI_STATUS     Status;
+
+  Mcq    = &Private->Mcq;
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  Status = UfsMmioRead32 (Private, Mcq->CqOprOffset + UFS_HC_CQTP_OFFSET, &Tail);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  Tail /= sizeof (UTP_CQE);
+  if (Tail >= UFS_MCQ_QUEUE_DEPTH) {
+    Status = EFI_DEVICE_ERROR;
+    goto Exit;
+  }
+
+  Head = Mcq->CqHead;
+  while (Head != Tail) {
+    Cqe = &Mcq->CqBase[Head];
+    Trd = (UTP_TRD *)Private->UtpTrlBase;
+    for (Index = 0; Index < Private->Nutrs; Index++, Trd++) {
+      if (((Private->McqPending & (BIT0 << Index)) != 0) &&
+          (Trd->UcdBa == Cqe->UcdBa) && (Trd->UcdBaU == Cqe->UcdBaU))
+      {
+        Trd->Ocs             = Cqe->Ocs;
+        Private->McqPending &= ~(BIT0 << Index);
+        if ((Private->McqAborted & (BIT0 << Index)) != 0) {
+          Private->McqAborted &= ~(BIT0 << Index);
+          Private->SlotsInUse &= ~(BIT0 << Index);
+        }
+
+        break;
+      }
     }
+
+    if (Index == Private->Nutrs) {
+      DEBUG ((DEBUG_ERROR, "UfsMcqProcessCompletions: Unexpected completion %08x%08x\n", Cqe->UcdBaU, Cqe->UcdBa << 7));
+    }
+
+    Head = (Head + 1) % UFS_MCQ_QUEUE_DEPTH;
   }
 
-  return EFI_NOT_READY;
+  if (Head != Mcq->CqHead) {
+    Mcq->CqHead = Head;
+    Status      = UfsMmioWrite32 (Private, Mcq->CqOprOffset + UFS_HC_CQHP_OFFSET, Head * sizeof (UTP_CQE));
+  }
+
+Exit:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Get the transfer request slots which have been started and not completed yet.
+
+  In legacy mode this is the UTP Transfer Request List Door Bell Register. In
+  MCQ mode the completion queue is processed first and the pending slots are
+  returned.
+
+  @param[in]  Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
+  @param[out] Value         The bitmap of the pending slots.
+
+  @retval EFI_SUCCESS       The pending slots were returned successfully.
+  @retval Others            The host controller registers could not be accessed.
+
+**/
+EFI_STATUS
+UfsReadTransferDoorbell (
+  IN  UFS_PASS_THRU_PRIVATE_DATA  *Private,
+  OUT UINT32                      *Value
+  )
+{
+  EFI_STATUS  Status;
+
+  if (!Private->McqEnabled) {
+    return UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, Value);
+  }
+
+  Status = UfsMcqProcessCompletions (Private);
+  *Value = Private->McqPending;
+  return Status;
+}
+
+/**
+  Wait for the completion of the transfer request of the specified slot.
+
+  @param[in]  Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
+  @param[in]  Slot          The slot to wait for.
+  @param[in]  Timeout       The time out value, uses 100ns as a unit. 0 means infinite wait.
+
+  @retval EFI_TIMEOUT       The transfer request did not complete in time.
+  @retval EFI_SUCCESS       The transfer request completed.
+  @retval Others            The operation fails.
+
+**/
+EFI_STATUS
+UfsWaitTransferComplete (
+  IN  UFS_PASS_THRU_PRIVATE_DATA  *Private,
+  IN  UINT8                       Slot,
+  IN  UINT64                      Timeout
+  )
+{
+  UINT32      Value;
+  UINT64      Delay;
+  BOOLEAN     InfiniteWait;
+  EFI_STATUS  Status;
+
+  if (!Private->McqEnabled) {
+    return UfsWaitMemSet (Private, UFS_HC_UTRLDBR_OFFSET, BIT0 << Slot, 0, Timeout);
+  }
+
+  InfiniteWait = (BOOLEAN)(Timeout == 0);
+  Delay        = DivU64x32 (Timeout, 10) + 1;
+
+  do {
+    Status = UfsReadTransferDoorbell (Private, &Value);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if ((Value & (BIT0 << Slot)) == 0) {
+      return EFI_SUCCESS;
+    }
+
+    //
+    // Stall for 1 microseconds.
+    //
+    MicroSecondDelay (1);
+
+    Delay--;
+  } while (InfiniteWait || (Delay > 0));
+
+  return EFI_TIMEOUT;
 }
 
 /**
@@ -763,6 +1008,10 @@ UfsStartExecCmd (
   UINT32      Data;
   EFI_STATUS  Status;
 
+  if (Private->McqEnabled) {
+    return UfsMcqSubmit (Private, Slot);
+  }
+
   Status = UfsMmioRead32 (Private, UFS_HC_UTRLRSR_OFFSET, &Data);
   if (EFI_ERROR (Status)) {
     return Status;
@@ -783,22 +1032,151 @@ UfsStartExecCmd (
   return EFI_SUCCESS;
 }
 
+/**
+  Clean up the transfer request of the specified slot in MCQ mode.
+
+  The submission queue is stopped and the host controller is asked to clean up
+  the request identified by its LUN and task tag. Once the cleanup completes, the
+  host controller no longer accesses the buffers of the request.
+
+  @param[in]  Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
+  @param[in]  Slot          The slot to be cleaned up.
+  @param[in]  CmdDescHost   The command descriptor of the request.
+
+  @retval EFI_SUCCESS       The request completed or was cleaned up.
+  @retval EFI_TIMEOUT       The host controller did not complete the cleanup in time.
+  @retval Others            The host controller registers could not be accessed.
+
+**/
+EFI_STATUS
+UfsMcqCleanupSlot (
+  IN  UFS_PASS_THRU_PRIVATE_DATA  *Private,
+  IN  UINT8                       Slot,
+  IN  VOID                        *CmdDescHost
+  )
+{
+  UFS_MCQ_QUEUE     *Mcq;
+  UTP_COMMAND_UPIU  *Upiu;
+  EFI_TPL           OldTpl;
+  EFI_STATUS        Status;
+  EFI_STATUS        StartStatus;
+
+  ASSERT (CmdDescHost != NULL);
+
+  Mcq = &Private->Mcq;
+
+  //
+  // Stop the submission queue before working on it.
+  //
+  Status = UfsMmioWrite32 (Private, Mcq->SqOprOffset + UFS_HC_SQRTC_OFFSET, UFS_HC_SQRTC_STOP);
+  if (!EFI_ERROR (Status)) {
+    Status = UfsWaitMemSet (Private, Mcq->SqOprOffset + UFS_HC_SQRTS_OFFSET, UFS_HC_SQRTS_SQSTS, UFS_HC_SQRTS_SQSTS, UFS_TIMEOUT);
+  }
+
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  //
+  // The request may have completed in the meantime.
+  //
+  Status = UfsMcqProcessCompletions (Private);
+  if (EFI_ERROR (Status) || ((Private->McqPending & (BIT0 << Slot)) == 0)) {
+    goto Exit;
+  }
+
+  Upiu   = (UTP_COMMAND_UPIU *)CmdDescHost;
+  Status = UfsMmioWrite32 (
+             Private,
+             Mcq->SqOprOffset + UFS_HC_SQCTI_OFFSET,
+             ((UINT32)Upiu->Lun << UFS_HC_SQCTI_LUN_SHIFT) | Upiu->TaskTag
+             );
+  if (!EFI_ERROR (Status)) {
+    Status = UfsMmioWrite32 (Private, Mcq->SqOprOffset + UFS_HC_SQRTC_OFFSET, UFS_HC_SQRTC_ICU);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = UfsWaitMemSet (Private, Mcq->SqOprOffset + UFS_HC_SQRTS_OFFSET, UFS_HC_SQRTS_CUS, UFS_HC_SQRTS_CUS, UFS_TIMEOUT);
+  }
+
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  //
+  // Consume the completion posted for the request, if any. The request is no
+  // longer pending either way.
+  //
+  Status = UfsMcqProcessCompletions (Private);
+
+  OldTpl               = gBS->RaiseTPL (TPL_NOTIFY);
+  Private->McqPending &= ~(BIT0 << Slot);
+  gBS->RestoreTPL (OldTpl);
+
+Exit:
+  StartStatus = UfsMmioWrite32 (Private, Mcq->SqOprOffset + UFS_HC_SQRTC_OFFSET, UFS_HC_SQRTC_START);
+  if (!EFI_ERROR (StartStatus)) {
+    StartStatus = UfsWaitMemSet (Private, Mcq->SqOprOffset + UFS_HC_SQRTS_OFFSET, UFS_HC_SQRTS_SQSTS, 0, UFS_TIMEOUT);
+  }
+
+  if (EFI_ERROR (StartStatus)) {
+    DEBUG ((DEBUG_ERROR, "UfsMcqCleanupSlot: Failed to restart the submission queue, %r\n", StartStatus));
+  }
+
+  return Status;
+}
+
 /**
   Stop specified slot in transfer list of a UFS device.
 
+  The host controller no longer accesses the buffers of the request when this
+  function succeeds. Otherwise the caller must keep the buffers of the request
+  mapped, as the host controller may still transfer data to or from them.
+
   @param[in]  Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
   @param[in]  Slot          The slot to be stop.
+  @param[in]  CmdDescHost   The command descriptor of the request in the slot.
+
+  @retval EFI_SUCCESS       The slot is stopped.
+  @retval Others            The slot could not be stopped.
 
 **/
 EFI_STATUS
 UfsStopExecCmd (
   IN  UFS_PASS_THRU_PRIVATE_DATA  *Private,
-  IN  UINT8                       Slot
+  IN  UINT8                       Slot,
+  IN  VOID                        *CmdDescHost
   )
 {
   UINT32      Data;
+  EFI_TPL     OldTpl;
   EFI_STATUS  Status;
 
+  if (Private->McqEnabled) {
+    if ((Private->McqPending & (BIT0 << Slot)) == 0) {
+      return EFI_SUCCESS;
+    }
+
+    Status = UfsMcqCleanupSlot (Private, Slot, CmdDescHost);
+    if (EFI_ERROR (Status)) {
+      //
+      // Keep the slot reserved until its completion shows up, see
+      // UfsReleaseSlotInTrl().
+      //
+      OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+      if ((Private->McqPending & (BIT0 << Slot)) != 0) {
+        Private->McqAborted |= BIT0 << Slot;
+        DEBUG ((DEBUG_ERROR, "UfsStopExecCmd: Failed to clean up slot %d, %r\n", Slot, Status));
+      } else {
+        Status = EFI_SUCCESS;
+      }
+
+      gBS->RestoreTPL (OldTpl);
+    }
+
+    return Status;
+  }
+
   Status = UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, &Data);
   if (EFI_ERROR (Status)) {
     return Status;
@@ -814,6 +1192,14 @@ UfsStopExecCmd (
     if (EFI_ERROR (Status)) {
       return Status;
     }
+
+    //
+    // The doorbell bit is cleared when the host controller has stopped the request.
+    //
+    Status = UfsWaitMemSet (Private, UFS_HC_UTRLDBR_OFFSET, BIT0 << Slot, 0, UFS_TIMEOUT);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
   }
 
   return EFI_SUCCESS;
@@ -927,6 +1313,7 @@ UfsSendDmRequestRetry (
   Status = UfsCreateDMCommandDesc (Private, Packet, Trd, &CmdDescHost, &CmdDescMapping);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "Failed to create DM command descriptor\n"));
+    UfsReleaseSlotInTrl (Private, Slot);
     return Status;
   }
 
@@ -943,7 +1330,7 @@ UfsSendDmRequestRetry (
   //
   // Wait for the completion of the transfer request.
   //
-  Status = UfsWaitMemSet (Private, UFS_HC_UTRLDBR_OFFSET, BIT0, 0, Packet->Timeout);
+  Status = UfsWaitTransferComplete (Private, Slot, Packet->Timeout);
   if (EFI_ERROR (Status)) {
     goto Exit;
   }
@@ -973,7 +1360,16 @@ UfsSendDmRequestRetry (
 Exit:
   UfsHc->Flush (UfsHc);
 
-  UfsStopExecCmd (Private, Slot);
+  if (EFI_ERROR (UfsStopExecCmd (Private, Slot, CmdDescHost))) {
+    //
+    // The host controller may still access the command descriptor, leak it
+    // rather than unmap and free it.
+    //
+    CmdDescMapping = NULL;
+    CmdDescHost    = NULL;
+  }
+
+  UfsReleaseSlotInTrl (Private, Slot);
 
   if (CmdDescMapping != NULL) {
     UfsHc->Unmap (UfsHc, CmdDescMapping);
@@ -1278,6 +1674,7 @@ UfsExecNopCmds (
   Trd    = ((UTP_TRD *)Private->UtpTrlBase) + Slot;
   Status = UfsCreateNopCommandDesc (Private, Trd, &CmdDescHost, &CmdDescMapping);
   if (EFI_ERROR (Status)) {
+    UfsReleaseSlotInTrl (Private, Slot);
     return Status;
   }
 
@@ -1297,7 +1694,7 @@ UfsExecNopCmds (
   //
   // Wait for the completion of the transfer request.
   //
-  Status = UfsWaitMemSet (Private, UFS_HC_UTRLDBR_OFFSET, BIT0 << Slot, 0, UFS_TIMEOUT);
+  Status = UfsWaitTransferComplete (Private, Slot, UFS_TIMEOUT);
   if (EFI_ERROR (Status)) {
     goto Exit;
   }
@@ -1311,7 +1708,16 @@ UfsExecNopCmds (
 Exit:
   UfsHc->Flush (UfsHc);
 
-  UfsStopExecCmd (Private, Slot);
+  if (EFI_ERROR (UfsStopExecCmd (Private, Slot, CmdDescHost))) {
+    //
+    // The host controller may still access the command descriptor, leak it
+    // rather than unmap and free it.
+    //
+    CmdDescMapping = NULL;
+    CmdDescHost    = NULL;
+  }
+
+  UfsReleaseSlotInTrl (Private, Slot);
 
   if (CmdDescMapping != NULL) {
     UfsHc->Unmap (UfsHc, CmdDescMapping);
@@ -1522,6 +1928,7 @@ UfsExecScsiCmds (
   //
   Status = UfsFindAvailableSlotInTrl (Private, &TransReq->Slot);
   if (EFI_ERROR (Status)) {
+    FreePool (TransReq);
     return Status;
   }
 
@@ -1539,7 +1946,7 @@ UfsExecScsiCmds (
              &TransReq->CmdDescMapping
              );
   if (EFI_ERROR (Status)) {
-    return Status;
+    goto Exit1;
   }
 
   TransReq->CmdDescSize = TransReq->Trd->PrdtO * sizeof (UINT32) + TransReq->Trd->PrdtL * sizeof (UTP_TR_PRD);
@@ -1550,13 +1957,21 @@ UfsExecScsiCmds (
   }
 
   //
-  // Insert the async SCSI cmd to the Async I/O list
+  // Insert the async SCSI cmd to the Async I/O list and start it. Both are done
+  // at TPL_NOTIFY, otherwise ProcessAsyncTaskList() could find the request in the
+  // list before its doorbell is rung and take it for a completed one.
   //
   if (Event != NULL) {
     OldTpl                = gBS->RaiseTPL (TPL_NOTIFY);
     TransReq->CallerEvent = Event;
     InsertTailList (&Private->Queue, &TransReq->TransferList);
+    UfsStartExecCmd (Private, TransReq->Slot);
     gBS->RestoreTPL (OldTpl);
+
+    //
+    // Immediately return for async I/O.
+    //
+    return EFI_SUCCESS;
   }
 
   //
@@ -1564,17 +1979,10 @@ UfsExecScsiCmds (
   //
   UfsStartExecCmd (Private, TransReq->Slot);
 
-  //
-  // Immediately return for async I/O.
-  //
-  if (Event != NULL) {
-    return EFI_SUCCESS;
-  }
-
   //
   // Wait for the completion of the transfer request.
   //
-  Status = UfsWaitMemSet (Private, UFS_HC_UTRLDBR_OFFSET, BIT0 << TransReq->Slot, 0, Packet->Timeout);
+  Status = UfsWaitTransferComplete (Private, TransReq->Slot, Packet->Timeout);
   if (EFI_ERROR (Status)) {
     goto Exit;
   }
@@ -1630,11 +2038,20 @@ UfsExecScsiCmds (
 Exit:
   UfsHc->Flush (UfsHc);
 
-  UfsStopExecCmd (Private, TransReq->Slot);
-
-  UfsReconcileDataTransferBuffer (Private, TransReq);
+  if (EFI_ERROR (UfsStopExecCmd (Private, TransReq->Slot, TransReq->CmdDescHost))) {
+    //
+    // The host controller may still access the buffers of the request, leak
+    // them rather than unmap and free them.
+    //
+    TransReq->CmdDescMapping = NULL;
+    TransReq->CmdDescHost    = NULL;
+  } else {
+    UfsReconcileDataTransferBuffer (Private, TransReq);
+  }
 
 Exit1:
+  UfsReleaseSlotInTrl (Private, TransReq->Slot);
+
   if (TransReq->CmdDescMapping != NULL) {
     UfsHc->Unmap (UfsHc, TransReq->CmdDescMapping);
   }
@@ -2227,6 +2644,203 @@ UfsControllerStop (
   return EFI_SUCCESS;
 }
 
+/**
+  Switch the UFS host controller to Multi-Circular Queue mode.
+
+  The device is initialized in legacy single doorbell mode. Once that is done,
+  one submission/completion queue pair is created and the host controller is
+  switched to MCQ mode. The caller can keep using legacy mode if this fails.
+
+  @param[in] Private                 The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
+
+  @retval EFI_SUCCESS                The Ufs Host Controller is switched to MCQ mode successfully.
+  @retval EFI_UNSUPPORTED            MCQ mode is disabled or not supported by the Ufs Host Controller.
+  @retval Others                     A device error occurred while configuring the queues.
+
+**/
+EFI_STATUS
+UfsMcqInit (
+  IN  UFS_PASS_THRU_PRIVATE_DATA  *Private
+  )
+{
+  UFS_MCQ_QUEUE         *Mcq;
+  VOID                  *Buffer;
+  EFI_PHYSICAL_ADDRESS  SqPhyAddr;
+  EFI_PHYSICAL_ADDRESS  CqPhyAddr;
+  UINT32                Data;
+  EFI_STATUS            Status;
+
+  if (!PcdGetBool (PcdUfsMcqEnable) ||
+      ((Private->UfsHcInfo.Capabilities & UFS_HC_CAP_MCQS) != UFS_HC_CAP_MCQS))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  Mcq = &Private->Mcq;
+
+  Status = UfsMmioRead32 (Private, UFS_HC_MCQCAP_OFFSET, &Data);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Mcq->QcfgOffset = ((Data & UFS_HC_MCQCAP_QCFGPTR) >> 16) * UFS_HC_MCQCAP_QCFGPTR_UNIT;
+  if (Mcq->QcfgOffset == 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Allocate the submission and completion queue of queue 0.
+  //
+  Status = UfsAllocateAlignCommonBuffer (Private, UFS_MCQ_QUEUE_DEPTH * sizeof (UTP_TRD), &Buffer, &SqPhyAddr, &Mcq->SqMapping);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Mcq->SqBase = Buffer;
+
+  Status = UfsAllocateAlignCommonBuffer (Private, UFS_MCQ_QUEUE_DEPTH * sizeof (UTP_CQE), &Buffer, &CqPhyAddr, &Mcq->CqMapping);
+  if (EFI_ERROR (Status)) {
+    goto Error;
+  }
+
+  Mcq->CqBase = Buffer;
+
+  //
+  // Program the queue base addresses and get the offsets of the queue doorbells.
+  //
+  Status = UfsMmioWrite32 (Private, Mcq->QcfgOffset + UFS_HC_SQLBA_OFFSET, (UINT32)(UINTN)SqPhyAddr);
+  if (EFI_ERROR (Status)) {
+    goto Error;
+  }
+
+  Status = UfsMmioWrite32 (Private, Mcq->QcfgOffset + UFS_HC_SQUBA_OFFSET, (UINT32)RShiftU64 ((UINT64)SqPhyAddr, 32));
+  if (EFI_ERROR (Status)) {
+    goto Error;
+  }
+
+  Status = UfsMmioWrite32 (Private, Mcq->QcfgOffset + UFS_HC_CQLBA_OFFSET, (UINT32)(UINTN)CqPhyAddr);
+  if (EFI_ERROR (Status)) {
+    goto Error;
+  }
+
+  Status = UfsMmioWrite32 (Private, Mcq->QcfgOffset + UFS_HC_CQUBA_OFFSET, (UINT32)RShiftU64 ((UINT64)CqPhyAddr, 32));
+  if (EFI_ERROR (Status)) {
+    goto Error;
+  }
+
+  Status = UfsMmioRead32 (Private, Mcq->QcfgOffset + UFS_HC_SQDAO_OFFSET, &Data);
+  if (EFI_ERROR (Status)) {
+    goto Error;
+  }
+
+  Mcq->SqOprOffset = Data;
+
+  Status = UfsMmioRead32 (Private, Mcq->QcfgOffset + UFS_HC_CQDAO_OFFSET, &Data);
+  if (EFI_ERROR (Status)) {
+    goto Error;
+  }
+
+  Mcq->CqOprOffset = Data;
+  if ((Mcq->SqOprOffset == 0) || (Mcq->CqOprOffset == 0)) {
+    Status = EFI_UNSUPPORTED;
+    goto Error;
+  }
+
+  //
+  // Enable the completion queue first, then the submission queue bound to it.
+  // The queue size is given in dwords, minus 1.
+  //
+  Data   = UFS_HC_QATTR_EN | ((UFS_MCQ_QUEUE_DEPTH * sizeof (UTP_CQE) / sizeof (UINT32) - 1) & UFS_HC_QATTR_SIZE);
+  Status = UfsMmioWrite32 (Private, Mcq->QcfgOffset + UFS_HC_CQATTR_OFFSET, Data);
+  if (EFI_ERROR (Status)) {
+    goto Error;
+  }
+
+  Data   = UFS_HC_QATTR_EN | (0 << UFS_HC_SQATTR_CQID_SHIFT) | ((UFS_MCQ_QUEUE_DEPTH * sizeof (UTP_TRD) / sizeof (UINT32) - 1) & UFS_HC_QATTR_SIZE);
+  Status = UfsMmioWrite32 (Private, Mcq->QcfgOffset + UFS_HC_SQATTR_OFFSET, Data);
+  if (EFI_ERROR (Status)) {
+    goto Error;
+  }
+
+  //
+  // Allow as many active commands as there are transfer request slots, then
+  // select MCQ as the queue type.
+  //
+  Status = UfsMmioRead32 (Private, UFS_HC_MCQCONFIG_OFFSET, &Data);
+  if (EFI_ERROR (Status)) {
+    goto Error;
+  }
+
+  Data   = (Data & ~UFS_HC_MCQCONFIG_MAC) | (((UINT32)(Private->Nutrs - 1) << 8) & UFS_HC_MCQCONFIG_MAC);
+  Status = UfsMmioWrite32 (Private, UFS_HC_MCQCONFIG_OFFSET, Data);
+  if (EFI_ERROR (Status)) {
+    goto Error;
+  }
+
+  Status = UfsMmioRead32 (Private, UFS_HC_CONFIG_OFFSET, &Data);
+  if (EFI_ERROR (Status)) {
+    goto Error;
+  }
+
+  Status = UfsMmioWrite32 (Private, UFS_HC_CONFIG_OFFSET, Data | UFS_HC_CONFIG_QT);
+  if (EFI_ERROR (Status)) {
+    goto Error;
+  }
+
+  Mcq->SqTail         = 0;
+  Mcq->CqHead         = 0;
+  Private->McqEnabled = TRUE;
+
+  DEBUG ((DEBUG_INFO, "UfsMcqInit: MCQ mode enabled, queue depth %d\n", UFS_MCQ_QUEUE_DEPTH));
+  return EFI_SUCCESS;
+
+Error:
+  UfsMmioWrite32 (Private, Mcq->QcfgOffset + UFS_HC_SQATTR_OFFSET, 0);
+  UfsMmioWrite32 (Private, Mcq->QcfgOffset + UFS_HC_CQATTR_OFFSET, 0);
+  UfsMcqFree (Private);
+  return Status;
+}
+
+/**
+  Free the submission and completion queue used in MCQ mode.
+
+  @param[in] Private                 The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
+
+**/
+VOID
+UfsMcqFree (
+  IN  UFS_PASS_THRU_PRIVATE_DATA  *Private
+  )
+{
+  EDKII_UFS_HOST_CONTROLLER_PROTOCOL  *UfsHc;
+  UFS_MCQ_QUEUE                       *Mcq;
+
+  UfsHc = Private->UfsHostController;
+  Mcq   = &Private->Mcq;
+
+  if (Mcq->SqMapping != NULL) {
+    UfsHc->Unmap (UfsHc, Mcq->SqMapping);
+    Mcq->SqMapping = NULL;
+  }
+
+  if (Mcq->SqBase != NULL) {
+    UfsHc->FreeBuffer (UfsHc, EFI_SIZE_TO_PAGES (UFS_MCQ_QUEUE_DEPTH * sizeof (UTP_TRD)), Mcq->SqBase);
+    Mcq->SqBase = NULL;
+  }
+
+  if (Mcq->CqMapping != NULL) {
+    UfsHc->Unmap (UfsHc, Mcq->CqMapping);
+    Mcq->CqMapping = NULL;
+  }
+
+  if (Mcq->CqBase != NULL) {
+    UfsHc->FreeBuffer (UfsHc, EFI_SIZE_TO_PAGES (UFS_MCQ_QUEUE_DEPTH * sizeof (UTP_CQE)), Mcq->CqBase);
+    Mcq->CqBase = NULL;
+  }
+
+  Private->McqEnabled = FALSE;
+}
+
 /**
   Internal helper function which will signal the caller event and clean up
   resources.
@@ -2256,9 +2870,18 @@ SignalCallerEvent (
 
   UfsHc->Flush (UfsHc);
 
-  UfsStopExecCmd (Private, TransReq->Slot);
+  if (EFI_ERROR (UfsStopExecCmd (Private, TransReq->Slot, TransReq->CmdDescHost))) {
+    //
+    // The host controller may still access the buffers of the request, leak
+    // them rather than unmap and free them.
+    //
+    TransReq->CmdDescMapping = NULL;
+    TransReq->CmdDescHost    = NULL;
+  } else {
+    UfsReconcileDataTransferBuffer (Private, TransReq);
+  }
 
-  UfsReconcileDataTransferBuffer (Private, TransReq);
+  UfsReleaseSlotInTrl (Private, TransReq->Slot);
 
   if (TransReq->CmdDescMapping != NULL) {
     UfsHc->Unmap (UfsHc, TransReq->CmdDescMapping);
@@ -2300,35 +2923,29 @@ ProcessAsyncTaskList (
   UTP_RESPONSE_UPIU                           *Response;
   UINT16                                      SenseDataLen;
   UINT32                                      ResTranCount;
-  UINT32                                      SlotsMap;
   UINT32                                      Value;
   EFI_STATUS                                  Status;
 
-  Private  = (UFS_PASS_THRU_PRIVATE_DATA *)Context;
-  SlotsMap = 0;
+  Private = (UFS_PASS_THRU_PRIVATE_DATA *)Context;
 
   //
-  // Check the entries in the async I/O queue are done or not.
+  // Check the entries in the async I/O queue are done or not. Every request owns
+  // its slot, so the doorbell only needs to be sampled once for all of them.
   //
   if (!IsListEmpty (&Private->Queue)) {
+    Status = UfsReadTransferDoorbell (Private, &Value);
+
     BASE_LIST_FOR_EACH_SAFE (Entry, NextEntry, &Private->Queue) {
       TransReq = UFS_PASS_THRU_TRANS_REQ_FROM_THIS (Entry);
       Packet   = TransReq->Packet;
 
-      if ((SlotsMap & (BIT0 << TransReq->Slot)) != 0) {
-        return;
-      }
-
-      SlotsMap |= BIT0 << TransReq->Slot;
-
-      Status = UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, &Value);
       if (EFI_ERROR (Status)) {
         //
         // TODO: Should find/add a proper host adapter return status for this
         // case.
         //
         Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_PHASE_ERROR;
-        DEBUG ((DEBUG_VERBOSE, "ProcessAsyncTaskList(): Signal Event %p UfsMmioRead32() Error.\n", TransReq->CallerEvent));
+        DEBUG ((DEBUG_VERBOSE, "ProcessAsyncTaskList(): Signal Event %p UfsReadTransferDoorbell() Error.\n", TransReq->CallerEvent));
         SignalCallerEvent (Private, TransReq);
         continue;
       }
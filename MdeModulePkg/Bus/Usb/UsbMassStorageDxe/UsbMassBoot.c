@@ -605,6 +605,39 @@ UsbScsiModeSense (
   return Status;
 }
 
+/**
+  Get the maximum number of bytes carried by one READ/WRITE command.
+
+  Only the Bulk-Only transport is given a larger limit, and only when both of
+  its bulk endpoints run at SuperSpeed. All other devices keep the conservative
+  64KB limit that has been in use for USB 1.1/2.0 devices.
+
+  @param  UsbMass                The USB mass storage device.
+
+  @return The maximum number of bytes carried by one READ/WRITE command.
+
+**/
+UINT32
+UsbBootGetMaxCarrySize (
+  IN USB_MASS_DEVICE  *UsbMass
+  )
+{
+  USB_BOT_PROTOCOL  *UsbBot;
+
+  if (UsbMass->Transport->Protocol != USB_MASS_STORE_BOT) {
+    return USB_BOOT_MAX_CARRY_SIZE;
+  }
+
+  UsbBot = (USB_BOT_PROTOCOL *)UsbMass->Context;
+  if ((UsbBot->BulkInEndpoint->MaxPacketSize >= USB_BOOT_SUPER_SPEED_BULK_PACKET_SIZE) &&
+      (UsbBot->BulkOutEndpoint->MaxPacketSize >= USB_BOOT_SUPER_SPEED_BULK_PACKET_SIZE))
+  {
+    return USB_BOOT_MAX_CARRY_SIZE_SUPER_SPEED;
+  }
+
+  return USB_BOOT_MAX_CARRY_SIZE;
+}
+
 /**
   Get the parameters for the USB mass storage media.
 
@@ -630,6 +663,8 @@ UsbBootGetParams (
 
   Media = &(UsbMass->BlockIoMedia);
 
+  UsbMass->MaxCarrySize = UsbBootGetMaxCarrySize (UsbMass);
+
   Status = UsbBootInquiry (UsbMass);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "UsbBootGetParams: UsbBootInquiry (%r)\n", Status));
@@ -824,7 +859,7 @@ UsbBootReadWriteBlocks (
   UINT32                      Timeout;
 
   BlockSize = UsbMass->BlockIoMedia.BlockSize;
-  CountMax  = USB_BOOT_MAX_CARRY_SIZE / BlockSize;
+  CountMax  = UsbMass->MaxCarrySize / BlockSize;
   Status    = EFI_SUCCESS;
 
   while (TotalBlock > 0) {
@@ -910,7 +945,7 @@ UsbBootReadWriteBlocks16 (
   UINT32      Timeout;
 
   BlockSize = UsbMass->BlockIoMedia.BlockSize;
-  CountMax  = USB_BOOT_MAX_CARRY_SIZE / BlockSize;
+  CountMax  = UsbMass->MaxCarrySize / BlockSize;
   Status    = EFI_SUCCESS;
 
   while (TotalBlock > 0) {
@@ -62,6 +62,14 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 #define USB_BOOT_MAX_CARRY_SIZE  SIZE_64KB
 
+//
+// SuperSpeed bulk endpoints report a max packet size of 1024 bytes. Such devices
+// sustain much larger transfers per command, so carry up to 1MB per READ/WRITE
+// to amortize the CBW/CSW round trips of the Bulk-Only transport.
+//
+#define USB_BOOT_SUPER_SPEED_BULK_PACKET_SIZE  1024
+#define USB_BOOT_MAX_CARRY_SIZE_SUPER_SPEED    SIZE_1MB
+
 //
 // Retry mass command times, set by experience
 //
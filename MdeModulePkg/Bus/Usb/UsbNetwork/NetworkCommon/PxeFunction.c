@@ -1558,6 +1558,14 @@ Receive (
     return PXE_STATCODE_NO_DATA;
   }
 
+  //
+  // Receive straight into the caller's buffer when it can hold a full segment,
+  // which saves copying every frame through the bounce buffer.
+  //
+  if ((Cpb->BufferAddr != 0) && (Cpb->BufferLen >= DataLength)) {
+    BulkInData = (UINT8 *)(UINTN)Cpb->BufferAddr;
+  }
+
   Status = Nic->UsbEth->UsbEthReceive (Cdb, Nic->UsbEth, (VOID *)BulkInData, &DataLength);
   if (EFI_ERROR (Status)) {
     Nic->ReceiveStatus = 0;
@@ -1580,7 +1588,9 @@ Receive (
       DataLength = (UINTN)Cpb->BufferLen;
     }
 
-    CopyMem ((UINT8 *)(UINTN)Cpb->BufferAddr, (UINT8 *)BulkInData, DataLength);
+    if (BulkInData != (UINT8 *)(UINTN)Cpb->BufferAddr) {
+      CopyMem ((UINT8 *)(UINTN)Cpb->BufferAddr, (UINT8 *)BulkInData, DataLength);
+    }
 
     Header = (ETHERNET_HEADER *)BulkInData;
 
@@ -391,6 +391,11 @@ UsbNcmDriverStart (
   UsbEthDriver->UsbEth.GetUsbEthStatistic          = GetUsbEthStatistic;
 
   UsbEthDriver->BulkBuffer = AllocateZeroPool (USB_NCM_MAX_NTB_SIZE);
+  UsbEthDriver->TxBuffer   = AllocateZeroPool (USB_NCM_MAX_NTB_SIZE);
+  if ((UsbEthDriver->BulkBuffer == NULL) || (UsbEthDriver->TxBuffer == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ErrorExit;
+  }
 
   Status = gBS->InstallProtocolInterface (
                   &ControllerHandle,
@@ -399,17 +404,32 @@ UsbNcmDriverStart (
                   &(UsbEthDriver->UsbEth)
                   );
   if (EFI_ERROR (Status)) {
-    gBS->CloseProtocol (
-           ControllerHandle,
-           &gEfiUsbIoProtocolGuid,
-           This->DriverBindingHandle,
-           ControllerHandle
-           );
-    FreePool (UsbEthDriver);
-    return Status;
+    goto ErrorExit;
   }
 
   return Status;
+
+ErrorExit:
+  gBS->CloseProtocol (
+         ControllerHandle,
+         &gEfiUsbIoProtocolGuid,
+         This->DriverBindingHandle,
+         ControllerHandle
+         );
+  if (UsbEthDriver->Config != NULL) {
+    FreePool (UsbEthDriver->Config);
+  }
+
+  if (UsbEthDriver->BulkBuffer != NULL) {
+    FreePool (UsbEthDriver->BulkBuffer);
+  }
+
+  if (UsbEthDriver->TxBuffer != NULL) {
+    FreePool (UsbEthDriver->TxBuffer);
+  }
+
+  FreePool (UsbEthDriver);
+  return Status;
 }
 
 /**
@@ -469,6 +489,7 @@ UsbNcmDriverStop (
                   );
   FreePool (UsbEthDriver->Config);
   FreePool (UsbEthDriver->BulkBuffer);
+  FreePool (UsbEthDriver->TxBuffer);
   FreePool (UsbEthDriver);
   return Status;
 }
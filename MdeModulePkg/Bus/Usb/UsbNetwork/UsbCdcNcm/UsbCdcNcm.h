@@ -31,8 +31,10 @@ typedef struct {
   EFI_MAC_ADDRESS                MacAddress;
   UINT16                         BulkOutSequence;
   UINT8                          *BulkBuffer;
-  UINT8                          TotalDatagram;
-  UINT8                          NowDatagram;
+  UINTN                          BulkLength;
+  UINT16                         NdpIndex;
+  UINT16                         NowDatagram;
+  UINT8                          *TxBuffer;
 } USB_ETHERNET_DRIVER;
 
 #define USB_NCM_DRIVER_VERSION         1
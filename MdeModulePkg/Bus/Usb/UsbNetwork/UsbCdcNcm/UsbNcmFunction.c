@@ -196,9 +196,86 @@ GetEndpoint (
   }
 }
 
+/**
+  Fetch the next datagram from the NTB held in the bulk-in buffer.
+
+  The NDPs of the NTB are walked in chain order and each datagram pointer entry
+  up to the null terminator is returned in turn, so every datagram aggregated
+  into one bulk transfer is handed up as a frame of its own. All offsets come
+  from the device and are checked against the received NTB length.
+
+  @param[in, out] UsbEthDriver    A pointer to the USB_ETHERNET_DRIVER instance.
+  @param[out]     DatagramIndex   Offset of the datagram in the bulk-in buffer.
+  @param[out]     DatagramLength  Length of the datagram.
+
+  @retval EFI_SUCCESS             A datagram has been returned.
+  @retval EFI_NOT_FOUND           The NTB holds no further datagram.
+
+**/
+STATIC
+EFI_STATUS
+NcmNextDatagram (
+  IN OUT USB_ETHERNET_DRIVER  *UsbEthDriver,
+  OUT    UINT16               *DatagramIndex,
+  OUT    UINT16               *DatagramLength
+  )
+{
+  USB_NCM_DATAGRAM_POINTER_16  *Ndp;
+  USB_NCM_DATA_GRAM            *Datagram;
+  UINTN                        EntryOffset;
+
+  while (UsbEthDriver->NdpIndex != 0) {
+    if (((UsbEthDriver->NdpIndex & 0x3) != 0) ||
+        ((UINTN)UsbEthDriver->NdpIndex + sizeof (USB_NCM_DATAGRAM_POINTER_16) > UsbEthDriver->BulkLength))
+    {
+      break;
+    }
+
+    Ndp = (USB_NCM_DATAGRAM_POINTER_16 *)(UsbEthDriver->BulkBuffer + UsbEthDriver->NdpIndex);
+    if (((Ndp->Signature != USB_NCM_NDP_SIGN_16) && (Ndp->Signature != USB_NCM_NDP_SIGN_16_CRC)) ||
+        ((UINTN)UsbEthDriver->NdpIndex + Ndp->Length > UsbEthDriver->BulkLength))
+    {
+      break;
+    }
+
+    EntryOffset = sizeof (USB_NCM_DATAGRAM_POINTER_16) + UsbEthDriver->NowDatagram * sizeof (USB_NCM_DATA_GRAM);
+    if (EntryOffset + sizeof (USB_NCM_DATA_GRAM) <= Ndp->Length) {
+      Datagram = (USB_NCM_DATA_GRAM *)((UINT8 *)Ndp + EntryOffset);
+      if ((Datagram->DatagramIndex != 0) && (Datagram->DatagramLength != 0)) {
+        UsbEthDriver->NowDatagram++;
+        if ((UINTN)Datagram->DatagramIndex + Datagram->DatagramLength > UsbEthDriver->BulkLength) {
+          continue;
+        }
+
+        *DatagramIndex  = Datagram->DatagramIndex;
+        *DatagramLength = Datagram->DatagramLength;
+        return EFI_SUCCESS;
+      }
+    }
+
+    //
+    // This NDP is exhausted. Only follow forward links so that a malformed
+    // chain cannot keep us looping.
+    //
+    if (Ndp->NextNdpIndex <= UsbEthDriver->NdpIndex) {
+      break;
+    }
+
+    UsbEthDriver->NdpIndex    = Ndp->NextNdpIndex;
+    UsbEthDriver->NowDatagram = 0;
+  }
+
+  UsbEthDriver->NdpIndex    = 0;
+  UsbEthDriver->NowDatagram = 0;
+  return EFI_NOT_FOUND;
+}
+
 /**
   This function is used to manage a USB device with the bulk transfer pipe. The endpoint is Bulk in.
 
+  A new bulk-in transfer is only issued once every datagram of the previously
+  received NTB has been returned.
+
   @param[in]      Cdb           A pointer to the command descriptor block.
   @param[in]      This          A pointer to the EDKII_USB_ETHERNET_PROTOCOL instance.
   @param[in, out] Packet        A pointer to the buffer of data that will be transmitted to USB
@@ -210,6 +287,7 @@ GetEndpoint (
   @retval EFI_INVALID_PARAMETER One or more parameters are invalid.
   @retval EFI_OUT_OF_RESOURCES  The request could not be submitted due to a lack of resources.
   @retval EFI_TIMEOUT           The control transfer fails due to timeout.
+  @retval EFI_NOT_FOUND         The received NTB did not carry any datagram.
 
 **/
 EFI_STATUS
@@ -221,21 +299,19 @@ UsbEthNcmReceive (
   IN OUT UINTN                        *PacketLength
   )
 {
-  EFI_STATUS                   Status;
-  USB_ETHERNET_DRIVER          *UsbEthDriver;
-  EFI_USB_IO_PROTOCOL          *UsbIo;
-  UINT32                       TransStatus;
-  UINT8                        Index;
-  UINTN                        BulkDataLength;
-  UINTN                        TotalLength;
-  USB_NCM_TRANSFER_HEADER_16   *Nth;
-  USB_NCM_DATAGRAM_POINTER_16  *Ndp;
-  USB_NCM_DATA_GRAM            *Datagram;
+  EFI_STATUS                  Status;
+  USB_ETHERNET_DRIVER         *UsbEthDriver;
+  EFI_USB_IO_PROTOCOL         *UsbIo;
+  UINT32                      TransStatus;
+  UINTN                       BulkDataLength;
+  USB_NCM_TRANSFER_HEADER_16  *Nth;
+  UINT16                      DatagramIndex;
+  UINT16                      DatagramLength;
 
   UsbEthDriver = USB_ETHERNET_DEV_FROM_THIS (This);
-  TotalLength  = 0;
 
-  if (UsbEthDriver->TotalDatagram == UsbEthDriver->NowDatagram) {
+  Status = NcmNextDatagram (UsbEthDriver, &DatagramIndex, &DatagramLength);
+  if (EFI_ERROR (Status)) {
     Status = gBS->HandleProtocol (
                     UsbEthDriver->UsbCdcDataHandle,
                     &gEfiUsbIoProtocolGuid,
@@ -250,9 +326,6 @@ UsbEthNcmReceive (
     }
 
     BulkDataLength = USB_NCM_MAX_NTB_SIZE;
-    SetMem (UsbEthDriver->BulkBuffer, BulkDataLength, 0);
-    UsbEthDriver->NowDatagram   = 0;
-    UsbEthDriver->TotalDatagram = 0;
 
     Status = UsbIo->UsbBulkTransfer (
                       UsbIo,
@@ -266,55 +339,44 @@ UsbEthNcmReceive (
       return Status;
     }
 
-    Nth                         = (USB_NCM_TRANSFER_HEADER_16 *)UsbEthDriver->BulkBuffer;
-    Ndp                         = (USB_NCM_DATAGRAM_POINTER_16 *)((UINT8 *)UsbEthDriver->BulkBuffer + Nth->NdpIndex);
-    Datagram                    = (USB_NCM_DATA_GRAM *)((UINT8 *)Ndp + sizeof (USB_NCM_DATAGRAM_POINTER_16));
-    UsbEthDriver->TotalDatagram = (UINT8)((Ndp->Length - 8) / 4 - 1);
-
-    for (Index = 0; Index < UsbEthDriver->TotalDatagram; Index++) {
-      TotalLength += Datagram->DatagramLength;
-      Datagram     = (USB_NCM_DATA_GRAM *)((UINT8 *)Datagram + sizeof (USB_NCM_DATA_GRAM));
+    Nth = (USB_NCM_TRANSFER_HEADER_16 *)UsbEthDriver->BulkBuffer;
+    if ((BulkDataLength < sizeof (USB_NCM_TRANSFER_HEADER_16)) ||
+        (Nth->Signature != USB_NCM_NTH_SIGN_16) ||
+        (Nth->HeaderLength != USB_NCM_NTH_LENGTH))
+    {
+      return EFI_DEVICE_ERROR;
     }
 
-    if (TotalLength < USB_ETHERNET_FRAME_SIZE) {
-      Datagram = (USB_NCM_DATA_GRAM *)((UINT8 *)Ndp + sizeof (USB_NCM_DATAGRAM_POINTER_16));
-
-      TotalLength = 0;
-      for (Index = 0; Index < UsbEthDriver->TotalDatagram; Index++) {
-        CopyMem ((UINT8 *)Packet + TotalLength, (UINT8 *)UsbEthDriver->BulkBuffer + Datagram->DatagramIndex, Datagram->DatagramLength);
-        TotalLength += Datagram->DatagramLength;
-        Datagram     = (USB_NCM_DATA_GRAM *)((UINT8 *)Datagram + sizeof (USB_NCM_DATA_GRAM));
-      }
+    if ((Nth->BlockLength != 0) && (Nth->BlockLength < BulkDataLength)) {
+      BulkDataLength = Nth->BlockLength;
+    }
 
-      *PacketLength             = TotalLength;
-      UsbEthDriver->NowDatagram = UsbEthDriver->TotalDatagram;
-    } else {
-      UsbEthDriver->NowDatagram++;
+    UsbEthDriver->BulkLength  = BulkDataLength;
+    UsbEthDriver->NdpIndex    = Nth->NdpIndex;
+    UsbEthDriver->NowDatagram = 0;
 
-      Datagram = (USB_NCM_DATA_GRAM *)((UINT8 *)Ndp + sizeof (USB_NCM_DATAGRAM_POINTER_16));
-      CopyMem (Packet, (UINT8 *)UsbEthDriver->BulkBuffer + Datagram->DatagramIndex, Datagram->DatagramLength);
-      *PacketLength = Datagram->DatagramLength;
+    Status = NcmNextDatagram (UsbEthDriver, &DatagramIndex, &DatagramLength);
+    if (EFI_ERROR (Status)) {
+      return Status;
     }
+  }
 
-    return Status;
-  } else {
-    UsbEthDriver->NowDatagram++;
-
-    Nth      = (USB_NCM_TRANSFER_HEADER_16 *)UsbEthDriver->BulkBuffer;
-    Ndp      = (USB_NCM_DATAGRAM_POINTER_16 *)((UINT8 *)UsbEthDriver->BulkBuffer + Nth->NdpIndex);
-    Datagram = (USB_NCM_DATA_GRAM *)((UINT8 *)Ndp + sizeof (USB_NCM_DATAGRAM_POINTER_16));
-    Datagram = (USB_NCM_DATA_GRAM *)((UINT8 *)Datagram + sizeof (USB_NCM_DATA_GRAM) * (UsbEthDriver->NowDatagram - 1));
+  if (DatagramLength > *PacketLength) {
+    DatagramLength = (UINT16)*PacketLength;
+  }
 
-    CopyMem (Packet, (UINT8 *)UsbEthDriver->BulkBuffer + Datagram->DatagramIndex, Datagram->DatagramLength);
-    *PacketLength = Datagram->DatagramLength;
+  CopyMem (Packet, UsbEthDriver->BulkBuffer + DatagramIndex, DatagramLength);
+  *PacketLength = DatagramLength;
 
-    return EFI_SUCCESS;
-  }
+  return EFI_SUCCESS;
 }
 
 /**
   This function is used to manage a USB device with the bulk transfer pipe. The endpoint is Bulk out.
 
+  The NTB is built in the transmit buffer preallocated at driver start, so no
+  pool allocation is made per frame.
+
   @param[in]      Cdb           A pointer to the command descriptor block.
   @param[in]      This          A pointer to the EDKII_USB_ETHERNET_PROTOCOL instance.
   @param[in]      Packet        A pointer to the buffer of data that will be transmitted to USB
@@ -363,13 +425,12 @@ UsbEthNcmTransmit (
   }
 
   TotalLength = (UINTN)(USB_NCM_NTH_LENGTH + USB_NCM_NDP_LENGTH + (*PacketLength));
-
-  Status = gBS->AllocatePool (EfiBootServicesData, TotalLength, (VOID **)&TotalPacket);
-  if (EFI_ERROR (Status)) {
-    return Status;
+  if (TotalLength > USB_NCM_MAX_NTB_SIZE) {
+    return EFI_INVALID_PARAMETER;
   }
 
-  SetMem (TotalPacket, TotalLength, 0);
+  TotalPacket = UsbEthDriver->TxBuffer;
+  SetMem (TotalPacket, USB_NCM_NTH_LENGTH + USB_NCM_NDP_LENGTH, 0);
 
   Nth               = (USB_NCM_TRANSFER_HEADER_16 *)TotalPacket;
   Nth->Signature    = USB_NCM_NTH_SIGN_16;
@@ -399,7 +460,6 @@ UsbEthNcmTransmit (
                     USB_ETHERNET_BULK_TIMEOUT,
                     &TransStatus
                     );
-  FreePool (TotalPacket);
   return Status;
 }
 
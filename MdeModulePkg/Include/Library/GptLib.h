@@ -57,6 +57,35 @@ PartitionValidGptTable (
   OUT EFI_PARTITION_TABLE_HEADER  *PartHeader
   );
 
+/**
+  Read GPT partition table header from the given LBA and validate it, and
+  return the partition entry array whose CRC was verified.
+
+  Caution: This function may receive untrusted input.
+  The GPT partition table header is external input, so this routine
+  will do basic validation for GPT partition table header before return.
+
+  @param[in]  BlockIo     Parent BlockIo interface.
+  @param[in]  DiskIo      Disk Io protocol.
+  @param[in]  Lba         The starting Lba of the Partition Table.
+  @param[out] PartHeader  Stores the partition table that is read.
+  @param[out] PartEntry   Optional; on success receives a pool buffer holding
+                          the partition entry array. The caller frees it.
+                          Set to NULL on failure.
+
+  @retval TRUE      The partition table is valid.
+  @retval FALSE     The partition table is not valid.
+
+**/
+BOOLEAN
+PartitionValidGptTableEx (
+  IN  EFI_BLOCK_IO_PROTOCOL       *BlockIo,
+  IN  EFI_DISK_IO_PROTOCOL        *DiskIo,
+  IN  EFI_LBA                     Lba,
+  OUT EFI_PARTITION_TABLE_HEADER  *PartHeader,
+  OUT EFI_PARTITION_ENTRY         **PartEntry  OPTIONAL
+  );
+
 /**
   Restore Partition Table to its alternate place
   (Primary -> Backup or Backup -> Primary).
@@ -45,6 +45,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
   @param[in]  BlockIo     Parent BlockIo interface
   @param[in]  DiskIo      Disk Io Protocol.
   @param[in]  PartHeader  Partition table header structure
+  @param[out] PartEntry   Optional; receives the entry array the CRC was
+                          computed over when the CRC is valid.
 
   @retval TRUE      the CRC is valid
   @retval FALSE     the CRC is invalid
@@ -55,7 +57,8 @@ BOOLEAN
 PartitionCheckGptEntryArrayCRC (
   IN  EFI_BLOCK_IO_PROTOCOL       *BlockIo,
   IN  EFI_DISK_IO_PROTOCOL        *DiskIo,
-  IN  EFI_PARTITION_TABLE_HEADER  *PartHeader
+  IN  EFI_PARTITION_TABLE_HEADER  *PartHeader,
+  OUT EFI_PARTITION_ENTRY         **PartEntry  OPTIONAL
   );
 
 /**
@@ -143,12 +146,52 @@ PartitionValidGptTable (
   IN  EFI_LBA                     Lba,
   OUT EFI_PARTITION_TABLE_HEADER  *PartHeader
   )
+{
+  return PartitionValidGptTableEx (BlockIo, DiskIo, Lba, PartHeader, NULL);
+}
+
+/**
+  This routine will read GPT partition table header and return it, along with
+  the partition entry array whose CRC was verified against the header.
+
+  Caution: This function may receive untrusted input.
+  The GPT partition table header is external input, so this routine
+  will do basic validation for GPT partition table header before return.
+
+  Returning the entry array lets the caller parse exactly the bytes whose CRC
+  was checked, instead of reading the array from the disk a second time.
+
+  @param[in]  BlockIo     Parent BlockIo interface.
+  @param[in]  DiskIo      Disk Io protocol.
+  @param[in]  Lba         The starting Lba of the Partition Table
+  @param[out] PartHeader  Stores the partition table that is read
+  @param[out] PartEntry   Optional; on success receives a pool buffer holding
+                          NumberOfPartitionEntries * SizeOfPartitionEntry
+                          bytes of partition entries. The caller frees it.
+                          Set to NULL on failure.
+
+  @retval TRUE      The partition table is valid
+  @retval FALSE     The partition table is not valid
+
+**/
+BOOLEAN
+PartitionValidGptTableEx (
+  IN  EFI_BLOCK_IO_PROTOCOL       *BlockIo,
+  IN  EFI_DISK_IO_PROTOCOL        *DiskIo,
+  IN  EFI_LBA                     Lba,
+  OUT EFI_PARTITION_TABLE_HEADER  *PartHeader,
+  OUT EFI_PARTITION_ENTRY         **PartEntry  OPTIONAL
+  )
 {
   EFI_STATUS                  Status;
   UINT32                      BlockSize;
   EFI_PARTITION_TABLE_HEADER  *PartHdr;
   UINT32                      MediaId;
 
+  if (PartEntry != NULL) {
+    *PartEntry = NULL;
+  }
+
   BlockSize = BlockIo->Media->BlockSize;
   MediaId   = BlockIo->Media->MediaId;
   PartHdr   = AllocateZeroPool (BlockSize);
@@ -208,7 +251,7 @@ PartitionValidGptTable (
   }
 
   CopyMem (PartHeader, PartHdr, sizeof (EFI_PARTITION_TABLE_HEADER));
-  if (!PartitionCheckGptEntryArrayCRC (BlockIo, DiskIo, PartHeader)) {
+  if (!PartitionCheckGptEntryArrayCRC (BlockIo, DiskIo, PartHeader, PartEntry)) {
     FreePool (PartHdr);
     return FALSE;
   }
@@ -225,6 +268,8 @@ PartitionValidGptTable (
   @param[in]  BlockIo     Parent BlockIo interface
   @param[in]  DiskIo      Disk Io Protocol.
   @param[in]  PartHeader  Partition table header structure
+  @param[out] PartEntry   Optional; receives the entry array the CRC was
+                          computed over when the CRC is valid.
 
   @retval TRUE      the CRC is valid
   @retval FALSE     the CRC is invalid
@@ -235,7 +280,8 @@ BOOLEAN
 PartitionCheckGptEntryArrayCRC (
   IN  EFI_BLOCK_IO_PROTOCOL       *BlockIo,
   IN  EFI_DISK_IO_PROTOCOL        *DiskIo,
-  IN  EFI_PARTITION_TABLE_HEADER  *PartHeader
+  IN  EFI_PARTITION_TABLE_HEADER  *PartHeader,
+  OUT EFI_PARTITION_ENTRY         **PartEntry  OPTIONAL
   )
 {
   EFI_STATUS  Status;
@@ -273,6 +319,11 @@ PartitionCheckGptEntryArrayCRC (
     return FALSE;
   }
 
+  if ((PartEntry != NULL) && (PartHeader->PartitionEntryArrayCRC32 == Crc)) {
+    *PartEntry = (EFI_PARTITION_ENTRY *)Ptr;
+    return TRUE;
+  }
+
   FreePool (Ptr);
 
   return (BOOLEAN)(PartHeader->PartitionEntryArrayCRC32 == Crc);
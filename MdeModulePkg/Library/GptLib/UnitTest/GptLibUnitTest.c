@@ -1,8 +1,8 @@
 /** @file
   Host-based unit tests for GptLib.
 
-  These tests exercise PartitionValidGptTable(), PartitionCheckGptEntry()
-  and PartitionRestoreGptTable() against an in-memory mock disk, covering
+  These tests exercise PartitionValidGptTable(), PartitionValidGptTableEx(),
+  PartitionCheckGptEntry() and PartitionRestoreGptTable() against an in-memory mock disk, covering
   both well-formed GPT structures and malformed ones an attacker may
   present: bad signature/revision, header size
   boundaries, CRC corruption, MyLBA replay, zero/non-power-of-two entry
@@ -17,6 +17,7 @@
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
 #include <Library/UnitTestLib.h>
 #include <Library/GptLib.h>
 #include "GptLibUnitTestCommon.h"
@@ -564,6 +565,71 @@ TestEntryArrayReadFailureIsRejected (
   return UNIT_TEST_PASSED;
 }
 
+/**
+  Verify that PartitionValidGptTableEx() hands back the entry array whose CRC
+  it checked, so the caller does not need to read it again.
+
+  @param[in]  Context  Unit test context.
+
+  @retval  UNIT_TEST_PASSED  The test passed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestValidTableExReturnsEntryArray (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_PARTITION_TABLE_HEADER  Header;
+  EFI_PARTITION_ENTRY         *PartEntry;
+  BOOLEAN                     Valid;
+
+  SetupDiskWithValidPrimary ();
+
+  PartEntry = NULL;
+  Valid     = PartitionValidGptTableEx (&mBlockIo, &mDiskIo, PRIMARY_PART_HEADER_LBA, &Header, &PartEntry);
+
+  UT_ASSERT_TRUE (Valid);
+  UT_ASSERT_NOT_NULL (PartEntry);
+  UT_ASSERT_MEM_EQUAL (PartEntry, GetDiskLba (Header.PartitionEntryLBA), PART_ARRAY_SIZE);
+
+  FreePool (PartEntry);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Verify that PartitionValidGptTableEx() returns no entry array when the
+  entry array CRC does not match.
+
+  @param[in]  Context  Unit test context.
+
+  @retval  UNIT_TEST_PASSED  The test passed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestValidTableExCrcMismatchReturnsNoEntryArray (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_PARTITION_TABLE_HEADER  Header;
+  EFI_PARTITION_ENTRY         *PartEntry;
+  BOOLEAN                     Valid;
+
+  SetupDiskWithValidPrimary ();
+
+  GetDiskLba (PRIMARY_PART_HEADER_LBA + 1)[(2U * PARTITION_ENTRY_SIZE) + 7] ^= 0xA5;
+
+  PartEntry = (EFI_PARTITION_ENTRY *)(UINTN)1;
+  Valid     = PartitionValidGptTableEx (&mBlockIo, &mDiskIo, PRIMARY_PART_HEADER_LBA, &Header, &PartEntry);
+
+  UT_ASSERT_FALSE (Valid);
+  UT_ASSERT_TRUE (PartEntry == NULL);
+
+  return UNIT_TEST_PASSED;
+}
+
 // ---------------------------------------------------------------------------
 // PartitionCheckGptEntry() tests
 // ---------------------------------------------------------------------------
@@ -997,6 +1063,8 @@ UefiTestMain (
   AddTestCase (ValidSuite, "PartitionEntryLBA overflow is rejected", "EntryLbaOverflow", TestEntryLbaMultiplicationOverflowIsRejected, NULL, NULL, NULL);
   AddTestCase (ValidSuite, "Entry array CRC mismatch is rejected", "EntryArrayCrcMismatch", TestEntryArrayCrcMismatchIsRejected, NULL, NULL, NULL);
   AddTestCase (ValidSuite, "Entry array read failure is rejected", "EntryArrayReadFailure", TestEntryArrayReadFailureIsRejected, NULL, NULL, NULL);
+  AddTestCase (ValidSuite, "Ex returns the verified entry array", "ExReturnsEntryArray", TestValidTableExReturnsEntryArray, NULL, NULL, NULL);
+  AddTestCase (ValidSuite, "Ex returns no entry array on CRC mismatch", "ExCrcMismatchNoEntryArray", TestValidTableExCrcMismatchReturnsNoEntryArray, NULL, NULL, NULL);
 
   AddTestCase (EntrySuite, "Valid entries report no flags", "ValidEntries", TestValidEntriesReportNoFlags, NULL, NULL, NULL);
   AddTestCase (EntrySuite, "OS-specific attribute is reported", "OsSpecificAttribute", TestOsSpecificAttributeIsReported, NULL, NULL, NULL);
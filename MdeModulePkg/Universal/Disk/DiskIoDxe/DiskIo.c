@@ -186,6 +186,8 @@ DiskIoDriverBindingStart (
     goto ErrorExit;
   }
 
+  DiskIoCacheInitialize (Instance);
+
   //
   // Install protocol interfaces for the Disk IO device.
   //
@@ -217,6 +219,7 @@ ErrorExit:
     }
 
     if (Instance != NULL) {
+      DiskIoCacheFree (Instance);
       FreePool (Instance);
     }
 
@@ -329,6 +332,7 @@ DiskIoDriverBindingStop (
       Instance->SharedWorkingBuffer,
       EFI_SIZE_TO_PAGES (PcdGet32 (PcdDiskIoDataBufferBlockNum) * Instance->BlockIo->Media->BlockSize)
       );
+    DiskIoCacheFree (Instance);
 
     Status = gBS->CloseProtocol (
                     ControllerHandle,
@@ -432,6 +436,18 @@ DiskIo2OnReadWriteComplete (
     CopyMem (Subtask->Buffer, Subtask->WorkingBuffer + Subtask->Offset, Subtask->Length);
   }
 
+  //
+  // A read may have filled the cache with the old data of the blocks between
+  // the submission of this nonblocking write and its completion.
+  //
+  if (Subtask->Write) {
+    DiskIoCacheInvalidate (
+      Instance,
+      MultU64x32 (Subtask->Lba, Instance->BlockIo->Media->BlockSize) + Subtask->Offset,
+      Subtask->Length
+      );
+  }
+
   DiskIoDestroySubtask (Instance, Subtask);
 
   if (EFI_ERROR (TransactionStatus) || IsListEmpty (&Task->Subtasks)) {
@@ -943,13 +959,13 @@ DiskIo2ReadWriteDisk (
       // Read
       //
       if (SubtaskBlocking) {
-        Status = BlockIo->ReadBlocks (
-                            BlockIo,
-                            MediaId,
-                            Subtask->Lba,
-                            (Subtask->Length % Media->BlockSize == 0) ? Subtask->Length : Media->BlockSize,
-                            (Subtask->WorkingBuffer != NULL) ? Subtask->WorkingBuffer : Subtask->Buffer
-                            );
+        Status = DiskIoCacheReadBlocks (
+                   Instance,
+                   MediaId,
+                   Subtask->Lba,
+                   (Subtask->Length % Media->BlockSize == 0) ? Subtask->Length : Media->BlockSize,
+                   (Subtask->WorkingBuffer != NULL) ? Subtask->WorkingBuffer : Subtask->Buffer
+                   );
         if (!EFI_ERROR (Status) && (Subtask->WorkingBuffer != NULL)) {
           CopyMem (Subtask->Buffer, Subtask->WorkingBuffer + Subtask->Offset, Subtask->Length);
         }
@@ -978,6 +994,14 @@ DiskIo2ReadWriteDisk (
     }
   }
 
+  //
+  // The read cache is write-through. Drop the lines overwritten by this request,
+  // including the ones filled by the read-modify-write of partial blocks above.
+  //
+  if (Write) {
+    DiskIoCacheInvalidate (Instance, Offset, BufferSize);
+  }
+
   SubtaskLockTpl = gBS->RaiseTPL (TPL_NOTIFY);
 
   //
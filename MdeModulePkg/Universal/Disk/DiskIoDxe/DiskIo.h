@@ -23,6 +23,20 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 
+//
+// One line of the optional read cache. A line holds up to
+// PcdDiskIoCacheLineBlockNum blocks starting at a line aligned LBA.
+//
+typedef struct {
+  BOOLEAN    Valid;
+  BOOLEAN    Busy;                              /// < being filled from the device
+  UINT32     MediaId;
+  EFI_LBA    Lba;                               /// < first block held by the line
+  UINTN      BlockNum;                          /// < number of blocks held by the line
+  UINT64     LastUse;                           /// < LRU stamp
+  UINT8      *Buffer;
+} DISK_IO_CACHE_LINE;
+
 #define DISK_IO_PRIVATE_DATA_SIGNATURE  SIGNATURE_32 ('d', 's', 'k', 'I')
 typedef struct {
   UINT32                    Signature;
@@ -36,6 +50,23 @@ typedef struct {
 
   EFI_LOCK                  TaskQueueLock;
   LIST_ENTRY                TaskQueue;
+
+  //
+  // Optional write-through read cache, enabled by PcdDiskIoCacheLineNum.
+  // The lines are accessed at TPL_NOTIFY.
+  //
+  DISK_IO_CACHE_LINE        *CacheLines;
+  UINT32                    CacheLineNum;
+  UINT32                    CacheLineBlockNum;
+  UINTN                     CacheLineSize;      /// < size in bytes of the buffer of a line
+  UINT32                    CacheMediaId;       /// < media the lines are filled from
+  UINT32                    CacheBlockSize;
+  UINT8                     *CacheBuffer;
+  UINTN                     CacheBufferPages;
+  UINT64                    CacheTick;
+  UINT64                    CacheGeneration;    /// < bumped whenever lines are dropped
+  UINT64                    CacheHits;
+  UINT64                    CacheMisses;
 } DISK_IO_PRIVATE_DATA;
 #define DISK_IO_PRIVATE_DATA_FROM_DISK_IO(a)   CR (a, DISK_IO_PRIVATE_DATA, DiskIo,  DISK_IO_PRIVATE_DATA_SIGNATURE)
 #define DISK_IO_PRIVATE_DATA_FROM_DISK_IO2(a)  CR (a, DISK_IO_PRIVATE_DATA, DiskIo2, DISK_IO_PRIVATE_DATA_SIGNATURE)
@@ -334,6 +365,67 @@ DiskIo2FlushDiskEx (
   IN OUT EFI_DISK_IO2_TOKEN  *Token
   );
 
+//
+// Read cache
+//
+
+/**
+  Allocate the optional read cache of the Disk IO instance.
+
+  The cache is only enabled when PcdDiskIoCacheLineNum is not zero. Failing to
+  allocate the cache is not fatal, the instance simply runs without it.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoCacheInitialize (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  );
+
+/**
+  Free the read cache of the Disk IO instance.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoCacheFree (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  );
+
+/**
+  Drop the cache lines that overlap a range of the device.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Offset      The starting byte offset of the range.
+  @param BufferSize  The size in bytes of the range.
+**/
+VOID
+DiskIoCacheInvalidate (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT64                Offset,
+  IN UINTN                 BufferSize
+  );
+
+/**
+  Read blocks from the device through the read cache.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param MediaId     ID of the medium to read.
+  @param Lba         The starting logical block address to read from on the device.
+  @param BufferSize  The size in bytes of Buffer, a multiple of the block size.
+  @param Buffer      A pointer to the destination buffer for the data.
+
+  @return The status returned by the Block IO protocol.
+**/
+EFI_STATUS
+DiskIoCacheReadBlocks (
+  IN  DISK_IO_PRIVATE_DATA  *Instance,
+  IN  UINT32                MediaId,
+  IN  EFI_LBA               Lba,
+  IN  UINTN                 BufferSize,
+  OUT UINT8                 *Buffer
+  );
+
 //
 // EFI Component Name Functions
 //
@@ -0,0 +1,341 @@
+/** @file
+  Optional write-through read cache of the DiskIo driver.
+
+  The cache holds PcdDiskIoCacheLineNum lines of PcdDiskIoCacheLineBlockNum
+  blocks. The lines are looked up and updated at TPL_NOTIFY, because the
+  nonblocking DiskIo2 requests invalidate them from the BlockIo2 completion
+  events, while the device is only read at the TPL of the caller.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DiskIo.h"
+
+/**
+  Allocate the optional read cache of the Disk IO instance.
+
+  The cache is only enabled when PcdDiskIoCacheLineNum is not zero. Failing to
+  allocate the cache is not fatal, the instance simply runs without it.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoCacheInitialize (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  EFI_BLOCK_IO_MEDIA  *Media;
+  UINTN               LinePages;
+  UINT32              Index;
+
+  Instance->CacheLineNum      = PcdGet32 (PcdDiskIoCacheLineNum);
+  Instance->CacheLineBlockNum = PcdGet32 (PcdDiskIoCacheLineBlockNum);
+  Media                       = Instance->BlockIo->Media;
+  if ((Instance->CacheLineNum == 0) || (Instance->CacheLineBlockNum == 0) || (Media->BlockSize == 0)) {
+    Instance->CacheLineNum = 0;
+    return;
+  }
+
+  //
+  // Give every line its own pages so that all of them satisfy the IoAlign
+  // requirement of the Block IO protocol. The lines are sized for the current
+  // block size, DiskIoCacheLineBlocks() fits fewer blocks in them if the block
+  // size grows later.
+  //
+  LinePages                  = EFI_SIZE_TO_PAGES (Instance->CacheLineBlockNum * Media->BlockSize);
+  Instance->CacheLineSize    = EFI_PAGES_TO_SIZE (LinePages);
+  Instance->CacheMediaId     = Media->MediaId;
+  Instance->CacheBlockSize   = Media->BlockSize;
+  Instance->CacheBufferPages = LinePages * Instance->CacheLineNum;
+  Instance->CacheBuffer      = AllocateAlignedPages (Instance->CacheBufferPages, Media->IoAlign);
+  Instance->CacheLines       = AllocateZeroPool (Instance->CacheLineNum * sizeof (DISK_IO_CACHE_LINE));
+  if ((Instance->CacheBuffer == NULL) || (Instance->CacheLines == NULL)) {
+    DEBUG ((DEBUG_WARN, "DiskIo: No enough memory for the read cache, run without it\n"));
+    DiskIoCacheFree (Instance);
+    return;
+  }
+
+  for (Index = 0; Index < Instance->CacheLineNum; Index++) {
+    Instance->CacheLines[Index].Buffer = Instance->CacheBuffer + EFI_PAGES_TO_SIZE (LinePages * Index);
+  }
+}
+
+/**
+  Free the read cache of the Disk IO instance.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoCacheFree (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  if (Instance->CacheLineNum != 0) {
+    DEBUG ((
+      DEBUG_INFO,
+      "DiskIo: Read cache hits/misses = %ld/%ld\n",
+      Instance->CacheHits,
+      Instance->CacheMisses
+      ));
+  }
+
+  if (Instance->CacheBuffer != NULL) {
+    FreeAlignedPages (Instance->CacheBuffer, Instance->CacheBufferPages);
+    Instance->CacheBuffer = NULL;
+  }
+
+  if (Instance->CacheLines != NULL) {
+    FreePool (Instance->CacheLines);
+    Instance->CacheLines = NULL;
+  }
+
+  Instance->CacheLineNum = 0;
+}
+
+/**
+  Drop all the cache lines.
+
+  Lines being filled are not marked valid when their read completes, because
+  the generation they were filled in is over.
+
+  The caller must be at TPL_NOTIFY.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+STATIC
+VOID
+DiskIoCacheFlush (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  UINT32  Index;
+
+  for (Index = 0; Index < Instance->CacheLineNum; Index++) {
+    Instance->CacheLines[Index].Valid = FALSE;
+  }
+
+  Instance->CacheGeneration++;
+}
+
+/**
+  Get the number of blocks of the current media held by a cache line.
+
+  The lines are filled with the block size and media seen when the instance
+  started. Flush them when the media is changed or its block size differs, and
+  fit as many blocks of the new size as the line buffers can hold.
+
+  The caller must be at TPL_NOTIFY.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Media       The current media of the Block IO protocol.
+
+  @return The number of blocks per line, 0 if a block doesn't fit in a line.
+**/
+STATIC
+UINT32
+DiskIoCacheLineBlocks (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN EFI_BLOCK_IO_MEDIA    *Media
+  )
+{
+  if ((Media->MediaId != Instance->CacheMediaId) || (Media->BlockSize != Instance->CacheBlockSize)) {
+    DiskIoCacheFlush (Instance);
+    Instance->CacheMediaId   = Media->MediaId;
+    Instance->CacheBlockSize = Media->BlockSize;
+  }
+
+  if (Instance->CacheBlockSize == 0) {
+    return 0;
+  }
+
+  return (UINT32)MIN (Instance->CacheLineBlockNum, Instance->CacheLineSize / Instance->CacheBlockSize);
+}
+
+/**
+  Drop the cache lines that overlap a range of the device.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Offset      The starting byte offset of the range.
+  @param BufferSize  The size in bytes of the range.
+**/
+VOID
+DiskIoCacheInvalidate (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT64                Offset,
+  IN UINTN                 BufferSize
+  )
+{
+  DISK_IO_CACHE_LINE  *Line;
+  EFI_LBA             StartLba;
+  EFI_LBA             EndLba;
+  UINT32              Index;
+  EFI_TPL             OldTpl;
+
+  if (Instance->CacheLineNum == 0) {
+    return;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  //
+  // A line being filled may already hold the old data of the range, don't let
+  // any of the pending fills validate its line.
+  //
+  Instance->CacheGeneration++;
+
+  if (Instance->CacheBlockSize != 0) {
+    StartLba = DivU64x32 (Offset, Instance->CacheBlockSize);
+    EndLba   = DivU64x32 (Offset + BufferSize + Instance->CacheBlockSize - 1, Instance->CacheBlockSize);
+
+    for (Index = 0; Index < Instance->CacheLineNum; Index++) {
+      Line = &Instance->CacheLines[Index];
+      if (Line->Valid && (Line->Lba < EndLba) && (Line->Lba + Line->BlockNum > StartLba)) {
+        Line->Valid = FALSE;
+      }
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Read blocks from the device through the read cache.
+
+  Requests that fit in one cache line are served from the cache. On a miss the
+  whole line is read from the device, so that the small sequential and repeated
+  accesses made by file systems and partition drivers hit the cache afterwards.
+  Requests spanning several lines bypass the cache to avoid evicting hot lines
+  with streaming data.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param MediaId     ID of the medium to read.
+  @param Lba         The starting logical block address to read from on the device.
+  @param BufferSize  The size in bytes of Buffer, a multiple of the block size.
+  @param Buffer      A pointer to the destination buffer for the data.
+
+  @return The status returned by the Block IO protocol.
+**/
+EFI_STATUS
+DiskIoCacheReadBlocks (
+  IN  DISK_IO_PRIVATE_DATA  *Instance,
+  IN  UINT32                MediaId,
+  IN  EFI_LBA               Lba,
+  IN  UINTN                 BufferSize,
+  OUT UINT8                 *Buffer
+  )
+{
+  EFI_STATUS             Status;
+  EFI_BLOCK_IO_PROTOCOL  *BlockIo;
+  EFI_BLOCK_IO_MEDIA     *Media;
+  DISK_IO_CACHE_LINE     *Line;
+  DISK_IO_CACHE_LINE     *Victim;
+  EFI_LBA                LineLba;
+  UINT32                 LineBlockNum;
+  UINT32                 BlockSize;
+  UINTN                  BlockNum;
+  UINT64                 Generation;
+  UINT32                 Index;
+  EFI_TPL                OldTpl;
+
+  BlockIo = Instance->BlockIo;
+  Media   = BlockIo->Media;
+
+  if ((Instance->CacheLineNum == 0) || (BufferSize == 0) ||
+      (MediaId != Media->MediaId) || !Media->MediaPresent)
+  {
+    return BlockIo->ReadBlocks (BlockIo, MediaId, Lba, BufferSize, Buffer);
+  }
+
+  OldTpl       = gBS->RaiseTPL (TPL_NOTIFY);
+  LineBlockNum = DiskIoCacheLineBlocks (Instance, Media);
+  BlockSize    = Instance->CacheBlockSize;
+  if (LineBlockNum == 0) {
+    gBS->RestoreTPL (OldTpl);
+    return BlockIo->ReadBlocks (BlockIo, MediaId, Lba, BufferSize, Buffer);
+  }
+
+  BlockNum = BufferSize / BlockSize;
+  LineLba  = Lba - ModU64x32 (Lba, LineBlockNum);
+  if ((Lba + BlockNum > LineLba + LineBlockNum) || (Lba + BlockNum - 1 > Media->LastBlock)) {
+    gBS->RestoreTPL (OldTpl);
+    return BlockIo->ReadBlocks (BlockIo, MediaId, Lba, BufferSize, Buffer);
+  }
+
+  Victim = NULL;
+  for (Index = 0; Index < Instance->CacheLineNum; Index++) {
+    Line = &Instance->CacheLines[Index];
+    if (Line->Valid && (Line->MediaId == MediaId) && (Line->Lba == LineLba) &&
+        (Lba + BlockNum <= Line->Lba + Line->BlockNum))
+    {
+      Instance->CacheHits++;
+      Line->LastUse = ++Instance->CacheTick;
+      CopyMem (Buffer, Line->Buffer + MultU64x32 (Lba - LineLba, BlockSize), BufferSize);
+      gBS->RestoreTPL (OldTpl);
+      return EFI_SUCCESS;
+    }
+
+    if (Line->Busy) {
+      continue;
+    }
+
+    if ((Victim == NULL) || (Victim->Valid && (!Line->Valid || (Line->LastUse < Victim->LastUse)))) {
+      Victim = Line;
+    }
+  }
+
+  if (Victim == NULL) {
+    //
+    // All the lines are being filled by nested requests.
+    //
+    gBS->RestoreTPL (OldTpl);
+    return BlockIo->ReadBlocks (BlockIo, MediaId, Lba, BufferSize, Buffer);
+  }
+
+  //
+  // Claim the least recently used line, and fill it without reading past the
+  // end of the device. The device is read at the TPL of the caller, so the
+  // line is kept busy and invalid until the read completes.
+  //
+  Instance->CacheMisses++;
+  Victim->Valid    = FALSE;
+  Victim->Busy     = TRUE;
+  Victim->MediaId  = MediaId;
+  Victim->Lba      = LineLba;
+  Victim->BlockNum = (UINTN)MIN (LineBlockNum, Media->LastBlock - LineLba + 1);
+  Generation       = Instance->CacheGeneration;
+  gBS->RestoreTPL (OldTpl);
+
+  Status = BlockIo->ReadBlocks (
+                      BlockIo,
+                      MediaId,
+                      LineLba,
+                      Victim->BlockNum * BlockSize,
+                      Victim->Buffer
+                      );
+
+  OldTpl       = gBS->RaiseTPL (TPL_NOTIFY);
+  Victim->Busy = FALSE;
+  if (!EFI_ERROR (Status)) {
+    CopyMem (Buffer, Victim->Buffer + MultU64x32 (Lba - LineLba, BlockSize), BufferSize);
+    //
+    // Only keep the line if nothing overlapping was written, and the media was
+    // not changed, while it was read.
+    //
+    if (Generation == Instance->CacheGeneration) {
+      Victim->Valid   = TRUE;
+      Victim->LastUse = ++Instance->CacheTick;
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (EFI_ERROR (Status)) {
+    //
+    // The line may contain a bad block outside of the request, retry the request alone.
+    //
+    return BlockIo->ReadBlocks (BlockIo, MediaId, Lba, BufferSize, Buffer);
+  }
+
+  return EFI_SUCCESS;
+}
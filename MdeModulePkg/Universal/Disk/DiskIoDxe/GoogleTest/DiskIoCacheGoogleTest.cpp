@@ -0,0 +1,267 @@
+/** @file
+  Tests for DiskIoCache.c.
+
+  The tests expect PcdDiskIoCacheLineNum = 4 and PcdDiskIoCacheLineBlockNum = 8.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/DebugLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/MemoryAllocationLib.h>
+  #include "../DiskIo.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define TEST_LINE_NUM        4
+#define TEST_LINE_BLOCK_NUM  8
+#define TEST_BLOCK_SIZE      512
+#define TEST_DISK_SIZE       SIZE_256KB
+
+////////////////////////////////////////////////////////////////////////
+// Test Block IO
+////////////////////////////////////////////////////////////////////////
+
+//
+// A RAM disk recording the reads made to it.
+//
+static UINT8               mDisk[TEST_DISK_SIZE];
+static EFI_BLOCK_IO_MEDIA  mMedia;
+static UINTN               mReadCount;
+static EFI_LBA             mReadLba;
+static UINTN               mReadSize;
+static VOID (*mReadHook)(
+  VOID
+  );
+
+static EFI_STATUS
+EFIAPI
+TestReadBlocks (
+  IN  EFI_BLOCK_IO_PROTOCOL  *This,
+  IN  UINT32                 MediaId,
+  IN  EFI_LBA                Lba,
+  IN  UINTN                  BufferSize,
+  OUT VOID                   *Buffer
+  )
+{
+  if ((MediaId != mMedia.MediaId) || (BufferSize % mMedia.BlockSize != 0) ||
+      (Lba + BufferSize / mMedia.BlockSize - 1 > mMedia.LastBlock))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  mReadCount++;
+  mReadLba  = Lba;
+  mReadSize = BufferSize;
+  CopyMem (Buffer, mDisk + Lba * mMedia.BlockSize, BufferSize);
+  if (mReadHook != NULL) {
+    mReadHook ();
+  }
+
+  return EFI_SUCCESS;
+}
+
+static EFI_BLOCK_IO_PROTOCOL  mBlockIo;
+static DISK_IO_PRIVATE_DATA   mInstance;
+
+static VOID
+InvalidateFirstLine (
+  VOID
+  )
+{
+  DiskIoCacheInvalidate (&mInstance, 0, TEST_BLOCK_SIZE);
+}
+
+////////////////////////////////////////////////////////////////////////
+// Tests
+////////////////////////////////////////////////////////////////////////
+
+class DiskIoCacheTest : public ::testing::Test {
+protected:
+  UINT8 Buffer[TEST_LINE_BLOCK_NUM * SIZE_4KB];
+
+  void
+  SetUp (
+    ) override
+  {
+    UINTN  Index;
+
+    for (Index = 0; Index < sizeof (mDisk); Index++) {
+      mDisk[Index] = (UINT8)(Index / TEST_BLOCK_SIZE);
+    }
+
+    ZeroMem (&mMedia, sizeof (mMedia));
+    mMedia.MediaId      = 1;
+    mMedia.MediaPresent = TRUE;
+    mMedia.BlockSize    = TEST_BLOCK_SIZE;
+    mMedia.LastBlock    = TEST_DISK_SIZE / TEST_BLOCK_SIZE - 1;
+
+    ZeroMem (&mBlockIo, sizeof (mBlockIo));
+    mBlockIo.Media      = &mMedia;
+    mBlockIo.ReadBlocks = TestReadBlocks;
+
+    ZeroMem (&mInstance, sizeof (mInstance));
+    mInstance.Signature = DISK_IO_PRIVATE_DATA_SIGNATURE;
+    mInstance.BlockIo   = &mBlockIo;
+
+    mReadCount = 0;
+    mReadHook  = NULL;
+
+    DiskIoCacheInitialize (&mInstance);
+    ASSERT_EQ (mInstance.CacheLineNum, (UINT32)TEST_LINE_NUM);
+    ASSERT_EQ (mInstance.CacheLineBlockNum, (UINT32)TEST_LINE_BLOCK_NUM);
+  }
+
+  void
+  TearDown (
+    ) override
+  {
+    DiskIoCacheFree (&mInstance);
+  }
+
+  EFI_STATUS
+  Read (
+    EFI_LBA  Lba,
+    UINTN    BlockNum
+    )
+  {
+    return DiskIoCacheReadBlocks (&mInstance, mMedia.MediaId, Lba, BlockNum * mMedia.BlockSize, Buffer);
+  }
+};
+
+//
+// A miss reads the whole line, later reads in the line are served from the cache.
+//
+TEST_F (DiskIoCacheTest, MissReadsLineAndHitsFollow) {
+  ASSERT_EQ (Read (1, 1), EFI_SUCCESS);
+  EXPECT_EQ (mReadCount, 1U);
+  EXPECT_EQ (mReadLba, 0U);
+  EXPECT_EQ (mReadSize, (UINTN)TEST_LINE_BLOCK_NUM * TEST_BLOCK_SIZE);
+  EXPECT_EQ (Buffer[0], 1);
+
+  ASSERT_EQ (Read (1, 1), EFI_SUCCESS);
+  ASSERT_EQ (Read (3, 2), EFI_SUCCESS);
+  EXPECT_EQ (mReadCount, 1U);
+  EXPECT_EQ (Buffer[0], 3);
+  EXPECT_EQ (Buffer[TEST_BLOCK_SIZE], 4);
+  EXPECT_EQ (mInstance.CacheHits, 2U);
+  EXPECT_EQ (mInstance.CacheMisses, 1U);
+}
+
+//
+// Reads spanning several lines go straight to the device.
+//
+TEST_F (DiskIoCacheTest, MultiLineReadBypasses) {
+  ASSERT_EQ (Read (6, 4), EFI_SUCCESS);
+  EXPECT_EQ (mReadCount, 1U);
+  EXPECT_EQ (mReadLba, 6U);
+  EXPECT_EQ (mReadSize, 4U * TEST_BLOCK_SIZE);
+  EXPECT_EQ (Buffer[3 * TEST_BLOCK_SIZE], 9);
+  EXPECT_EQ (mInstance.CacheMisses, 0U);
+}
+
+//
+// A write drops the lines it overlaps.
+//
+TEST_F (DiskIoCacheTest, InvalidateDropsLine) {
+  ASSERT_EQ (Read (9, 1), EFI_SUCCESS);
+  mDisk[10 * TEST_BLOCK_SIZE + 5] = 0xAA;
+  DiskIoCacheInvalidate (&mInstance, 10 * TEST_BLOCK_SIZE + 5, 1);
+
+  ASSERT_EQ (Read (10, 1), EFI_SUCCESS);
+  EXPECT_EQ (mReadCount, 2U);
+  EXPECT_EQ (Buffer[5], 0xAA);
+}
+
+//
+// The least recently used line is replaced.
+//
+TEST_F (DiskIoCacheTest, LruLineIsEvicted) {
+  EFI_LBA  Line;
+
+  for (Line = 0; Line < TEST_LINE_NUM; Line++) {
+    ASSERT_EQ (Read (Line * TEST_LINE_BLOCK_NUM, 1), EFI_SUCCESS);
+  }
+
+  ASSERT_EQ (Read (0, 1), EFI_SUCCESS);
+  ASSERT_EQ (Read (TEST_LINE_NUM * TEST_LINE_BLOCK_NUM, 1), EFI_SUCCESS);
+  EXPECT_EQ (mReadCount, (UINTN)TEST_LINE_NUM + 1);
+
+  ASSERT_EQ (Read (0, 1), EFI_SUCCESS);
+  EXPECT_EQ (mReadCount, (UINTN)TEST_LINE_NUM + 1);
+  ASSERT_EQ (Read (TEST_LINE_BLOCK_NUM, 1), EFI_SUCCESS);
+  EXPECT_EQ (mReadCount, (UINTN)TEST_LINE_NUM + 2);
+}
+
+//
+// The line filled at the end of the device stops at the last block.
+//
+TEST_F (DiskIoCacheTest, LineStopsAtLastBlock) {
+  mMedia.LastBlock = 2 * TEST_LINE_BLOCK_NUM + 2;
+  ASSERT_EQ (Read (mMedia.LastBlock, 1), EFI_SUCCESS);
+  EXPECT_EQ (mReadLba, 2U * TEST_LINE_BLOCK_NUM);
+  EXPECT_EQ (mReadSize, 3U * TEST_BLOCK_SIZE);
+  EXPECT_EQ (Buffer[0], mMedia.LastBlock);
+}
+
+//
+// A new media flushes the lines.
+//
+TEST_F (DiskIoCacheTest, MediaChangeFlushes) {
+  ASSERT_EQ (Read (0, 1), EFI_SUCCESS);
+  mMedia.MediaId++;
+  mDisk[0] = 0xAA;
+
+  ASSERT_EQ (Read (0, 1), EFI_SUCCESS);
+  EXPECT_EQ (mReadCount, 2U);
+  EXPECT_EQ (Buffer[0], 0xAA);
+}
+
+//
+// A larger block size flushes the lines and fits fewer blocks in them.
+//
+TEST_F (DiskIoCacheTest, BlockSizeChangeResizesLines) {
+  ASSERT_EQ (Read (0, 1), EFI_SUCCESS);
+  mMedia.BlockSize = SIZE_4KB;
+  mMedia.LastBlock = TEST_DISK_SIZE / SIZE_4KB - 1;
+
+  ASSERT_EQ (Read (3, 1), EFI_SUCCESS);
+  EXPECT_EQ (mReadCount, 2U);
+  EXPECT_EQ (mReadLba, 3U);
+  EXPECT_EQ (mReadSize, (UINTN)SIZE_4KB);
+  EXPECT_EQ (Buffer[0], 3 * SIZE_4KB / TEST_BLOCK_SIZE);
+
+  ASSERT_EQ (Read (3, 1), EFI_SUCCESS);
+  EXPECT_EQ (mReadCount, 2U);
+
+  //
+  // A block larger than a line bypasses the cache.
+  //
+  mMedia.BlockSize = SIZE_8KB;
+  mMedia.LastBlock = TEST_DISK_SIZE / SIZE_8KB - 1;
+  ASSERT_EQ (Read (1, 1), EFI_SUCCESS);
+  EXPECT_EQ (mReadLba, 1U);
+  EXPECT_EQ (mReadSize, (UINTN)SIZE_8KB);
+  EXPECT_EQ (mInstance.CacheMisses, 2U);
+}
+
+//
+// A write racing with the fill of a line leaves the line invalid.
+//
+TEST_F (DiskIoCacheTest, InvalidateDuringFillDropsLine) {
+  mReadHook = InvalidateFirstLine;
+  ASSERT_EQ (Read (0, 1), EFI_SUCCESS);
+  mReadHook = NULL;
+
+  ASSERT_EQ (Read (0, 1), EFI_SUCCESS);
+  EXPECT_EQ (mReadCount, 2U);
+  ASSERT_EQ (Read (0, 1), EFI_SUCCESS);
+  EXPECT_EQ (mReadCount, 2U);
+}
@@ -19,6 +19,240 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "Partition.h"
 
+//
+// GPTs that passed full validation on an earlier connect, most recently
+// inserted last.
+//
+STATIC LIST_ENTRY  mPartitionGptCache      = INITIALIZE_LIST_HEAD_VARIABLE (mPartitionGptCache);
+STATIC UINTN       mPartitionGptCacheCount = 0;
+
+/**
+  Remove an entry from the validated GPT cache and free it.
+
+  @param[in]  CacheEntry  The entry to remove.
+
+**/
+STATIC
+VOID
+PartitionGptCacheRemove (
+  IN PARTITION_GPT_CACHE_ENTRY  *CacheEntry
+  )
+{
+  RemoveEntryList (&CacheEntry->Link);
+  mPartitionGptCacheCount--;
+
+  FreePool (CacheEntry->DevicePath);
+  FreePool (CacheEntry->HeaderBlock);
+  FreePool (CacheEntry->PartEntry);
+  FreePool (CacheEntry);
+}
+
+/**
+  Find the validated GPT cache entry of a disk.
+
+  @param[in]  BlockIo     Parent BlockIo interface.
+  @param[in]  DevicePath  Parent Device Path.
+
+  @return The cache entry, or NULL if the disk has none.
+
+**/
+STATIC
+PARTITION_GPT_CACHE_ENTRY *
+PartitionGptCacheFind (
+  IN EFI_BLOCK_IO_PROTOCOL     *BlockIo,
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  )
+{
+  LIST_ENTRY                 *Link;
+  PARTITION_GPT_CACHE_ENTRY  *CacheEntry;
+  UINTN                      DevicePathSize;
+
+  DevicePathSize = GetDevicePathSize (DevicePath);
+
+  for (Link = GetFirstNode (&mPartitionGptCache);
+       !IsNull (&mPartitionGptCache, Link);
+       Link = GetNextNode (&mPartitionGptCache, Link))
+  {
+    CacheEntry = PARTITION_GPT_CACHE_ENTRY_FROM_LINK (Link);
+    if ((CacheEntry->MediaId == BlockIo->Media->MediaId) &&
+        (CacheEntry->BlockSize == BlockIo->Media->BlockSize) &&
+        (CacheEntry->LastBlock == BlockIo->Media->LastBlock) &&
+        (GetDevicePathSize (CacheEntry->DevicePath) == DevicePathSize) &&
+        (CompareMem (CacheEntry->DevicePath, DevicePath, DevicePathSize) == 0))
+    {
+      return CacheEntry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Look up a previously validated GPT of the disk.
+
+  The cached partition table is only returned when the primary header block
+  currently on the disk is identical to the one that was validated. The
+  header carries the CRC of the entry array, so any conforming update of the
+  partition entries also changes the header and invalidates the cache entry.
+
+  @param[in]  BlockIo        Parent BlockIo interface.
+  @param[in]  DiskIo         Parent DiskIo interface.
+  @param[in]  DevicePath     Parent Device Path.
+  @param[out] PrimaryHeader  Receives the cached primary header.
+  @param[out] PartEntry      Receives a pool copy of the cached partition
+                             entries. The caller frees it.
+
+  @retval TRUE   The cached partition table is still valid for the disk.
+  @retval FALSE  There is no usable cached partition table.
+
+**/
+STATIC
+BOOLEAN
+PartitionGptCacheLookup (
+  IN  EFI_BLOCK_IO_PROTOCOL       *BlockIo,
+  IN  EFI_DISK_IO_PROTOCOL        *DiskIo,
+  IN  EFI_DEVICE_PATH_PROTOCOL    *DevicePath,
+  OUT EFI_PARTITION_TABLE_HEADER  *PrimaryHeader,
+  OUT EFI_PARTITION_ENTRY         **PartEntry
+  )
+{
+  EFI_STATUS                 Status;
+  PARTITION_GPT_CACHE_ENTRY  *CacheEntry;
+  VOID                       *HeaderBlock;
+  BOOLEAN                    Match;
+
+  CacheEntry = PartitionGptCacheFind (BlockIo, DevicePath);
+  if (CacheEntry == NULL) {
+    return FALSE;
+  }
+
+  HeaderBlock = AllocatePool (CacheEntry->BlockSize);
+  if (HeaderBlock == NULL) {
+    return FALSE;
+  }
+
+  Status = DiskIo->ReadDisk (
+                     DiskIo,
+                     CacheEntry->MediaId,
+                     MultU64x32 (PRIMARY_PART_HEADER_LBA, CacheEntry->BlockSize),
+                     CacheEntry->BlockSize,
+                     HeaderBlock
+                     );
+  Match = (BOOLEAN)(!EFI_ERROR (Status) &&
+                    (CompareMem (HeaderBlock, CacheEntry->HeaderBlock, CacheEntry->BlockSize) == 0));
+  FreePool (HeaderBlock);
+
+  if (!Match) {
+    PartitionGptCacheRemove (CacheEntry);
+    return FALSE;
+  }
+
+  *PartEntry = AllocateCopyPool (CacheEntry->PartEntrySize, CacheEntry->PartEntry);
+  if (*PartEntry == NULL) {
+    return FALSE;
+  }
+
+  CopyMem (PrimaryHeader, CacheEntry->HeaderBlock, sizeof (EFI_PARTITION_TABLE_HEADER));
+
+  //
+  // Keep the most recently used disks at the tail so eviction drops the
+  // disk that has gone longest without a connect.
+  //
+  RemoveEntryList (&CacheEntry->Link);
+  InsertTailList (&mPartitionGptCache, &CacheEntry->Link);
+
+  return TRUE;
+}
+
+/**
+  Remember a GPT whose primary and backup tables both passed validation.
+
+  Failures are not reported; the next connect of the disk simply validates
+  the partition table from scratch.
+
+  @param[in]  BlockIo        Parent BlockIo interface.
+  @param[in]  DiskIo         Parent DiskIo interface.
+  @param[in]  DevicePath     Parent Device Path.
+  @param[in]  PrimaryHeader  The validated primary header.
+  @param[in]  PartEntry      The partition entries whose CRC was validated.
+
+**/
+STATIC
+VOID
+PartitionGptCacheInsert (
+  IN EFI_BLOCK_IO_PROTOCOL       *BlockIo,
+  IN EFI_DISK_IO_PROTOCOL        *DiskIo,
+  IN EFI_DEVICE_PATH_PROTOCOL    *DevicePath,
+  IN EFI_PARTITION_TABLE_HEADER  *PrimaryHeader,
+  IN EFI_PARTITION_ENTRY         *PartEntry
+  )
+{
+  EFI_STATUS                 Status;
+  PARTITION_GPT_CACHE_ENTRY  *CacheEntry;
+
+  CacheEntry = PartitionGptCacheFind (BlockIo, DevicePath);
+  if (CacheEntry != NULL) {
+    PartitionGptCacheRemove (CacheEntry);
+  }
+
+  if (mPartitionGptCacheCount >= PARTITION_GPT_CACHE_MAX_ENTRIES) {
+    PartitionGptCacheRemove (PARTITION_GPT_CACHE_ENTRY_FROM_LINK (GetFirstNode (&mPartitionGptCache)));
+  }
+
+  CacheEntry = AllocateZeroPool (sizeof (PARTITION_GPT_CACHE_ENTRY));
+  if (CacheEntry == NULL) {
+    return;
+  }
+
+  CacheEntry->Signature     = PARTITION_GPT_CACHE_SIGNATURE;
+  CacheEntry->MediaId       = BlockIo->Media->MediaId;
+  CacheEntry->BlockSize     = BlockIo->Media->BlockSize;
+  CacheEntry->LastBlock     = BlockIo->Media->LastBlock;
+  CacheEntry->PartEntrySize = PrimaryHeader->NumberOfPartitionEntries * PrimaryHeader->SizeOfPartitionEntry;
+  CacheEntry->DevicePath    = DuplicateDevicePath (DevicePath);
+  CacheEntry->HeaderBlock   = AllocatePool (CacheEntry->BlockSize);
+  CacheEntry->PartEntry     = AllocateCopyPool (CacheEntry->PartEntrySize, PartEntry);
+  if ((CacheEntry->DevicePath == NULL) || (CacheEntry->HeaderBlock == NULL) || (CacheEntry->PartEntry == NULL)) {
+    goto Error;
+  }
+
+  //
+  // Key the entry on the raw header block, and only if it still holds the
+  // header that was validated.
+  //
+  Status = DiskIo->ReadDisk (
+                     DiskIo,
+                     CacheEntry->MediaId,
+                     MultU64x32 (PRIMARY_PART_HEADER_LBA, CacheEntry->BlockSize),
+                     CacheEntry->BlockSize,
+                     CacheEntry->HeaderBlock
+                     );
+  if (EFI_ERROR (Status) ||
+      (CompareMem (CacheEntry->HeaderBlock, PrimaryHeader, sizeof (EFI_PARTITION_TABLE_HEADER)) != 0))
+  {
+    goto Error;
+  }
+
+  InsertTailList (&mPartitionGptCache, &CacheEntry->Link);
+  mPartitionGptCacheCount++;
+  return;
+
+Error:
+  if (CacheEntry->DevicePath != NULL) {
+    FreePool (CacheEntry->DevicePath);
+  }
+
+  if (CacheEntry->HeaderBlock != NULL) {
+    FreePool (CacheEntry->HeaderBlock);
+  }
+
+  if (CacheEntry->PartEntry != NULL) {
+    FreePool (CacheEntry->PartEntry);
+  }
+
+  FreePool (CacheEntry);
+}
+
 /**
   Install child handles if the Handle supports GPT partition structure.
 
@@ -65,6 +299,7 @@ PartitionInstallGptChildHandles (
   HARDDRIVE_DEVICE_PATH        HdDev;
   UINT32                       MediaId;
   EFI_PARTITION_INFO_PROTOCOL  PartitionInfo;
+  BOOLEAN                      Cached;
 
   ProtectiveMbr = NULL;
   PrimaryHeader = NULL;
@@ -141,9 +376,17 @@ PartitionInstallGptChildHandles (
   }
 
   //
-  // Check primary and backup partition tables
+  // Check primary and backup partition tables. A disk whose primary table
+  // validated on an earlier connect and whose primary header is unchanged
+  // skips re-reading and checking the primary entry array. The backup table
+  // is still checked, and restored if needed, on every connect.
   //
-  if (!PartitionValidGptTable (BlockIo, DiskIo, PRIMARY_PART_HEADER_LBA, PrimaryHeader)) {
+  Cached = PartitionGptCacheLookup (BlockIo, DiskIo, DevicePath, PrimaryHeader, &PartEntry);
+  if (Cached) {
+    DEBUG ((DEBUG_INFO, " Valid cached primary partition table\n"));
+  }
+
+  if (!Cached && !PartitionValidGptTableEx (BlockIo, DiskIo, PRIMARY_PART_HEADER_LBA, PrimaryHeader, &PartEntry)) {
     DEBUG ((DEBUG_INFO, " Not Valid primary partition table\n"));
 
     if (!PartitionValidGptTable (BlockIo, DiskIo, LastBlock, BackupHeader)) {
@@ -165,7 +408,7 @@ PartitionInstallGptChildHandles (
       goto Done;
     }
 
-    if (!PartitionValidGptTable (BlockIo, DiskIo, BackupHeader->AlternateLBA, PrimaryHeader)) {
+    if (!PartitionValidGptTableEx (BlockIo, DiskIo, BackupHeader->AlternateLBA, PrimaryHeader, &PartEntry)) {
       DEBUG ((DEBUG_INFO, " Not Valid restored primary partition table\n"));
       goto Done;
     }
@@ -181,33 +424,17 @@ PartitionInstallGptChildHandles (
     if (PartitionValidGptTable (BlockIo, DiskIo, PrimaryHeader->AlternateLBA, BackupHeader)) {
       DEBUG ((DEBUG_INFO, " Restore backup partition table success\n"));
     }
+  } else if (!Cached) {
+    PartitionGptCacheInsert (BlockIo, DiskIo, DevicePath, PrimaryHeader, PartEntry);
   }
 
   DEBUG ((DEBUG_INFO, " Valid primary and Valid backup partition table\n"));
 
   //
-  // Read the EFI Partition Entries
+  // The partition entries are the ones whose CRC was just validated against
+  // PrimaryHeader; they are not read from the disk a second time.
   //
-  PartEntry = AllocatePool (PrimaryHeader->NumberOfPartitionEntries * PrimaryHeader->SizeOfPartitionEntry);
-  if (PartEntry == NULL) {
-    DEBUG ((DEBUG_ERROR, "Allocate pool error\n"));
-    goto Done;
-  }
-
-  Status = DiskIo->ReadDisk (
-                     DiskIo,
-                     MediaId,
-                     MultU64x32 (PrimaryHeader->PartitionEntryLBA, BlockSize),
-                     PrimaryHeader->NumberOfPartitionEntries * (PrimaryHeader->SizeOfPartitionEntry),
-                     PartEntry
-                     );
-  if (EFI_ERROR (Status)) {
-    GptValidStatus = Status;
-    DEBUG ((DEBUG_ERROR, " Partition Entry ReadDisk error\n"));
-    goto Done;
-  }
-
-  DEBUG ((DEBUG_INFO, " Partition entries read block success\n"));
+  ASSERT (PartEntry != NULL);
 
   DEBUG ((DEBUG_INFO, " Number of partition entries: %d\n", PrimaryHeader->NumberOfPartitionEntries));
 
@@ -72,6 +72,30 @@ typedef struct {
 #define PARTITION_DEVICE_FROM_BLOCK_IO_THIS(a)   CR (a, PARTITION_PRIVATE_DATA, BlockIo, PARTITION_PRIVATE_DATA_SIGNATURE)
 #define PARTITION_DEVICE_FROM_BLOCK_IO2_THIS(a)  CR (a, PARTITION_PRIVATE_DATA, BlockIo2, PARTITION_PRIVATE_DATA_SIGNATURE)
 
+//
+// Validated GPT cache entry. A disk whose GPT validated on an earlier
+// connect is identified by its device path and media geometry; the cached
+// partition entries are reused as long as the primary header block on the
+// disk is byte-for-byte unchanged.
+//
+#define PARTITION_GPT_CACHE_SIGNATURE    SIGNATURE_32 ('P', 'g', 'p', 't')
+#define PARTITION_GPT_CACHE_MAX_ENTRIES  64
+typedef struct {
+  UINT32                      Signature;
+  LIST_ENTRY                  Link;
+
+  EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
+  UINT32                      MediaId;
+  UINT32                      BlockSize;
+  EFI_LBA                     LastBlock;
+
+  VOID                        *HeaderBlock;
+  EFI_PARTITION_ENTRY         *PartEntry;
+  UINTN                       PartEntrySize;
+} PARTITION_GPT_CACHE_ENTRY;
+
+#define PARTITION_GPT_CACHE_ENTRY_FROM_LINK(a)  CR (a, PARTITION_GPT_CACHE_ENTRY, Link, PARTITION_GPT_CACHE_SIGNATURE)
+
 //
 // Global Variables
 //
@@ -239,6 +239,7 @@ UdfOpen (
     sizeof (PRIVATE_UDF_FILE_DATA)
     );
   CopyMem ((VOID *)&NewPrivFileData->File, &File, sizeof (UDF_FILE_INFO));
+  ZeroMem ((VOID *)&NewPrivFileData->ExtentMap, sizeof (UDF_FILE_EXTENT_MAP));
 
   NewPrivFileData->IsRootDirectory = FALSE;
 
@@ -383,6 +384,7 @@ UdfRead (
                Volume,
                Parent,
                PrivFileData->FileSize,
+               &PrivFileData->ExtentMap,
                &PrivFileData->FilePosition,
                Buffer,
                &BufferSizeUint64
@@ -566,6 +568,7 @@ UdfClose (
 
   if (!PrivFileData->IsRootDirectory) {
     CleanupFileInformation (&PrivFileData->File);
+    CleanupFileExtentMap (&PrivFileData->ExtentMap);
 
     if (PrivFileData->ReadDirInfo.DirectoryData != NULL) {
       FreePool (PrivFileData->ReadDirInfo.DirectoryData);
@@ -1053,6 +1053,69 @@ GrowUpBufferToNextAd (
   return EFI_SUCCESS;
 }
 
+/**
+  Append an extent to a file extent map, merging it into the last run when it
+  directly follows that run on the medium.
+
+  @param[in, out] ExtentMap     Extent map pointer.
+  @param[in]      FileOffset    Offset of the extent within the file.
+  @param[in]      DiskOffset    Byte offset of the extent on the medium.
+  @param[in]      Length        Length of the extent in bytes.
+
+  @retval EFI_SUCCESS           The extent was appended.
+  @retval EFI_OUT_OF_RESOURCES  The extent map could not be grown.
+
+**/
+STATIC
+EFI_STATUS
+AppendFileExtent (
+  IN OUT  UDF_FILE_EXTENT_MAP  *ExtentMap,
+  IN      UINT64               FileOffset,
+  IN      UINT64               DiskOffset,
+  IN      UINT64               Length
+  )
+{
+  UDF_FILE_EXTENT  *Last;
+  UDF_FILE_EXTENT  *Extents;
+  UINTN            Capacity;
+
+  if (Length == 0) {
+    return EFI_SUCCESS;
+  }
+
+  if (ExtentMap->Count > 0) {
+    Last = &ExtentMap->Extents[ExtentMap->Count - 1];
+    if ((Last->FileOffset + Last->Length == FileOffset) &&
+        (Last->DiskOffset + Last->Length == DiskOffset))
+    {
+      Last->Length += Length;
+      return EFI_SUCCESS;
+    }
+  }
+
+  if (ExtentMap->Count == ExtentMap->Capacity) {
+    Capacity = (ExtentMap->Capacity == 0) ? 16 : ExtentMap->Capacity * 2;
+    Extents  = ReallocatePool (
+                 ExtentMap->Capacity * sizeof (UDF_FILE_EXTENT),
+                 Capacity * sizeof (UDF_FILE_EXTENT),
+                 ExtentMap->Extents
+                 );
+    if (Extents == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    ExtentMap->Extents  = Extents;
+    ExtentMap->Capacity = Capacity;
+  }
+
+  ExtentMap->Extents[ExtentMap->Count].FileOffset = FileOffset;
+  ExtentMap->Extents[ExtentMap->Count].DiskOffset = DiskOffset;
+  ExtentMap->Extents[ExtentMap->Count].Length     = Length;
+  ExtentMap->Count++;
+
+  return EFI_SUCCESS;
+}
+
 /**
   Read data or size of either a File Entry or an Extended File Entry.
 
@@ -1116,9 +1179,10 @@ ReadFile (
   switch (ReadFileInfo->Flags) {
     case ReadFileGetFileSize:
     case ReadFileAllocateAndRead:
+    case ReadFileGetExtentMap:
       //
-      // Initialise ReadFileInfo structure for either getting file size, or
-      // reading file's recorded data.
+      // Initialise ReadFileInfo structure for either getting file size,
+      // reading file's recorded data, or mapping its extents.
       //
       ReadFileInfo->ReadLength = 0;
       ReadFileInfo->FileData   = NULL;
@@ -1185,6 +1249,11 @@ ReadFile (
           );
 
         ReadFileInfo->FilePosition += ReadFileInfo->FileDataSize;
+      } else if (ReadFileInfo->Flags == ReadFileGetExtentMap) {
+        //
+        // Inline data is not recorded in extents.
+        //
+        return EFI_UNSUPPORTED;
       } else {
         ASSERT (FALSE);
         return EFI_INVALID_PARAMETER;
@@ -1368,6 +1437,19 @@ Skip_File_Seek:
               goto Done;
             }
 
+            break;
+          case ReadFileGetExtentMap:
+            Status = AppendFileExtent (
+                       ReadFileInfo->ExtentMap,
+                       ReadFileInfo->ReadLength,
+                       MultU64x32 (Lsn, LogicalBlockSize),
+                       ExtentLength
+                       );
+            if (EFI_ERROR (Status)) {
+              goto Done;
+            }
+
+            ReadFileInfo->ReadLength += ExtentLength;
             break;
         }
 
@@ -1415,6 +1497,277 @@ Error_Get_Aed:
   return Status;
 }
 
+/**
+  Hash a file name for the directory entry index.
+
+  @param[in] FileName  File name string.
+
+  @return The hash of the file name.
+
+**/
+STATIC
+UINT32
+HashFileName (
+  IN CHAR16  *FileName
+  )
+{
+  UINT32  Hash;
+
+  //
+  // FNV-1a
+  //
+  Hash = 0x811C9DC5;
+  while (*FileName != L'\0') {
+    Hash ^= *FileName++;
+    Hash *= 0x01000193;
+  }
+
+  return Hash;
+}
+
+/**
+  Free a directory entry index entry.
+
+  @param[in] CacheEntry  Directory cache entry pointer.
+
+**/
+STATIC
+VOID
+FreeDirectoryCacheEntry (
+  IN UDF_DIRECTORY_CACHE_ENTRY  *CacheEntry
+  )
+{
+  if (CacheEntry->DirectoryData != NULL) {
+    FreePool (CacheEntry->DirectoryData);
+  }
+
+  if (CacheEntry->Buckets != NULL) {
+    FreePool (CacheEntry->Buckets);
+  }
+
+  if (CacheEntry->Entries != NULL) {
+    FreePool (CacheEntry->Entries);
+  }
+
+  FreePool (CacheEntry);
+}
+
+/**
+  Read a directory and index its File Identifier Descriptors by file name.
+
+  @attention This is boundary function that may receive untrusted input.
+  @attention The input is from FileSystem.
+
+  @param[in]   BlockIo        BlockIo interface.
+  @param[in]   DiskIo         DiskIo interface.
+  @param[in]   Volume         UDF volume information structure.
+  @param[in]   ParentIcb      ICB of the directory.
+  @param[in]   FileEntryData  FE/EFE of the directory.
+  @param[out]  CacheEntry     The directory cache entry.
+
+  @retval EFI_SUCCESS          The directory was read and indexed.
+  @retval EFI_OUT_OF_RESOURCES The directory was not indexed due to lack of
+                               resources.
+  @retval other                The directory was not read.
+
+**/
+STATIC
+EFI_STATUS
+BuildDirectoryCacheEntry (
+  IN   EFI_BLOCK_IO_PROTOCOL           *BlockIo,
+  IN   EFI_DISK_IO_PROTOCOL            *DiskIo,
+  IN   UDF_VOLUME_INFO                 *Volume,
+  IN   UDF_LONG_ALLOCATION_DESCRIPTOR  *ParentIcb,
+  IN   VOID                            *FileEntryData,
+  OUT  UDF_DIRECTORY_CACHE_ENTRY       **CacheEntry
+  )
+{
+  EFI_STATUS                      Status;
+  UDF_READ_FILE_INFO              ReadFileInfo;
+  UDF_DIRECTORY_CACHE_ENTRY       *Entry;
+  UDF_FILE_IDENTIFIER_DESCRIPTOR  *FileIdentifierDesc;
+  UINT64                          FidOffset;
+  UINT64                          FidLength;
+  UINT32                          FidCount;
+  UINT32                          Bucket;
+  CHAR16                          FoundFileName[UDF_FILENAME_LENGTH];
+  UDF_DIRECTORY_INDEX_ENTRY       *IndexEntry;
+
+  ReadFileInfo.Flags = ReadFileAllocateAndRead;
+
+  Status = ReadFile (
+             BlockIo,
+             DiskIo,
+             Volume,
+             ParentIcb,
+             FileEntryData,
+             &ReadFileInfo
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Entry = AllocateZeroPool (sizeof (UDF_DIRECTORY_CACHE_ENTRY));
+  if (Entry == NULL) {
+    if (ReadFileInfo.FileData != NULL) {
+      FreePool (ReadFileInfo.FileData);
+    }
+
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Entry->Signature       = UDF_DIRECTORY_CACHE_SIGNATURE;
+  Entry->DirectoryData   = ReadFileInfo.FileData;
+  Entry->DirectoryLength = ReadFileInfo.ReadLength;
+  Entry->ParentFidOffset = MAX_UINT64;
+  CopyMem (&Entry->Location, &ParentIcb->ExtentLocation, sizeof (UDF_LB_ADDR));
+
+  //
+  // Count the FIDs so the index can be sized, stopping at a FID that does
+  // not fit in the recorded directory data.
+  //
+  FidCount = 0;
+  for (FidOffset = 0; FidOffset < Entry->DirectoryLength; FidOffset += FidLength) {
+    if (Entry->DirectoryLength - FidOffset < sizeof (UDF_FILE_IDENTIFIER_DESCRIPTOR)) {
+      break;
+    }
+
+    FileIdentifierDesc = GET_FID_FROM_ADS (Entry->DirectoryData, FidOffset);
+    FidLength          = GetFidDescriptorLength (FileIdentifierDesc);
+    if (FidLength > Entry->DirectoryLength - FidOffset) {
+      break;
+    }
+
+    if (FidCount == BIT31) {
+      break;
+    }
+
+    FidCount++;
+  }
+
+  Entry->BucketCount = 1;
+  while (Entry->BucketCount < FidCount) {
+    Entry->BucketCount <<= 1;
+  }
+
+  Entry->Buckets = AllocatePool (Entry->BucketCount * sizeof (UINT32));
+  if (FidCount != 0) {
+    Entry->Entries = AllocatePool (FidCount * sizeof (UDF_DIRECTORY_INDEX_ENTRY));
+  }
+
+  if ((Entry->Buckets == NULL) || ((FidCount != 0) && (Entry->Entries == NULL))) {
+    FreeDirectoryCacheEntry (Entry);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  SetMem32 (Entry->Buckets, Entry->BucketCount * sizeof (UINT32), UDF_DIRECTORY_INDEX_END);
+
+  FidOffset = 0;
+  for ( ; FidCount > 0; FidCount--, FidOffset += FidLength) {
+    FileIdentifierDesc = GET_FID_FROM_ADS (Entry->DirectoryData, FidOffset);
+    FidLength          = GetFidDescriptorLength (FileIdentifierDesc);
+
+    if ((FileIdentifierDesc->FileCharacteristics & DELETED_FILE) != 0) {
+      continue;
+    }
+
+    if ((FileIdentifierDesc->FileCharacteristics & PARENT_FILE) != 0) {
+      if (Entry->ParentFidOffset == MAX_UINT64) {
+        Entry->ParentFidOffset = FidOffset;
+      }
+
+      continue;
+    }
+
+    //
+    // A FID whose name cannot be decoded can never match a lookup.
+    //
+    Status = GetFileNameFromFid (FileIdentifierDesc, ARRAY_SIZE (FoundFileName), FoundFileName);
+    if (EFI_ERROR (Status)) {
+      continue;
+    }
+
+    IndexEntry            = &Entry->Entries[Entry->EntryCount];
+    IndexEntry->FidOffset = FidOffset;
+    IndexEntry->NameHash  = HashFileName (FoundFileName);
+
+    Bucket                 = IndexEntry->NameHash & (Entry->BucketCount - 1);
+    IndexEntry->Next       = Entry->Buckets[Bucket];
+    Entry->Buckets[Bucket] = Entry->EntryCount;
+    Entry->EntryCount++;
+  }
+
+  *CacheEntry = Entry;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the directory entry index of a directory, reading and indexing the
+  directory if it is not in the directory cache of the volume yet.
+
+  @param[in]   BlockIo        BlockIo interface.
+  @param[in]   DiskIo         DiskIo interface.
+  @param[in]   Volume         UDF volume information structure.
+  @param[in]   ParentIcb      ICB of the directory.
+  @param[in]   FileEntryData  FE/EFE of the directory.
+  @param[out]  CacheEntry     The directory cache entry.
+
+  @retval EFI_SUCCESS          The directory entry index was found or built.
+  @retval other                The directory was not read or indexed.
+
+**/
+STATIC
+EFI_STATUS
+GetDirectoryCacheEntry (
+  IN   EFI_BLOCK_IO_PROTOCOL           *BlockIo,
+  IN   EFI_DISK_IO_PROTOCOL            *DiskIo,
+  IN   UDF_VOLUME_INFO                 *Volume,
+  IN   UDF_LONG_ALLOCATION_DESCRIPTOR  *ParentIcb,
+  IN   VOID                            *FileEntryData,
+  OUT  UDF_DIRECTORY_CACHE_ENTRY       **CacheEntry
+  )
+{
+  EFI_STATUS                 Status;
+  LIST_ENTRY                 *Link;
+  UDF_DIRECTORY_CACHE_ENTRY  *Entry;
+
+  for (Link = GetFirstNode (&Volume->DirectoryCache);
+       !IsNull (&Volume->DirectoryCache, Link);
+       Link = GetNextNode (&Volume->DirectoryCache, Link))
+  {
+    Entry = UDF_DIRECTORY_CACHE_ENTRY_FROM_LINK (Link);
+    if (CompareMem (&Entry->Location, &ParentIcb->ExtentLocation, sizeof (UDF_LB_ADDR)) == 0) {
+      //
+      // Keep the most recently used directories at the head.
+      //
+      RemoveEntryList (&Entry->Link);
+      InsertHeadList (&Volume->DirectoryCache, &Entry->Link);
+      *CacheEntry = Entry;
+      return EFI_SUCCESS;
+    }
+  }
+
+  Status = BuildDirectoryCacheEntry (BlockIo, DiskIo, Volume, ParentIcb, FileEntryData, &Entry);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (Volume->DirectoryCacheCount >= UDF_DIRECTORY_CACHE_MAX_ENTRIES) {
+    Link = GetPreviousNode (&Volume->DirectoryCache, &Volume->DirectoryCache);
+    RemoveEntryList (Link);
+    FreeDirectoryCacheEntry (UDF_DIRECTORY_CACHE_ENTRY_FROM_LINK (Link));
+    Volume->DirectoryCacheCount--;
+  }
+
+  InsertHeadList (&Volume->DirectoryCache, &Entry->Link);
+  Volume->DirectoryCacheCount++;
+
+  *CacheEntry = Entry;
+
+  return EFI_SUCCESS;
+}
+
 /**
   Find a file by its filename from a given Parent file.
 
@@ -1444,7 +1797,11 @@ InternalFindFile (
 {
   EFI_STATUS                      Status;
   UDF_FILE_IDENTIFIER_DESCRIPTOR  *FileIdentifierDesc;
-  UDF_READ_DIRECTORY_INFO         ReadDirInfo;
+  UDF_DIRECTORY_CACHE_ENTRY       *DirCache;
+  UDF_DIRECTORY_INDEX_ENTRY       *IndexEntry;
+  UINT32                          NameHash;
+  UINT32                          Index;
+  UINT64                          FidOffset;
   BOOLEAN                         Found;
   CHAR16                          FoundFileName[UDF_FILENAME_LENGTH];
   VOID                            *CompareFileEntry;
@@ -1487,77 +1844,73 @@ InternalFindFile (
   }
 
   //
-  // Start directory listing.
+  // Look the name up in the directory entry index.
   //
-  ZeroMem ((VOID *)&ReadDirInfo, sizeof (UDF_READ_DIRECTORY_INFO));
-  Found = FALSE;
+  Status = GetDirectoryCacheEntry (
+             BlockIo,
+             DiskIo,
+             Volume,
+             (Parent->FileIdentifierDesc != NULL) ?
+             &Parent->FileIdentifierDesc->Icb :
+             Icb,
+             Parent->FileEntry,
+             &DirCache
+             );
+  if (EFI_ERROR (Status)) {
+    if (Status == EFI_DEVICE_ERROR) {
+      Status = EFI_NOT_FOUND;
+    }
 
-  for ( ; ;) {
-    Status = ReadDirectoryEntry (
-               BlockIo,
-               DiskIo,
-               Volume,
-               (Parent->FileIdentifierDesc != NULL) ?
-               &Parent->FileIdentifierDesc->Icb :
-               Icb,
-               Parent->FileEntry,
-               &ReadDirInfo,
-               &FileIdentifierDesc
-               );
-    if (EFI_ERROR (Status)) {
-      if (Status == EFI_DEVICE_ERROR) {
-        Status = EFI_NOT_FOUND;
-      }
+    return Status;
+  }
 
-      break;
-    }
+  Found     = FALSE;
+  FidOffset = 0;
 
+  if ((StrCmp (FileName, L"..") == 0) || (StrCmp (FileName, L"\\") == 0)) {
     //
-    // After calling function ReadDirectoryEntry(), if 'FileIdentifierDesc' is
-    // NULL, then the 'Status' must be EFI_OUT_OF_RESOURCES. Hence, if the code
-    // reaches here, 'FileIdentifierDesc' must be not NULL.
-    //
-    // The ASSERT here is for addressing a false positive NULL pointer
-    // dereference issue raised from static analysis.
+    // The parent FID contains the location (FE/EFE) of the parent directory
+    // of this directory (Parent).
     //
-    ASSERT (FileIdentifierDesc != NULL);
-
-    if (FileIdentifierDesc->FileCharacteristics & PARENT_FILE) {
-      //
-      // This FID contains the location (FE/EFE) of the parent directory of this
-      // directory (Parent), and if FileName is either ".." or "\\", then it's
-      // the expected FID.
-      //
-      if ((StrCmp (FileName, L"..") == 0) || (StrCmp (FileName, L"\\") == 0)) {
-        Found = TRUE;
-        break;
-      }
-    } else {
-      Status = GetFileNameFromFid (FileIdentifierDesc, ARRAY_SIZE (FoundFileName), FoundFileName);
-      if (EFI_ERROR (Status)) {
-        break;
+    if (DirCache->ParentFidOffset != MAX_UINT64) {
+      FidOffset = DirCache->ParentFidOffset;
+      Found     = TRUE;
+    }
+  } else {
+    NameHash = HashFileName (FileName);
+    for (Index = DirCache->Buckets[NameHash & (DirCache->BucketCount - 1)];
+         Index != UDF_DIRECTORY_INDEX_END;
+         Index = IndexEntry->Next)
+    {
+      IndexEntry = &DirCache->Entries[Index];
+      if (IndexEntry->NameHash != NameHash) {
+        continue;
       }
 
-      if (StrCmp (FileName, FoundFileName) == 0) {
-        //
-        // FID has been found. Prepare to find its respective FE/EFE.
-        //
-        Found = TRUE;
+      Status = GetFileNameFromFid (
+                 GET_FID_FROM_ADS (DirCache->DirectoryData, IndexEntry->FidOffset),
+                 ARRAY_SIZE (FoundFileName),
+                 FoundFileName
+                 );
+      if (!EFI_ERROR (Status) && (StrCmp (FileName, FoundFileName) == 0)) {
+        FidOffset = IndexEntry->FidOffset;
+        Found     = TRUE;
         break;
       }
     }
-
-    FreePool ((VOID *)FileIdentifierDesc);
   }
 
-  if (ReadDirInfo.DirectoryData != NULL) {
+  Status = EFI_NOT_FOUND;
+
+  if (Found) {
     //
-    // Free all allocated resources for the directory listing.
+    // FID has been found. Prepare to find its respective FE/EFE.
     //
-    FreePool (ReadDirInfo.DirectoryData);
-  }
+    DuplicateFid (GET_FID_FROM_ADS (DirCache->DirectoryData, FidOffset), &FileIdentifierDesc);
+    if (FileIdentifierDesc == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
 
-  if (Found) {
     Status = EFI_SUCCESS;
 
     File->FileIdentifierDesc = FileIdentifierDesc;
@@ -1838,7 +2191,8 @@ FindFile (
       if ((((UINTN)FileNamePointer - (UINTN)FileName) / sizeof (CHAR16)) >=
           (ARRAY_SIZE (FileName) - 1))
       {
-        return EFI_NOT_FOUND;
+        Status = EFI_NOT_FOUND;
+        goto Error_Find_File;
       }
 
       *FileNamePointer++ = *FilePath++;
@@ -1901,7 +2255,7 @@ FindFile (
     }
 
     if (EFI_ERROR (Status)) {
-      return Status;
+      goto Error_Find_File;
     }
 
     //
@@ -1925,7 +2279,7 @@ FindFile (
       FreePool (FileEntry);
 
       if (EFI_ERROR (Status)) {
-        return Status;
+        goto Error_Find_File;
       }
     }
 
@@ -1944,6 +2298,21 @@ FindFile (
     }
   }
 
+  return Status;
+
+Error_Find_File:
+  //
+  // Release the directory found for the previous path component, if any.
+  //
+  if (CompareMem (
+        (VOID *)&PreviousFile,
+        (VOID *)Parent,
+        sizeof (UDF_FILE_INFO)
+        ) != 0)
+  {
+    CleanupFileInformation (&PreviousFile);
+  }
+
   return Status;
 }
 
@@ -2407,6 +2776,50 @@ CleanupFileInformation (
   ZeroMem ((VOID *)File, sizeof (UDF_FILE_INFO));
 }
 
+/**
+  Clean up the in-memory extent map of an UDF file.
+
+  @param[in] ExtentMap  Extent map pointer.
+
+**/
+VOID
+CleanupFileExtentMap (
+  IN UDF_FILE_EXTENT_MAP  *ExtentMap
+  )
+{
+  if (ExtentMap->Extents != NULL) {
+    FreePool (ExtentMap->Extents);
+  }
+
+  ZeroMem ((VOID *)ExtentMap, sizeof (UDF_FILE_EXTENT_MAP));
+}
+
+/**
+  Clean up the directory cache of an UDF volume.
+
+  @param[in] Volume  UDF volume information structure.
+
+**/
+VOID
+CleanupDirectoryCache (
+  IN UDF_VOLUME_INFO  *Volume
+  )
+{
+  LIST_ENTRY  *Link;
+
+  if (Volume->DirectoryCache.ForwardLink == NULL) {
+    return;
+  }
+
+  while (!IsListEmpty (&Volume->DirectoryCache)) {
+    Link = GetFirstNode (&Volume->DirectoryCache);
+    RemoveEntryList (Link);
+    FreeDirectoryCacheEntry (UDF_DIRECTORY_CACHE_ENTRY_FROM_LINK (Link));
+  }
+
+  Volume->DirectoryCacheCount = 0;
+}
+
 /**
   Find a file from its absolute path on an UDF volume.
 
@@ -2856,6 +3269,9 @@ Out_Free:
   @param[in]      Volume        UDF volume information structure.
   @param[in]      File          File information structure.
   @param[in]      FileSize      Size of the file.
+  @param[in, out] ExtentMap     Optional extent map of the file. It is built
+                                on first use and then used to read the file
+                                data straight from the recorded extents.
   @param[in, out] FilePosition  File position.
   @param[in, out] Buffer        File data.
   @param[in, out] BufferSize    Read size.
@@ -2876,6 +3292,7 @@ ReadFileData (
   IN      UDF_VOLUME_INFO        *Volume,
   IN      UDF_FILE_INFO          *File,
   IN      UINT64                 FileSize,
+  IN OUT  UDF_FILE_EXTENT_MAP    *ExtentMap OPTIONAL,
   IN OUT  UINT64                 *FilePosition,
   IN OUT  VOID                   *Buffer,
   IN OUT  UINT64                 *BufferSize
@@ -2883,6 +3300,106 @@ ReadFileData (
 {
   EFI_STATUS          Status;
   UDF_READ_FILE_INFO  ReadFileInfo;
+  UDF_FILE_EXTENT     *Extent;
+  UINTN               Low;
+  UINTN               High;
+  UINTN               Middle;
+  UINT64              Position;
+  UINT64              BytesLeft;
+  UINT64              Offset;
+  UINT64              Length;
+  UINT8               *Data;
+
+  if ((ExtentMap != NULL) &&
+      ((GET_FE_RECORDING_FLAGS (File->FileEntry) == LongAdsSequence) ||
+       (GET_FE_RECORDING_FLAGS (File->FileEntry) == ShortAdsSequence)))
+  {
+    if (ExtentMap->Count == 0) {
+      //
+      // Walk the allocation descriptors (and AEDs) once and remember where
+      // every byte of the file lives on the disk.
+      //
+      ReadFileInfo.Flags     = ReadFileGetExtentMap;
+      ReadFileInfo.ExtentMap = ExtentMap;
+
+      Status = ReadFile (
+                 BlockIo,
+                 DiskIo,
+                 Volume,
+                 &File->FileIdentifierDesc->Icb,
+                 File->FileEntry,
+                 &ReadFileInfo
+                 );
+      if (EFI_ERROR (Status)) {
+        CleanupFileExtentMap (ExtentMap);
+      }
+    }
+
+    if (ExtentMap->Count != 0) {
+      Position = *FilePosition;
+      if (Position >= FileSize) {
+        *BufferSize = 0;
+        return EFI_SUCCESS;
+      }
+
+      if (*BufferSize > FileSize - Position) {
+        *BufferSize = FileSize - Position;
+      }
+
+      //
+      // Find the extent which holds the current file position.
+      //
+      Low  = 0;
+      High = ExtentMap->Count;
+      while (High - Low > 1) {
+        Middle = Low + (High - Low) / 2;
+        if (ExtentMap->Extents[Middle].FileOffset <= Position) {
+          Low = Middle;
+        } else {
+          High = Middle;
+        }
+      }
+
+      Data      = (UINT8 *)Buffer;
+      BytesLeft = *BufferSize;
+      for (Extent = &ExtentMap->Extents[Low];
+           BytesLeft > 0 && Extent < &ExtentMap->Extents[ExtentMap->Count];
+           Extent++)
+      {
+        if (Position >= Extent->FileOffset + Extent->Length) {
+          continue;
+        }
+
+        Offset = Position - Extent->FileOffset;
+        Length = MIN (BytesLeft, Extent->Length - Offset);
+
+        Status = DiskIo->ReadDisk (
+                           DiskIo,
+                           BlockIo->Media->MediaId,
+                           Extent->DiskOffset + Offset,
+                           (UINTN)Length,
+                           Data
+                           );
+        if (EFI_ERROR (Status)) {
+          return Status;
+        }
+
+        Data      += Length;
+        Position  += Length;
+        BytesLeft -= Length;
+      }
+
+      //
+      // On a corrupted volume the recorded extents may end before the file
+      // size. Only report the bytes that were really read.
+      //
+      *BufferSize -= BytesLeft;
+
+      *FilePosition = Position;
+
+      return EFI_SUCCESS;
+    }
+  }
 
   ReadFileInfo.Flags        = ReadFileSeekAndRead;
   ReadFileInfo.FilePosition = *FilePosition;
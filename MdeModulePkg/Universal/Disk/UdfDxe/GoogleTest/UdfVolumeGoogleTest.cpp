@@ -0,0 +1,632 @@
+/** @file
+  Tests and read/lookup benchmark for UdfDxe over a generated UDF 2.50 volume.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+#include <chrono>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/MemoryAllocationLib.h>
+  #include <Library/PrintLib.h>
+  #include "../Udf.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define TEST_BLOCK_SIZE  2048
+
+//
+// The volume is the logical partition the Partition driver installs for an
+// UDF volume: it starts at the Main Volume Descriptor Sequence, so the
+// sequence is at LBA 0 and the Anchor Volume Descriptor Pointer at LBA 256.
+//
+#define TEST_MAIN_VDS_LOCATION  32
+#define TEST_AVDP_LBA           256
+#define TEST_PARTITION_LBA      512
+
+//
+// Partition layout, in logical blocks: the File Set Descriptor, the File
+// Entries of the root directory and of every file, the root directory data,
+// then the extents of the large file. Each large file extent is followed by
+// an unused block so that no two extents are adjacent on the medium.
+//
+#define TEST_FSD_LBN        0
+#define TEST_ROOT_FE_LBN    1
+#define TEST_LARGE_FE_LBN   2
+#define TEST_SMALL_FE_LBN   3
+#define TEST_SMALL_COUNT    4096
+#define TEST_LARGE_SIZE     SIZE_16MB
+#define TEST_EXTENT_SIZE    SIZE_128KB
+#define TEST_EXTENT_COUNT   (TEST_LARGE_SIZE / TEST_EXTENT_SIZE)
+#define TEST_EXTENT_BLOCKS  (TEST_EXTENT_SIZE / TEST_BLOCK_SIZE)
+#define TEST_LARGE_NAME     "LARGE.BIN"
+
+#define TEST_BENCH_SMALL_IO  SIZE_4KB
+#define TEST_BENCH_LARGE_IO  SIZE_1MB
+
+////////////////////////////////////////////////////////////////////////
+// Test Block IO and Disk IO
+////////////////////////////////////////////////////////////////////////
+
+//
+// The generated volume, and the reads made from it.
+//
+STATIC UINT8               *mImage;
+STATIC UINTN               mImageSize;
+STATIC UINT32              mDirectoryLbn;
+STATIC UINT32              mDirectoryLength;
+STATIC UINT32              mLargeLbn;
+STATIC EFI_BLOCK_IO_MEDIA  mMedia;
+STATIC UINTN               mDiskIoCount;
+STATIC UINT64              mDiskIoBytes;
+
+STATIC
+EFI_STATUS
+EFIAPI
+TestReadBlocks (
+  IN  EFI_BLOCK_IO_PROTOCOL  *This,
+  IN  UINT32                 MediaId,
+  IN  EFI_LBA                Lba,
+  IN  UINTN                  BufferSize,
+  OUT VOID                   *Buffer
+  )
+{
+  if ((MediaId != mMedia.MediaId) || (BufferSize % mMedia.BlockSize != 0) ||
+      (Lba * mMedia.BlockSize + BufferSize > mImageSize))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  CopyMem (Buffer, mImage + Lba * mMedia.BlockSize, BufferSize);
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TestReadDisk (
+  IN  EFI_DISK_IO_PROTOCOL  *This,
+  IN  UINT32                MediaId,
+  IN  UINT64                Offset,
+  IN  UINTN                 BufferSize,
+  OUT VOID                  *Buffer
+  )
+{
+  if ((MediaId != mMedia.MediaId) || (Offset > mImageSize) ||
+      (BufferSize > mImageSize - Offset))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  mDiskIoCount++;
+  mDiskIoBytes += BufferSize;
+  CopyMem (Buffer, mImage + Offset, BufferSize);
+  return EFI_SUCCESS;
+}
+
+STATIC EFI_BLOCK_IO_PROTOCOL  mBlockIo = {
+  EFI_BLOCK_IO_PROTOCOL_REVISION,
+  &mMedia,
+  NULL,
+  TestReadBlocks,
+  NULL,
+  NULL
+};
+
+STATIC EFI_DISK_IO_PROTOCOL  mDiskIo = {
+  EFI_DISK_IO_PROTOCOL_REVISION,
+  TestReadDisk,
+  NULL
+};
+
+////////////////////////////////////////////////////////////////////////
+// UDF 2.50 volume
+////////////////////////////////////////////////////////////////////////
+
+STATIC
+UINT8 *
+PartitionBlock (
+  UINT32  Lbn
+  )
+{
+  return mImage + (UINTN)(TEST_PARTITION_LBA + Lbn) * TEST_BLOCK_SIZE;
+}
+
+STATIC
+VOID
+SetTag (
+  VOID    *Descriptor,
+  UINT16  TagIdentifier,
+  UINT32  TagLocation
+  )
+{
+  UDF_DESCRIPTOR_TAG  *Tag;
+
+  Tag                    = (UDF_DESCRIPTOR_TAG *)Descriptor;
+  Tag->TagIdentifier     = TagIdentifier;
+  Tag->DescriptorVersion = 3;
+  Tag->TagLocation       = TagLocation;
+}
+
+STATIC
+VOID
+SetLongAd (
+  UDF_LONG_ALLOCATION_DESCRIPTOR  *LongAd,
+  UINT32                          Length,
+  UINT32                          Lbn
+  )
+{
+  LongAd->ExtentLength                            = Length;
+  LongAd->ExtentLocation.LogicalBlockNumber       = Lbn;
+  LongAd->ExtentLocation.PartitionReferenceNumber = 0;
+}
+
+//
+// Content of the large file at Offset.
+//
+STATIC
+UINT8
+LargeFileByte (
+  UINT64  Offset
+  )
+{
+  return (UINT8)(Offset ^ (Offset >> 8) ^ (Offset >> 16));
+}
+
+//
+// Record a File Entry at Lbn. Small files keep their content inline.
+//
+STATIC
+UDF_FILE_ENTRY *
+WriteFileEntry (
+  UINT32  Lbn,
+  UINT8   FileType,
+  UINT16  RecordingFlags,
+  UINT64  InformationLength
+  )
+{
+  UDF_FILE_ENTRY  *FileEntry;
+
+  FileEntry = (UDF_FILE_ENTRY *)PartitionBlock (Lbn);
+  SetTag (FileEntry, UdfFileEntry, Lbn);
+  FileEntry->IcbTag.StrategyType           = 4;
+  FileEntry->IcbTag.MaximumNumberOfEntries = 1;
+  FileEntry->IcbTag.FileType               = FileType;
+  FileEntry->IcbTag.Flags                  = RecordingFlags;
+  FileEntry->FileLinkCount                 = 1;
+  FileEntry->InformationLength             = InformationLength;
+  FileEntry->UniqueId                      = Lbn;
+  return FileEntry;
+}
+
+//
+// Record a File Identifier Descriptor with an 8 bit OSTA CS0 name at Data.
+//
+STATIC
+UINT32
+WriteFid (
+  UINT8        *Data,
+  UINT8        FileCharacteristics,
+  CONST CHAR8  *Name,
+  UINT32       Lbn
+  )
+{
+  UDF_FILE_IDENTIFIER_DESCRIPTOR  *Fid;
+  UINTN                           NameLength;
+
+  Fid = (UDF_FILE_IDENTIFIER_DESCRIPTOR *)Data;
+  SetTag (Fid, UdfFileIdentifierDescriptor, mDirectoryLbn);
+  Fid->FileVersionNumber   = 1;
+  Fid->FileCharacteristics = FileCharacteristics;
+  SetLongAd (&Fid->Icb, TEST_BLOCK_SIZE, Lbn);
+
+  NameLength = AsciiStrLen (Name);
+  if (NameLength != 0) {
+    Fid->Data[0] = 8;
+    CopyMem (&Fid->Data[1], Name, NameLength);
+    Fid->LengthOfFileIdentifier = (UINT8)(NameLength + 1);
+  }
+
+  return ALIGN_VALUE (OFFSET_OF (UDF_FILE_IDENTIFIER_DESCRIPTOR, Data) + Fid->LengthOfFileIdentifier, 4);
+}
+
+STATIC
+VOID
+SmallFileName (
+  UINTN  Index,
+  CHAR8  *Name,
+  UINTN  Size
+  )
+{
+  AsciiSPrint (Name, Size, "FILE%05u.TXT", (UINT32)Index);
+}
+
+STATIC
+VOID
+SmallFileContent (
+  UINTN  Index,
+  CHAR8  *Content,
+  UINTN  Size
+  )
+{
+  AsciiSPrint (Content, Size, "Content of file %u\n", (UINT32)Index);
+}
+
+//
+// Generate the volume: a single Type 1 partition map with UDF 2.50 domain,
+// a root directory holding TEST_SMALL_COUNT small files and a large file of
+// TEST_EXTENT_COUNT extents.
+//
+STATIC
+VOID
+BuildVolume (
+  VOID
+  )
+{
+  UDF_ANCHOR_VOLUME_DESCRIPTOR_POINTER  *Anchor;
+  UDF_PARTITION_DESCRIPTOR              *PartitionDesc;
+  UDF_LOGICAL_VOLUME_DESCRIPTOR         *LogicalVolDesc;
+  UDF_FILE_SET_DESCRIPTOR               *FileSetDesc;
+  UDF_FILE_ENTRY                        *FileEntry;
+  UDF_SHORT_ALLOCATION_DESCRIPTOR       *ShortAd;
+  UINT8                                 *Directory;
+  UINT32                                Offset;
+  UINT32                                PartitionLength;
+  UINTN                                 Index;
+  UINT64                                Position;
+  UINT8                                 *Extent;
+  CHAR8                                 Name[16];
+  CHAR8                                 Content[32];
+
+  //
+  // The root directory holds the parent FID, then the FIDs of the large file
+  // and of the small files. A FID takes 38 bytes plus its name, rounded up to
+  // 4 bytes.
+  //
+  mDirectoryLength = 40 + 48 + TEST_SMALL_COUNT * 52;
+  mDirectoryLbn    = TEST_SMALL_FE_LBN + TEST_SMALL_COUNT;
+  mLargeLbn        = mDirectoryLbn + ALIGN_VALUE (mDirectoryLength, TEST_BLOCK_SIZE) / TEST_BLOCK_SIZE;
+  PartitionLength  = mLargeLbn + TEST_EXTENT_COUNT * (TEST_EXTENT_BLOCKS + 1);
+
+  mImageSize = (UINTN)(TEST_PARTITION_LBA + PartitionLength) * TEST_BLOCK_SIZE;
+  mImage     = (UINT8 *)AllocateZeroPool (mImageSize);
+  ASSERT (mImage != NULL);
+
+  mMedia.MediaId      = 1;
+  mMedia.MediaPresent = TRUE;
+  mMedia.ReadOnly     = TRUE;
+  mMedia.BlockSize    = TEST_BLOCK_SIZE;
+  mMedia.LastBlock    = mImageSize / TEST_BLOCK_SIZE - 1;
+
+  //
+  // Main Volume Descriptor Sequence
+  //
+  PartitionDesc = (UDF_PARTITION_DESCRIPTOR *)(mImage + 0 * TEST_BLOCK_SIZE);
+  SetTag (PartitionDesc, UdfPartitionDescriptor, TEST_MAIN_VDS_LOCATION + 0);
+  PartitionDesc->VolumeDescriptorSequenceNumber = 1;
+  PartitionDesc->PartitionFlags                 = 1;
+  PartitionDesc->PartitionNumber                = 0;
+  PartitionDesc->AccessType                     = 1;
+  PartitionDesc->PartitionStartingLocation      = TEST_MAIN_VDS_LOCATION + TEST_PARTITION_LBA;
+  PartitionDesc->PartitionLength                = PartitionLength;
+
+  LogicalVolDesc = (UDF_LOGICAL_VOLUME_DESCRIPTOR *)(mImage + 1 * TEST_BLOCK_SIZE);
+  SetTag (LogicalVolDesc, UdfLogicalVolumeDescriptor, TEST_MAIN_VDS_LOCATION + 1);
+  LogicalVolDesc->VolumeDescriptorSequenceNumber             = 2;
+  LogicalVolDesc->LogicalBlockSize                           = TEST_BLOCK_SIZE;
+  LogicalVolDesc->DomainIdentifier.Suffix.Domain.UdfRevision = 0x0250;
+  SetLongAd (&LogicalVolDesc->LogicalVolumeContentsUse, TEST_BLOCK_SIZE, TEST_FSD_LBN);
+  //
+  // A Type 1 Partition Map for partition 0 of volume 1
+  //
+  LogicalVolDesc->MapTableLength        = 6;
+  LogicalVolDesc->NumberOfPartitionMaps = 1;
+  LogicalVolDesc->PartitionMaps[0]      = 1;
+  LogicalVolDesc->PartitionMaps[1]      = 6;
+  LogicalVolDesc->PartitionMaps[2]      = 1;
+
+  SetTag (mImage + 2 * TEST_BLOCK_SIZE, UdfTerminatingDescriptor, TEST_MAIN_VDS_LOCATION + 2);
+
+  Anchor = (UDF_ANCHOR_VOLUME_DESCRIPTOR_POINTER *)(mImage + TEST_AVDP_LBA * TEST_BLOCK_SIZE);
+  SetTag (Anchor, UdfAnchorVolumeDescriptorPointer, TEST_MAIN_VDS_LOCATION + TEST_AVDP_LBA);
+  Anchor->MainVolumeDescriptorSequenceExtent.ExtentLength   = 16 * TEST_BLOCK_SIZE;
+  Anchor->MainVolumeDescriptorSequenceExtent.ExtentLocation = TEST_MAIN_VDS_LOCATION;
+
+  //
+  // File Set Descriptor
+  //
+  FileSetDesc = (UDF_FILE_SET_DESCRIPTOR *)PartitionBlock (TEST_FSD_LBN);
+  SetTag (FileSetDesc, UdfFileSetDescriptor, TEST_FSD_LBN);
+  FileSetDesc->InterchangeLevel = 3;
+  SetLongAd (&FileSetDesc->RootDirectoryIcb, TEST_BLOCK_SIZE, TEST_ROOT_FE_LBN);
+
+  //
+  // Root directory
+  //
+  FileEntry = WriteFileEntry (TEST_ROOT_FE_LBN, UdfFileEntryDirectory, ShortAdsSequence, mDirectoryLength);
+  FileEntry->LengthOfAllocationDescriptors = sizeof (UDF_SHORT_ALLOCATION_DESCRIPTOR);
+  ShortAd                                  = (UDF_SHORT_ALLOCATION_DESCRIPTOR *)FileEntry->Data;
+  ShortAd->ExtentLength                    = mDirectoryLength;
+  ShortAd->ExtentPosition                  = mDirectoryLbn;
+
+  Directory = PartitionBlock (mDirectoryLbn);
+  Offset    = WriteFid (Directory, DIRECTORY_FILE | PARENT_FILE, "", TEST_ROOT_FE_LBN);
+  Offset   += WriteFid (Directory + Offset, 0, TEST_LARGE_NAME, TEST_LARGE_FE_LBN);
+  for (Index = 0; Index < TEST_SMALL_COUNT; Index++) {
+    SmallFileName (Index, Name, sizeof (Name));
+    Offset += WriteFid (Directory + Offset, 0, Name, (UINT32)(TEST_SMALL_FE_LBN + Index));
+
+    SmallFileContent (Index, Content, sizeof (Content));
+    FileEntry = WriteFileEntry (
+                  (UINT32)(TEST_SMALL_FE_LBN + Index),
+                  UdfFileEntryStandardFile,
+                  InlineData,
+                  AsciiStrLen (Content)
+                  );
+    FileEntry->LengthOfAllocationDescriptors = (UINT32)AsciiStrLen (Content);
+    CopyMem (FileEntry->Data, Content, AsciiStrLen (Content));
+  }
+
+  ASSERT (Offset == mDirectoryLength);
+
+  //
+  // Large file
+  //
+  FileEntry = WriteFileEntry (TEST_LARGE_FE_LBN, UdfFileEntryStandardFile, ShortAdsSequence, TEST_LARGE_SIZE);
+  FileEntry->LengthOfAllocationDescriptors = TEST_EXTENT_COUNT * sizeof (UDF_SHORT_ALLOCATION_DESCRIPTOR);
+  ShortAd                                  = (UDF_SHORT_ALLOCATION_DESCRIPTOR *)FileEntry->Data;
+  Position                                 = 0;
+  for (Index = 0; Index < TEST_EXTENT_COUNT; Index++) {
+    ShortAd[Index].ExtentLength   = TEST_EXTENT_SIZE;
+    ShortAd[Index].ExtentPosition = (UINT32)(mLargeLbn + Index * (TEST_EXTENT_BLOCKS + 1));
+
+    Extent = PartitionBlock (ShortAd[Index].ExtentPosition);
+    for (Offset = 0; Offset < TEST_EXTENT_SIZE; Offset++, Position++) {
+      Extent[Offset] = LargeFileByte (Position);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+// Volume Tests
+////////////////////////////////////////////////////////////////////////
+
+class UdfVolumeTest : public ::testing::Test {
+protected:
+  PRIVATE_UDF_SIMPLE_FS_DATA FsData;
+  EFI_FILE_PROTOCOL *Root;
+
+  static void
+  SetUpTestSuite (
+    )
+  {
+    BuildVolume ();
+  }
+
+  static void
+  TearDownTestSuite (
+    )
+  {
+    FreePool (mImage);
+    mImage = NULL;
+  }
+
+  //
+  // Mount the volume the way UdfDriverBindingStart() does.
+  //
+  void
+  SetUp (
+    ) override
+  {
+    ZeroMem (&FsData, sizeof (FsData));
+    FsData.Signature           = PRIVATE_UDF_SIMPLE_FS_DATA_SIGNATURE;
+    FsData.BlockIo             = &mBlockIo;
+    FsData.DiskIo              = &mDiskIo;
+    FsData.SimpleFs.Revision   = EFI_SIMPLE_FILE_SYSTEM_PROTOCOL_REVISION;
+    FsData.SimpleFs.OpenVolume = UdfOpenVolume;
+    InitializeListHead (&FsData.Volume.DirectoryCache);
+
+    ASSERT_EQ (FsData.SimpleFs.OpenVolume (&FsData.SimpleFs, &Root), EFI_SUCCESS);
+  }
+
+  void
+  TearDown (
+    ) override
+  {
+    Root->Close (Root);
+    CleanupFileInformation (&FsData.Root);
+    CleanupDirectoryCache (&FsData.Volume);
+  }
+
+  //
+  // Read the whole large file in chunks of IoSize bytes, checking its content.
+  // Return the time taken by the reads, in microseconds.
+  //
+  UINT64
+  ReadLargeFile (
+    UINTN  IoSize
+    )
+  {
+    EFI_FILE_PROTOCOL  *File;
+    UINT8              *Buffer;
+    UINTN              Size;
+    UINT64             Position;
+    UINTN              Index;
+    BOOLEAN            Match;
+
+    std::chrono::steady_clock::duration  Elapsed;
+
+    Buffer = (UINT8 *)AllocatePool (IoSize);
+    EXPECT_NE (Buffer, nullptr);
+    EXPECT_EQ (Root->Open (Root, &File, (CHAR16 *)L"\\" TEST_LARGE_NAME, EFI_FILE_MODE_READ, 0), EFI_SUCCESS);
+
+    mDiskIoCount = 0;
+    mDiskIoBytes = 0;
+    Position     = 0;
+    Match        = TRUE;
+    Elapsed      = std::chrono::steady_clock::duration::zero ();
+
+    do {
+      Size = IoSize;
+
+      auto  Start = std::chrono::steady_clock::now ();
+
+      EXPECT_EQ (File->Read (File, &Size, Buffer), EFI_SUCCESS);
+
+      auto  End = std::chrono::steady_clock::now ();
+
+      Elapsed += End - Start;
+      for (Index = 0; Index < Size; Index++, Position++) {
+        Match &= (Buffer[Index] == LargeFileByte (Position));
+      }
+    } while (Size != 0);
+
+    EXPECT_TRUE (Match);
+    EXPECT_EQ (Position, (UINT64)TEST_LARGE_SIZE);
+    File->Close (File);
+    FreePool (Buffer);
+    return std::chrono::duration_cast<std::chrono::microseconds>(Elapsed).count ();
+  }
+};
+
+//
+// Every file can be found by name, through a directory listing and read.
+//
+TEST_F (UdfVolumeTest, FilesShouldBeFoundAndRead) {
+  EFI_FILE_PROTOCOL  *File;
+  UINTN              Index;
+  UINTN              Size;
+  CHAR8              Name[16];
+  CHAR16             FileName[16];
+  CHAR8              Content[32];
+  CHAR8              Buffer[32];
+  UINT8              InfoBuffer[sizeof (EFI_FILE_INFO) + sizeof (FileName)];
+  EFI_FILE_INFO      *Info;
+
+  for (Index = 0; Index < TEST_SMALL_COUNT; Index++) {
+    SmallFileName (Index, Name, sizeof (Name));
+    AsciiStrToUnicodeStrS (Name, FileName, ARRAY_SIZE (FileName));
+    ASSERT_EQ (Root->Open (Root, &File, FileName, EFI_FILE_MODE_READ, 0), EFI_SUCCESS);
+
+    SmallFileContent (Index, Content, sizeof (Content));
+    Size = sizeof (Buffer);
+    ASSERT_EQ (File->Read (File, &Size, Buffer), EFI_SUCCESS);
+    ASSERT_EQ (Size, AsciiStrLen (Content));
+    ASSERT_EQ (CompareMem (Buffer, Content, Size), 0);
+    File->Close (File);
+  }
+
+  EXPECT_EQ (Root->Open (Root, &File, (CHAR16 *)L"FILE99999.TXT", EFI_FILE_MODE_READ, 0), EFI_NOT_FOUND);
+
+  Info = (EFI_FILE_INFO *)InfoBuffer;
+  Size = sizeof (InfoBuffer);
+  ASSERT_EQ (Root->Read (Root, &Size, Info), EFI_SUCCESS);
+  EXPECT_EQ (StrCmp (Info->FileName, (CHAR16 *)L"" TEST_LARGE_NAME), 0);
+  EXPECT_EQ (Info->FileSize, (UINT64)TEST_LARGE_SIZE);
+
+  for (Index = 0; Index < TEST_SMALL_COUNT; Index++) {
+    Size = sizeof (InfoBuffer);
+    ASSERT_EQ (Root->Read (Root, &Size, Info), EFI_SUCCESS);
+    SmallFileName (Index, Name, sizeof (Name));
+    AsciiStrToUnicodeStrS (Name, FileName, ARRAY_SIZE (FileName));
+    ASSERT_EQ (StrCmp (Info->FileName, FileName), 0);
+  }
+
+  Size = sizeof (InfoBuffer);
+  EXPECT_EQ (Root->Read (Root, &Size, Info), EFI_SUCCESS);
+  EXPECT_EQ (Size, (UINTN)0);
+}
+
+//
+// Reads at any position, including the first byte of an extent, return the
+// data of the right extents.
+//
+TEST_F (UdfVolumeTest, ReadsShouldCrossExtents) {
+  EFI_FILE_PROTOCOL  *File;
+  UINT8              *Buffer;
+  UINTN              Size;
+  UINT64             Position;
+  UINTN              Index;
+  UINT64             Positions[] = {
+    0,
+    TEST_EXTENT_SIZE - 1,
+    2 * TEST_EXTENT_SIZE,
+    3 * TEST_EXTENT_SIZE - 100,
+    TEST_LARGE_SIZE - TEST_EXTENT_SIZE - 1,
+    TEST_LARGE_SIZE - 10
+  };
+
+  Buffer = (UINT8 *)AllocatePool (3 * TEST_EXTENT_SIZE);
+  ASSERT_NE (Buffer, nullptr);
+  ASSERT_EQ (Root->Open (Root, &File, (CHAR16 *)L"" TEST_LARGE_NAME, EFI_FILE_MODE_READ, 0), EFI_SUCCESS);
+
+  for (Index = ARRAY_SIZE (Positions); Index > 0; Index--) {
+    ASSERT_EQ (File->SetPosition (File, Positions[Index - 1]), EFI_SUCCESS);
+    Size = 3 * TEST_EXTENT_SIZE;
+    ASSERT_EQ (File->Read (File, &Size, Buffer), EFI_SUCCESS);
+    ASSERT_EQ ((UINT64)Size, MIN (3 * TEST_EXTENT_SIZE, TEST_LARGE_SIZE - Positions[Index - 1]));
+    for (Position = 0; Position < Size; Position++) {
+      ASSERT_EQ (Buffer[Position], LargeFileByte (Positions[Index - 1] + Position));
+    }
+  }
+
+  File->Close (File);
+  FreePool (Buffer);
+}
+
+//
+// Look every file of the root directory up, then read the large file with
+// small and large reads.
+//
+TEST_F (UdfVolumeTest, ReadLookupBenchmark) {
+  EFI_FILE_PROTOCOL  *File;
+  UINTN              Index;
+  CHAR16             FileName[16];
+  UINT64             LookupUs;
+  UINTN              LookupCount;
+  UINT64             LookupBytes;
+  UINT64             SmallUs;
+  UINTN              SmallCount;
+  UINT64             LargeUs;
+  UINTN              LargeCount;
+
+  mDiskIoCount = 0;
+  mDiskIoBytes = 0;
+
+  auto  Start = std::chrono::steady_clock::now ();
+
+  for (Index = 0; Index < TEST_SMALL_COUNT; Index++) {
+    UnicodeSPrint (FileName, sizeof (FileName), (CHAR16 *)L"\\FILE%05u.TXT", (UINT32)Index);
+    ASSERT_EQ (Root->Open (Root, &File, FileName, EFI_FILE_MODE_READ, 0), EFI_SUCCESS);
+    File->Close (File);
+  }
+
+  auto  End = std::chrono::steady_clock::now ();
+
+  LookupUs    = std::chrono::duration_cast<std::chrono::microseconds>(End - Start).count ();
+  LookupCount = mDiskIoCount;
+  LookupBytes = mDiskIoBytes;
+
+  SmallUs    = ReadLargeFile (TEST_BENCH_SMALL_IO);
+  SmallCount = mDiskIoCount;
+  LargeUs    = ReadLargeFile (TEST_BENCH_LARGE_IO);
+  LargeCount = mDiskIoCount;
+
+  RecordProperty ("LookupDiskRequests", (int)LookupCount);
+  RecordProperty ("LookupDiskBytes", (int)LookupBytes);
+  RecordProperty ("LookupUsec", (int)LookupUs);
+  RecordProperty ("SmallReadDiskRequests", (int)SmallCount);
+  RecordProperty ("SmallReadUsec", (int)SmallUs);
+  RecordProperty ("LargeReadDiskRequests", (int)LargeCount);
+  RecordProperty ("LargeReadUsec", (int)LargeUs);
+  std::cout << "[ BENCH    ] " << TEST_SMALL_COUNT << " lookups: " << LookupCount << " disk requests, "
+            << LookupBytes << " bytes, " << LookupUs << " us\n";
+  std::cout << "[ BENCH    ] 16MB in 4KB reads: " << SmallCount << " disk requests, " << SmallUs << " us\n";
+  std::cout << "[ BENCH    ] 16MB in 1MB reads: " << LargeCount << " disk requests, " << LargeUs << " us\n";
+}
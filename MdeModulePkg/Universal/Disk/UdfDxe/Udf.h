@@ -133,8 +133,26 @@ typedef enum {
   ReadFileGetFileSize,
   ReadFileAllocateAndRead,
   ReadFileSeekAndRead,
+  ReadFileGetExtentMap,
 } UDF_READ_FILE_FLAGS;
 
+//
+// A run of a file's recorded data that is contiguous both in the file and on
+// the medium. Adjacent allocation descriptors that are also adjacent on the
+// medium are merged into a single run.
+//
+typedef struct {
+  UINT64    FileOffset;
+  UINT64    DiskOffset;
+  UINT64    Length;
+} UDF_FILE_EXTENT;
+
+typedef struct {
+  UDF_FILE_EXTENT    *Extents;
+  UINTN              Count;
+  UINTN              Capacity;
+} UDF_FILE_EXTENT_MAP;
+
 typedef struct {
   VOID                   *FileData;
   UDF_READ_FILE_FLAGS    Flags;
@@ -142,6 +160,7 @@ typedef struct {
   UINT64                 FilePosition;
   UINT64                 FileSize;
   UINT64                 ReadLength;
+  UDF_FILE_EXTENT_MAP    *ExtentMap;
 } UDF_READ_FILE_INFO;
 
 #pragma pack(1)
@@ -308,6 +327,37 @@ typedef struct {
 
 #pragma pack()
 
+//
+// Directory entry index. Each directory whose entries were looked up keeps
+// its recorded data, plus a hash table of the decoded file names, so later
+// lookups in the same directory neither re-read the directory nor decode
+// every File Identifier Descriptor again.
+//
+#define UDF_DIRECTORY_CACHE_SIGNATURE    SIGNATURE_32 ('U', 'd', 'f', 'd')
+#define UDF_DIRECTORY_CACHE_MAX_ENTRIES  32
+#define UDF_DIRECTORY_INDEX_END          MAX_UINT32
+
+typedef struct {
+  UINT64    FidOffset;
+  UINT32    NameHash;
+  UINT32    Next;
+} UDF_DIRECTORY_INDEX_ENTRY;
+
+typedef struct {
+  UINT32                       Signature;
+  LIST_ENTRY                   Link;
+  UDF_LB_ADDR                  Location;
+  VOID                         *DirectoryData;
+  UINT64                       DirectoryLength;
+  UINT64                       ParentFidOffset;
+  UINT32                       *Buckets;
+  UINT32                       BucketCount;
+  UDF_DIRECTORY_INDEX_ENTRY    *Entries;
+  UINT32                       EntryCount;
+} UDF_DIRECTORY_CACHE_ENTRY;
+
+#define UDF_DIRECTORY_CACHE_ENTRY_FROM_LINK(a)  CR (a, UDF_DIRECTORY_CACHE_ENTRY, Link, UDF_DIRECTORY_CACHE_SIGNATURE)
+
 //
 // UDF filesystem driver's private data
 //
@@ -317,6 +367,8 @@ typedef struct {
   UDF_PARTITION_DESCRIPTOR         PartitionDesc;
   UDF_FILE_SET_DESCRIPTOR          FileSetDesc;
   UINTN                            FileEntrySize;
+  LIST_ENTRY                       DirectoryCache;
+  UINTN                            DirectoryCacheCount;
 } UDF_VOLUME_INFO;
 
 typedef struct {
@@ -352,6 +404,7 @@ typedef struct {
   CHAR16                             FileName[UDF_FILENAME_LENGTH];
   UINT64                             FileSize;
   UINT64                             FilePosition;
+  UDF_FILE_EXTENT_MAP                ExtentMap;
 } PRIVATE_UDF_FILE_DATA;
 
 #define PRIVATE_UDF_SIMPLE_FS_DATA_SIGNATURE  SIGNATURE_32 ('U', 'd', 'f', 's')
@@ -840,6 +893,28 @@ CleanupFileInformation (
   IN UDF_FILE_INFO  *File
   );
 
+/**
+  Clean up the cached extent map of a file.
+
+  @param[in] ExtentMap Extent map pointer.
+
+**/
+VOID
+CleanupFileExtentMap (
+  IN UDF_FILE_EXTENT_MAP  *ExtentMap
+  );
+
+/**
+  Clean up the directory entry index of a volume.
+
+  @param[in] Volume UDF volume information structure.
+
+**/
+VOID
+CleanupDirectoryCache (
+  IN UDF_VOLUME_INFO  *Volume
+  );
+
 /**
   Find a file from its absolute path on an UDF volume.
 
@@ -961,6 +1036,8 @@ GetVolumeSize (
   @param[in]      Volume        UDF volume information structure.
   @param[in]      File          File information structure.
   @param[in]      FileSize      Size of the file.
+  @param[in, out] ExtentMap     Optional extent map of the file. It is built
+                                on the first read and reused afterwards.
   @param[in, out] FilePosition  File position.
   @param[in, out] Buffer        File data.
   @param[in, out] BufferSize    Read size.
@@ -981,6 +1058,7 @@ ReadFileData (
   IN      UDF_VOLUME_INFO        *Volume,
   IN      UDF_FILE_INFO          *File,
   IN      UINT64                 FileSize,
+  IN OUT  UDF_FILE_EXTENT_MAP    *ExtentMap OPTIONAL,
   IN OUT  UINT64                 *FilePosition,
   IN OUT  VOID                   *Buffer,
   IN OUT  UINT64                 *BufferSize
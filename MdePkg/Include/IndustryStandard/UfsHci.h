@@ -66,6 +66,36 @@
 // UMA Register Offsets
 //
 #define UFS_HC_UMA_OFFSET  0x00b0          // Reserved for Unified Memory Extension
+//
+// UFSHCI 4.0 Multi-Circular Queue (MCQ) Register Offsets
+//
+#define UFS_HC_MCQCAP_OFFSET     0x001c    // Multi-Circular Queue Capability
+#define UFS_HC_CONFIG_OFFSET     0x0300    // Global Configuration
+#define UFS_HC_MCQCONFIG_OFFSET  0x0380    // Multi-Circular Queue Configuration
+//
+// MCQ Queue Configuration Register Offsets, relative to the configuration
+// block of queue n at (MCQCAP.QCFGPTR * 0x200) + (n * 0x40)
+//
+#define UFS_HC_SQATTR_OFFSET  0x0000       // Submission Queue Attribute
+#define UFS_HC_SQLBA_OFFSET   0x0004       // Submission Queue Lower Base Address
+#define UFS_HC_SQUBA_OFFSET   0x0008       // Submission Queue Upper Base Address
+#define UFS_HC_SQDAO_OFFSET   0x000c       // Submission Queue Doorbell Address Offset
+#define UFS_HC_SQISAO_OFFSET  0x0010       // Submission Queue Interrupt Status Address Offset
+#define UFS_HC_CQATTR_OFFSET  0x0020       // Completion Queue Attribute
+#define UFS_HC_CQLBA_OFFSET   0x0024       // Completion Queue Lower Base Address
+#define UFS_HC_CQUBA_OFFSET   0x0028       // Completion Queue Upper Base Address
+#define UFS_HC_CQDAO_OFFSET   0x002c       // Completion Queue Doorbell Address Offset
+#define UFS_HC_CQISAO_OFFSET  0x0030       // Completion Queue Interrupt Status Address Offset
+//
+// MCQ Operation and Runtime Register Offsets, relative to SQDAO/CQDAO
+//
+#define UFS_HC_SQHP_OFFSET   0x0000        // Submission Queue Head Pointer
+#define UFS_HC_SQTP_OFFSET   0x0004        // Submission Queue Tail Pointer
+#define UFS_HC_SQRTC_OFFSET  0x0008        // Submission Queue Run Time Command
+#define UFS_HC_SQCTI_OFFSET  0x000c        // Submission Queue Cleanup Task Identifier
+#define UFS_HC_SQRTS_OFFSET  0x0010        // Submission Queue Run Time Status
+#define UFS_HC_CQHP_OFFSET   0x0000        // Completion Queue Head Pointer
+#define UFS_HC_CQTP_OFFSET   0x0004        // Completion Queue Tail Pointer
 
 #define UFS_HC_HCE_EN      BIT0
 #define UFS_HC_HCS_DP      BIT0
@@ -78,6 +108,24 @@
 #define UFS_HC_UTMRLRSR    BIT0
 #define UFS_HC_UTRLRSR     BIT0
 
+#define UFS_HC_CAP_LSDBS            BIT29
+#define UFS_HC_CAP_MCQS             BIT30
+#define UFS_HC_MCQCAP_MAXQ          0x000000FF
+#define UFS_HC_MCQCAP_QCFGPTR       0x00FF0000
+#define UFS_HC_MCQCAP_QCFGPTR_UNIT  0x200
+#define UFS_HC_MCQ_QCFG_SIZE        0x40
+#define UFS_HC_CONFIG_QT            BIT0
+#define UFS_HC_MCQCONFIG_MAC        0x0001FF00
+#define UFS_HC_QATTR_EN             BIT31
+#define UFS_HC_QATTR_SIZE           0x0000FFFF
+#define UFS_HC_SQATTR_CQID_SHIFT    16
+#define UFS_HC_SQRTC_START          0
+#define UFS_HC_SQRTC_STOP           BIT0
+#define UFS_HC_SQRTC_ICU            BIT1
+#define UFS_HC_SQRTS_SQSTS          BIT0
+#define UFS_HC_SQRTS_CUS            BIT1
+#define UFS_HC_SQCTI_LUN_SHIFT      8
+
 //
 // The initial value of the OCS field of UTP TRD or TMRD descriptor
 // defined in JEDEC JESD223 specification
@@ -458,6 +506,45 @@ typedef struct {
   UINT16    PrdtO;            /* PRDT Offset */
 } UTP_TRD;
 
+//
+// UFSHCI 4.0 Spec - Completion Queue Entry
+//
+typedef struct {
+  //
+  // DW0
+  //
+  UINT32    Rsvd1 : 7;
+  UINT32    UcdBa : 25;       /* UTP Command Descriptor Base Address */
+
+  //
+  // DW1
+  //
+  UINT32    UcdBaU;           /* UTP Command Descriptor Base Address Upper 32-bits */
+
+  //
+  // DW2
+  //
+  UINT16    RuL;              /* Response UPIU Length */
+  UINT16    RuO;              /* Response UPIU Offset */
+
+  //
+  // DW3
+  //
+  UINT16    PrdtL;            /* PRDT Length */
+  UINT16    PrdtO;            /* PRDT Offset */
+
+  //
+  // DW4
+  //
+  UINT32    Ocs   : 8;        /* Overall Command Status */
+  UINT32    Rsvd2 : 24;
+
+  //
+  // DW5 ~ DW7
+  //
+  UINT32    Rsvd3[3];
+} UTP_CQE;
+
 typedef enum {
   UfsNoData  = 0,
   UfsDataOut = 1,
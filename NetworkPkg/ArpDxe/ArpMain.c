@@ -567,6 +567,13 @@ ArpRequest (
                  NULL
                  );
   if (CacheEntry != NULL) {
+    //
+    // Promote the cache entry to the head of the table, the next lookup
+    // of the same address, usually the gateway, hits it immediately.
+    //
+    RemoveEntryList (&CacheEntry->List);
+    InsertHeadList (&ArpService->ResolvedCacheTable, &CacheEntry->List);
+
     //
     // Resolved, copy the address into the user buffer.
     //
@@ -342,16 +342,18 @@ DnsUnload (
 {
   EFI_STATUS  Status;
 
-  LIST_ENTRY      *Entry;
-  DNS4_CACHE      *ItemCache4;
-  DNS4_SERVER_IP  *ItemServerIp4;
-  DNS6_CACHE      *ItemCache6;
-  DNS6_SERVER_IP  *ItemServerIp6;
-
-  ItemCache4    = NULL;
-  ItemServerIp4 = NULL;
-  ItemCache6    = NULL;
-  ItemServerIp6 = NULL;
+  LIST_ENTRY          *Entry;
+  DNS4_CACHE          *ItemCache4;
+  DNS4_SERVER_IP      *ItemServerIp4;
+  DNS6_CACHE          *ItemCache6;
+  DNS6_SERVER_IP      *ItemServerIp6;
+  DNS_NEGATIVE_CACHE  *ItemNegativeCache;
+
+  ItemCache4        = NULL;
+  ItemServerIp4     = NULL;
+  ItemCache6        = NULL;
+  ItemServerIp6     = NULL;
+  ItemNegativeCache = NULL;
 
   //
   // Disconnect the driver specified by ImageHandle
@@ -401,6 +403,22 @@ DnsUnload (
       FreePool (ItemServerIp6);
     }
 
+    while (!IsListEmpty (&mDriverData->Dns4NegativeCacheList)) {
+      Entry = NetListRemoveHead (&mDriverData->Dns4NegativeCacheList);
+      ASSERT (Entry != NULL);
+      ItemNegativeCache = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+      FreePool (ItemNegativeCache->HostName);
+      FreePool (ItemNegativeCache);
+    }
+
+    while (!IsListEmpty (&mDriverData->Dns6NegativeCacheList)) {
+      Entry = NetListRemoveHead (&mDriverData->Dns6NegativeCacheList);
+      ASSERT (Entry != NULL);
+      ItemNegativeCache = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+      FreePool (ItemNegativeCache->HostName);
+      FreePool (ItemNegativeCache);
+    }
+
     FreePool (mDriverData);
   }
 
@@ -486,8 +504,10 @@ DnsDriverEntryPoint (
   }
 
   InitializeListHead (&mDriverData->Dns4CacheList);
+  InitializeListHead (&mDriverData->Dns4NegativeCacheList);
   InitializeListHead (&mDriverData->Dns4ServerList);
   InitializeListHead (&mDriverData->Dns6CacheList);
+  InitializeListHead (&mDriverData->Dns6NegativeCacheList);
   InitializeListHead (&mDriverData->Dns6ServerList);
 
   return Status;
@@ -31,13 +31,17 @@ typedef struct _DNS_INSTANCE DNS_INSTANCE;
 #define DNS_INSTANCE_SIGNATURE  SIGNATURE_32 ('D', 'N', 'S', 'I')
 
 struct _DNS_DRIVER_DATA {
-  EFI_EVENT     Timer;                 /// Ticking timer for DNS cache update.
+  EFI_EVENT           Timer;             /// Ticking timer for DNS cache update.
 
-  LIST_ENTRY    Dns4CacheList;
-  LIST_ENTRY    Dns4ServerList;
+  LIST_ENTRY          Dns4CacheList;
+  LIST_ENTRY          Dns4NegativeCacheList;
+  LIST_ENTRY          Dns4ServerList;
+  EFI_IPv4_ADDRESS    Dns4ActiveServer;  /// The DNSv4 server that answered last.
 
-  LIST_ENTRY    Dns6CacheList;
-  LIST_ENTRY    Dns6ServerList;
+  LIST_ENTRY          Dns6CacheList;
+  LIST_ENTRY          Dns6NegativeCacheList;
+  LIST_ENTRY          Dns6ServerList;
+  EFI_IPv6_ADDRESS    Dns6ActiveServer;  /// The DNSv6 server that answered last.
 };
 
 struct _DNS_SERVICE {
@@ -78,6 +82,7 @@ struct _DNS_INSTANCE {
   EFI_DNS6_CONFIG_DATA    Dns6CfgData;
 
   EFI_IP_ADDRESS          SessionDnsServer;
+  UINTN                   SessionDnsServerIndex;
 
   NET_MAP                 Dns4TxTokens;
   NET_MAP                 Dns6TxTokens;
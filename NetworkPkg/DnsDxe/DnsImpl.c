@@ -1052,6 +1052,196 @@ AddDns6ServerIp (
   return EFI_SUCCESS;
 }
 
+/**
+  Add the failed lookup of a host name to the negative cache list, replacing
+  the earlier entry of the same host name.
+
+  @param  NegativeCacheList The Dns4 or Dns6 negative cache list.
+  @param  HostName          The host name failed to be resolved.
+  @param  LookupStatus      The status the lookup failed with.
+  @param  Timeout           Time in seconds the failure is cached. Zero means
+                            that the failure is not cached.
+
+  @retval EFI_SUCCESS       Update the negative cache successfully.
+  @retval Others            Failed to update the negative cache.
+
+**/
+EFI_STATUS
+UpdateDnsNegativeCache (
+  IN LIST_ENTRY  *NegativeCacheList,
+  IN CHAR16      *HostName,
+  IN EFI_STATUS  LookupStatus,
+  IN UINT32      Timeout
+  )
+{
+  DNS_NEGATIVE_CACHE  *Item;
+  LIST_ENTRY          *Entry;
+  LIST_ENTRY          *Next;
+
+  NET_LIST_FOR_EACH_SAFE (Entry, Next, NegativeCacheList) {
+    Item = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+    if (StrCmp (HostName, Item->HostName) == 0) {
+      RemoveEntryList (&Item->AllCacheLink);
+      FreePool (Item->HostName);
+      FreePool (Item);
+    }
+  }
+
+  if (Timeout == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Item = AllocatePool (sizeof (DNS_NEGATIVE_CACHE));
+  if (Item == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Item->HostName = AllocateCopyPool (StrSize (HostName), HostName);
+  if (Item->HostName == NULL) {
+    FreePool (Item);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Item->Status  = LookupStatus;
+  Item->Timeout = Timeout;
+
+  InsertTailList (NegativeCacheList, &Item->AllCacheLink);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Find out whether a lookup of the host name failed recently.
+
+  @param  NegativeCacheList The Dns4 or Dns6 negative cache list.
+  @param  HostName          The host name to be resolved.
+  @param  LookupStatus      Return the status the lookup failed with.
+
+  @retval TRUE              The failure of the host name is cached.
+  @retval FALSE             The failure of the host name is not cached.
+
+**/
+BOOLEAN
+FindDnsNegativeCache (
+  IN  LIST_ENTRY  *NegativeCacheList,
+  IN  CHAR16      *HostName,
+  OUT EFI_STATUS  *LookupStatus
+  )
+{
+  DNS_NEGATIVE_CACHE  *Item;
+  LIST_ENTRY          *Entry;
+
+  NET_LIST_FOR_EACH (Entry, NegativeCacheList) {
+    Item = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+    if (StrCmp (HostName, Item->HostName) == 0) {
+      *LookupStatus = Item->Status;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Age the entries of the negative cache list by one second, and remove the
+  expired ones.
+
+  @param  NegativeCacheList The Dns4 or Dns6 negative cache list.
+
+**/
+VOID
+AgeDnsNegativeCache (
+  IN LIST_ENTRY  *NegativeCacheList
+  )
+{
+  DNS_NEGATIVE_CACHE  *Item;
+  LIST_ENTRY          *Entry;
+  LIST_ENTRY          *Next;
+
+  NET_LIST_FOR_EACH_SAFE (Entry, Next, NegativeCacheList) {
+    Item = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+    if (--Item->Timeout == 0) {
+      RemoveEntryList (&Item->AllCacheLink);
+      FreePool (Item->HostName);
+      FreePool (Item);
+    }
+  }
+}
+
+/**
+  Get the time a failed lookup may be cached from the authority section of the
+  response. According to RFC 2308, it's the minimum of the TTL of the SOA record
+  and its MINIMUM field. Without an SOA record the failure is not cached.
+
+  The answer section may hold records too, such as the CNAME chain leading to a
+  name that doesn't exist. They are skipped to reach the authority section.
+
+  @param  Records               The start of the answer section.
+  @param  Length                The length of the rest of the response.
+  @param  AnswersNum            The number of records in the answer section.
+  @param  AuthorityNum          The number of records in the authority section.
+
+  @return The time in seconds the failed lookup may be cached.
+
+**/
+STATIC
+UINT32
+GetDnsNegativeCacheTimeout (
+  IN UINT8   *Records,
+  IN UINT32  Length,
+  IN UINT16  AnswersNum,
+  IN UINT16  AuthorityNum
+  )
+{
+  UINT32              Offset;
+  UINT32              Index;
+  DNS_ANSWER_SECTION  Section;
+  UINT32              Minimum;
+
+  Offset = 0;
+
+  for (Index = 0; Index < (UINT32)AnswersNum + AuthorityNum; Index++) {
+    //
+    // Skip the owner name, the labels may end with a compression pointer.
+    //
+    while ((Offset < Length) && (Records[Offset] != 0) && ((Records[Offset] & 0xC0) != 0xC0)) {
+      Offset += Records[Offset] + 1;
+    }
+
+    if (Offset >= Length) {
+      return 0;
+    }
+
+    Offset += (Records[Offset] == 0) ? 1 : 2;
+
+    if (Offset + sizeof (DNS_ANSWER_SECTION) > Length) {
+      return 0;
+    }
+
+    CopyMem (&Section, Records + Offset, sizeof (DNS_ANSWER_SECTION));
+    Offset            += sizeof (DNS_ANSWER_SECTION);
+    Section.Type       = NTOHS (Section.Type);
+    Section.Ttl        = NTOHL (Section.Ttl);
+    Section.DataLength = NTOHS (Section.DataLength);
+
+    if (Offset + Section.DataLength > Length) {
+      return 0;
+    }
+
+    if ((Index >= AnswersNum) && (Section.Type == DNS_TYPE_SOA) && (Section.DataLength >= sizeof (UINT32))) {
+      //
+      // MINIMUM is the last field of the SOA record.
+      //
+      Minimum = NTOHL (ReadUnaligned32 ((UINT32 *)(Records + Offset + Section.DataLength - sizeof (UINT32))));
+      return MIN (MIN (Minimum, Section.Ttl), DNS_NEGATIVE_CACHE_MAX_TIMEOUT);
+    }
+
+    Offset += Section.DataLength;
+  }
+
+  return 0;
+}
+
 /**
   Find out whether the response is valid or invalid.
 
@@ -1158,6 +1348,7 @@ ParseDnsResponse (
 
   EFI_STATUS  Status;
   UINT32      RemainingLength;
+  UINT32      NegativeTimeout;
 
   EFI_TPL  OldTpl;
 
@@ -1258,6 +1449,11 @@ ParseDnsResponse (
 
     ASSERT (Item != NULL);
     Dns4TokenEntry = (DNS4_TOKEN_ENTRY *)(Item->Key);
+
+    //
+    // Remember the server that answers, the instances configured later start with it.
+    //
+    CopyMem (&mDriverData->Dns4ActiveServer, &Instance->SessionDnsServer.v4, sizeof (EFI_IPv4_ADDRESS));
   } else {
     if (!IsValidDnsResponse (
            &Instance->Dns6TxTokens,
@@ -1274,6 +1470,11 @@ ParseDnsResponse (
 
     ASSERT (Item != NULL);
     Dns6TokenEntry = (DNS6_TOKEN_ENTRY *)(Item->Key);
+
+    //
+    // Remember the server that answers, the instances configured later start with it.
+    //
+    CopyMem (&mDriverData->Dns6ActiveServer, &Instance->SessionDnsServer.v6, sizeof (EFI_IPv6_ADDRESS));
   }
 
   //
@@ -1291,6 +1492,27 @@ ParseDnsResponse (
       Status = EFI_DEVICE_ERROR;
     }
 
+    //
+    // Cache the name error or the empty answer of a host name lookup, the other
+    // consumers trying the same host name then fail without asking again.
+    //
+    if ((DnsHeader->Flags.Bits.QR == DNS_FLAGS_QR_RESPONSE) &&
+        ((DnsHeader->Flags.Bits.RCode == DNS_FLAGS_RCODE_NAME_ERROR) ||
+         ((DnsHeader->Flags.Bits.RCode == DNS_FLAGS_RCODE_NO_ERROR) && (DnsHeader->AnswersNum == 0))))
+    {
+      NegativeTimeout = GetDnsNegativeCacheTimeout (
+                          (UINT8 *)QuerySection + sizeof (*QuerySection),
+                          RemainingLength,
+                          DnsHeader->AnswersNum,
+                          DnsHeader->AuthorityNum
+                          );
+      if ((Dns4TokenEntry != NULL) && !Dns4TokenEntry->GeneralLookUp) {
+        UpdateDnsNegativeCache (&mDriverData->Dns4NegativeCacheList, Dns4TokenEntry->QueryHostName, Status, NegativeTimeout);
+      } else if ((Dns6TokenEntry != NULL) && !Dns6TokenEntry->GeneralLookUp) {
+        UpdateDnsNegativeCache (&mDriverData->Dns6NegativeCacheList, Dns6TokenEntry->QueryHostName, Status, NegativeTimeout);
+      }
+    }
+
     goto ON_COMPLETE;
   }
 
@@ -2086,6 +2308,117 @@ DnsRetransmit (
   return Status;
 }
 
+/**
+  Select the DNS server the instance starts with. It's the server answered last
+  if the instance is configured with it, otherwise the first configured server.
+
+  @param  Instance          The DNS instance.
+
+**/
+VOID
+DnsSelectServer (
+  IN DNS_INSTANCE  *Instance
+  )
+{
+  UINTN  Index;
+
+  Instance->SessionDnsServerIndex = 0;
+
+  if (Instance->Service->IpVersion == IP_VERSION_4) {
+    for (Index = 0; Index < Instance->Dns4CfgData.DnsServerListCount; Index++) {
+      if (EFI_IP4_EQUAL (&Instance->Dns4CfgData.DnsServerList[Index], &mDriverData->Dns4ActiveServer)) {
+        Instance->SessionDnsServerIndex = Index;
+        break;
+      }
+    }
+
+    CopyMem (
+      &Instance->SessionDnsServer.v4,
+      &Instance->Dns4CfgData.DnsServerList[Instance->SessionDnsServerIndex],
+      sizeof (EFI_IPv4_ADDRESS)
+      );
+  } else {
+    for (Index = 0; Index < Instance->Dns6CfgData.DnsServerCount; Index++) {
+      if (EFI_IP6_EQUAL (&Instance->Dns6CfgData.DnsServerList[Index], &mDriverData->Dns6ActiveServer)) {
+        Instance->SessionDnsServerIndex = Index;
+        break;
+      }
+    }
+
+    CopyMem (
+      &Instance->SessionDnsServer.v6,
+      &Instance->Dns6CfgData.DnsServerList[Instance->SessionDnsServerIndex],
+      sizeof (EFI_IPv6_ADDRESS)
+      );
+  }
+}
+
+/**
+  Switch the DNS instance to the next configured DNS server.
+
+  @param  Instance          The DNS instance.
+
+  @retval EFI_SUCCESS       The instance switched to the next server.
+  @retval EFI_NOT_FOUND     There is no other server to switch to.
+  @retval Others            Failed to reconfigure the UDP.
+
+**/
+EFI_STATUS
+DnsSwitchServer (
+  IN DNS_INSTANCE  *Instance
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Count;
+
+  if (Instance->Service->IpVersion == IP_VERSION_4) {
+    Count = Instance->Dns4CfgData.DnsServerListCount;
+  } else {
+    Count = Instance->Dns6CfgData.DnsServerCount;
+  }
+
+  if (Count <= 1) {
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // The UDP is connected to the current server. Reset it, and let the DPC
+  // release the aborted receive request before it's restarted.
+  //
+  UdpIoCleanIo (Instance->UdpIo);
+  DispatchDpc ();
+
+  Instance->SessionDnsServerIndex = (Instance->SessionDnsServerIndex + 1) % Count;
+
+  if (Instance->Service->IpVersion == IP_VERSION_4) {
+    CopyMem (
+      &Instance->SessionDnsServer.v4,
+      &Instance->Dns4CfgData.DnsServerList[Instance->SessionDnsServerIndex],
+      sizeof (EFI_IPv4_ADDRESS)
+      );
+    Status = Dns4ConfigUdp (Instance, Instance->UdpIo);
+  } else {
+    CopyMem (
+      &Instance->SessionDnsServer.v6,
+      &Instance->Dns6CfgData.DnsServerList[Instance->SessionDnsServerIndex],
+      sizeof (EFI_IPv6_ADDRESS)
+      );
+    Status = Dns6ConfigUdp (Instance, Instance->UdpIo);
+  }
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  DEBUG ((DEBUG_INFO, "DnsDxe: Fall back to DNS server %d of %d.\n", (UINT32)Instance->SessionDnsServerIndex + 1, (UINT32)Count));
+
+  if (Instance->UdpIo->RecvRequest == NULL) {
+    Status = UdpIoRecvDatagram (Instance->UdpIo, DnsOnPacketReceived, Instance, 0);
+  }
+
+  return Status;
+}
+
 /**
   The timer ticking function for the DNS services.
 
@@ -2110,6 +2443,7 @@ DnsOnTimerRetransmit (
   NET_MAP_ITEM      *ItemNetMap;
   DNS4_TOKEN_ENTRY  *Dns4TokenEntry;
   DNS6_TOKEN_ENTRY  *Dns6TokenEntry;
+  BOOLEAN           Switched;
 
   Dns4TokenEntry = NULL;
   Dns6TokenEntry = NULL;
@@ -2123,6 +2457,7 @@ DnsOnTimerRetransmit (
     //
     NET_LIST_FOR_EACH_SAFE (Entry, Next, &Service->Dns4ChildrenList) {
       Instance = NET_LIST_USER_STRUCT (Entry, DNS_INSTANCE, Link);
+      Switched = FALSE;
 
       EntryNetMap = Instance->Dns4TxTokens.Used.ForwardLink;
       while (EntryNetMap != &Instance->Dns4TxTokens.Used) {
@@ -2138,6 +2473,16 @@ DnsOnTimerRetransmit (
         // otherwise exit the transfer.
         //
         if (++Dns4TokenEntry->RetryCounting <= Dns4TokenEntry->Token->RetryCount) {
+          //
+          // Retry with the next configured server, if any, rather than
+          // waiting on the one that doesn't answer. All the tokens timing
+          // out in this tick failed on the same server, so move on only once.
+          //
+          if (!Switched) {
+            DnsSwitchServer (Instance);
+            Switched = TRUE;
+          }
+
           DnsRetransmit (Instance, (NET_BUF *)ItemNetMap->Value);
           EntryNetMap = EntryNetMap->ForwardLink;
         } else {
@@ -2167,6 +2512,7 @@ DnsOnTimerRetransmit (
     //
     NET_LIST_FOR_EACH_SAFE (Entry, Next, &Service->Dns6ChildrenList) {
       Instance = NET_LIST_USER_STRUCT (Entry, DNS_INSTANCE, Link);
+      Switched = FALSE;
 
       EntryNetMap = Instance->Dns6TxTokens.Used.ForwardLink;
       while (EntryNetMap != &Instance->Dns6TxTokens.Used) {
@@ -2182,6 +2528,16 @@ DnsOnTimerRetransmit (
         // otherwise exit the transfer.
         //
         if (++Dns6TokenEntry->RetryCounting <= Dns6TokenEntry->Token->RetryCount) {
+          //
+          // Retry with the next configured server, if any, rather than
+          // waiting on the one that doesn't answer. All the tokens timing
+          // out in this tick failed on the same server, so move on only once.
+          //
+          if (!Switched) {
+            DnsSwitchServer (Instance);
+            Switched = TRUE;
+          }
+
           DnsRetransmit (Instance, (NET_BUF *)ItemNetMap->Value);
           EntryNetMap = EntryNetMap->ForwardLink;
         } else {
@@ -2272,4 +2628,10 @@ DnsOnTimerUpdate (
       Entry = Entry->ForwardLink;
     }
   }
+
+  //
+  // Age the negative caches.
+  //
+  AgeDnsNegativeCache (&mDriverData->Dns4NegativeCacheList);
+  AgeDnsNegativeCache (&mDriverData->Dns6NegativeCacheList);
 }
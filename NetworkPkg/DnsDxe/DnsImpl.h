@@ -82,6 +82,11 @@ extern EFI_DNS6_PROTOCOL             mDns6Protocol;
 
 #define DNS_TIME_TO_GETMAP  5
 
+//
+// Upper bound in seconds of caching a failed host name lookup, see RFC 2308.
+//
+#define DNS_NEGATIVE_CACHE_MAX_TIMEOUT  300
+
 #pragma pack(1)
 
 typedef union _DNS_FLAGS DNS_FLAGS;
@@ -96,6 +101,13 @@ typedef struct {
   EFI_DNS6_CACHE_ENTRY    DnsCache;
 } DNS6_CACHE;
 
+typedef struct {
+  LIST_ENTRY    AllCacheLink;
+  CHAR16        *HostName;
+  EFI_STATUS    Status;              /// The status the lookup failed with.
+  UINT32        Timeout;
+} DNS_NEGATIVE_CACHE;
+
 typedef struct {
   LIST_ENTRY          AllServerLink;
   EFI_IPv4_ADDRESS    Dns4ServerIp;
@@ -548,6 +560,85 @@ AddDns6ServerIp (
   IN EFI_IPv6_ADDRESS  ServerIp
   );
 
+/**
+  Add the failed lookup of a host name to the negative cache list, replacing
+  the earlier entry of the same host name.
+
+  @param  NegativeCacheList The Dns4 or Dns6 negative cache list.
+  @param  HostName          The host name failed to be resolved.
+  @param  LookupStatus      The status the lookup failed with.
+  @param  Timeout           Time in seconds the failure is cached. Zero means
+                            that the failure is not cached.
+
+  @retval EFI_SUCCESS       Update the negative cache successfully.
+  @retval Others            Failed to update the negative cache.
+
+**/
+EFI_STATUS
+UpdateDnsNegativeCache (
+  IN LIST_ENTRY  *NegativeCacheList,
+  IN CHAR16      *HostName,
+  IN EFI_STATUS  LookupStatus,
+  IN UINT32      Timeout
+  );
+
+/**
+  Find out whether a lookup of the host name failed recently.
+
+  @param  NegativeCacheList The Dns4 or Dns6 negative cache list.
+  @param  HostName          The host name to be resolved.
+  @param  LookupStatus      Return the status the lookup failed with.
+
+  @retval TRUE              The failure of the host name is cached.
+  @retval FALSE             The failure of the host name is not cached.
+
+**/
+BOOLEAN
+FindDnsNegativeCache (
+  IN  LIST_ENTRY  *NegativeCacheList,
+  IN  CHAR16      *HostName,
+  OUT EFI_STATUS  *LookupStatus
+  );
+
+/**
+  Age the entries of the negative cache list by one second, and remove the
+  expired ones.
+
+  @param  NegativeCacheList The Dns4 or Dns6 negative cache list.
+
+**/
+VOID
+AgeDnsNegativeCache (
+  IN LIST_ENTRY  *NegativeCacheList
+  );
+
+/**
+  Select the DNS server the instance starts with. It's the server answered last
+  if the instance is configured with it, otherwise the first configured server.
+
+  @param  Instance          The DNS instance.
+
+**/
+VOID
+DnsSelectServer (
+  IN DNS_INSTANCE  *Instance
+  );
+
+/**
+  Switch the DNS instance to the next configured DNS server.
+
+  @param  Instance          The DNS instance.
+
+  @retval EFI_SUCCESS       The instance switched to the next server.
+  @retval EFI_NOT_FOUND     There is no other server to switch to.
+  @retval Others            Failed to reconfigure the UDP.
+
+**/
+EFI_STATUS
+DnsSwitchServer (
+  IN DNS_INSTANCE  *Instance
+  );
+
 /**
   Find out whether the response is valid or invalid.
 
@@ -268,11 +268,15 @@ Dns4Configure (
 
       OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
 
-      CopyMem (&Instance->SessionDnsServer.v4, &ServerList[0], sizeof (EFI_IPv4_ADDRESS));
-    } else {
-      CopyMem (&Instance->SessionDnsServer.v4, &DnsConfigData->DnsServerList[0], sizeof (EFI_IPv4_ADDRESS));
+      //
+      // Keep all the servers from DHCP, to fall back to the next one.
+      //
+      Instance->Dns4CfgData.DnsServerListCount = ServerListCount;
+      Instance->Dns4CfgData.DnsServerList      = ServerList;
     }
 
+    DnsSelectServer (Instance);
+
     //
     // Config UDP
     //
@@ -448,6 +452,19 @@ Dns4HostNameToIp (
       Status = Token->Status;
       goto ON_EXIT;
     }
+
+    //
+    // Fail fast if the host name failed to be resolved recently.
+    //
+    if (FindDnsNegativeCache (&mDriverData->Dns4NegativeCacheList, HostName, &Token->Status)) {
+      if (Token->Event != NULL) {
+        gBS->SignalEvent (Token->Event);
+        DispatchDpc ();
+      }
+
+      Status = EFI_SUCCESS;
+      goto ON_EXIT;
+    }
   }
 
   //
@@ -1105,11 +1122,15 @@ Dns6Configure (
 
       OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
 
-      CopyMem (&Instance->SessionDnsServer.v6, &ServerList[0], sizeof (EFI_IPv6_ADDRESS));
-    } else {
-      CopyMem (&Instance->SessionDnsServer.v6, &DnsConfigData->DnsServerList[0], sizeof (EFI_IPv6_ADDRESS));
+      //
+      // Keep all the servers from DHCP, to fall back to the next one.
+      //
+      Instance->Dns6CfgData.DnsServerCount = ServerListCount;
+      Instance->Dns6CfgData.DnsServerList  = ServerList;
     }
 
+    DnsSelectServer (Instance);
+
     //
     // Config UDP
     //
@@ -1289,6 +1310,19 @@ Dns6HostNameToIp (
       Status = Token->Status;
       goto ON_EXIT;
     }
+
+    //
+    // Fail fast if the host name failed to be resolved recently.
+    //
+    if (FindDnsNegativeCache (&mDriverData->Dns6NegativeCacheList, HostName, &Token->Status)) {
+      if (Token->Event != NULL) {
+        gBS->SignalEvent (Token->Event);
+        DispatchDpc ();
+      }
+
+      Status = EFI_SUCCESS;
+      goto ON_EXIT;
+    }
   }
 
   //
@@ -71,6 +71,24 @@ HttpBootDiscoverBootInfo (
   IN OUT HTTP_BOOT_PRIVATE_DATA  *Private
   );
 
+/**
+  Create and configure a HTTP child for the file download.
+
+  @param[in]    Private        The pointer to the driver's private data.
+  @param[in]    Callback       Callback function invoked by HttpIo, may be NULL.
+  @param[out]   HttpIo         The created HttpIo.
+
+  @retval EFI_SUCCESS          Successfully created.
+  @retval Others               Failed to create HttpIo.
+
+**/
+EFI_STATUS
+HttpBootCreateHttpIoChild (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     HTTP_IO_CALLBACK        Callback  OPTIONAL,
+  OUT    HTTP_IO                 *HttpIo
+  );
+
 /**
   Create a HttpIo instance for the file download.
 
@@ -435,6 +435,19 @@ HttpBootGetBootFileCaller (
           return EFI_BUFFER_TOO_SMALL;
         }
 
+        //
+        // Split a large file over several connections if possible, and
+        // fall back to a single connection if this fails.
+        //
+        Status = HttpBootGetBootFileByRanges (Private, BufferSize, Buffer, ImageType);
+        if (!EFI_ERROR (Status)) {
+          return Status;
+        }
+
+        if (Status != EFI_UNSUPPORTED) {
+          DEBUG ((DEBUG_WARN, "HttpBootGetBootFileCaller: Parallel download failed - %r, using a single connection.\n", Status));
+        }
+
         //
         // Load the boot file into Buffer
         //
@@ -628,6 +641,7 @@ HttpBootStop (
   Private->SelectIndex            = 0;
   Private->SelectProxyType        = HttpOfferTypeMax;
   Private->PartialTransferredSize = 0;
+  Private->RangeRefused           = FALSE;
 
   if (!Private->UsingIpv6) {
     //
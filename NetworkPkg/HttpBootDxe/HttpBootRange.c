@@ -0,0 +1,653 @@
+/** @file
+  Parallel ranged download of the boot file.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "HttpBootDxe.h"
+
+/**
+  Build the request headers of one range connection. The Range header
+  itself is updated before each request.
+
+  @param[in]    Private        The pointer to the driver's private data.
+  @param[out]   HttpIoHeader   The created request headers.
+
+  @retval EFI_SUCCESS          The headers were created.
+  @retval Others               Failed to create the headers.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootRangeCreateHeader (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  OUT    HTTP_IO_HEADER          **HttpIoHeader
+  )
+{
+  EFI_STATUS      Status;
+  HTTP_IO_HEADER  *Header;
+  CHAR8           *HostName;
+  CHAR8           BaseAuthValue[80];
+
+  //
+  // Host, Accept, User-Agent, Range, [Authorization], [If-Match]|[If-Unmodified-Since]
+  //
+  Header = HttpIoCreateHeader (6);
+  if (Header == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  HostName = NULL;
+  Status   = HttpUrlGetHostName (
+               Private->BootFileUri,
+               Private->BootFileUriParser,
+               &HostName
+               );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (Header, HTTP_HEADER_HOST, HostName);
+  FreePool (HostName);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (Header, HTTP_HEADER_ACCEPT, "*/*");
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (Header, HTTP_HEADER_USER_AGENT, HTTP_USER_AGENT_EFI_HTTP_BOOT);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (Header, "Range", "bytes=0-0");
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  if (Private->AuthData != NULL) {
+    AsciiSPrint (BaseAuthValue, sizeof (BaseAuthValue), "%a %a", "Basic", Private->AuthData);
+    Status = HttpIoSetHeader (Header, HTTP_HEADER_AUTHORIZATION, BaseAuthValue);
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+  }
+
+  //
+  // Make the server reject the ranges if the file changed since the
+  // first response, so the pieces always come from the same file.
+  //
+  if (Private->LastModifiedOrEtag != NULL) {
+    Status = HttpIoSetHeader (
+               Header,
+               (Private->LastModifiedOrEtag[0] == '"') ? HTTP_HEADER_IF_MATCH : HTTP_HEADER_IF_UNMODIFIED_SINCE,
+               Private->LastModifiedOrEtag
+               );
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+  }
+
+  *HttpIoHeader = Header;
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  HttpIoFreeHeader (Header);
+  return Status;
+}
+
+/**
+  Parse a Content-Range header value of the form "bytes First-Last/Total".
+
+  @param[in]    Value        The header value.
+  @param[out]   First        The first byte of the range.
+  @param[out]   Last         The last byte of the range.
+  @param[out]   Total        The size of the whole file.
+
+  @retval EFI_SUCCESS          The value was parsed.
+  @retval EFI_UNSUPPORTED      The value is malformed or the size is unknown.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootRangeParseContentRange (
+  IN  CHAR8  *Value,
+  OUT UINTN  *First,
+  OUT UINTN  *Last,
+  OUT UINTN  *Total
+  )
+{
+  CHAR8  *End;
+
+  if (AsciiStrnCmp (Value, "bytes ", 6) != 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (EFI_ERROR (AsciiStrDecimalToUintnS (Value + 6, &End, First)) || (*End != '-')) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (EFI_ERROR (AsciiStrDecimalToUintnS (End + 1, &End, Last)) || (*End != '/')) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (EFI_ERROR (AsciiStrDecimalToUintnS (End + 1, &End, Total))) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Check the response header of a range request.
+
+  @param[in]    Download       The parallel download.
+  @param[in]    Connection     The connection which received the response.
+
+  @retval EFI_SUCCESS          The response carries exactly the requested range.
+  @retval EFI_UNSUPPORTED      The server doesn't serve the requested range.
+  @retval Others               The request failed.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootRangeCheckResponse (
+  IN HTTP_BOOT_RANGE_DOWNLOAD    *Download,
+  IN HTTP_BOOT_RANGE_CONNECTION  *Connection
+  )
+{
+  EFI_HTTP_MESSAGE  *Message;
+  EFI_HTTP_HEADER   *Header;
+  CHAR8             *Validator;
+  UINTN             First;
+  UINTN             Last;
+  UINTN             Total;
+
+  Message = Connection->HttpIo.RspToken.Message;
+
+  if (Connection->Response.StatusCode != HTTP_STATUS_206_PARTIAL_CONTENT) {
+    DEBUG ((
+      DEBUG_WARN,
+      "HttpBootRangeCheckResponse: Server answered the range request with status %d\n",
+      Connection->Response.StatusCode
+      ));
+    if ((Connection->Response.StatusCode == HTTP_STATUS_200_OK) ||
+        (Connection->Response.StatusCode == HTTP_STATUS_416_REQUESTED_RANGE_NOT_SATISFIED))
+    {
+      return EFI_UNSUPPORTED;
+    }
+
+    return EFI_DEVICE_ERROR;
+  }
+
+  Header = HttpFindHeader (Message->HeaderCount, Message->Headers, HTTP_HEADER_CONTENT_RANGE);
+  if ((Header == NULL) ||
+      EFI_ERROR (HttpBootRangeParseContentRange (Header->FieldValue, &First, &Last, &Total)) ||
+      (First != Connection->Start) ||
+      (Last != Connection->Start + Connection->Length - 1) ||
+      (Total != Download->FileSize))
+  {
+    DEBUG ((DEBUG_WARN, "HttpBootRangeCheckResponse: Content-Range doesn't match the request\n"));
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Don't mix pieces of different versions of the file, in case the
+  // server ignored the precondition.
+  //
+  Validator = Download->Private->LastModifiedOrEtag;
+  if ((Validator != NULL) && (Validator[0] == '"')) {
+    Header = HttpFindHeader (Message->HeaderCount, Message->Headers, HTTP_HEADER_ETAG);
+    if ((Header != NULL) && (AsciiStrCmp (Header->FieldValue, Validator) != 0)) {
+      DEBUG ((DEBUG_WARN, "HttpBootRangeCheckResponse: ETag changed to %a\n", Header->FieldValue));
+      return EFI_UNSUPPORTED;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Queue a response token on the connection, either for the response header
+  or for the rest of the range body.
+
+  @param[in]      Download       The parallel download.
+  @param[in, out] Connection     The connection.
+
+  @retval EFI_SUCCESS          The token was queued.
+  @retval Others               Failed to queue the token.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootRangeQueueResponse (
+  IN     HTTP_BOOT_RANGE_DOWNLOAD    *Download,
+  IN OUT HTTP_BOOT_RANGE_CONNECTION  *Connection
+  )
+{
+  HTTP_IO     *HttpIo;
+  EFI_STATUS  Status;
+
+  HttpIo = &Connection->HttpIo;
+
+  HttpIo->RspToken.Status               = EFI_NOT_READY;
+  HttpIo->RspToken.Message->HeaderCount = 0;
+  HttpIo->RspToken.Message->Headers     = NULL;
+  if (Connection->State == HttpBootRangeHeader) {
+    HttpIo->RspToken.Message->Data.Response = &Connection->Response;
+    HttpIo->RspToken.Message->BodyLength    = 0;
+    HttpIo->RspToken.Message->Body          = NULL;
+  } else {
+    HttpIo->RspToken.Message->Data.Response = NULL;
+    HttpIo->RspToken.Message->BodyLength    = Connection->Length - Connection->Received;
+    HttpIo->RspToken.Message->Body          = Download->Buffer + Connection->Start + Connection->Received;
+  }
+
+  HttpIo->IsRxDone = FALSE;
+
+  Status = gBS->SetTimer (HttpIo->TimeoutEvent, TimerRelative, HttpIo->Timeout * TICKS_PER_MS);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = HttpIo->Http->Response (HttpIo->Http, &HttpIo->RspToken);
+  if (EFI_ERROR (Status)) {
+    gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+  }
+
+  return Status;
+}
+
+/**
+  Assign the next chunk of the file to the connection and send its request.
+  The connection is done if the whole file has been assigned.
+
+  @param[in, out] Download       The parallel download.
+  @param[in, out] Connection     The connection.
+
+  @retval EFI_SUCCESS          The request was queued, or there is nothing left to request.
+  @retval Others               Failed to queue the request.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootRangeSendRequest (
+  IN OUT HTTP_BOOT_RANGE_DOWNLOAD    *Download,
+  IN OUT HTTP_BOOT_RANGE_CONNECTION  *Connection
+  )
+{
+  HTTP_IO     *HttpIo;
+  CHAR8       RangeValue[64];
+  EFI_STATUS  Status;
+
+  if (Download->NextOffset >= Download->FileSize) {
+    Connection->State = HttpBootRangeDone;
+    return EFI_SUCCESS;
+  }
+
+  Connection->Start    = Download->NextOffset;
+  Connection->Length   = MIN (Download->ChunkSize, Download->FileSize - Download->NextOffset);
+  Connection->Received = 0;
+  Download->NextOffset = Connection->Start + Connection->Length;
+
+  AsciiSPrint (
+    RangeValue,
+    sizeof (RangeValue),
+    "bytes=%lu-%lu",
+    (UINT64)Connection->Start,
+    (UINT64)(Connection->Start + Connection->Length - 1)
+    );
+  Status = HttpIoSetHeader (Connection->RequestHeader, "Range", RangeValue);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  HttpIo = &Connection->HttpIo;
+
+  HttpIo->ReqToken.Status                = EFI_NOT_READY;
+  HttpIo->ReqToken.Message->Data.Request = &Download->RequestData;
+  HttpIo->ReqToken.Message->HeaderCount  = Connection->RequestHeader->HeaderCount;
+  HttpIo->ReqToken.Message->Headers      = Connection->RequestHeader->Headers;
+  HttpIo->ReqToken.Message->BodyLength   = 0;
+  HttpIo->ReqToken.Message->Body         = NULL;
+  HttpIo->IsTxDone                       = FALSE;
+
+  Status = HttpIo->Http->Request (HttpIo->Http, &HttpIo->ReqToken);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Connection->State = HttpBootRangeSending;
+  return EFI_SUCCESS;
+}
+
+/**
+  Pass the data that follows the part already delivered to the HTTP Boot
+  Callback, in file order. Data of a range that arrived before the ranges in
+  front of it is held back until those are complete.
+
+  Every chunk between DeliveredSize and NextOffset is either still owned by an
+  active connection, which has received its first Received bytes, or complete.
+
+  @param[in, out] Download       The parallel download.
+
+  @retval EFI_SUCCESS          The data was delivered, or there was nothing to deliver.
+  @retval Others               The callback aborted the download.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootRangeDeliver (
+  IN OUT HTTP_BOOT_RANGE_DOWNLOAD  *Download
+  )
+{
+  EFI_HTTP_BOOT_CALLBACK_PROTOCOL  *HttpBootCallback;
+  HTTP_BOOT_RANGE_CONNECTION       *Connection;
+  UINTN                            ChunkStart;
+  UINTN                            End;
+  UINTN                            Index;
+  EFI_STATUS                       Status;
+
+  HttpBootCallback = Download->Private->HttpBootCallback;
+  if (HttpBootCallback == NULL) {
+    return EFI_SUCCESS;
+  }
+
+  while (Download->DeliveredSize < Download->NextOffset) {
+    ChunkStart = Download->DeliveredSize - Download->DeliveredSize % Download->ChunkSize;
+    End        = MIN (ChunkStart + Download->ChunkSize, Download->FileSize);
+    for (Index = 0; Index < Download->ConnectionCount; Index++) {
+      Connection = &Download->Connection[Index];
+      if ((Connection->State != HttpBootRangeDone) && (Connection->Start == ChunkStart)) {
+        End = ChunkStart + Connection->Received;
+        break;
+      }
+    }
+
+    if (End <= Download->DeliveredSize) {
+      break;
+    }
+
+    Status = HttpBootCallback->Callback (
+                                 HttpBootCallback,
+                                 HttpBootHttpEntityBody,
+                                 TRUE,
+                                 (UINT32)(End - Download->DeliveredSize),
+                                 Download->Buffer + Download->DeliveredSize
+                                 );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Download->DeliveredSize = End;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Advance the connection once its pending token has completed.
+
+  @param[in, out] Download       The parallel download.
+  @param[in, out] Connection     The connection.
+
+  @retval EFI_SUCCESS          The connection is progressing.
+  @retval Others               The connection failed.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootRangeProcess (
+  IN OUT HTTP_BOOT_RANGE_DOWNLOAD    *Download,
+  IN OUT HTTP_BOOT_RANGE_CONNECTION  *Connection
+  )
+{
+  HTTP_IO           *HttpIo;
+  EFI_HTTP_MESSAGE  *Message;
+  EFI_STATUS        Status;
+
+  HttpIo  = &Connection->HttpIo;
+  Message = HttpIo->RspToken.Message;
+
+  switch (Connection->State) {
+    case HttpBootRangeSending:
+      if (!HttpIo->IsTxDone) {
+        return EFI_SUCCESS;
+      }
+
+      if (EFI_ERROR (HttpIo->ReqToken.Status)) {
+        return HttpIo->ReqToken.Status;
+      }
+
+      Connection->State = HttpBootRangeHeader;
+      return HttpBootRangeQueueResponse (Download, Connection);
+
+    case HttpBootRangeHeader:
+    case HttpBootRangeBody:
+      if (!HttpIo->IsRxDone) {
+        if (!EFI_ERROR (gBS->CheckEvent (HttpIo->TimeoutEvent))) {
+          HttpIo->Http->Cancel (HttpIo->Http, &HttpIo->RspToken);
+          return EFI_TIMEOUT;
+        }
+
+        return EFI_SUCCESS;
+      }
+
+      HttpIo->IsRxDone = FALSE;
+      gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+
+      if (Connection->State == HttpBootRangeHeader) {
+        if (EFI_ERROR (HttpIo->RspToken.Status) && (HttpIo->RspToken.Status != EFI_HTTP_ERROR)) {
+          return HttpIo->RspToken.Status;
+        }
+
+        Status = HttpBootRangeCheckResponse (Download, Connection);
+        if (Message->Headers != NULL) {
+          HttpFreeHeaderFields (Message->Headers, Message->HeaderCount);
+          Message->Headers = NULL;
+        }
+
+        if (EFI_ERROR (Status)) {
+          return Status;
+        }
+
+        Connection->State = HttpBootRangeBody;
+        return HttpBootRangeQueueResponse (Download, Connection);
+      }
+
+      if (EFI_ERROR (HttpIo->RspToken.Status)) {
+        return HttpIo->RspToken.Status;
+      }
+
+      Connection->Received += Message->BodyLength;
+      Status                = HttpBootRangeDeliver (Download);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      if (Connection->Received < Connection->Length) {
+        return HttpBootRangeQueueResponse (Download, Connection);
+      }
+
+      Download->CompletedSize += Connection->Length;
+      return HttpBootRangeSendRequest (Download, Connection);
+
+    default:
+      return EFI_SUCCESS;
+  }
+}
+
+/**
+  Download the boot file with several concurrent HTTP range requests, each on its
+  own HTTP child, straight into the caller's buffer.
+
+  The file is split in chunks of PcdHttpBootRangeChunkSize bytes which are handed
+  out to up to PcdHttpBootRangeConnections connections. Every response must be a
+  206 Partial Content whose Content-Range matches the request exactly and whose
+  validator matches the one of the initial response, otherwise the download is
+  abandoned. The HTTP Boot Callback still receives the entity body in file order.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in, out]  BufferSize      On input the size of Buffer in bytes. On output with a return
+                                   code of EFI_SUCCESS, the amount of data transferred to Buffer.
+  @param[out]      Buffer          The memory buffer to transfer the file to.
+  @param[out]      ImageType       The image type of the downloaded file.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_UNSUPPORTED          A parallel download is not possible for this file, or the
+                                   server refused the range requests. The caller should use a
+                                   single connection.
+  @retval Others                   The parallel download failed, the caller may retry it
+                                   on a single connection.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileByRanges (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN OUT UINTN                   *BufferSize,
+  OUT UINT8                      *Buffer,
+  OUT HTTP_BOOT_IMAGE_TYPE       *ImageType
+  )
+{
+  HTTP_BOOT_RANGE_DOWNLOAD    *Download;
+  HTTP_BOOT_RANGE_CONNECTION  *Connection;
+  UINTN                       ChunkSize;
+  UINTN                       ChunkCount;
+  UINTN                       UrlSize;
+  UINTN                       Index;
+  BOOLEAN                     Active;
+  EFI_STATUS                  Status;
+
+  ChunkSize = PcdGet32 (PcdHttpBootRangeChunkSize);
+
+  //
+  // Only large files of known size are worth splitting. Leave proxied
+  // downloads, resumed downloads and files already in the cache to the
+  // single connection.
+  //
+  if ((PcdGet8 (PcdHttpBootRangeConnections) < 2) ||
+      (ChunkSize == 0) ||
+      (Private->BootFileSize <= ChunkSize) ||
+      (*BufferSize < Private->BootFileSize) ||
+      (Buffer == NULL) ||
+      (Private->ProxyUri != NULL) ||
+      (Private->PartialTransferredSize != 0) ||
+      Private->RangeRefused ||
+      !IsListEmpty (&Private->CacheList))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  Download = AllocateZeroPool (sizeof (HTTP_BOOT_RANGE_DOWNLOAD));
+  if (Download == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ChunkCount = (Private->BootFileSize + ChunkSize - 1) / ChunkSize;
+
+  Download->Private         = Private;
+  Download->Buffer          = Buffer;
+  Download->FileSize        = Private->BootFileSize;
+  Download->ChunkSize       = ChunkSize;
+  Download->ConnectionCount = MIN (MIN (PcdGet8 (PcdHttpBootRangeConnections), HTTP_BOOT_RANGE_MAX_CONNECTIONS), ChunkCount);
+
+  UrlSize                      = AsciiStrSize (Private->BootFileUri);
+  Download->RequestData.Method = HttpMethodGet;
+  Download->RequestData.Url    = AllocatePool (UrlSize * sizeof (CHAR16));
+  if (Download->RequestData.Url == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  AsciiStrToUnicodeStrS (Private->BootFileUri, Download->RequestData.Url, UrlSize);
+
+  DEBUG ((
+    DEBUG_INFO,
+    "HttpBootGetBootFileByRanges: Downloading %lu bytes over %d connections\n",
+    (UINT64)Download->FileSize,
+    Download->ConnectionCount
+    ));
+
+  for (Index = 0; Index < Download->ConnectionCount; Index++) {
+    Connection = &Download->Connection[Index];
+
+    Status = HttpBootCreateHttpIoChild (Private, NULL, &Connection->HttpIo);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+
+    Connection->Created = TRUE;
+
+    Status = HttpBootRangeCreateHeader (Private, &Connection->RequestHeader);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+
+    Status = HttpBootRangeSendRequest (Download, Connection);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+  }
+
+  //
+  // Drive all the connections until the whole file has arrived.
+  //
+  Status = EFI_SUCCESS;
+  while (Download->CompletedSize < Download->FileSize) {
+    Active = FALSE;
+    for (Index = 0; Index < Download->ConnectionCount; Index++) {
+      Connection = &Download->Connection[Index];
+      if (Connection->State == HttpBootRangeDone) {
+        continue;
+      }
+
+      Active = TRUE;
+      Connection->HttpIo.Http->Poll (Connection->HttpIo.Http);
+
+      Status = HttpBootRangeProcess (Download, Connection);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+    }
+
+    if (!Active) {
+      Status = EFI_DEVICE_ERROR;
+      goto ON_EXIT;
+    }
+  }
+
+  *BufferSize = Download->FileSize;
+  *ImageType  = Private->ImageType;
+
+ON_EXIT:
+  if (Status == EFI_UNSUPPORTED) {
+    //
+    // Don't try again on this server.
+    //
+    Private->RangeRefused = TRUE;
+  }
+
+  for (Index = 0; Index < Download->ConnectionCount; Index++) {
+    Connection = &Download->Connection[Index];
+    if (Connection->Created) {
+      if (Connection->State != HttpBootRangeDone) {
+        Connection->HttpIo.Http->Cancel (Connection->HttpIo.Http, NULL);
+      }
+
+      HttpIoDestroyIo (&Connection->HttpIo);
+    }
+
+    HttpIoFreeHeader (Connection->RequestHeader);
+  }
+
+  if (Download->RequestData.Url != NULL) {
+    FreePool (Download->RequestData.Url);
+  }
+
+  FreePool (Download);
+  return Status;
+}
@@ -0,0 +1,80 @@
+/** @file
+  Declaration of the parallel ranged boot file download.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#pragma once
+
+#define HTTP_BOOT_RANGE_MAX_CONNECTIONS  8
+
+typedef enum {
+  HttpBootRangeIdle,
+  HttpBootRangeSending,
+  HttpBootRangeHeader,
+  HttpBootRangeBody,
+  HttpBootRangeDone
+} HTTP_BOOT_RANGE_STATE;
+
+//
+// One HTTP child downloading a range of the boot file.
+//
+typedef struct {
+  HTTP_IO                   HttpIo;
+  BOOLEAN                   Created;
+  HTTP_BOOT_RANGE_STATE     State;
+  HTTP_IO_HEADER            *RequestHeader;
+  EFI_HTTP_RESPONSE_DATA    Response;
+  UINTN                     Start;                ///< First byte of the range
+  UINTN                     Length;               ///< Length of the range
+  UINTN                     Received;             ///< Bytes of the range received so far
+} HTTP_BOOT_RANGE_CONNECTION;
+
+//
+// The state of a parallel ranged download.
+//
+typedef struct {
+  HTTP_BOOT_PRIVATE_DATA        *Private;
+  EFI_HTTP_REQUEST_DATA         RequestData;
+  UINT8                         *Buffer;
+  UINTN                         FileSize;
+  UINTN                         ChunkSize;
+  UINTN                         NextOffset;       ///< First byte not assigned to a connection yet
+  UINTN                         CompletedSize;
+  UINTN                         DeliveredSize;    ///< Bytes passed to the HTTP Boot Callback so far, in file order
+  UINTN                         ConnectionCount;
+  HTTP_BOOT_RANGE_CONNECTION    Connection[HTTP_BOOT_RANGE_MAX_CONNECTIONS];
+} HTTP_BOOT_RANGE_DOWNLOAD;
+
+/**
+  Download the boot file with several concurrent HTTP range requests, each on its
+  own HTTP child, straight into the caller's buffer.
+
+  The file is split in chunks of PcdHttpBootRangeChunkSize bytes which are handed
+  out to up to PcdHttpBootRangeConnections connections. Every response must be a
+  206 Partial Content whose Content-Range matches the request exactly and whose
+  validator matches the one of the initial response, otherwise the download is
+  abandoned. The HTTP Boot Callback still receives the entity body in file order.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in, out]  BufferSize      On input the size of Buffer in bytes. On output with a return
+                                   code of EFI_SUCCESS, the amount of data transferred to Buffer.
+  @param[out]      Buffer          The memory buffer to transfer the file to.
+  @param[out]      ImageType       The image type of the downloaded file.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_UNSUPPORTED          A parallel download is not possible for this file, or the
+                                   server refused the range requests. The caller should use a
+                                   single connection.
+  @retval Others                   The parallel download failed, the caller may retry it
+                                   on a single connection.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileByRanges (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN OUT UINTN                   *BufferSize,
+  OUT UINT8                      *Buffer,
+  OUT HTTP_BOOT_IMAGE_TYPE       *ImageType
+  );
@@ -199,6 +199,33 @@ EfiHttpConfigure (
   }
 }
 
+/**
+  Check whether an HTTP request asks the server to close the connection
+  after the response, that is, whether it carries "Connection: close".
+
+  @param[in]  HttpMsg             Pointer to the HTTP request message.
+
+  @retval TRUE                    The connection is closed after the response.
+  @retval FALSE                   The connection may be kept alive.
+
+**/
+STATIC
+BOOLEAN
+HttpRequestClosesConnection (
+  IN EFI_HTTP_MESSAGE  *HttpMsg
+  )
+{
+  EFI_HTTP_HEADER  *Header;
+
+  Header = HttpFindHeader (HttpMsg->HeaderCount, HttpMsg->Headers, "Connection");
+  if ((Header == NULL) || (AsciiStriCmp ("close", Header->FieldValue) != 0)) {
+    return FALSE;
+  }
+
+  DEBUG ((DEBUG_VERBOSE, "Http: 'Connection: close' header sent.\n"));
+  return TRUE;
+}
+
 /**
   The Request() function queues an HTTP request to this HTTP instance.
 
@@ -497,6 +524,20 @@ EfiHttpRequest (
       // Request() is called the first time.
       //
       ReConfigure = FALSE;
+
+      //
+      // Reuse the idle connection to the same server left by another HTTP instance.
+      //
+      if (!HttpInstance->UseHttps &&
+          (Request->Method != HttpMethodConnect) &&
+          (HttpInstance->State == HTTP_STATE_HTTP_CONFIGED) &&
+          !EFI_ERROR (HttpConnPoolGet (HttpInstance, HostName, RemotePort)))
+      {
+        HttpInstance->RemotePort = RemotePort;
+        HttpInstance->RemoteHost = HostName;
+        HostName                 = NULL;
+        Configure                = FALSE;
+      }
     } else {
       if ((HttpInstance->ConnectionClose == FALSE) &&
           (HttpInstance->RemotePort == RemotePort) &&
@@ -541,6 +582,12 @@ EfiHttpRequest (
 
           HttpUrlFreeParser (UrlParser);
 
+          HttpInstance->Service->RequestsServed++;
+
+          if (HttpRequestClosesConnection (HttpMsg)) {
+            HttpInstance->ConnectionClose = TRUE;
+          }
+
           //
           // Queue the HTTP token and return.
           //
@@ -756,7 +803,14 @@ EfiHttpRequest (
     }
   }
 
-  HttpInstance->ConnectionClose = FALSE;
+  //
+  // A new request resets the connection state. A request that asks for
+  // "Connection: close" leaves a connection that must not be reused or pooled.
+  // A body sent without a new request keeps the state of its request.
+  //
+  if (Request != NULL) {
+    HttpInstance->ConnectionClose = HttpRequestClosesConnection (HttpMsg);
+  }
 
   //
   // Transmit the request message.
@@ -777,6 +831,8 @@ EfiHttpRequest (
     HttpInstance->ProxyConnected = TRUE;
   }
 
+  HttpInstance->Service->RequestsServed++;
+
   if (HostName != NULL) {
     FreePool (HostName);
   }
@@ -822,6 +822,12 @@ HttpCleanProtocol (
   IN  HTTP_PROTOCOL  *HttpInstance
   )
 {
+  //
+  // Keep the idle keep-alive connection for the next HTTP instance talking to
+  // the same server.
+  //
+  HttpConnPoolPut (HttpInstance);
+
   HttpCloseConnection (HttpInstance);
 
   HttpCloseTcpConnCloseEvent (HttpInstance);
@@ -997,6 +1003,16 @@ HttpCreateConnection (
 
   if (!EFI_ERROR (Status)) {
     HttpInstance->State = HTTP_STATE_TCP_CONNECTED;
+
+    HttpInstance->Service->ConnectionsOpened++;
+    DEBUG ((
+      DEBUG_INFO,
+      "HttpDxe: New connection to %a:%d, %d connections opened for %d requests.\n",
+      HttpInstance->RemoteHost,
+      HttpInstance->RemotePort,
+      (UINT32)HttpInstance->Service->ConnectionsOpened,
+      (UINT32)HttpInstance->Service->RequestsServed
+      ));
   }
 
   return Status;
@@ -1048,6 +1064,378 @@ HttpCloseConnection (
   return EFI_SUCCESS;
 }
 
+/**
+  Close a connection taken out of the connection pool.
+
+  @param[in]  HttpService        The HTTP service.
+  @param[in]  Entry              The pooled connection.
+
+**/
+STATIC
+VOID
+HttpConnPoolClose (
+  IN  HTTP_SERVICE     *HttpService,
+  IN  HTTP_CONN_ENTRY  *Entry
+  )
+{
+  //
+  // Reset the connection, the same as Close() with AbortOnClose.
+  //
+  if (!Entry->LocalAddressIsIPv6) {
+    Entry->Tcp4->Configure (Entry->Tcp4, NULL);
+
+    gBS->CloseProtocol (
+           Entry->TcpChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip4DriverBindingHandle,
+      &gEfiTcp4ServiceBindingProtocolGuid,
+      Entry->TcpChildHandle
+      );
+  } else {
+    Entry->Tcp6->Configure (Entry->Tcp6, NULL);
+
+    gBS->CloseProtocol (
+           Entry->TcpChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip6DriverBindingHandle,
+      &gEfiTcp6ServiceBindingProtocolGuid,
+      Entry->TcpChildHandle
+      );
+  }
+
+  FreePool (Entry->RemoteHost);
+  FreePool (Entry);
+}
+
+/**
+  Move the idle keep-alive TCP connection of the HTTP instance to the connection
+  pool of its service, so that a later HTTP instance can reuse it. HTTPS and proxy
+  connections are not pooled.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+  @retval EFI_SUCCESS            The connection is moved to the pool.
+  @retval EFI_UNSUPPORTED        The connection can't be reused.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+HttpConnPoolPut (
+  IN  HTTP_PROTOCOL  *HttpInstance
+  )
+{
+  EFI_STATUS                 Status;
+  HTTP_SERVICE               *HttpService;
+  HTTP_CONN_ENTRY            *Entry;
+  EFI_TCP4_CONNECTION_STATE  Tcp4State;
+  EFI_TCP6_CONNECTION_STATE  Tcp6State;
+  EFI_TPL                    OldTpl;
+
+  HttpService = HttpInstance->Service;
+  Entry       = NULL;
+
+  //
+  // The connection is reusable only if the last response is read completely,
+  // and neither side asked to close it.
+  //
+  if ((HttpInstance->State != HTTP_STATE_TCP_CONNECTED) || (HttpInstance->RemoteHost == NULL) ||
+      HttpInstance->UseHttps || HttpInstance->ProxyConnected || HttpInstance->ConnectionClose ||
+      (HttpInstance->MsgParser != NULL) || (HttpInstance->CacheBody != NULL) ||
+      !NetMapIsEmpty (&HttpInstance->TxTokens) || !NetMapIsEmpty (&HttpInstance->RxTokens))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (!HttpInstance->LocalAddressIsIPv6) {
+    Status = HttpInstance->Tcp4->GetModeData (HttpInstance->Tcp4, &Tcp4State, NULL, NULL, NULL, NULL);
+    if (EFI_ERROR (Status) || (Tcp4State != Tcp4StateEstablished)) {
+      return EFI_UNSUPPORTED;
+    }
+  } else {
+    Status = HttpInstance->Tcp6->GetModeData (HttpInstance->Tcp6, &Tcp6State, NULL, NULL, NULL, NULL);
+    if (EFI_ERROR (Status) || (Tcp6State != Tcp6StateEstablished)) {
+      return EFI_UNSUPPORTED;
+    }
+  }
+
+  Entry = AllocateZeroPool (sizeof (HTTP_CONN_ENTRY));
+  if (Entry == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Detach the TCP child from the HTTP instance. It stays opened by the
+  // driver on the controller.
+  //
+  if (!HttpInstance->LocalAddressIsIPv6) {
+    gBS->CloseProtocol (
+           HttpInstance->Tcp4ChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    Entry->TcpChildHandle = HttpInstance->Tcp4ChildHandle;
+    Entry->Tcp4           = HttpInstance->Tcp4;
+    CopyMem (&Entry->IPv4Node, &HttpInstance->IPv4Node, sizeof (EFI_HTTPv4_ACCESS_POINT));
+    IP4_COPY_ADDRESS (&Entry->RemoteAddr, &HttpInstance->RemoteAddr);
+
+    HttpInstance->Tcp4ChildHandle = NULL;
+    HttpInstance->Tcp4            = NULL;
+  } else {
+    gBS->CloseProtocol (
+           HttpInstance->Tcp6ChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    Entry->TcpChildHandle = HttpInstance->Tcp6ChildHandle;
+    Entry->Tcp6           = HttpInstance->Tcp6;
+    CopyMem (&Entry->Ipv6Node, &HttpInstance->Ipv6Node, sizeof (EFI_HTTPv6_ACCESS_POINT));
+    IP6_COPY_ADDRESS (&Entry->RemoteIpv6Addr, &HttpInstance->RemoteIpv6Addr);
+
+    HttpInstance->Tcp6ChildHandle = NULL;
+    HttpInstance->Tcp6            = NULL;
+  }
+
+  Entry->LocalAddressIsIPv6 = HttpInstance->LocalAddressIsIPv6;
+  Entry->RemotePort         = HttpInstance->RemotePort;
+  Entry->RemoteHost         = HttpInstance->RemoteHost;
+  HttpInstance->RemoteHost  = NULL;
+  HttpInstance->State       = HTTP_STATE_TCP_UNCONFIGED;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  InsertHeadList (&HttpService->ConnPool, &Entry->Link);
+  HttpService->ConnPoolNum++;
+
+  //
+  // Drop the least recently used connection if the pool is full.
+  //
+  if (HttpService->ConnPoolNum > HTTP_CONN_POOL_SIZE) {
+    Entry = NET_LIST_TAIL (&HttpService->ConnPool, HTTP_CONN_ENTRY, Link);
+    RemoveEntryList (&Entry->Link);
+    HttpService->ConnPoolNum--;
+  } else {
+    Entry = NULL;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (Entry != NULL) {
+    HttpConnPoolClose (HttpService, Entry);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Take a pooled connection to the remote host and port for the HTTP instance,
+  in place of its own unconnected TCP child.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+  @param[in]  RemoteHost         The remote host name.
+  @param[in]  RemotePort         The remote port.
+
+  @retval EFI_SUCCESS            The HTTP instance is connected to the remote host.
+  @retval EFI_NOT_FOUND          No pooled connection matches.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+HttpConnPoolGet (
+  IN  HTTP_PROTOCOL  *HttpInstance,
+  IN  CHAR8          *RemoteHost,
+  IN  UINT16         RemotePort
+  )
+{
+  EFI_STATUS       Status;
+  HTTP_SERVICE     *HttpService;
+  HTTP_CONN_ENTRY  *Entry;
+  LIST_ENTRY       *Link;
+  VOID             *Interface;
+  EFI_TPL          OldTpl;
+
+  HttpService = HttpInstance->Service;
+  Entry       = NULL;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  NET_LIST_FOR_EACH (Link, &HttpService->ConnPool) {
+    Entry = NET_LIST_USER_STRUCT (Link, HTTP_CONN_ENTRY, Link);
+    if ((Entry->LocalAddressIsIPv6 == HttpInstance->LocalAddressIsIPv6) &&
+        (Entry->RemotePort == RemotePort) &&
+        (AsciiStrCmp (Entry->RemoteHost, RemoteHost) == 0) &&
+        (HttpInstance->LocalAddressIsIPv6 ?
+         (CompareMem (&Entry->Ipv6Node, &HttpInstance->Ipv6Node, sizeof (EFI_HTTPv6_ACCESS_POINT)) == 0) :
+         (CompareMem (&Entry->IPv4Node, &HttpInstance->IPv4Node, sizeof (EFI_HTTPv4_ACCESS_POINT)) == 0)))
+    {
+      break;
+    }
+
+    Entry = NULL;
+  }
+
+  if (Entry != NULL) {
+    RemoveEntryList (&Entry->Link);
+    HttpService->ConnPoolNum--;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (Entry == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // The events to close the connection, or to reconnect if the server has
+  // closed it meanwhile.
+  //
+  Status = HttpCreateTcpConnCloseEvent (HttpInstance);
+  if (EFI_ERROR (Status)) {
+    HttpConnPoolClose (HttpService, Entry);
+    return Status;
+  }
+
+  //
+  // Replace the unconnected TCP child of the HTTP instance with the pooled one.
+  //
+  if (!HttpInstance->LocalAddressIsIPv6) {
+    Status = gBS->OpenProtocol (
+                    Entry->TcpChildHandle,
+                    &gEfiTcp4ProtocolGuid,
+                    &Interface,
+                    HttpService->Ip4DriverBindingHandle,
+                    HttpInstance->Handle,
+                    EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER
+                    );
+  } else {
+    Status = gBS->OpenProtocol (
+                    Entry->TcpChildHandle,
+                    &gEfiTcp6ProtocolGuid,
+                    &Interface,
+                    HttpService->Ip6DriverBindingHandle,
+                    HttpInstance->Handle,
+                    EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER
+                    );
+  }
+
+  if (EFI_ERROR (Status)) {
+    HttpCloseTcpConnCloseEvent (HttpInstance);
+    HttpConnPoolClose (HttpService, Entry);
+    return Status;
+  }
+
+  if (!HttpInstance->LocalAddressIsIPv6) {
+    gBS->CloseProtocol (
+           HttpInstance->Tcp4ChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    gBS->CloseProtocol (
+           HttpInstance->Tcp4ChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip4DriverBindingHandle,
+      &gEfiTcp4ServiceBindingProtocolGuid,
+      HttpInstance->Tcp4ChildHandle
+      );
+
+    HttpInstance->Tcp4ChildHandle = Entry->TcpChildHandle;
+    HttpInstance->Tcp4            = Entry->Tcp4;
+    IP4_COPY_ADDRESS (&HttpInstance->RemoteAddr, &Entry->RemoteAddr);
+  } else {
+    gBS->CloseProtocol (
+           HttpInstance->Tcp6ChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    gBS->CloseProtocol (
+           HttpInstance->Tcp6ChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip6DriverBindingHandle,
+      &gEfiTcp6ServiceBindingProtocolGuid,
+      HttpInstance->Tcp6ChildHandle
+      );
+
+    HttpInstance->Tcp6ChildHandle = Entry->TcpChildHandle;
+    HttpInstance->Tcp6            = Entry->Tcp6;
+    IP6_COPY_ADDRESS (&HttpInstance->RemoteIpv6Addr, &Entry->RemoteIpv6Addr);
+  }
+
+  HttpInstance->State = HTTP_STATE_TCP_CONNECTED;
+
+  FreePool (Entry->RemoteHost);
+  FreePool (Entry);
+
+  DEBUG ((
+    DEBUG_INFO,
+    "HttpDxe: Reuse the connection to %a:%d, %d connections opened for %d requests.\n",
+    RemoteHost,
+    RemotePort,
+    (UINT32)HttpService->ConnectionsOpened,
+    (UINT32)HttpService->RequestsServed
+    ));
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Close the pooled connections of the HTTP service.
+
+  @param[in]  HttpService        The HTTP service.
+  @param[in]  UsingIpv6          Close the TCP6 connections if TRUE, otherwise
+                                 the TCP4 connections.
+
+**/
+VOID
+HttpConnPoolFlush (
+  IN  HTTP_SERVICE  *HttpService,
+  IN  BOOLEAN       UsingIpv6
+  )
+{
+  LIST_ENTRY       *Link;
+  LIST_ENTRY       *Next;
+  HTTP_CONN_ENTRY  *Entry;
+
+  NET_LIST_FOR_EACH_SAFE (Link, Next, &HttpService->ConnPool) {
+    Entry = NET_LIST_USER_STRUCT (Link, HTTP_CONN_ENTRY, Link);
+    if (Entry->LocalAddressIsIPv6 == UsingIpv6) {
+      RemoveEntryList (&Entry->Link);
+      HttpService->ConnPoolNum--;
+      HttpConnPoolClose (HttpService, Entry);
+    }
+  }
+}
+
 /**
   Configure TCP4 protocol child.
 
@@ -48,6 +48,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define HTTP_URL_BUFFER_LEN  4096
 
+//
+// Maximum number of idle connections kept per HTTP service.
+//
+#define HTTP_CONN_POOL_SIZE  4
+
 typedef struct _HTTP_SERVICE {
   UINT32                          Signature;
   EFI_SERVICE_BINDING_PROTOCOL    ServiceBinding;
@@ -59,8 +64,30 @@ typedef struct _HTTP_SERVICE {
   LIST_ENTRY                      ChildrenList;
   UINTN                           ChildrenNumber;
   INTN                            State;
+
+  //
+  // Idle keep-alive connections left by the destroyed children.
+  //
+  LIST_ENTRY                      ConnPool;
+  UINTN                           ConnPoolNum;
+  UINTN                           ConnectionsOpened;
+  UINTN                           RequestsServed;
 } HTTP_SERVICE;
 
+typedef struct {
+  LIST_ENTRY                 Link;
+  CHAR8                      *RemoteHost;
+  UINT16                     RemotePort;
+  BOOLEAN                    LocalAddressIsIPv6;
+  EFI_HTTPv4_ACCESS_POINT    IPv4Node;
+  EFI_HTTPv6_ACCESS_POINT    Ipv6Node;
+  EFI_IPv4_ADDRESS           RemoteAddr;
+  EFI_IPv6_ADDRESS           RemoteIpv6Addr;
+  EFI_HANDLE                 TcpChildHandle;
+  EFI_TCP4_PROTOCOL          *Tcp4;
+  EFI_TCP6_PROTOCOL          *Tcp6;
+} HTTP_CONN_ENTRY;
+
 typedef struct {
   EFI_TCP4_IO_TOKEN         Tx4Token;
   EFI_TCP4_TRANSMIT_DATA    Tx4Data;
@@ -370,6 +397,57 @@ HttpCloseConnection (
   IN  HTTP_PROTOCOL  *HttpInstance
   );
 
+/**
+  Move the idle keep-alive TCP connection of the HTTP instance to the connection
+  pool of its service, so that a later HTTP instance can reuse it. HTTPS and proxy
+  connections are not pooled.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+  @retval EFI_SUCCESS            The connection is moved to the pool.
+  @retval EFI_UNSUPPORTED        The connection can't be reused.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+HttpConnPoolPut (
+  IN  HTTP_PROTOCOL  *HttpInstance
+  );
+
+/**
+  Take a pooled connection to the remote host and port for the HTTP instance,
+  in place of its own unconnected TCP child.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+  @param[in]  RemoteHost         The remote host name.
+  @param[in]  RemotePort         The remote port.
+
+  @retval EFI_SUCCESS            The HTTP instance is connected to the remote host.
+  @retval EFI_NOT_FOUND          No pooled connection matches.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+HttpConnPoolGet (
+  IN  HTTP_PROTOCOL  *HttpInstance,
+  IN  CHAR8          *RemoteHost,
+  IN  UINT16         RemotePort
+  );
+
+/**
+  Close the pooled connections of the HTTP service.
+
+  @param[in]  HttpService        The HTTP service.
+  @param[in]  UsingIpv6          Close the TCP6 connections if TRUE, otherwise
+                                 the TCP4 connections.
+
+**/
+VOID
+HttpConnPoolFlush (
+  IN  HTTP_SERVICE  *HttpService,
+  IN  BOOLEAN       UsingIpv6
+  );
+
 /**
   Configure TCP4 protocol child.
 
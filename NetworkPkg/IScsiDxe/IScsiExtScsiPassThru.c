@@ -81,6 +81,7 @@ IScsiExtScsiPassThruFunction (
 {
   EFI_STATUS         Status;
   ISCSI_DRIVER_DATA  *Private;
+  EFI_TPL            OldTpl;
 
   if (Target[0] != 0) {
     return EFI_INVALID_PARAMETER;
@@ -90,19 +91,50 @@ IScsiExtScsiPassThruFunction (
     return EFI_INVALID_PARAMETER;
   }
 
-  Status = IScsiExecuteScsiCommand (This, Target, Lun, Packet);
-  if ((Status != EFI_SUCCESS) && (Status != EFI_NOT_READY)) {
+  if (EfiGetCurrentTpl () > TPL_CALLBACK) {
     //
-    // Try to reinstate the session and re-execute the Scsi command.
+    // The TCP I/O can't complete above TPL_CALLBACK, e.g. when the request is
+    // issued from the completion event of a previous one. Queue the nonblocking
+    // request and let the task poll timer send it.
+    //
+    if (Event == NULL) {
+      return EFI_NOT_READY;
+    }
+
+    return IScsiQueueScsiCommand (This, Lun, Packet, Event);
+  }
+
+  Private = ISCSI_DRIVER_DATA_FROM_EXT_SCSI_PASS_THRU (This);
+
+  //
+  // Serialize with the task poll timer which drives the nonblocking requests.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  if (Private->Session->ReinstatementPending) {
+    //
+    // The task poll timer found the connection out of step with the target.
     //
-    Private = ISCSI_DRIVER_DATA_FROM_EXT_SCSI_PASS_THRU (This);
     if (EFI_ERROR (IScsiSessionReinstatement (Private->Session))) {
+      gBS->RestoreTPL (OldTpl);
       return EFI_DEVICE_ERROR;
     }
+  }
 
-    Status = IScsiExecuteScsiCommand (This, Target, Lun, Packet);
+  Status = IScsiExecuteScsiCommand (This, Target, Lun, Packet, Event);
+  if ((Status != EFI_SUCCESS) && (Status != EFI_NOT_READY)) {
+    //
+    // Try to reinstate the session and re-execute the Scsi command.
+    //
+    if (EFI_ERROR (IScsiSessionReinstatement (Private->Session))) {
+      Status = EFI_DEVICE_ERROR;
+    } else {
+      Status = IScsiExecuteScsiCommand (This, Target, Lun, Packet, Event);
+    }
   }
 
+  gBS->RestoreTPL (OldTpl);
+
   return Status;
 }
 
@@ -106,6 +106,18 @@ struct _ISCSI_SESSION {
 
   LIST_ENTRY                     TcbList;
 
+  //
+  // The nonblocking requests issued above TPL_CALLBACK, which are turned into
+  // tasks by the task poll timer. Accessed at TPL_NOTIFY.
+  //
+  LIST_ENTRY                     PendingList;
+
+  //
+  // Set by the task poll timer when the connection is out of step with the
+  // target. The session is reinstated by the next pass thru call.
+  //
+  BOOLEAN                        ReinstatementPending;
+
   //
   // Session-wide parameters
   //
@@ -153,6 +165,16 @@ struct _ISCSI_CONNECTION {
   //
   NET_BUF_QUEUE        RspQue;
 
+  //
+  // The PDU partially received by the task poll timer: the header, and the
+  // data segment once the header is complete.
+  //
+  NET_BUF              *RxPduHdr;
+  UINT32               RxPduHdrLen;
+  NET_BUF              *RxDataSeg;
+  UINT32               RxDataSegLen;
+  UINT32               RxPadAndCRC32[2];
+
   BOOLEAN              Ipv6Flag;
   TCP_IO               TcpIo;
 
@@ -189,6 +211,7 @@ struct _ISCSI_DRIVER_DATA {
   ISCSI_PRIVATE_PROTOCOL             IScsiIdentifier;
 
   EFI_EVENT                          ExitBootServiceEvent;
+  EFI_EVENT                          TaskPollEvent;
 
   EFI_EXT_SCSI_PASS_THRU_PROTOCOL    IScsiExtScsiPassThru;
   EFI_EXT_SCSI_PASS_THRU_MODE        ExtScsiPassThruMode;
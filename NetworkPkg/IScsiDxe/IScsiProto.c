@@ -314,6 +314,14 @@ IScsiDestroyConnection (
   TcpIoDestroySocket (&Conn->TcpIo);
 
   NetbufQueFlush (&Conn->RspQue);
+  if (Conn->RxPduHdr != NULL) {
+    NetbufFree (Conn->RxPduHdr);
+  }
+
+  if (Conn->RxDataSeg != NULL) {
+    NetbufFree (Conn->RxDataSeg);
+  }
+
   gBS->CloseEvent (Conn->TimeoutEvent);
   FreePool (Conn);
 }
@@ -1284,99 +1292,190 @@ IScsiNbufExtFree (
 }
 
 /**
-  Receive an iSCSI response PDU. An iSCSI response PDU contains an iSCSI PDU header and
-  an optional data segment. The two parts will be put into two blocks of buffers in the
-  net buffer. The digest check will be conducted in this function if needed and the digests
-  will be trimmed from the PDU buffer.
+  Receive the data already buffered by the TCP into a buffer, without waiting
+  for more data to arrive.
 
   @param[in]  Conn         The iSCSI connection to receive data from.
-  @param[out] Pdu          The received iSCSI pdu.
-  @param[in]  Context      The context used to describe information on the caller provided
-                           buffer to receive data segment of the iSCSI pdu. It is optional.
-  @param[in]  HeaderDigest Whether there will be header digest received.
-  @param[in]  DataDigest   Whether there will be data digest.
-  @param[in]  TimeoutEvent The timeout event. It is optional.
+  @param[out] Buffer       The buffer to receive the data.
+  @param[in]  Length       The size of Buffer in bytes.
+  @param[out] Received     The number of bytes received.
 
-  @retval EFI_SUCCESS          An iSCSI pdu is received.
-  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
-  @retval EFI_PROTOCOL_ERROR   Some kind of iSCSI protocol error occurred.
+  @retval EFI_SUCCESS          Some data is received.
+  @retval EFI_NOT_READY        No data is buffered by the TCP.
   @retval Others               Other errors as indicated.
 
 **/
+STATIC
 EFI_STATUS
-IScsiReceivePdu (
-  IN ISCSI_CONNECTION         *Conn,
-  OUT NET_BUF                 **Pdu,
-  IN ISCSI_IN_BUFFER_CONTEXT  *Context  OPTIONAL,
-  IN BOOLEAN                  HeaderDigest,
-  IN BOOLEAN                  DataDigest,
-  IN EFI_EVENT                TimeoutEvent OPTIONAL
+IScsiPollReceive (
+  IN  ISCSI_CONNECTION  *Conn,
+  OUT UINT8             *Buffer,
+  IN  UINT32            Length,
+  OUT UINT32            *Received
   )
 {
-  LIST_ENTRY    *NbufList;
-  UINT32        Len;
-  NET_BUF       *PduHdr;
-  UINT8         *Header;
-  EFI_STATUS    Status;
-  UINT32        PadLen;
-  UINT32        InDataOffset;
-  NET_FRAGMENT  Fragment[2];
-  UINT32        FragmentCount;
-  NET_BUF       *DataSeg;
-  UINT32        PadAndCRC32[2];
-
-  NbufList = AllocatePool (sizeof (LIST_ENTRY));
-  if (NbufList == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  InitializeListHead (NbufList);
+  TCP_IO                 *TcpIo;
+  EFI_TCP4_RECEIVE_DATA  *RxData;
+  EFI_STATUS             Status;
 
   //
-  // The header digest will be received together with the PDU header, if exists.
+  // Post a receive request and poll the TCP once. The request completes at once
+  // if some data is already buffered by the TCP, otherwise it's cancelled so
+  // that it doesn't wait for the data.
   //
-  Len    = sizeof (ISCSI_BASIC_HEADER) + (HeaderDigest ? sizeof (UINT32) : 0);
-  PduHdr = NetbufAlloc (Len);
-  if (PduHdr == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto ON_EXIT;
+  TcpIo  = &Conn->TcpIo;
+  RxData = TcpIo->RxToken.Tcp4Token.Packet.RxData;
+
+  RxData->DataLength                      = Length;
+  RxData->FragmentCount                   = 1;
+  RxData->FragmentTable[0].FragmentLength = Length;
+  RxData->FragmentTable[0].FragmentBuffer = Buffer;
+
+  TcpIo->IsRxDone = FALSE;
+
+  if (TcpIo->TcpVersion == TCP_VERSION_4) {
+    Status = TcpIo->Tcp.Tcp4->Receive (TcpIo->Tcp.Tcp4, &TcpIo->RxToken.Tcp4Token);
+    if (!EFI_ERROR (Status) && !TcpIo->IsRxDone) {
+      TcpIo->Tcp.Tcp4->Poll (TcpIo->Tcp.Tcp4);
+      if (!TcpIo->IsRxDone) {
+        TcpIo->Tcp.Tcp4->Cancel (TcpIo->Tcp.Tcp4, &TcpIo->RxToken.Tcp4Token.CompletionToken);
+      }
+    }
+  } else {
+    Status = TcpIo->Tcp.Tcp6->Receive (TcpIo->Tcp.Tcp6, &TcpIo->RxToken.Tcp6Token);
+    if (!EFI_ERROR (Status) && !TcpIo->IsRxDone) {
+      TcpIo->Tcp.Tcp6->Poll (TcpIo->Tcp.Tcp6);
+      if (!TcpIo->IsRxDone) {
+        TcpIo->Tcp.Tcp6->Cancel (TcpIo->Tcp.Tcp6, &TcpIo->RxToken.Tcp6Token.CompletionToken);
+      }
+    }
   }
 
-  Header = NetbufAllocSpace (PduHdr, Len, NET_BUF_TAIL);
-  if (Header == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto ON_EXIT;
+  if (EFI_ERROR (Status)) {
+    return Status;
   }
 
-  InsertTailList (NbufList, &PduHdr->List);
+  TcpIo->IsRxDone = FALSE;
 
-  //
-  // First step, receive the BHS of the PDU.
-  //
-  Status = TcpIoReceive (&Conn->TcpIo, PduHdr, FALSE, TimeoutEvent);
+  Status = TcpIo->RxToken.Tcp4Token.CompletionToken.Status;
+  if (Status == EFI_ABORTED) {
+    return EFI_NOT_READY;
+  }
 
   if (EFI_ERROR (Status)) {
-    goto ON_EXIT;
+    return Status;
   }
 
-  if (HeaderDigest) {
-    //
-    // TODO: check the header-digest.
-    //
-    //
-    // Trim off the digest.
-    //
-    NetbufTrim (PduHdr, sizeof (UINT32), NET_BUF_TAIL);
+  *Received = (UINT32)RxData->FragmentTable[0].FragmentLength;
+  return EFI_SUCCESS;
+}
+
+/**
+  Receive the BHS of an iSCSI PDU, together with the header digest if exists. The
+  bytes received are kept in the connection, so that a header arriving in pieces
+  can be received by several calls.
+
+  @param[in]  Conn         The iSCSI connection to receive data from.
+  @param[in]  Len          The length of the BHS and the header digest.
+  @param[in]  Poll         If TRUE, only receive the data already arrived. Otherwise
+                           wait until the whole header is received.
+  @param[in]  TimeoutEvent The timeout event if Poll is FALSE. It is optional.
+
+  @retval EFI_SUCCESS          The whole header is received into Conn->RxPduHdr.
+  @retval EFI_NOT_READY        Poll is TRUE and the whole header hasn't arrived yet.
+  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
+  @retval Others               Other errors as indicated.
+
+**/
+STATIC
+EFI_STATUS
+IScsiReceivePduHeader (
+  IN ISCSI_CONNECTION  *Conn,
+  IN UINT32            Len,
+  IN BOOLEAN           Poll,
+  IN EFI_EVENT         TimeoutEvent OPTIONAL
+  )
+{
+  NET_FRAGMENT  Fragment;
+  NET_BUF       *Remainder;
+  UINT32        Received;
+  EFI_STATUS    Status;
+
+  if (Conn->RxPduHdr == NULL) {
+    Conn->RxPduHdr = NetbufAlloc (Len);
+    if (Conn->RxPduHdr == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    NetbufAllocSpace (Conn->RxPduHdr, Len, NET_BUF_TAIL);
+    Conn->RxPduHdrLen = 0;
   }
 
-  Len = ISCSI_GET_DATASEG_LEN (Header);
-  if (Len == 0) {
-    //
-    // No data segment.
-    //
-    goto FORM_PDU;
+  ASSERT (Conn->RxPduHdr->TotalSize == Len);
+
+  Fragment.Len  = Len - Conn->RxPduHdrLen;
+  Fragment.Bulk = NetbufGetByte (Conn->RxPduHdr, Conn->RxPduHdrLen, NULL);
+
+  if (!Poll) {
+    Remainder = NetbufFromExt (&Fragment, 1, 0, 0, IScsiNbufExtFree, NULL);
+    if (Remainder == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Status = TcpIoReceive (&Conn->TcpIo, Remainder, FALSE, TimeoutEvent);
+    NetbufFree (Remainder);
+
+    if (!EFI_ERROR (Status)) {
+      Conn->RxPduHdrLen = Len;
+    }
+
+    return Status;
+  }
+
+  Status = IScsiPollReceive (Conn, Fragment.Bulk, Fragment.Len, &Received);
+  if (EFI_ERROR (Status)) {
+    return Status;
   }
 
+  Conn->RxPduHdrLen += Received;
+
+  return (Conn->RxPduHdrLen < Len) ? EFI_NOT_READY : EFI_SUCCESS;
+}
+
+/**
+  Create the buffer to receive the data segment of an iSCSI PDU whose header
+  has been received. The data digest, if any, is received into the buffer too.
+
+  @param[in]  Conn         The iSCSI connection to receive data from.
+  @param[in]  Header       The header of the PDU.
+  @param[in]  Context      The context used to describe information on the caller provided
+                           buffer to receive data segment of the iSCSI pdu. It is optional.
+  @param[in]  DataDigest   Whether there will be data digest.
+
+  @retval EFI_SUCCESS          The buffer is created in Conn->RxDataSeg.
+  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
+  @retval EFI_PROTOCOL_ERROR   Some kind of iSCSI protocol error occurred.
+
+**/
+STATIC
+EFI_STATUS
+IScsiCreatePduDataSeg (
+  IN ISCSI_CONNECTION         *Conn,
+  IN UINT8                    *Header,
+  IN ISCSI_IN_BUFFER_CONTEXT  *Context  OPTIONAL,
+  IN BOOLEAN                  DataDigest
+  )
+{
+  UINT32        Len;
+  UINT32        PadLen;
+  UINT32        InDataOffset;
+  NET_FRAGMENT  Fragment[2];
+  UINT32        FragmentCount;
+  NET_BUF       *DataSeg;
+  ISCSI_TCB     *Tcb;
+
+  Len = ISCSI_GET_DATASEG_LEN (Header);
+
   //
   // Get the length of the padding bytes of the data segment.
   //
@@ -1386,12 +1485,17 @@ IScsiReceivePdu (
     case ISCSI_OPCODE_SCSI_DATA_IN:
       //
       // To reduce memory copy overhead, try to use the buffer described by Context
-      // if the PDU is an iSCSI SCSI data.
+      // if the PDU is an iSCSI SCSI data. With several outstanding tasks, use the
+      // buffer of the task the PDU belongs to.
       //
+      Tcb = IScsiFindTcb (Conn->Session, NTOHL (((ISCSI_BASIC_HEADER *)Header)->InitiatorTaskTag));
+      if (Tcb != NULL) {
+        Context = &Tcb->InBufferContext;
+      }
+
       InDataOffset = ISCSI_GET_BUFFER_OFFSET (Header);
       if ((Context == NULL) || ((InDataOffset + Len) > Context->InDataLen)) {
-        Status = EFI_PROTOCOL_ERROR;
-        goto ON_EXIT;
+        return EFI_PROTOCOL_ERROR;
       }
 
       Fragment[0].Len  = Len;
@@ -1403,7 +1507,7 @@ IScsiReceivePdu (
         // the first to receive the useful data; the second to receive the padding.
         //
         Fragment[1].Len  = PadLen + (DataDigest ? sizeof (UINT32) : 0);
-        Fragment[1].Bulk = (UINT8 *)PadAndCRC32 + (4 - PadLen);
+        Fragment[1].Bulk = (UINT8 *)Conn->RxPadAndCRC32 + (4 - PadLen);
 
         FragmentCount = 2;
       } else {
@@ -1412,8 +1516,7 @@ IScsiReceivePdu (
 
       DataSeg = NetbufFromExt (&Fragment[0], FragmentCount, 0, 0, IScsiNbufExtFree, NULL);
       if (DataSeg == NULL) {
-        Status = EFI_OUT_OF_RESOURCES;
-        goto ON_EXIT;
+        return EFI_OUT_OF_RESOURCES;
       }
 
       break;
@@ -1433,121 +1536,333 @@ IScsiReceivePdu (
       Len    += PadLen + (DataDigest ? sizeof (UINT32) : 0);
       DataSeg = NetbufAlloc (Len);
       if (DataSeg == NULL) {
-        Status = EFI_OUT_OF_RESOURCES;
-        goto ON_EXIT;
+        return EFI_OUT_OF_RESOURCES;
       }
 
       NetbufAllocSpace (DataSeg, Len, NET_BUF_TAIL);
       break;
 
     default:
-      Status = EFI_PROTOCOL_ERROR;
-      goto ON_EXIT;
+      return EFI_PROTOCOL_ERROR;
   }
 
-  InsertTailList (NbufList, &DataSeg->List);
+  Conn->RxDataSeg    = DataSeg;
+  Conn->RxDataSegLen = 0;
+  return EFI_SUCCESS;
+}
 
-  //
-  // Receive the data segment with the data digest, if any.
-  //
-  Status = TcpIoReceive (&Conn->TcpIo, DataSeg, FALSE, TimeoutEvent);
+/**
+  Receive the data segment of an iSCSI PDU into Conn->RxDataSeg. The bytes
+  received are kept in the connection, so that a data segment arriving in
+  pieces can be received by several calls.
 
-  if (EFI_ERROR (Status)) {
-    goto ON_EXIT;
-  }
+  @param[in]  Conn         The iSCSI connection to receive data from.
+  @param[in]  Poll         If TRUE, only receive the data already arrived. Otherwise
+                           wait until the whole data segment is received.
+  @param[in]  TimeoutEvent The timeout event if Poll is FALSE. It is optional.
 
-  if (DataDigest) {
-    //
-    // TODO: Check the data digest.
-    //
-    NetbufTrim (DataSeg, sizeof (UINT32), NET_BUF_TAIL);
-  }
+  @retval EFI_SUCCESS          The whole data segment is received.
+  @retval EFI_NOT_READY        Poll is TRUE and the whole data segment hasn't arrived yet.
+  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
+  @retval Others               Other errors as indicated.
 
-  if (PadLen != 0) {
+**/
+STATIC
+EFI_STATUS
+IScsiReceivePduData (
+  IN ISCSI_CONNECTION  *Conn,
+  IN BOOLEAN           Poll,
+  IN EFI_EVENT         TimeoutEvent OPTIONAL
+  )
+{
+  NET_BUF     *DataSeg;
+  NET_BUF     *Remainder;
+  UINT8       *Bulk;
+  UINT32      Index;
+  UINT32      Received;
+  EFI_STATUS  Status;
+
+  DataSeg = Conn->RxDataSeg;
+
+  if (!Poll) {
     //
-    // Trim off the padding bytes in the data segment.
+    // The remainder shares the blocks of the data segment.
     //
-    NetbufTrim (DataSeg, PadLen, NET_BUF_TAIL);
-  }
+    Remainder = NetbufGetFragment (DataSeg, Conn->RxDataSegLen, DataSeg->TotalSize - Conn->RxDataSegLen, 0);
+    if (Remainder == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
 
-FORM_PDU:
-  //
-  // Form the pdu from a list of pdu segments.
-  //
-  *Pdu = NetbufFromBufList (NbufList, 0, 0, IScsiFreeNbufList, NbufList);
-  if (*Pdu == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
+    Status = TcpIoReceive (&Conn->TcpIo, Remainder, FALSE, TimeoutEvent);
+    NetbufFree (Remainder);
+
+    if (!EFI_ERROR (Status)) {
+      Conn->RxDataSegLen = DataSeg->TotalSize;
+    }
+
+    return Status;
   }
 
-ON_EXIT:
+  while (Conn->RxDataSegLen < DataSeg->TotalSize) {
+    Bulk   = NetbufGetByte (DataSeg, Conn->RxDataSegLen, &Index);
+    Status = IScsiPollReceive (
+               Conn,
+               Bulk,
+               (UINT32)(DataSeg->BlockOp[Index].Tail - Bulk),
+               &Received
+               );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
 
-  if (EFI_ERROR (Status)) {
-    //
-    // Free the Nbufs in this NbufList and the NbufList itself.
-    //
-    IScsiFreeNbufList (NbufList);
+    Conn->RxDataSegLen += Received;
   }
 
-  return Status;
+  return EFI_SUCCESS;
 }
 
 /**
-  Check and get the result of the parameter negotiation.
+  Receive an iSCSI response PDU. An iSCSI response PDU contains an iSCSI PDU header and
+  an optional data segment. The two parts will be put into two blocks of buffers in the
+  net buffer. The digest check will be conducted in this function if needed and the digests
+  will be trimmed from the PDU buffer.
 
-  @param[in, out]  Conn          The connection in iSCSI login.
+  @param[in]  Conn         The iSCSI connection to receive data from.
+  @param[out] Pdu          The received iSCSI pdu.
+  @param[in]  Context      The context used to describe information on the caller provided
+                           buffer to receive data segment of the iSCSI pdu. It is optional.
+  @param[in]  HeaderDigest Whether there will be header digest received.
+  @param[in]  DataDigest   Whether there will be data digest.
+  @param[in]  Poll         If TRUE, return at once if the whole PDU hasn't arrived. The
+                           part already arrived is kept in the connection.
+  @param[in]  TimeoutEvent The timeout event. It is optional.
 
-  @retval EFI_SUCCESS          The parameter check is passed and negotiation is finished.
-  @retval EFI_PROTOCOL_ERROR   Some kind of iSCSI protocol error occurred.
+  @retval EFI_SUCCESS          An iSCSI pdu is received.
+  @retval EFI_NOT_READY        Poll is TRUE and the whole PDU hasn't arrived yet.
   @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
+  @retval EFI_PROTOCOL_ERROR   Some kind of iSCSI protocol error occurred.
+  @retval Others               Other errors as indicated.
 
 **/
+STATIC
 EFI_STATUS
-IScsiCheckOpParams (
-  IN OUT ISCSI_CONNECTION  *Conn
+IScsiReceivePduEx (
+  IN ISCSI_CONNECTION         *Conn,
+  OUT NET_BUF                 **Pdu,
+  IN ISCSI_IN_BUFFER_CONTEXT  *Context  OPTIONAL,
+  IN BOOLEAN                  HeaderDigest,
+  IN BOOLEAN                  DataDigest,
+  IN BOOLEAN                  Poll,
+  IN EFI_EVENT                TimeoutEvent OPTIONAL
   )
 {
-  EFI_STATUS     Status;
-  LIST_ENTRY     *KeyValueList;
-  CHAR8          *Data;
-  UINT32         Len;
-  ISCSI_SESSION  *Session;
-  CHAR8          *Value;
-  UINTN          NumericValue;
-
-  ASSERT (Conn->RspQue.BufNum != 0);
-
-  Session = Conn->Session;
-
-  Len  = Conn->RspQue.BufSize;
-  Data = AllocatePool (Len);
-  if (Data == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  NetbufQueCopy (&Conn->RspQue, 0, Len, (UINT8 *)Data);
-
-  Status = EFI_PROTOCOL_ERROR;
+  LIST_ENTRY  *NbufList;
+  UINT32      Len;
+  NET_BUF     *PduHdr;
+  UINT8       *Header;
+  EFI_STATUS  Status;
+  UINT32      PadLen;
+  NET_BUF     *DataSeg;
 
   //
-  // Extract the Key-Value pairs into a list.
+  // First step, receive the BHS of the PDU. The header digest will be received
+  // together with the PDU header, if exists.
   //
-  KeyValueList = IScsiBuildKeyValueList (Data, Len);
-  if (KeyValueList == NULL) {
-    FreePool (Data);
+  Len    = sizeof (ISCSI_BASIC_HEADER) + (HeaderDigest ? sizeof (UINT32) : 0);
+  Status = IScsiReceivePduHeader (Conn, Len, Poll, TimeoutEvent);
+  if (EFI_ERROR (Status)) {
     return Status;
   }
 
+  Header = NetbufGetByte (Conn->RxPduHdr, 0, NULL);
+  Len    = ISCSI_GET_DATASEG_LEN (Header);
+  PadLen = ISCSI_GET_PAD_LEN (Len);
+
   //
-  // HeaderDigest
+  // Second step, receive the data segment with the data digest, if any.
   //
-  Value = IScsiGetValueByKeyFromList (KeyValueList, ISCSI_KEY_HEADER_DIGEST);
-  if (Value == NULL) {
-    goto ON_ERROR;
-  }
-
-  if (AsciiStrCmp (Value, "CRC32") == 0) {
-    if (Conn->HeaderDigest != IScsiDigestCRC32) {
-      goto ON_ERROR;
+  if (Len != 0) {
+    if (Conn->RxDataSeg == NULL) {
+      Status = IScsiCreatePduDataSeg (Conn, Header, Context, DataDigest);
+    }
+
+    if (!EFI_ERROR (Status)) {
+      Status = IScsiReceivePduData (Conn, Poll, TimeoutEvent);
+      if (Status == EFI_NOT_READY) {
+        return Status;
+      }
+    }
+
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+  }
+
+  PduHdr             = Conn->RxPduHdr;
+  DataSeg            = Conn->RxDataSeg;
+  Conn->RxPduHdr     = NULL;
+  Conn->RxDataSeg    = NULL;
+  Conn->RxDataSegLen = 0;
+
+  NbufList = AllocatePool (sizeof (LIST_ENTRY));
+  if (NbufList == NULL) {
+    NetbufFree (PduHdr);
+    if (DataSeg != NULL) {
+      NetbufFree (DataSeg);
+    }
+
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  InitializeListHead (NbufList);
+  InsertTailList (NbufList, &PduHdr->List);
+
+  if (HeaderDigest) {
+    //
+    // TODO: check the header-digest.
+    //
+    //
+    // Trim off the digest.
+    //
+    NetbufTrim (PduHdr, sizeof (UINT32), NET_BUF_TAIL);
+  }
+
+  if (DataSeg != NULL) {
+    InsertTailList (NbufList, &DataSeg->List);
+
+    if (DataDigest) {
+      //
+      // TODO: Check the data digest.
+      //
+      NetbufTrim (DataSeg, sizeof (UINT32), NET_BUF_TAIL);
+    }
+
+    if (PadLen != 0) {
+      //
+      // Trim off the padding bytes in the data segment.
+      //
+      NetbufTrim (DataSeg, PadLen, NET_BUF_TAIL);
+    }
+  }
+
+  //
+  // Form the pdu from a list of pdu segments.
+  //
+  *Pdu = NetbufFromBufList (NbufList, 0, 0, IScsiFreeNbufList, NbufList);
+  if (*Pdu == NULL) {
+    //
+    // Free the Nbufs in this NbufList and the NbufList itself.
+    //
+    IScsiFreeNbufList (NbufList);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  //
+  // Drop the partially received PDU.
+  //
+  NetbufFree (Conn->RxPduHdr);
+  Conn->RxPduHdr = NULL;
+  if (Conn->RxDataSeg != NULL) {
+    NetbufFree (Conn->RxDataSeg);
+    Conn->RxDataSeg = NULL;
+  }
+
+  return Status;
+}
+
+/**
+  Receive an iSCSI response PDU. An iSCSI response PDU contains an iSCSI PDU header and
+  an optional data segment. The two parts will be put into two blocks of buffers in the
+  net buffer. The digest check will be conducted in this function if needed and the digests
+  will be trimmed from the PDU buffer.
+
+  @param[in]  Conn         The iSCSI connection to receive data from.
+  @param[out] Pdu          The received iSCSI pdu.
+  @param[in]  Context      The context used to describe information on the caller provided
+                           buffer to receive data segment of the iSCSI pdu. It is optional.
+  @param[in]  HeaderDigest Whether there will be header digest received.
+  @param[in]  DataDigest   Whether there will be data digest.
+  @param[in]  TimeoutEvent The timeout event. It is optional.
+
+  @retval EFI_SUCCESS          An iSCSI pdu is received.
+  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
+  @retval EFI_PROTOCOL_ERROR   Some kind of iSCSI protocol error occurred.
+  @retval Others               Other errors as indicated.
+
+**/
+EFI_STATUS
+IScsiReceivePdu (
+  IN ISCSI_CONNECTION         *Conn,
+  OUT NET_BUF                 **Pdu,
+  IN ISCSI_IN_BUFFER_CONTEXT  *Context  OPTIONAL,
+  IN BOOLEAN                  HeaderDigest,
+  IN BOOLEAN                  DataDigest,
+  IN EFI_EVENT                TimeoutEvent OPTIONAL
+  )
+{
+  return IScsiReceivePduEx (Conn, Pdu, Context, HeaderDigest, DataDigest, FALSE, TimeoutEvent);
+}
+
+/**
+  Check and get the result of the parameter negotiation.
+
+  @param[in, out]  Conn          The connection in iSCSI login.
+
+  @retval EFI_SUCCESS          The parameter check is passed and negotiation is finished.
+  @retval EFI_PROTOCOL_ERROR   Some kind of iSCSI protocol error occurred.
+  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
+
+**/
+EFI_STATUS
+IScsiCheckOpParams (
+  IN OUT ISCSI_CONNECTION  *Conn
+  )
+{
+  EFI_STATUS     Status;
+  LIST_ENTRY     *KeyValueList;
+  CHAR8          *Data;
+  UINT32         Len;
+  ISCSI_SESSION  *Session;
+  CHAR8          *Value;
+  UINTN          NumericValue;
+
+  ASSERT (Conn->RspQue.BufNum != 0);
+
+  Session = Conn->Session;
+
+  Len  = Conn->RspQue.BufSize;
+  Data = AllocatePool (Len);
+  if (Data == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  NetbufQueCopy (&Conn->RspQue, 0, Len, (UINT8 *)Data);
+
+  Status = EFI_PROTOCOL_ERROR;
+
+  //
+  // Extract the Key-Value pairs into a list.
+  //
+  KeyValueList = IScsiBuildKeyValueList (Data, Len);
+  if (KeyValueList == NULL) {
+    FreePool (Data);
+    return Status;
+  }
+
+  //
+  // HeaderDigest
+  //
+  Value = IScsiGetValueByKeyFromList (KeyValueList, ISCSI_KEY_HEADER_DIGEST);
+  if (Value == NULL) {
+    goto ON_ERROR;
+  }
+
+  if (AsciiStrCmp (Value, "CRC32") == 0) {
+    if (Conn->HeaderDigest != IScsiDigestCRC32) {
+      goto ON_ERROR;
     }
   } else if (AsciiStrCmp (Value, ISCSI_KEY_VALUE_NONE) == 0) {
     Conn->HeaderDigest = IScsiDigestNone;
@@ -2908,54 +3223,172 @@ IScsiOnNopInRcvd (
 }
 
 /**
-  Execute the SCSI command issued through the EXT SCSI PASS THRU protocol.
+  Find the outstanding task with the specified initiator task tag.
 
-  @param[in]       PassThru  The EXT SCSI PASS THRU protocol.
-  @param[in]       Target    The target ID.
+  @param[in]  Session           The iSCSI session.
+  @param[in]  InitiatorTaskTag  The initiator task tag in host byte order.
+
+  @return The task control block, or NULL if no task uses this tag.
+
+**/
+ISCSI_TCB *
+IScsiFindTcb (
+  IN ISCSI_SESSION  *Session,
+  IN UINT32         InitiatorTaskTag
+  )
+{
+  LIST_ENTRY  *Entry;
+  ISCSI_TCB   *Tcb;
+
+  NET_LIST_FOR_EACH (Entry, &Session->TcbList) {
+    Tcb = NET_LIST_USER_STRUCT (Entry, ISCSI_TCB, Link);
+    if (Tcb->InitiatorTaskTag == InitiatorTaskTag) {
+      return Tcb;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Get the oldest nonblocking task whose SCSI command is already sent.
+
+  @param[in]  Session           The iSCSI session.
+
+  @return The task control block, or NULL if there is no such task.
+
+**/
+STATIC
+ISCSI_TCB *
+IScsiGetNonblockingTcb (
+  IN ISCSI_SESSION  *Session
+  )
+{
+  LIST_ENTRY  *Entry;
+  ISCSI_TCB   *Tcb;
+
+  NET_LIST_FOR_EACH (Entry, &Session->TcbList) {
+    Tcb = NET_LIST_USER_STRUCT (Entry, ISCSI_TCB, Link);
+    if ((Tcb->Event != NULL) && Tcb->CmdSent) {
+      return Tcb;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Complete a nonblocking task. The task is destroyed and the event of the
+  caller is signaled.
+
+  @param[in]  Tcb               The task control block.
+  @param[in]  Status            The completion status of the task.
+
+**/
+STATIC
+VOID
+IScsiCompleteTcb (
+  IN ISCSI_TCB   *Tcb,
+  IN EFI_STATUS  Status
+  )
+{
+  EFI_EVENT  Event;
+
+  ASSERT (Tcb->Event != NULL);
+
+  if (EFI_ERROR (Status) && (Status != EFI_BAD_BUFFER_SIZE)) {
+    Tcb->Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_OTHER;
+  }
+
+  Event = Tcb->Event;
+  IScsiDelTcb (Tcb);
+
+  gBS->SignalEvent (Event);
+}
+
+/**
+  Abort all the outstanding nonblocking tasks and the pending nonblocking
+  requests of the session, and signal their events.
+
+  @param[in]  Session           The iSCSI session.
+
+**/
+VOID
+IScsiAbortTcbs (
+  IN ISCSI_SESSION  *Session
+  )
+{
+  LIST_ENTRY             *Entry;
+  ISCSI_TCB              *Tcb;
+  ISCSI_PENDING_REQUEST  *Request;
+  EFI_TPL                OldTpl;
+
+  //
+  // The caller may queue a new task when its event is signaled, so restart
+  // from the list head after each completion.
+  //
+  Entry = Session->TcbList.ForwardLink;
+  while (Entry != &Session->TcbList) {
+    Tcb = NET_LIST_USER_STRUCT (Entry, ISCSI_TCB, Link);
+    if (Tcb->Event == NULL) {
+      Entry = Entry->ForwardLink;
+      continue;
+    }
+
+    IScsiCompleteTcb (Tcb, EFI_ABORTED);
+    Entry = Session->TcbList.ForwardLink;
+  }
+
+  while (TRUE) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    if (IsListEmpty (&Session->PendingList)) {
+      gBS->RestoreTPL (OldTpl);
+      break;
+    }
+
+    Request = NET_LIST_HEAD (&Session->PendingList, ISCSI_PENDING_REQUEST, Link);
+    RemoveEntryList (&Request->Link);
+    gBS->RestoreTPL (OldTpl);
+
+    Request->Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_OTHER;
+    gBS->SignalEvent (Request->Event);
+    FreePool (Request);
+  }
+}
+
+/**
+  Create a task for the SCSI request issued through the EXT SCSI PASS THRU
+  protocol. The command is not sent yet.
+
+  @param[in]       Session   The iSCSI session.
   @param[in]       Lun       The LUN.
   @param[in, out]  Packet    The request packet containing IO request, SCSI command
                              buffer and buffers to read/write.
+  @param[in]       Event     The event to signal when the command completes. NULL
+                             for a blocking request.
+  @param[out]      Tcb       The newly created task control block.
 
-  @retval EFI_SUCCESS          The SCSI command is executed and the result is updated to
-                               the Packet.
+  @retval EFI_SUCCESS          The task is created.
   @retval EFI_DEVICE_ERROR     Session state was not as required.
   @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
-  @retval EFI_PROTOCOL_ERROR   There is no such data in the net buffer.
   @retval EFI_NOT_READY        The target can not accept new commands.
-  @retval Others               Other errors as indicated.
 
 **/
+STATIC
 EFI_STATUS
-IScsiExecuteScsiCommand (
-  IN EFI_EXT_SCSI_PASS_THRU_PROTOCOL                 *PassThru,
-  IN UINT8                                           *Target,
-  IN UINT64                                          Lun,
-  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet
+IScsiNewScsiTask (
+  IN     ISCSI_SESSION                               *Session,
+  IN     UINT64                                      Lun,
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  IN     EFI_EVENT                                   Event     OPTIONAL,
+  OUT    ISCSI_TCB                                   **Tcb
   )
 {
-  EFI_STATUS               Status;
-  ISCSI_DRIVER_DATA        *Private;
-  ISCSI_SESSION            *Session;
-  EFI_EVENT                TimeoutEvent;
-  ISCSI_CONNECTION         *Conn;
-  ISCSI_TCB                *Tcb;
-  NET_BUF                  *Pdu;
-  ISCSI_XFER_CONTEXT       *XferContext;
-  UINT8                    *Data;
-  ISCSI_IN_BUFFER_CONTEXT  InBufferContext;
-  UINT64                   Timeout;
-  UINT8                    *PduHdr;
-
-  Private      = ISCSI_DRIVER_DATA_FROM_EXT_SCSI_PASS_THRU (PassThru);
-  Session      = Private->Session;
-  Status       = EFI_SUCCESS;
-  Tcb          = NULL;
-  TimeoutEvent = NULL;
-  Timeout      = 0;
+  EFI_STATUS        Status;
+  ISCSI_CONNECTION  *Conn;
 
   if (Session->State != SESSION_STATE_LOGGED_IN) {
-    Status = EFI_DEVICE_ERROR;
-    goto ON_EXIT;
+    return EFI_DEVICE_ERROR;
   }
 
   Conn = NET_LIST_USER_STRUCT_S (
@@ -2965,30 +3398,67 @@ IScsiExecuteScsiCommand (
            ISCSI_CONNECTION_SIGNATURE
            );
 
-  if (Packet->Timeout != 0) {
-    Timeout = MultU64x32 (Packet->Timeout, 4);
+  Status = IScsiNewTcb (Conn, Tcb);
+  if (EFI_ERROR (Status)) {
+    return Status;
   }
 
-  Status = IScsiNewTcb (Conn, &Tcb);
-  if (EFI_ERROR (Status)) {
-    goto ON_EXIT;
+  (*Tcb)->Packet = Packet;
+  (*Tcb)->Lun    = Lun;
+  (*Tcb)->Event  = Event;
+
+  if (Packet->Timeout != 0) {
+    (*Tcb)->Timeout = MultU64x32 (Packet->Timeout, 4);
   }
 
+  (*Tcb)->InBufferContext.InData    = (UINT8 *)Packet->InDataBuffer;
+  (*Tcb)->InBufferContext.InDataLen = Packet->InTransferLength;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Send the SCSI Command PDU of the task, followed by the unsolicited Data-Out
+  PDUs if they are allowed.
+
+  @param[in]  Tcb              The task control block.
+
+  @retval EFI_SUCCESS          The SCSI command is sent.
+  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
+  @retval EFI_PROTOCOL_ERROR   There is no such data in the net buffer.
+  @retval Others               Other errors as indicated.
+
+**/
+STATIC
+EFI_STATUS
+IScsiSendScsiCmd (
+  IN ISCSI_TCB  *Tcb
+  )
+{
+  EFI_STATUS                                  Status;
+  ISCSI_SESSION                               *Session;
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet;
+  ISCSI_XFER_CONTEXT                          *XferContext;
+  NET_BUF                                     *Pdu;
+  UINT8                                       *PduHdr;
+  UINT8                                       *Data;
+
+  Session = Tcb->Conn->Session;
+  Packet  = Tcb->Packet;
+
   //
   // Encapsulate the SCSI request packet into an iSCSI SCSI Command PDU.
   //
-  Pdu = IScsiNewScsiCmdPdu (Packet, Lun, Tcb);
+  Pdu = IScsiNewScsiCmdPdu (Packet, Tcb->Lun, Tcb);
   if (Pdu == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto ON_EXIT;
+    return EFI_OUT_OF_RESOURCES;
   }
 
   XferContext = &Tcb->XferContext;
   PduHdr      = NetbufGetByte (Pdu, 0, NULL);
   if (PduHdr == NULL) {
-    Status = EFI_PROTOCOL_ERROR;
     NetbufFree (Pdu);
-    goto ON_EXIT;
+    return EFI_PROTOCOL_ERROR;
   }
 
   XferContext->Offset = ISCSI_GET_DATASEG_LEN (PduHdr);
@@ -2996,14 +3466,16 @@ IScsiExecuteScsiCommand (
   //
   // Transmit the SCSI Command PDU.
   //
-  Status = TcpIoTransmit (&Conn->TcpIo, Pdu);
+  Status = TcpIoTransmit (&Tcb->Conn->TcpIo, Pdu);
 
   NetbufFree (Pdu);
 
   if (EFI_ERROR (Status)) {
-    goto ON_EXIT;
+    return Status;
   }
 
+  Tcb->CmdSent = TRUE;
+
   if (!Session->InitialR2T &&
       (XferContext->Offset < Session->FirstBurstLength) &&
       (XferContext->Offset < Packet->OutTransferLength)
@@ -3020,54 +3492,253 @@ IScsiExecuteScsiCommand (
                                        );
 
     Data   = (UINT8 *)Packet->OutDataBuffer + XferContext->Offset;
-    Status = IScsiSendDataOutPduSequence (Data, Lun, Tcb);
+    Status = IScsiSendDataOutPduSequence (Data, Tcb->Lun, Tcb);
+  }
+
+  return Status;
+}
+
+/**
+  Send the SCSI commands of the queued tasks, in the order of their CmdSN.
+
+  @param[in]  Session          The iSCSI session.
+
+  @retval EFI_SUCCESS          All the queued SCSI commands are sent.
+  @retval Others               Other errors as indicated.
+
+**/
+STATIC
+EFI_STATUS
+IScsiSendQueuedTcbs (
+  IN ISCSI_SESSION  *Session
+  )
+{
+  EFI_STATUS  Status;
+  LIST_ENTRY  *Entry;
+  ISCSI_TCB   *Tcb;
+
+  NET_LIST_FOR_EACH (Entry, &Session->TcbList) {
+    Tcb = NET_LIST_USER_STRUCT (Entry, ISCSI_TCB, Link);
+    if (!Tcb->CmdSent) {
+      Status = IScsiSendScsiCmd (Tcb);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Create the tasks of the pending nonblocking requests, in the order they are
+  queued. The requests are left pending if the target can't accept new commands.
+
+  @param[in]  Session           The iSCSI session.
+
+**/
+STATIC
+VOID
+IScsiNewPendingTasks (
+  IN ISCSI_SESSION  *Session
+  )
+{
+  EFI_STATUS             Status;
+  ISCSI_PENDING_REQUEST  *Request;
+  ISCSI_TCB              *Tcb;
+  EFI_TPL                OldTpl;
+
+  while (TRUE) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    if (IsListEmpty (&Session->PendingList)) {
+      gBS->RestoreTPL (OldTpl);
+      break;
+    }
+
+    Request = NET_LIST_HEAD (&Session->PendingList, ISCSI_PENDING_REQUEST, Link);
+    RemoveEntryList (&Request->Link);
+    gBS->RestoreTPL (OldTpl);
+
+    Status = IScsiNewScsiTask (Session, Request->Lun, Request->Packet, Request->Event, &Tcb);
+    if (Status == EFI_NOT_READY) {
+      //
+      // The CmdSN window is used up. Retry when the target opens it again.
+      //
+      OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+      InsertHeadList (&Session->PendingList, &Request->Link);
+      gBS->RestoreTPL (OldTpl);
+      break;
+    }
+
     if (EFI_ERROR (Status)) {
-      goto ON_EXIT;
+      Request->Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_OTHER;
+      gBS->SignalEvent (Request->Event);
+    }
+
+    FreePool (Request);
+  }
+}
+
+/**
+  Account the elapsed poll interval to the outstanding nonblocking tasks.
+
+  @param[in]  Session           The iSCSI session.
+
+  @retval EFI_SUCCESS           No task times out.
+  @retval EFI_TIMEOUT           A task times out.
+
+**/
+STATIC
+EFI_STATUS
+IScsiCheckTaskTimeout (
+  IN ISCSI_SESSION  *Session
+  )
+{
+  LIST_ENTRY  *Entry;
+  ISCSI_TCB   *Tcb;
+
+  NET_LIST_FOR_EACH (Entry, &Session->TcbList) {
+    Tcb = NET_LIST_USER_STRUCT (Entry, ISCSI_TCB, Link);
+    if ((Tcb->Event == NULL) || !Tcb->CmdSent || (Tcb->Timeout == 0)) {
+      continue;
+    }
+
+    Tcb->Elapsed += ISCSI_TASK_POLL_INTERVAL;
+    if (Tcb->Elapsed >= Tcb->Timeout) {
+      return EFI_TIMEOUT;
     }
   }
 
-  InBufferContext.InData    = (UINT8 *)Packet->InDataBuffer;
-  InBufferContext.InDataLen = Packet->InTransferLength;
+  return EFI_SUCCESS;
+}
+
+/**
+  Receive the PDUs of the outstanding tasks and dispatch each of them to its task
+  by the initiator task tag. The nonblocking tasks are completed when their status
+  is received.
+
+  @param[in]  Session          The iSCSI session.
+  @param[in]  WaitTcb          The blocking task to wait for. If NULL, wait until all
+                               the nonblocking tasks complete.
+  @param[in]  Poll             If TRUE, only process the PDUs already arrived and
+                               return when no more PDU is available. WaitTcb must
+                               be NULL.
+
+  @retval EFI_SUCCESS          The tasks waited for are completed, or the PDUs
+                               arrived are processed.
+  @retval EFI_BAD_BUFFER_SIZE  WaitTcb is completed with a residual count.
+  @retval EFI_PROTOCOL_ERROR   A PDU violating the iSCSI protocol is received.
+  @retval Others               Other errors as indicated.
+
+**/
+STATIC
+EFI_STATUS
+IScsiProcessTaskPdus (
+  IN ISCSI_SESSION  *Session,
+  IN ISCSI_TCB      *WaitTcb  OPTIONAL,
+  IN BOOLEAN        Poll
+  )
+{
+  EFI_STATUS        Status;
+  ISCSI_CONNECTION  *Conn;
+  ISCSI_TCB         *Tcb;
+  ISCSI_TCB         *TimerTcb;
+  EFI_EVENT         TimeoutEvent;
+  NET_BUF           *Pdu;
+  UINT8             *PduHdr;
+
+  ASSERT (!Poll || (WaitTcb == NULL));
+
+  Conn = NET_LIST_USER_STRUCT_S (
+           Session->Conns.ForwardLink,
+           ISCSI_CONNECTION,
+           Link,
+           ISCSI_CONNECTION_SIGNATURE
+           );
+
+  Status       = EFI_SUCCESS;
+  TimeoutEvent = NULL;
+
+  while (TRUE) {
+    if (WaitTcb != NULL) {
+      if (WaitTcb->StatusXferd) {
+        break;
+      }
+
+      TimerTcb = WaitTcb;
+    } else {
+      TimerTcb = IScsiGetNonblockingTcb (Session);
+      if (TimerTcb == NULL) {
+        break;
+      }
+    }
 
-  while (!Tcb->StatusXferd) {
     //
-    // Start the timeout timer.
+    // Keep the pipeline full: send the commands queued by the callers whose
+    // tasks completed in the previous rounds.
     //
-    if (Timeout != 0) {
-      Status = gBS->SetTimer (Conn->TimeoutEvent, TimerRelative, Timeout);
+    Status = IScsiSendQueuedTcbs (Session);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    //
+    // Start the timeout timer. When polling, the task timeouts are accounted by
+    // the caller and nothing is waited for.
+    //
+    if (!Poll && (TimerTcb->Timeout != 0)) {
+      Status = gBS->SetTimer (Conn->TimeoutEvent, TimerRelative, TimerTcb->Timeout);
       if (EFI_ERROR (Status)) {
-        goto ON_EXIT;
+        break;
       }
 
       TimeoutEvent = Conn->TimeoutEvent;
+    } else if (TimeoutEvent != NULL) {
+      gBS->SetTimer (TimeoutEvent, TimerCancel, 0);
+      TimeoutEvent = NULL;
     }
 
     //
-    // Try to receive PDU from target.
+    // Try to receive PDU from target. The data of a SCSI Data-In PDU is received
+    // into the buffer of the task it belongs to.
     //
-    Status = IScsiReceivePdu (Conn, &Pdu, &InBufferContext, FALSE, FALSE, TimeoutEvent);
+    Status = IScsiReceivePduEx (Conn, &Pdu, NULL, FALSE, FALSE, Poll, TimeoutEvent);
+    if (Poll && (Status == EFI_NOT_READY)) {
+      Status = EFI_SUCCESS;
+      break;
+    }
+
     if (EFI_ERROR (Status)) {
-      goto ON_EXIT;
+      break;
     }
 
     PduHdr = NetbufGetByte (Pdu, 0, NULL);
     if (PduHdr == NULL) {
       Status = EFI_PROTOCOL_ERROR;
       NetbufFree (Pdu);
-      goto ON_EXIT;
+      break;
+    }
+
+    //
+    // Unsolicited PDUs, such as the NOP-In with the reserved tag, are processed
+    // by the task being waited for.
+    //
+    Tcb = IScsiFindTcb (Session, NTOHL (((ISCSI_BASIC_HEADER *)PduHdr)->InitiatorTaskTag));
+    if (Tcb == NULL) {
+      Tcb = TimerTcb;
     }
 
     switch (ISCSI_GET_OPCODE (PduHdr)) {
       case ISCSI_OPCODE_SCSI_DATA_IN:
-        Status = IScsiOnDataInRcvd (Pdu, Tcb, Packet);
+        Status = IScsiOnDataInRcvd (Pdu, Tcb, Tcb->Packet);
         break;
 
       case ISCSI_OPCODE_R2T:
-        Status = IScsiOnR2TRcvd (Pdu, Tcb, Lun, Packet);
+        Status = IScsiOnR2TRcvd (Pdu, Tcb, Tcb->Lun, Tcb->Packet);
         break;
 
       case ISCSI_OPCODE_SCSI_RSP:
-        Status = IScsiOnScsiRspRcvd (Pdu, Tcb, Packet);
+        Status = IScsiOnScsiRspRcvd (Pdu, Tcb, Tcb->Packet);
         break;
 
       case ISCSI_OPCODE_NOP_IN:
@@ -3089,24 +3760,263 @@ IScsiExecuteScsiCommand (
 
     NetbufFree (Pdu);
 
+    if ((Tcb->Event != NULL) && Tcb->StatusXferd &&
+        ((Status == EFI_SUCCESS) || (Status == EFI_BAD_BUFFER_SIZE)))
+    {
+      //
+      // The status of a nonblocking task is received, report it to the caller.
+      //
+      IScsiCompleteTcb (Tcb, Status);
+      Status = EFI_SUCCESS;
+    }
+
     if (EFI_ERROR (Status)) {
       break;
     }
   }
 
-ON_EXIT:
-
   if (TimeoutEvent != NULL) {
     gBS->SetTimer (TimeoutEvent, TimerCancel, 0);
   }
 
-  if (Tcb != NULL) {
-    IScsiDelTcb (Tcb);
+  return Status;
+}
+
+/**
+  Execute the SCSI command issued through the EXT SCSI PASS THRU protocol.
+
+  The SCSI commands are pipelined: a nonblocking command returns as soon as it is
+  sent, so several commands can be outstanding within the CmdSN window granted by
+  the target. The PDUs received are dispatched to their tasks by the initiator
+  task tag.
+
+  @param[in]       PassThru  The EXT SCSI PASS THRU protocol.
+  @param[in]       Target    The target ID.
+  @param[in]       Lun       The LUN.
+  @param[in, out]  Packet    The request packet containing IO request, SCSI command
+                             buffer and buffers to read/write.
+  @param[in]       Event     If not NULL, the command is sent and this function returns
+                             without waiting for its completion. Event is signaled when
+                             the command completes.
+
+  @retval EFI_SUCCESS          The SCSI command is executed and the result is updated to
+                               the Packet, or the nonblocking SCSI command is queued.
+  @retval EFI_DEVICE_ERROR     Session state was not as required.
+  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
+  @retval EFI_PROTOCOL_ERROR   There is no such data in the net buffer.
+  @retval EFI_NOT_READY        The target can not accept new commands.
+  @retval Others               Other errors as indicated.
+
+**/
+EFI_STATUS
+IScsiExecuteScsiCommand (
+  IN EFI_EXT_SCSI_PASS_THRU_PROTOCOL                 *PassThru,
+  IN UINT8                                           *Target,
+  IN UINT64                                          Lun,
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  IN EFI_EVENT                                       Event     OPTIONAL
+  )
+{
+  EFI_STATUS         Status;
+  ISCSI_DRIVER_DATA  *Private;
+  ISCSI_SESSION      *Session;
+  ISCSI_TCB          *Tcb;
+
+  Private = ISCSI_DRIVER_DATA_FROM_EXT_SCSI_PASS_THRU (PassThru);
+  Session = Private->Session;
+
+  if (Event != NULL) {
+    //
+    // The task poll timer receives the response of the nonblocking command.
+    //
+    Status = gBS->SetTimer (Private->TaskPollEvent, TimerPeriodic, ISCSI_TASK_POLL_INTERVAL);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  Status = IScsiNewScsiTask (Session, Lun, Packet, Event, &Tcb);
+  if ((Status == EFI_NOT_READY) && (Event == NULL) && (IScsiGetNonblockingTcb (Session) != NULL)) {
+    //
+    // The CmdSN window is used up by the nonblocking commands. Wait for them
+    // to complete so that the target opens the window again.
+    //
+    Status = IScsiProcessTaskPdus (Session, NULL, FALSE);
+    if (!EFI_ERROR (Status)) {
+      Status = IScsiNewScsiTask (Session, Lun, Packet, Event, &Tcb);
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Send the queued commands ahead of this one to keep the CmdSN in order.
+  //
+  Status = IScsiSendQueuedTcbs (Session);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  if (Event != NULL) {
+    return EFI_SUCCESS;
+  }
+
+  Status = IScsiProcessTaskPdus (Session, Tcb, FALSE);
+
+ON_EXIT:
+
+  IScsiDelTcb (Tcb);
+
+  return Status;
+}
+
+/**
+  Queue a nonblocking SCSI command issued at a TPL above TPL_CALLBACK. The task
+  of the command is created and sent later by the task poll timer, so that the
+  tasks of the session are only accessed at TPL_CALLBACK.
+
+  @param[in]       PassThru  The EXT SCSI PASS THRU protocol.
+  @param[in]       Lun       The LUN.
+  @param[in, out]  Packet    The request packet containing IO request, SCSI command
+                             buffer and buffers to read/write.
+  @param[in]       Event     The event to signal when the command completes.
+
+  @retval EFI_SUCCESS          The SCSI command is queued.
+  @retval EFI_DEVICE_ERROR     Session state was not as required.
+  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
+
+**/
+EFI_STATUS
+IScsiQueueScsiCommand (
+  IN EFI_EXT_SCSI_PASS_THRU_PROTOCOL                 *PassThru,
+  IN UINT64                                          Lun,
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  IN EFI_EVENT                                       Event
+  )
+{
+  EFI_STATUS             Status;
+  ISCSI_DRIVER_DATA      *Private;
+  ISCSI_SESSION          *Session;
+  ISCSI_PENDING_REQUEST  *Request;
+  EFI_TPL                OldTpl;
+
+  Private = ISCSI_DRIVER_DATA_FROM_EXT_SCSI_PASS_THRU (PassThru);
+  Session = Private->Session;
+
+  Request = AllocatePool (sizeof (ISCSI_PENDING_REQUEST));
+  if (Request == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Request->Packet = Packet;
+  Request->Lun    = Lun;
+  Request->Event  = Event;
+
+  //
+  // The task poll timer may be interrupted at TPL_CALLBACK, so the pending list
+  // and the timer are updated at TPL_NOTIFY.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  if ((Session->State != SESSION_STATE_LOGGED_IN) || Session->ReinstatementPending) {
+    Status = EFI_DEVICE_ERROR;
+  } else {
+    Status = gBS->SetTimer (Private->TaskPollEvent, TimerPeriodic, ISCSI_TASK_POLL_INTERVAL);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    InsertTailList (&Session->PendingList, &Request->Link);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (EFI_ERROR (Status)) {
+    FreePool (Request);
   }
 
   return Status;
 }
 
+/**
+  The notify function of the task poll timer. It sends the queued nonblocking
+  SCSI commands and processes the responses of the outstanding ones.
+
+  @param[in]  Event    The event this function is registered to.
+  @param[in]  Context  The iSCSI driver data.
+
+**/
+VOID
+EFIAPI
+IScsiOnTaskPollTimer (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  ISCSI_DRIVER_DATA  *Private;
+  ISCSI_SESSION      *Session;
+  EFI_STATUS         Status;
+  EFI_TPL            OldTpl;
+  BOOLEAN            Idle;
+
+  Private = (ISCSI_DRIVER_DATA *)Context;
+  Session = Private->Session;
+
+  if (Session == NULL) {
+    gBS->SetTimer (Event, TimerCancel, 0);
+    return;
+  }
+
+  if ((Session->State != SESSION_STATE_LOGGED_IN) || Session->ReinstatementPending) {
+    //
+    // Fail the requests queued while the session is being reinstated.
+    //
+    IScsiAbortTcbs (Session);
+  }
+
+  //
+  // Check the pending list and cancel the timer at TPL_NOTIFY, so that a request
+  // queued in between restarts the timer.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  Idle   = (BOOLEAN)(IsListEmpty (&Session->TcbList) && IsListEmpty (&Session->PendingList));
+  if (Idle) {
+    gBS->SetTimer (Event, TimerCancel, 0);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (Idle || (Session->State != SESSION_STATE_LOGGED_IN) || Session->ReinstatementPending) {
+    return;
+  }
+
+  //
+  // Only the PDUs already arrived are processed, the timer never waits for the
+  // target.
+  //
+  IScsiNewPendingTasks (Session);
+
+  Status = IScsiSendQueuedTcbs (Session);
+  if (!EFI_ERROR (Status)) {
+    Status = IScsiProcessTaskPdus (Session, NULL, TRUE);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = IScsiCheckTaskTimeout (Session);
+  }
+
+  if (EFI_ERROR (Status)) {
+    //
+    // The connection is out of step with the target. Fail the outstanding tasks
+    // now, but leave the reinstatement to the next pass thru call: the login
+    // waits for the target, which must not happen in this notify function.
+    //
+    Session->ReinstatementPending = TRUE;
+    IScsiAbortTcbs (Session);
+  }
+}
+
 /**
   Reinstate the session on some error.
 
@@ -3125,6 +4035,8 @@ IScsiSessionReinstatement (
 
   ASSERT (Session->State != SESSION_STATE_FREE);
 
+  Session->ReinstatementPending = FALSE;
+
   //
   // Abort the session and re-init it.
   //
@@ -3158,6 +4070,7 @@ IScsiSessionInit (
 
     InitializeListHead (&Session->Conns);
     InitializeListHead (&Session->TcbList);
+    InitializeListHead (&Session->PendingList);
   }
 
   Session->Tsih = 0;
@@ -3174,7 +4087,7 @@ IScsiSessionInit (
   Session->FirstBurstLength     = MAX_RECV_DATA_SEG_LEN_IN_FFP;
   Session->DefaultTime2Wait     = 2;
   Session->DefaultTime2Retain   = 20;
-  Session->MaxOutstandingR2T    = DEFAULT_MAX_OUTSTANDING_R2T;
+  Session->MaxOutstandingR2T    = MAX_OUTSTANDING_R2T_IN_FFP;
   Session->DataPDUInOrder       = TRUE;
   Session->DataSequenceInOrder  = TRUE;
   Session->ErrorRecoveryLevel   = 0;
@@ -3229,5 +4142,11 @@ IScsiSessionAbort (
 
   Session->State = SESSION_STATE_FAILED;
 
+  //
+  // The nonblocking tasks can't complete on the destroyed connection.
+  //
+  IScsiAbortTcbs (Session);
+  gBS->SetTimer (Session->Private->TaskPollEvent, TimerCancel, 0);
+
   return;
 }
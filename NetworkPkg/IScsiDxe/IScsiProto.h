@@ -27,8 +27,14 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define ISCSI_MAX_CONNS_PER_SESSION  1
 
 #define DEFAULT_MAX_RECV_DATA_SEG_LEN  8192
-#define MAX_RECV_DATA_SEG_LEN_IN_FFP   65536
+#define MAX_RECV_DATA_SEG_LEN_IN_FFP   262144
 #define DEFAULT_MAX_OUTSTANDING_R2T    1
+#define MAX_OUTSTANDING_R2T_IN_FFP     4
+
+///
+/// Interval of the timer which drives the nonblocking SCSI commands, 10ms.
+///
+#define ISCSI_TASK_POLL_INTERVAL  100000
 
 #define ISCSI_VERSION_MAX  0x00
 #define ISCSI_VERSION_MIN  0x00
@@ -594,24 +600,47 @@ typedef struct _ISCSI_IN_BUFFER_CONTEXT {
 } ISCSI_IN_BUFFER_CONTEXT;
 
 typedef struct _ISCSI_TCB {
-  LIST_ENTRY            Link;
-
-  BOOLEAN               SoFarInOrder;
-  UINT32                ExpDataSN;
-  BOOLEAN               FbitReceived;
-  BOOLEAN               StatusXferd;
-  UINT32                ActiveR2Ts;
-  UINT32                Response;
-  CHAR8                 *Reason;
-  UINT32                InitiatorTaskTag;
-  UINT32                CmdSN;
-  UINT32                SNACKTag;
-
-  ISCSI_XFER_CONTEXT    XferContext;
-
-  ISCSI_CONNECTION      *Conn;
+  LIST_ENTRY                                    Link;
+
+  BOOLEAN                                       SoFarInOrder;
+  UINT32                                        ExpDataSN;
+  BOOLEAN                                       FbitReceived;
+  BOOLEAN                                       StatusXferd;
+  UINT32                                        ActiveR2Ts;
+  UINT32                                        Response;
+  CHAR8                                         *Reason;
+  UINT32                                        InitiatorTaskTag;
+  UINT32                                        CmdSN;
+  UINT32                                        SNACKTag;
+
+  ISCSI_XFER_CONTEXT                            XferContext;
+
+  ISCSI_CONNECTION                              *Conn;
+
+  //
+  // The SCSI request carried by this task. Event is NULL for a blocking
+  // request, otherwise it is signaled when the task completes.
+  //
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET    *Packet;
+  UINT64                                        Lun;
+  UINT64                                        Timeout;
+  UINT64                                        Elapsed;
+  EFI_EVENT                                     Event;
+  BOOLEAN                                       CmdSent;
+  ISCSI_IN_BUFFER_CONTEXT                       InBufferContext;
 } ISCSI_TCB;
 
+//
+// A nonblocking SCSI request issued above TPL_CALLBACK, waiting for the task
+// poll timer to create its task.
+//
+typedef struct _ISCSI_PENDING_REQUEST {
+  LIST_ENTRY                                    Link;
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET    *Packet;
+  UINT64                                        Lun;
+  EFI_EVENT                                     Event;
+} ISCSI_PENDING_REQUEST;
+
 typedef struct _ISCSI_KEY_VALUE_PAIR {
   LIST_ENTRY    List;
 
@@ -976,9 +1005,12 @@ IScsiNormalizeName (
   @param[in]       Lun       The LUN.
   @param[in, out]  Packet    The request packet containing IO request, SCSI command
                              buffer and buffers to read/write.
+  @param[in]       Event     If not NULL, the command is sent and this function returns
+                             without waiting for its completion. Event is signaled when
+                             the command completes.
 
   @retval EFI_SUCCESS          The SCSI command is executed and the result is updated to
-                               the Packet.
+                               the Packet, or the nonblocking SCSI command is queued.
   @retval EFI_DEVICE_ERROR     Session state was not as required.
   @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
   @retval EFI_NOT_READY        The target can not accept new commands.
@@ -990,7 +1022,74 @@ IScsiExecuteScsiCommand (
   IN EFI_EXT_SCSI_PASS_THRU_PROTOCOL                 *PassThru,
   IN UINT8                                           *Target,
   IN UINT64                                          Lun,
-  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  IN EFI_EVENT                                       Event     OPTIONAL
+  );
+
+/**
+  Queue a nonblocking SCSI command issued at a TPL above TPL_CALLBACK. The task
+  of the command is created and sent later by the task poll timer, so that the
+  tasks of the session are only accessed at TPL_CALLBACK.
+
+  @param[in]       PassThru  The EXT SCSI PASS THRU protocol.
+  @param[in]       Lun       The LUN.
+  @param[in, out]  Packet    The request packet containing IO request, SCSI command
+                             buffer and buffers to read/write.
+  @param[in]       Event     The event to signal when the command completes.
+
+  @retval EFI_SUCCESS          The SCSI command is queued.
+  @retval EFI_DEVICE_ERROR     Session state was not as required.
+  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
+
+**/
+EFI_STATUS
+IScsiQueueScsiCommand (
+  IN EFI_EXT_SCSI_PASS_THRU_PROTOCOL                 *PassThru,
+  IN UINT64                                          Lun,
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  IN EFI_EVENT                                       Event
+  );
+
+/**
+  Find the outstanding task with the specified initiator task tag.
+
+  @param[in]  Session           The iSCSI session.
+  @param[in]  InitiatorTaskTag  The initiator task tag in host byte order.
+
+  @return The task control block, or NULL if no task uses this tag.
+
+**/
+ISCSI_TCB *
+IScsiFindTcb (
+  IN ISCSI_SESSION  *Session,
+  IN UINT32         InitiatorTaskTag
+  );
+
+/**
+  Abort all the outstanding nonblocking tasks and the pending nonblocking
+  requests of the session, and signal their events.
+
+  @param[in]  Session           The iSCSI session.
+
+**/
+VOID
+IScsiAbortTcbs (
+  IN ISCSI_SESSION  *Session
+  );
+
+/**
+  The notify function of the task poll timer. It sends the queued nonblocking
+  SCSI commands and processes the responses of the outstanding ones.
+
+  @param[in]  Event    The event this function is registered to.
+  @param[in]  Context  The iSCSI driver data.
+
+**/
+VOID
+EFIAPI
+IScsiOnTaskPollTimer (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
   );
 
 /**
@@ -0,0 +1,397 @@
+/** @file
+  Tests for the fragment reassembly of Ip4Input.c.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/DebugLib.h>
+  #include "../Ip4Impl.h"
+
+  NET_BUF *
+  Ip4Reassemble (
+    IN OUT IP4_ASSEMBLE_TABLE  *Table,
+    IN OUT NET_BUF             *Packet
+    );
+}
+
+/////////////////////////////////////////////////////////////////////////
+// Defines
+///////////////////////////////////////////////////////////////////////
+
+#define REASSEMBLE_TEST_ID            0x1234
+#define REASSEMBLE_TEST_SRC           0x0A000001
+#define REASSEMBLE_TEST_DST           0x0A000002
+#define REASSEMBLE_TEST_MTU_PAYLOAD   1480
+#define REASSEMBLE_TEST_MTU_FRAGMENTS 44
+#define REASSEMBLE_TEST_MIN_PAYLOAD   8
+#define REASSEMBLE_TEST_MAX_FRAGMENTS 8184
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// These functions are not directly under test - but required to compile
+////////////////////////////////////////////////////////////////////////
+EFI_IPSEC2_PROTOCOL  *mIpSec           = NULL;
+BOOLEAN              mIpSec2Installed  = FALSE;
+IP4_ICMP_CLASS       mIcmpClass[]      = {
+  { ICMP_ECHO_REPLY, ICMP_QUERY_MESSAGE }
+};
+
+VOID
+EFIAPI
+Ip4FreeTxToken (
+  IN VOID  *Context
+  )
+{
+}
+
+INTN
+Ip4GetHostCast (
+  IN  IP4_SERVICE  *IpSb,
+  IN  IP4_ADDR     Dst,
+  IN  IP4_ADDR     Src
+  )
+{
+  return IP4_LOCAL_HOST;
+}
+
+INTN
+Ip4GetNetCast (
+  IN  IP4_ADDR       IpAddr,
+  IN  IP4_INTERFACE  *IpIf
+  )
+{
+  return IP4_LOCAL_HOST;
+}
+
+EFI_STATUS
+Ip4IcmpHandle (
+  IN IP4_SERVICE  *IpSb,
+  IN IP4_HEAD     *Head,
+  IN NET_BUF      *Packet
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+EFI_STATUS
+Ip4IgmpHandle (
+  IN IP4_SERVICE  *IpSb,
+  IN IP4_HEAD     *Head,
+  IN NET_BUF      *Packet
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+IP4_HEAD *
+Ip4NtohHead (
+  IN IP4_HEAD  *Head
+  )
+{
+  return Head;
+}
+
+BOOLEAN
+Ip4OptionIsValid (
+  IN UINT8    *Option,
+  IN UINT32   OptionLen,
+  IN BOOLEAN  Rcvd
+  )
+{
+  return TRUE;
+}
+
+EFI_STATUS
+Ip4PrependHead (
+  IN OUT NET_BUF   *Packet,
+  IN     IP4_HEAD  *Head,
+  IN     UINT8     *Option,
+  IN     UINT32    OptLen
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+EFI_STATUS
+Ip4ReceiveFrame (
+  IN  IP4_INTERFACE       *Interface,
+  IN  IP4_PROTOCOL        *IpInstance       OPTIONAL,
+  IN  IP4_FRAME_CALLBACK  CallBack,
+  IN  VOID                *Context
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+EFI_STATUS
+EFIAPI
+Ip4SentPacketTicking (
+  IN NET_MAP       *Map,
+  IN NET_MAP_ITEM  *Item,
+  IN VOID          *Context
+  )
+{
+  return EFI_SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////
+// Ip4Reassemble Tests
+////////////////////////////////////////////////////////////////////////
+
+class Ip4ReassembleTest : public ::testing::Test {
+protected:
+  IP4_ASSEMBLE_TABLE Table;
+
+  void
+  SetUp (
+    ) override
+  {
+    Ip4InitAssembleTable (&Table);
+  }
+
+  void
+  TearDown (
+    ) override
+  {
+    Ip4CleanAssembleTable (&Table);
+  }
+
+  //
+  // Build a fragment the way Ip4PreProcessPacket hands it to Ip4Reassemble:
+  // the head in host byte order, trimmed off the payload, and the clip info
+  // set. Each payload byte is derived from its offset in the packet.
+  //
+  NET_BUF *
+  CreateFragment (
+    UINT32   Start,
+    UINT32   Length,
+    BOOLEAN  Last
+    )
+  {
+    NET_BUF        *Packet;
+    IP4_HEAD       *Head;
+    UINT8          *Data;
+    IP4_CLIP_INFO  *Info;
+    UINT32         Index;
+
+    Packet = NetbufAlloc (sizeof (IP4_HEAD) + Length);
+    if (Packet == NULL) {
+      return NULL;
+    }
+
+    Head = (IP4_HEAD *)NetbufAllocSpace (Packet, sizeof (IP4_HEAD), NET_BUF_TAIL);
+    Data = NetbufAllocSpace (Packet, Length, NET_BUF_TAIL);
+
+    ZeroMem (Head, sizeof (IP4_HEAD));
+    Head->Ver      = 4;
+    Head->HeadLen  = sizeof (IP4_HEAD) >> 2;
+    Head->TotalLen = (UINT16)(sizeof (IP4_HEAD) + Length);
+    Head->Id       = REASSEMBLE_TEST_ID;
+    Head->Fragment = IP4_HEAD_FRAGMENT_FIELD (FALSE, !Last, Start);
+    Head->Ttl      = 64;
+    Head->Protocol = EFI_IP_PROTO_UDP;
+    Head->Src      = REASSEMBLE_TEST_SRC;
+    Head->Dst      = REASSEMBLE_TEST_DST;
+
+    for (Index = 0; Index < Length; Index++) {
+      Data[Index] = (UINT8)((Start + Index) % 251);
+    }
+
+    NetbufTrim (Packet, sizeof (IP4_HEAD), NET_BUF_HEAD);
+    Packet->Ip.Ip4 = Head;
+
+    Info = IP4_GET_CLIP_INFO (Packet);
+    ZeroMem (Info, sizeof (IP4_CLIP_INFO));
+    Info->CastType = IP4_LOCAL_HOST;
+    Info->Start    = Start;
+    Info->Length   = Length;
+    Info->End      = Start + Length;
+
+    return Packet;
+  }
+
+  //
+  // Feed the fragments of a TotalLength byte packet, cut in FragmentLength
+  // byte pieces, in the given order. Only the last one fed must complete
+  // the packet.
+  //
+  NET_BUF *
+  Reassemble (
+    UINT32  TotalLength,
+    UINT32  FragmentLength,
+    UINT32  *Order,
+    UINT32  Count
+    )
+  {
+    NET_BUF  *Packet;
+    NET_BUF  *Assembled;
+    UINT32   Index;
+    UINT32   Start;
+
+    Assembled = NULL;
+    for (Index = 0; Index < Count; Index++) {
+      EXPECT_EQ (Assembled, nullptr);
+
+      Start  = Order[Index] * FragmentLength;
+      Packet = CreateFragment (Start, MIN (FragmentLength, TotalLength - Start), Start + FragmentLength >= TotalLength);
+      if (Packet == NULL) {
+        ADD_FAILURE () << "Out of memory";
+        return Assembled;
+      }
+
+      Assembled = Ip4Reassemble (&Table, Packet);
+    }
+
+    return Assembled;
+  }
+
+  //
+  // Check the reassembled packet against the payload pattern, then free it
+  // along with all its fragments.
+  //
+  void
+  CheckAndFree (
+    NET_BUF  *Assembled,
+    UINT32   TotalLength
+    )
+  {
+    UINT8   *Data;
+    UINT32  Index;
+
+    ASSERT_NE (Assembled, nullptr);
+    EXPECT_EQ (Assembled->TotalSize, TotalLength);
+    EXPECT_EQ (IP4_GET_CLIP_INFO (Assembled)->Start, 0);
+    EXPECT_EQ (Assembled->Ip.Ip4->Id, REASSEMBLE_TEST_ID);
+
+    Data = (UINT8 *)AllocatePool (TotalLength);
+    ASSERT_NE (Data, nullptr);
+    EXPECT_EQ (NetbufCopy (Assembled, 0, TotalLength, Data), TotalLength);
+
+    for (Index = 0; Index < TotalLength; Index++) {
+      if (Data[Index] != (UINT8)(Index % 251)) {
+        ADD_FAILURE () << "Payload mismatch at offset " << Index;
+        break;
+      }
+    }
+
+    FreePool (Data);
+    NetbufFree (Assembled);
+  }
+};
+
+// In order fragments, the common case, take the tail fast path.
+TEST_F (Ip4ReassembleTest, InOrderFragments) {
+  UINT32  Order[REASSEMBLE_TEST_MTU_FRAGMENTS];
+  UINT32  Index;
+
+  for (Index = 0; Index < REASSEMBLE_TEST_MTU_FRAGMENTS; Index++) {
+    Order[Index] = Index;
+  }
+
+  CheckAndFree (
+    Reassemble (REASSEMBLE_TEST_MTU_PAYLOAD * REASSEMBLE_TEST_MTU_FRAGMENTS, REASSEMBLE_TEST_MTU_PAYLOAD, Order, REASSEMBLE_TEST_MTU_FRAGMENTS),
+    REASSEMBLE_TEST_MTU_PAYLOAD * REASSEMBLE_TEST_MTU_FRAGMENTS
+    );
+}
+
+// Every fragment but the first one is inserted before the tail.
+TEST_F (Ip4ReassembleTest, ReverseOrderFragments) {
+  UINT32  Order[REASSEMBLE_TEST_MTU_FRAGMENTS];
+  UINT32  Index;
+
+  for (Index = 0; Index < REASSEMBLE_TEST_MTU_FRAGMENTS; Index++) {
+    Order[Index] = REASSEMBLE_TEST_MTU_FRAGMENTS - 1 - Index;
+  }
+
+  CheckAndFree (
+    Reassemble (REASSEMBLE_TEST_MTU_PAYLOAD * REASSEMBLE_TEST_MTU_FRAGMENTS, REASSEMBLE_TEST_MTU_PAYLOAD, Order, REASSEMBLE_TEST_MTU_FRAGMENTS),
+    REASSEMBLE_TEST_MTU_PAYLOAD * REASSEMBLE_TEST_MTU_FRAGMENTS
+    );
+}
+
+// The even fragments arrive first, then the odd ones fill the holes.
+TEST_F (Ip4ReassembleTest, FragmentsFillHoles) {
+  UINT32  Order[REASSEMBLE_TEST_MTU_FRAGMENTS];
+  UINT32  Index;
+
+  for (Index = 0; Index < REASSEMBLE_TEST_MTU_FRAGMENTS / 2; Index++) {
+    Order[Index]                                     = Index * 2;
+    Order[Index + REASSEMBLE_TEST_MTU_FRAGMENTS / 2] = Index * 2 + 1;
+  }
+
+  CheckAndFree (
+    Reassemble (REASSEMBLE_TEST_MTU_PAYLOAD * REASSEMBLE_TEST_MTU_FRAGMENTS, REASSEMBLE_TEST_MTU_PAYLOAD, Order, REASSEMBLE_TEST_MTU_FRAGMENTS),
+    REASSEMBLE_TEST_MTU_PAYLOAD * REASSEMBLE_TEST_MTU_FRAGMENTS
+    );
+}
+
+// A duplicate of the tail fragment is dropped, and a fragment overlapping
+// the tail is trimmed, on the fast path.
+TEST_F (Ip4ReassembleTest, DuplicateAndOverlappingTail) {
+  NET_BUF  *Packet;
+
+  Packet = CreateFragment (0, 16, FALSE);
+  ASSERT_NE (Packet, nullptr);
+  EXPECT_EQ (Ip4Reassemble (&Table, Packet), nullptr);
+
+  Packet = CreateFragment (16, 16, FALSE);
+  ASSERT_NE (Packet, nullptr);
+  EXPECT_EQ (Ip4Reassemble (&Table, Packet), nullptr);
+
+  Packet = CreateFragment (16, 16, FALSE);
+  ASSERT_NE (Packet, nullptr);
+  EXPECT_EQ (Ip4Reassemble (&Table, Packet), nullptr);
+
+  Packet = CreateFragment (24, 24, TRUE);
+  ASSERT_NE (Packet, nullptr);
+  CheckAndFree (Ip4Reassemble (&Table, Packet), 48);
+}
+
+// Reassemble the largest packet from minimum sized fragments, in order and
+// filling holes. The times are reported, not checked, since they depend on
+// the host.
+TEST_F (Ip4ReassembleTest, ManyFragmentsBenchmark) {
+  static UINT32                                       Order[REASSEMBLE_TEST_MAX_FRAGMENTS];
+  UINT32                                              Index;
+  std::chrono::time_point<std::chrono::steady_clock>  Start;
+  double                                              InOrderMicroseconds;
+  double                                              HolesMicroseconds;
+  NET_BUF                                             *Assembled;
+
+  for (Index = 0; Index < REASSEMBLE_TEST_MAX_FRAGMENTS; Index++) {
+    Order[Index] = Index;
+  }
+
+  Start               = std::chrono::steady_clock::now ();
+  Assembled           = Reassemble (REASSEMBLE_TEST_MIN_PAYLOAD * REASSEMBLE_TEST_MAX_FRAGMENTS, REASSEMBLE_TEST_MIN_PAYLOAD, Order, REASSEMBLE_TEST_MAX_FRAGMENTS);
+  InOrderMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now () - Start).count ();
+  CheckAndFree (Assembled, REASSEMBLE_TEST_MIN_PAYLOAD * REASSEMBLE_TEST_MAX_FRAGMENTS);
+
+  for (Index = 0; Index < REASSEMBLE_TEST_MAX_FRAGMENTS / 2; Index++) {
+    Order[Index]                                     = Index * 2;
+    Order[Index + REASSEMBLE_TEST_MAX_FRAGMENTS / 2] = Index * 2 + 1;
+  }
+
+  Start             = std::chrono::steady_clock::now ();
+  Assembled         = Reassemble (REASSEMBLE_TEST_MIN_PAYLOAD * REASSEMBLE_TEST_MAX_FRAGMENTS, REASSEMBLE_TEST_MIN_PAYLOAD, Order, REASSEMBLE_TEST_MAX_FRAGMENTS);
+  HolesMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now () - Start).count ();
+  CheckAndFree (Assembled, REASSEMBLE_TEST_MIN_PAYLOAD * REASSEMBLE_TEST_MAX_FRAGMENTS);
+
+  RecordProperty ("InOrderMicroseconds", std::to_string (InOrderMicroseconds));
+  RecordProperty ("FillHolesMicroseconds", std::to_string (HolesMicroseconds));
+  std::printf (
+    "%u fragments: %.0f us in order, %.0f us filling holes\n",
+    (unsigned)REASSEMBLE_TEST_MAX_FRAGMENTS,
+    InOrderMicroseconds,
+    HolesMicroseconds
+    );
+}
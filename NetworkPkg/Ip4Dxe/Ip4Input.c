@@ -264,15 +264,22 @@ Ip4Reassemble (
   //
   // Find the point to insert the packet: before the first
   // fragment with THIS.Start < CUR.Start. the previous one
-  // has PREV.Start <= THIS.Start < CUR.Start.
+  // has PREV.Start <= THIS.Start < CUR.Start. Fragments mostly
+  // arrive in order, so check the last fragment first and only
+  // walk the list if THIS fragment fills a hole.
   //
   Head = &Assemble->Fragments;
+  Cur  = Head;
 
-  NET_LIST_FOR_EACH (Cur, Head) {
-    Fragment = NET_LIST_USER_STRUCT (Cur, NET_BUF, List);
+  if (!IsListEmpty (Head) &&
+      (This->Start < IP4_GET_CLIP_INFO (NET_LIST_TAIL (Head, NET_BUF, List))->Start))
+  {
+    NET_LIST_FOR_EACH (Cur, Head) {
+      Fragment = NET_LIST_USER_STRUCT (Cur, NET_BUF, List);
 
-    if (This->Start < IP4_GET_CLIP_INFO (Fragment)->Start) {
-      break;
+      if (This->Start < IP4_GET_CLIP_INFO (Fragment)->Start) {
+        break;
+      }
     }
   }
 
@@ -0,0 +1,256 @@
+/** @file
+  Tests for Ip6Route.c and the neighbor cache hash.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/DebugLib.h>
+  #include "../Ip6Impl.h"
+}
+
+/////////////////////////////////////////////////////////////////////////
+// Defines
+///////////////////////////////////////////////////////////////////////
+
+#define ROUTE_TEST_DESTINATION_NUM  1024
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// These functions are not directly under test - but required to compile
+////////////////////////////////////////////////////////////////////////
+VOID
+Ip6CopyAddressByPrefix (
+  OUT EFI_IPv6_ADDRESS  *Dest,
+  IN  EFI_IPv6_ADDRESS  *Src,
+  IN  UINT8             PrefixLength
+  )
+{
+  UINT8  Byte;
+  UINT8  Bit;
+
+  Byte = (UINT8)(PrefixLength / 8);
+  Bit  = (UINT8)(PrefixLength % 8);
+
+  ZeroMem (Dest, sizeof (EFI_IPv6_ADDRESS));
+  CopyMem (Dest, Src, Byte);
+
+  if (Bit > 0) {
+    Dest->Addr[Byte] = (UINT8)(Src->Addr[Byte] & (0xFF << (8 - Bit)));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+// Helpers
+////////////////////////////////////////////////////////////////////////
+
+//
+// Build 2001:db8:<Subnet>::<Host>
+//
+STATIC
+VOID
+BuildAddress (
+  OUT EFI_IPv6_ADDRESS  *Address,
+  IN  UINT16            Subnet,
+  IN  UINT32            Host
+  )
+{
+  ZeroMem (Address, sizeof (EFI_IPv6_ADDRESS));
+  Address->Addr[0]  = 0x20;
+  Address->Addr[1]  = 0x01;
+  Address->Addr[2]  = 0x0d;
+  Address->Addr[3]  = 0xb8;
+  Address->Addr[4]  = (UINT8)(Subnet >> 8);
+  Address->Addr[5]  = (UINT8)Subnet;
+  Address->Addr[12] = (UINT8)(Host >> 24);
+  Address->Addr[13] = (UINT8)(Host >> 16);
+  Address->Addr[14] = (UINT8)(Host >> 8);
+  Address->Addr[15] = (UINT8)Host;
+}
+
+////////////////////////////////////////////////////////////////////////
+// Ip6Route Tests
+////////////////////////////////////////////////////////////////////////
+
+class Ip6RouteTest : public ::testing::Test {
+protected:
+  IP6_SERVICE IpSb;
+  EFI_IPv6_ADDRESS Source;
+  EFI_IPv6_ADDRESS Unspecified;
+  EFI_IPv6_ADDRESS DefaultGateway;
+  EFI_IPv6_ADDRESS SiteGateway;
+
+  virtual void
+  SetUp (
+    )
+  {
+    ZeroMem (&IpSb, sizeof (IpSb));
+    IpSb.RouteTable = Ip6CreateRouteTable ();
+    ASSERT_NE (IpSb.RouteTable, nullptr);
+
+    BuildAddress (&Source, 1, 1);
+    ZeroMem (&Unspecified, sizeof (Unspecified));
+    BuildAddress (&DefaultGateway, 0xffff, 1);
+    BuildAddress (&SiteGateway, 0xffff, 2);
+  }
+
+  virtual void
+  TearDown (
+    )
+  {
+    Ip6CleanRouteTable (IpSb.RouteTable);
+  }
+};
+
+// Test Description:
+// Ip6Route picks the most specific route and caches the result.
+TEST_F (Ip6RouteTest, LongestPrefixMatchIsCached) {
+  EFI_IPv6_ADDRESS       Prefix;
+  EFI_IPv6_ADDRESS       Dest;
+  IP6_ROUTE_CACHE_ENTRY  *RtCacheEntry;
+  IP6_ROUTE_CACHE_ENTRY  *Cached;
+
+  //
+  // ::/0 via the default gateway, 2001:db8::/32 via the site gateway,
+  // 2001:db8:1::/48 on-link.
+  //
+  ZeroMem (&Prefix, sizeof (Prefix));
+  ASSERT_EQ (Ip6AddRoute (IpSb.RouteTable, &Prefix, 0, &DefaultGateway), EFI_SUCCESS);
+  BuildAddress (&Prefix, 0, 0);
+  ASSERT_EQ (Ip6AddRoute (IpSb.RouteTable, &Prefix, 32, &SiteGateway), EFI_SUCCESS);
+  BuildAddress (&Prefix, 1, 0);
+  ASSERT_EQ (Ip6AddRoute (IpSb.RouteTable, &Prefix, 48, &Unspecified), EFI_SUCCESS);
+
+  BuildAddress (&Dest, 1, 5);
+  RtCacheEntry = Ip6Route (&IpSb, &Dest, &Source);
+  ASSERT_NE (RtCacheEntry, nullptr);
+  EXPECT_TRUE (EFI_IP6_EQUAL (&RtCacheEntry->NextHop, &Dest));
+
+  Cached = Ip6Route (&IpSb, &Dest, &Source);
+  EXPECT_EQ (Cached, RtCacheEntry);
+  Ip6FreeRouteCacheEntry (Cached);
+  Ip6FreeRouteCacheEntry (RtCacheEntry);
+
+  BuildAddress (&Dest, 2, 5);
+  RtCacheEntry = Ip6Route (&IpSb, &Dest, &Source);
+  ASSERT_NE (RtCacheEntry, nullptr);
+  EXPECT_TRUE (EFI_IP6_EQUAL (&RtCacheEntry->NextHop, &SiteGateway));
+  Ip6FreeRouteCacheEntry (RtCacheEntry);
+
+  ZeroMem (&Dest, sizeof (Dest));
+  Dest.Addr[0]  = 0x20;
+  Dest.Addr[1]  = 0x02;
+  Dest.Addr[15] = 0x01;
+  RtCacheEntry  = Ip6Route (&IpSb, &Dest, &Source);
+  ASSERT_NE (RtCacheEntry, nullptr);
+  EXPECT_TRUE (EFI_IP6_EQUAL (&RtCacheEntry->NextHop, &DefaultGateway));
+  Ip6FreeRouteCacheEntry (RtCacheEntry);
+}
+
+// Test Description:
+// Deleting a route purges the cache entries spawned from it and keeps
+// the per bucket counters in step with the buckets.
+TEST_F (Ip6RouteTest, DeleteRoutePurgesCache) {
+  EFI_IPv6_ADDRESS       Prefix;
+  EFI_IPv6_ADDRESS       Dest;
+  IP6_ROUTE_CACHE_ENTRY  *RtCacheEntry;
+  UINT32                 Host;
+  UINT32                 Index;
+  UINT32                 Total;
+
+  BuildAddress (&Prefix, 1, 0);
+  ASSERT_EQ (Ip6AddRoute (IpSb.RouteTable, &Prefix, 64, &Unspecified), EFI_SUCCESS);
+
+  for (Host = 1; Host <= 64; Host++) {
+    BuildAddress (&Dest, 1, Host);
+    RtCacheEntry = Ip6Route (&IpSb, &Dest, &Source);
+    ASSERT_NE (RtCacheEntry, nullptr);
+    Ip6FreeRouteCacheEntry (RtCacheEntry);
+  }
+
+  Total = 0;
+  for (Index = 0; Index < IP6_ROUTE_CACHE_HASH_SIZE; Index++) {
+    Total += IpSb.RouteTable->Cache.CacheNum[Index];
+  }
+
+  EXPECT_EQ (Total, 64U);
+
+  ASSERT_EQ (Ip6DelRoute (IpSb.RouteTable, &Prefix, 64, &Unspecified), EFI_SUCCESS);
+
+  for (Index = 0; Index < IP6_ROUTE_CACHE_HASH_SIZE; Index++) {
+    EXPECT_EQ (IpSb.RouteTable->Cache.CacheNum[Index], 0U);
+    EXPECT_TRUE (IsListEmpty (&IpSb.RouteTable->Cache.CacheBucket[Index]));
+  }
+}
+
+// Test Description:
+// Destinations in the same /64 spread over all the route cache buckets,
+// so a lookup walks a short chain however many neighbors are cached.
+TEST_F (Ip6RouteTest, RouteCacheBucketsStayBalanced) {
+  EFI_IPv6_ADDRESS       Prefix;
+  EFI_IPv6_ADDRESS       Dest;
+  IP6_ROUTE_CACHE_ENTRY  *RtCacheEntry;
+  UINT32                 Host;
+  UINT32                 Index;
+  UINT32                 Max;
+
+  BuildAddress (&Prefix, 1, 0);
+  ASSERT_EQ (Ip6AddRoute (IpSb.RouteTable, &Prefix, 64, &Unspecified), EFI_SUCCESS);
+
+  for (Host = 1; Host <= ROUTE_TEST_DESTINATION_NUM; Host++) {
+    BuildAddress (&Dest, 1, Host);
+    RtCacheEntry = Ip6Route (&IpSb, &Dest, &Source);
+    ASSERT_NE (RtCacheEntry, nullptr);
+    Ip6FreeRouteCacheEntry (RtCacheEntry);
+  }
+
+  Max = 0;
+  for (Index = 0; Index < IP6_ROUTE_CACHE_HASH_SIZE; Index++) {
+    EXPECT_GT (IpSb.RouteTable->Cache.CacheNum[Index], 0U);
+    Max = MAX (Max, IpSb.RouteTable->Cache.CacheNum[Index]);
+  }
+
+  EXPECT_LE (Max, 2 * ROUTE_TEST_DESTINATION_NUM / IP6_ROUTE_CACHE_HASH_SIZE);
+
+  //
+  // Every destination is now served from the cache.
+  //
+  for (Host = 1; Host <= ROUTE_TEST_DESTINATION_NUM; Host++) {
+    BuildAddress (&Dest, 1, Host);
+    RtCacheEntry = Ip6FindRouteCache (IpSb.RouteTable, &Dest, &Source);
+    ASSERT_NE (RtCacheEntry, nullptr);
+    Ip6FreeRouteCacheEntry (RtCacheEntry);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+// IP6_NEIGHBOR_HASH Tests
+////////////////////////////////////////////////////////////////////////
+
+// Test Description:
+// Neighbors on the same link only differ in the interface identifier,
+// which must be enough to spread them over all the buckets.
+TEST (Ip6NeighborHashTest, OnLinkNeighborsSpreadOverBuckets) {
+  EFI_IPv6_ADDRESS  Neighbor;
+  UINT32            Count[IP6_NEIGHBOR_HASH_SIZE];
+  UINT32            Host;
+  UINT32            Index;
+
+  ZeroMem (Count, sizeof (Count));
+
+  for (Host = 1; Host <= ROUTE_TEST_DESTINATION_NUM; Host++) {
+    BuildAddress (&Neighbor, 1, Host);
+    Index = IP6_NEIGHBOR_HASH (&Neighbor);
+    ASSERT_LT (Index, (UINT32)IP6_NEIGHBOR_HASH_SIZE);
+    Count[Index]++;
+  }
+
+  for (Index = 0; Index < IP6_NEIGHBOR_HASH_SIZE; Index++) {
+    EXPECT_GT (Count[Index], 0U);
+    EXPECT_LE (Count[Index], 2 * ROUTE_TEST_DESTINATION_NUM / IP6_NEIGHBOR_HASH_SIZE);
+  }
+}
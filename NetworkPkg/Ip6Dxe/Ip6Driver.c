@@ -266,6 +266,7 @@ Ip6CreateService (
   EFI_STATUS                            Status;
   EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *MnpToken;
   EFI_MANAGED_NETWORK_CONFIG_DATA       *Config;
+  UINT32                                Index;
 
   ASSERT (Service != NULL);
 
@@ -329,6 +330,10 @@ Ip6CreateService (
   IpSb->RoundRobin = 0;
 
   InitializeListHead (&IpSb->NeighborTable);
+  for (Index = 0; Index < IP6_NEIGHBOR_HASH_SIZE; Index++) {
+    InitializeListHead (&IpSb->NeighborBucket[Index]);
+  }
+
   InitializeListHead (&IpSb->DefaultRouterList);
   InitializeListHead (&IpSb->OnlinkPrefix);
   InitializeListHead (&IpSb->AutonomousPrefix);
@@ -196,6 +196,7 @@ struct _IP6_SERVICE {
   UINT32                             ReachableTime;
   UINT32                             RetransTimer;
   LIST_ENTRY                         NeighborTable;
+  LIST_ENTRY                         NeighborBucket[IP6_NEIGHBOR_HASH_SIZE];
 
   LIST_ENTRY                         OnlinkPrefix;
   LIST_ENTRY                         AutonomousPrefix;
@@ -221,15 +221,22 @@ Ip6Reassemble (
   //
   // Find the point to insert the packet: before the first
   // fragment with THIS.Start < CUR.Start. the previous one
-  // has PREV.Start <= THIS.Start < CUR.Start.
+  // has PREV.Start <= THIS.Start < CUR.Start. Fragments mostly
+  // arrive in order, so check the last fragment first and only
+  // walk the list if THIS fragment fills a hole.
   //
   ListHead = &Assemble->Fragments;
+  Cur      = ListHead;
 
-  NET_LIST_FOR_EACH (Cur, ListHead) {
-    Fragment = NET_LIST_USER_STRUCT (Cur, NET_BUF, List);
+  if (!IsListEmpty (ListHead) &&
+      (This->Start < IP6_GET_CLIP_INFO (NET_LIST_TAIL (ListHead, NET_BUF, List))->Start))
+  {
+    NET_LIST_FOR_EACH (Cur, ListHead) {
+      Fragment = NET_LIST_USER_STRUCT (Cur, NET_BUF, List);
 
-    if (This->Start < IP6_GET_CLIP_INFO (Fragment)->Start) {
-      break;
+      if (This->Start < IP6_GET_CLIP_INFO (Fragment)->Start) {
+        break;
+      }
     }
   }
 
@@ -707,6 +714,72 @@ ON_EXIT:
   return Status;
 }
 
+/**
+  Get the payload of the IPv6 packet, starting from the first byte after
+  the IPv6 header, for the extension header validation.
+
+  The payload is referenced in place when it is held in a single block of
+  the packet. It is copied to a newly allocated buffer only when it spans
+  several blocks, or when IPsec is installed, because IPsec may hand back
+  its own extension headers.
+
+  @param[in]      Packet           The IP6 packet, with the IPv6 header.
+  @param[in]      PayloadLen       The length of the payload.
+  @param[in, out] Payload          On input, the previously returned payload.
+                                   On output, the pointer to the payload.
+  @param[in, out] PayloadAllocated On input, whether the previous payload was
+                                   allocated. On output, whether the payload
+                                   was allocated and must be freed by the caller.
+
+  @retval     EFI_SUCCESS              The payload is returned.
+  @retval     EFI_OUT_OF_RESOURCES     Failed to allocate the payload copy.
+
+**/
+STATIC
+EFI_STATUS
+Ip6GetPayload (
+  IN     NET_BUF  *Packet,
+  IN     UINT16   PayloadLen,
+  IN OUT UINT8    **Payload,
+  IN OUT BOOLEAN  *PayloadAllocated
+  )
+{
+  NET_BLOCK_OP  *BlockOp;
+  UINT8         *Start;
+  UINT32        Index;
+
+  if (*PayloadAllocated && (*Payload != NULL)) {
+    FreePool (*Payload);
+  }
+
+  *Payload          = NULL;
+  *PayloadAllocated = FALSE;
+
+  if (PayloadLen == 0) {
+    return EFI_SUCCESS;
+  }
+
+  if (!mIpSec2Installed) {
+    Start = NetbufGetByte (Packet, sizeof (EFI_IP6_HEADER), &Index);
+    if (Start != NULL) {
+      BlockOp = &Packet->BlockOp[Index];
+      if ((UINTN)(BlockOp->Tail - Start) >= PayloadLen) {
+        *Payload = Start;
+        return EFI_SUCCESS;
+      }
+    }
+  }
+
+  *Payload = AllocatePool ((UINTN)PayloadLen);
+  if (*Payload == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  *PayloadAllocated = TRUE;
+  NetbufCopy (Packet, sizeof (EFI_IP6_HEADER), PayloadLen, *Payload);
+  return EFI_SUCCESS;
+}
+
 /**
   Pre-process the IPv6 packet. First validates the IPv6 packet, and
   then reassembles packet if it is necessary.
@@ -717,6 +790,8 @@ ON_EXIT:
                                 as multicast.
   @param[out]     Payload       The pointer to the payload of the received packet.
                                 it starts from the first byte of the extension header.
+  @param[in, out] PayloadAllocated Whether Payload was allocated and must be
+                                freed by the caller.
   @param[out]     LastHead      The pointer of NextHeader of the last extension
                                 header processed by IP6.
   @param[out]     ExtHdrsLen    The length of the whole option.
@@ -734,6 +809,7 @@ Ip6PreProcessPacket (
   IN OUT NET_BUF      **Packet,
   IN     UINT32       Flag,
   OUT UINT8           **Payload,
+  IN OUT BOOLEAN      *PayloadAllocated,
   OUT UINT8           **LastHead,
   OUT UINT32          *ExtHdrsLen,
   OUT UINT32          *UnFragmentLen,
@@ -841,13 +917,8 @@ Ip6PreProcessPacket (
   //
   // Check the extension headers, if exist validate them
   //
-  if (PayloadLen != 0) {
-    *Payload = AllocatePool ((UINTN)PayloadLen);
-    if (*Payload == NULL) {
-      return EFI_INVALID_PARAMETER;
-    }
-
-    NetbufCopy (*Packet, sizeof (EFI_IP6_HEADER), PayloadLen, *Payload);
+  if (EFI_ERROR (Ip6GetPayload (*Packet, PayloadLen, Payload, PayloadAllocated))) {
+    return EFI_INVALID_PARAMETER;
   }
 
   if (!Ip6IsExtsValid (
@@ -921,17 +992,8 @@ Ip6PreProcessPacket (
     //
     *Head      = (*Packet)->Ip.Ip6;
     PayloadLen = (*Head)->PayloadLength;
-    if (PayloadLen != 0) {
-      if (*Payload != NULL) {
-        FreePool (*Payload);
-      }
-
-      *Payload = AllocatePool ((UINTN)PayloadLen);
-      if (*Payload == NULL) {
-        return EFI_INVALID_PARAMETER;
-      }
-
-      NetbufCopy (*Packet, sizeof (EFI_IP6_HEADER), PayloadLen, *Payload);
+    if (EFI_ERROR (Ip6GetPayload (*Packet, PayloadLen, Payload, PayloadAllocated))) {
+      return EFI_INVALID_PARAMETER;
     }
 
     if (!Ip6IsExtsValid (
@@ -983,6 +1045,7 @@ Ip6AcceptFrame (
   IP6_SERVICE     *IpSb;
   EFI_IP6_HEADER  *Head;
   UINT8           *Payload;
+  BOOLEAN         PayloadAllocated;
   UINT8           *LastHead;
   UINT32          UnFragmentLen;
   UINT32          ExtHdrsLen;
@@ -993,8 +1056,9 @@ Ip6AcceptFrame (
   IpSb = (IP6_SERVICE *)Context;
   NET_CHECK_SIGNATURE (IpSb, IP6_SERVICE_SIGNATURE);
 
-  Payload  = NULL;
-  LastHead = NULL;
+  Payload          = NULL;
+  PayloadAllocated = FALSE;
+  LastHead         = NULL;
 
   //
   // Check input parameters
@@ -1011,6 +1075,7 @@ Ip6AcceptFrame (
              &Packet,
              Flag,
              &Payload,
+             &PayloadAllocated,
              &LastHead,
              &ExtHdrsLen,
              &UnFragmentLen,
@@ -1050,6 +1115,7 @@ Ip6AcceptFrame (
                &Packet,
                Flag,
                &Payload,
+               &PayloadAllocated,
                &LastHead,
                &ExtHdrsLen,
                &UnFragmentLen,
@@ -1092,7 +1158,7 @@ Ip6AcceptFrame (
   DispatchDpc ();
 
 Restart:
-  if (Payload != NULL) {
+  if (PayloadAllocated && (Payload != NULL)) {
     FreePool (Payload);
   }
 
@@ -540,6 +540,7 @@ Ip6CreateNeighborEntry (
   }
 
   InsertHeadList (&IpSb->NeighborTable, &Entry->Link);
+  InsertHeadList (&IpSb->NeighborBucket[IP6_NEIGHBOR_HASH (Ip6Address)], &Entry->HashLink);
 
   //
   // If corresponding default router entry exists, establish the relationship.
@@ -568,18 +569,23 @@ Ip6FindNeighborEntry (
   IN EFI_IPv6_ADDRESS  *Ip6Address
   )
 {
+  LIST_ENTRY          *Head;
   LIST_ENTRY          *Entry;
-  LIST_ENTRY          *Next;
   IP6_NEIGHBOR_ENTRY  *Neighbor;
 
   NET_CHECK_SIGNATURE (IpSb, IP6_SERVICE_SIGNATURE);
   ASSERT (Ip6Address != NULL);
 
-  NET_LIST_FOR_EACH_SAFE (Entry, Next, &IpSb->NeighborTable) {
-    Neighbor = NET_LIST_USER_STRUCT (Entry, IP6_NEIGHBOR_ENTRY, Link);
+  Head = &IpSb->NeighborBucket[IP6_NEIGHBOR_HASH (Ip6Address)];
+
+  NET_LIST_FOR_EACH (Entry, Head) {
+    Neighbor = NET_LIST_USER_STRUCT (Entry, IP6_NEIGHBOR_ENTRY, HashLink);
     if (EFI_IP6_EQUAL (Ip6Address, &Neighbor->Neighbor)) {
+      //
+      // Promote the entry to the head of its bucket. LRU
+      //
       RemoveEntryList (Entry);
-      InsertHeadList (&IpSb->NeighborTable, Entry);
+      InsertHeadList (Head, Entry);
 
       return Neighbor;
     }
@@ -669,6 +675,7 @@ Ip6FreeNeighborEntry (
     }
 
     RemoveEntryList (&NeighborCache->Link);
+    RemoveEntryList (&NeighborCache->HashLink);
     FreePool (NeighborCache);
   }
 
@@ -2778,6 +2785,7 @@ Ip6DelNeighbor (
   }
 
   RemoveEntryList (&Neighbor->Link);
+  RemoveEntryList (&Neighbor->HashLink);
   FreePool (Neighbor);
 
   return EFI_SUCCESS;
@@ -11,6 +11,17 @@
 
 #define IP6_GET_TICKS(Ms)  (((Ms) + IP6_TIMER_INTERVAL_IN_MS - 1) / IP6_TIMER_INTERVAL_IN_MS)
 
+///
+/// The neighbor cache is also hashed by the neighbor address so that
+/// the per packet lookup doesn't walk the whole table. On-link neighbors
+/// share the same prefix, so only the interface identifier is hashed.
+///
+#define IP6_NEIGHBOR_HASH_SIZE  31
+
+#define IP6_NEIGHBOR_HASH(Ip6Address)  \
+          ((ReadUnaligned32 ((UINT32 *) &(Ip6Address)->Addr[8]) ^ \
+            ReadUnaligned32 ((UINT32 *) &(Ip6Address)->Addr[12])) % IP6_NEIGHBOR_HASH_SIZE)
+
 enum {
   IP6_INF_ROUTER_LIFETIME = 0xFFFF,
 
@@ -159,6 +170,7 @@ typedef struct _IP6_DELAY_JOIN_LIST {
 
 typedef struct _IP6_NEIGHBOR_ENTRY {
   LIST_ENTRY                Link;
+  LIST_ENTRY                HashLink;       ///< Link in IP6_SERVICE.NeighborBucket
   LIST_ENTRY                ArpList;
   INTN                      RefCnt;
   BOOLEAN                   IsRouter;
@@ -11,12 +11,14 @@
 
 /**
   This is the worker function for IP6_ROUTE_CACHE_HASH(). It calculates the value
-  as the index of the route cache bucket according to the prefix of two IPv6 addresses.
+  as the index of the route cache bucket according to two IPv6 addresses. All the
+  32-bit words of both addresses are folded in, because the destinations cached
+  usually share the same prefix and only differ in the interface identifier.
 
   @param[in]  Ip1     The IPv6 address.
   @param[in]  Ip2     The IPv6 address.
 
-  @return The hash value of the prefix of two IPv6 addresses.
+  @return The hash value of the two IPv6 addresses.
 
 **/
 UINT32
@@ -25,13 +27,17 @@ Ip6RouteCacheHash (
   IN EFI_IPv6_ADDRESS  *Ip2
   )
 {
-  UINT32  Prefix1;
-  UINT32  Prefix2;
+  UINT32  Hash;
+  UINTN   Index;
 
-  Prefix1 = *((UINT32 *)((UINTN *)(Ip1)));
-  Prefix2 = *((UINT32 *)((UINTN *)(Ip2)));
+  Hash = 0;
 
-  return ((UINT32)(Prefix1 ^ Prefix2) % IP6_ROUTE_CACHE_HASH_SIZE);
+  for (Index = 0; Index < sizeof (EFI_IPv6_ADDRESS); Index += sizeof (UINT32)) {
+    Hash ^= ReadUnaligned32 ((UINT32 *)&Ip1->Addr[Index]);
+    Hash ^= ReadUnaligned32 ((UINT32 *)&Ip2->Addr[Index]);
+  }
+
+  return Hash % IP6_ROUTE_CACHE_HASH_SIZE;
 }
 
 /**
@@ -424,6 +430,9 @@ Ip6PurgeRouteCache (
       if (RtCacheEntry->Tag == Tag) {
         RemoveEntryList (Entry);
         Ip6FreeRouteCacheEntry (RtCacheEntry);
+
+        ASSERT (RtCache->CacheNum[Index] > 0);
+        RtCache->CacheNum[Index]--;
       }
     }
   }
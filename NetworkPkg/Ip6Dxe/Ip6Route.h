@@ -40,7 +40,7 @@ typedef struct {
 
 typedef struct {
   LIST_ENTRY    CacheBucket[IP6_ROUTE_CACHE_HASH_SIZE];
-  UINT8         CacheNum[IP6_ROUTE_CACHE_HASH_SIZE];
+  UINT32        CacheNum[IP6_ROUTE_CACHE_HASH_SIZE];
 } IP6_ROUTE_CACHE;
 
 //
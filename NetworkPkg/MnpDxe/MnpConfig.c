@@ -1261,9 +1261,11 @@ MnpStart (
     // The EnableSystemPoll differs with the current state, disable or enable
     // the system poll.
     //
-    TimerOpType = EnableSystemPoll ? TimerPeriodic : TimerCancel;
+    TimerOpType                 = EnableSystemPoll ? TimerPeriodic : TimerCancel;
+    MnpDeviceData->PollInterval = MNP_SYS_POLL_INTERVAL;
+    MnpDeviceData->IdlePolls    = 0;
 
-    Status = gBS->SetTimer (MnpDeviceData->PollTimer, TimerOpType, MNP_SYS_POLL_INTERVAL);
+    Status = gBS->SetTimer (MnpDeviceData->PollTimer, TimerOpType, MnpDeviceData->PollInterval);
     if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_ERROR, "MnpStart: gBS->SetTimer for PollTimer failed, %r.\n", Status));
 
@@ -1324,6 +1326,17 @@ MnpStop (
   //
   // No configured children now.
   //
+  DEBUG (
+    (DEBUG_NET,
+     "MnpStop: %Lu polls, %Lu packets, max batch %u, %Lu rx errors, %Lu no buffer, %Lu queue drops.\n",
+     MnpDeviceData->PollStats.Polls,
+     MnpDeviceData->PollStats.RxPackets,
+     MnpDeviceData->PollStats.MaxBatch,
+     MnpDeviceData->PollStats.RxErrors,
+     MnpDeviceData->PollStats.RxNoBuffer,
+     MnpDeviceData->PollStats.RxQueueDrops)
+    );
+
   if (MnpDeviceData->EnableSystemPoll) {
     //
     //  The system poll in on, cancel the poll timer.
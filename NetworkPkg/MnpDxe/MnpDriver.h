@@ -29,6 +29,22 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "ComponentName.h"
 
+//
+// The system poll batch sizes are counted in power of 2 buckets: 0, 1, 2-3,
+// 4-7, 8-15, 16-31, 32-63 and 64 or more packets.
+//
+#define MNP_POLL_BATCH_BUCKETS  8
+
+typedef struct {
+  UINT64    Polls;                                 ///< Number of system polls
+  UINT64    RxPackets;                             ///< Packets received by the system poll
+  UINT64    BatchCount[MNP_POLL_BATCH_BUCKETS];    ///< Polls per batch size bucket
+  UINT32    MaxBatch;                              ///< Largest batch received in one poll
+  UINT64    RxErrors;                              ///< Snp->Receive() failures other than EFI_NOT_READY
+  UINT64    RxNoBuffer;                            ///< Receives aborted for lack of a buffer
+  UINT64    RxQueueDrops;                          ///< Packets dropped by full instance queues
+} MNP_POLL_STATISTICS;
+
 #define MNP_DEVICE_DATA_SIGNATURE  SIGNATURE_32 ('M', 'n', 'p', 'D')
 
 //
@@ -68,6 +84,12 @@ typedef struct {
 
   EFI_EVENT                      PollTimer;
   BOOLEAN                        EnableSystemPoll;
+  //
+  // The system poll interval adapts to the receive load, see MnpSystemPoll().
+  //
+  UINT64                         PollInterval;
+  UINT32                         IdlePolls;
+  MNP_POLL_STATISTICS            PollStats;
 
   EFI_EVENT                      TimeoutCheckTimer;
   EFI_EVENT                      MediaDetectTimer;
@@ -13,6 +13,10 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define NET_ETHER_FCS_SIZE  4
 
 #define MNP_SYS_POLL_INTERVAL        (10 * TICKS_PER_MS)    // 10 milliseconds
+#define MNP_SYS_POLL_INTERVAL_MIN    (1 * TICKS_PER_MS)     // 1 millisecond
+#define MNP_SYS_POLL_INTERVAL_MAX    (50 * TICKS_PER_MS)    // 50 milliseconds
+#define MNP_SYS_POLL_IDLE_THRESHOLD  4                      // Idle polls before backing off
+#define MNP_SYS_POLL_BATCH           64                     // Packets drained in one system poll
 #define MNP_TIMEOUT_CHECK_INTERVAL   (50 * TICKS_PER_MS)    // 50 milliseconds
 #define MNP_MEDIA_DETECT_INTERVAL    (500 * TICKS_PER_MS)   // 500 milliseconds
 #define MNP_TX_TIMEOUT_TIME          (500 * TICKS_PER_MS)   // 500 milliseconds
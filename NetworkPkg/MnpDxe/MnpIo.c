@@ -481,6 +481,7 @@ MnpQueueRcvdPacket (
   //
   if (Instance->RcvdPacketQueueSize == MNP_MAX_RCVD_PACKET_QUE_SIZE) {
     DEBUG ((DEBUG_WARN, "MnpQueueRcvdPacket: Drop one packet bcz queue size limit reached.\n"));
+    Instance->MnpServiceData->MnpDeviceData->PollStats.RxQueueDrops++;
 
     //
     // Get the oldest packet.
@@ -860,6 +861,7 @@ MnpReceivePacket (
       //
       // No available buffer in the buffer pool.
       //
+      MnpDeviceData->PollStats.RxNoBuffer++;
       return EFI_DEVICE_ERROR;
     }
 
@@ -880,13 +882,11 @@ MnpReceivePacket (
   //
   Status = Snp->Receive (Snp, &HeaderSize, &BufLen, BufPtr, NULL, NULL, NULL);
   if (EFI_ERROR (Status)) {
-    DEBUG_CODE_BEGIN ();
     if (Status != EFI_NOT_READY) {
+      MnpDeviceData->PollStats.RxErrors++;
       DEBUG ((DEBUG_WARN, "MnpReceivePacket: Snp->Receive() = %r.\n", Status));
     }
 
-    DEBUG_CODE_END ();
-
     return Status;
   }
 
@@ -1083,10 +1083,65 @@ MnpCheckMediaStatus (
   }
 }
 
+/**
+  Account one system poll in the statistics and adapt the system poll interval
+  to the receive load.
+
+  The poll timer is switched to the shortest interval when a poll could not
+  drain Snp, the interval is halved when packets were received, and doubled
+  after MNP_SYS_POLL_IDLE_THRESHOLD consecutive polls found nothing.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+  @param[in]       Batch                The number of packets received in this poll.
+
+**/
+STATIC
+VOID
+MnpAdjustPollInterval (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN     UINT32           Batch
+  )
+{
+  MNP_POLL_STATISTICS  *Stats;
+  UINT64               Interval;
+  UINTN                Bucket;
+
+  Stats = &MnpDeviceData->PollStats;
+  Stats->Polls++;
+  Stats->RxPackets += Batch;
+  Stats->MaxBatch   = MAX (Stats->MaxBatch, Batch);
+  Bucket            = (Batch == 0) ? 0 : MIN (HighBitSet32 (Batch) + 1, MNP_POLL_BATCH_BUCKETS - 1);
+  Stats->BatchCount[Bucket]++;
+
+  Interval = MnpDeviceData->PollInterval;
+  if (Batch >= MNP_SYS_POLL_BATCH) {
+    //
+    // Snp may still hold received packets, poll as fast as possible.
+    //
+    MnpDeviceData->IdlePolls = 0;
+    Interval                 = MNP_SYS_POLL_INTERVAL_MIN;
+  } else if (Batch != 0) {
+    MnpDeviceData->IdlePolls = 0;
+    Interval                 = MAX (Interval / 2, MNP_SYS_POLL_INTERVAL_MIN);
+  } else if (++MnpDeviceData->IdlePolls >= MNP_SYS_POLL_IDLE_THRESHOLD) {
+    MnpDeviceData->IdlePolls = 0;
+    Interval                 = MIN (Interval * 2, MNP_SYS_POLL_INTERVAL_MAX);
+  }
+
+  if ((Interval != MnpDeviceData->PollInterval) && MnpDeviceData->EnableSystemPoll) {
+    if (!EFI_ERROR (gBS->SetTimer (MnpDeviceData->PollTimer, TimerPeriodic, Interval))) {
+      MnpDeviceData->PollInterval = Interval;
+    }
+  }
+}
+
 /**
   Poll to receive the packets from Snp. This function is either called by upperlayer
   protocols/applications or the system poll timer notify mechanism.
 
+  Up to MNP_SYS_POLL_BATCH packets are drained from Snp in one poll, and the
+  poll interval is adapted to the receive load.
+
   @param[in]  Event        The event this notify function registered to.
   @param[in]  Context      Pointer to the context data registered to the event.
 
@@ -1099,17 +1154,25 @@ MnpSystemPoll (
   )
 {
   MNP_DEVICE_DATA  *MnpDeviceData;
+  UINT32           Batch;
 
   MnpDeviceData = (MNP_DEVICE_DATA *)Context;
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
 
   //
-  // Try to receive packets from Snp.
+  // Try to receive packets from Snp until it is drained or the batch is full.
   //
-  MnpReceivePacket (MnpDeviceData);
+  for (Batch = 0; Batch < MNP_SYS_POLL_BATCH; Batch++) {
+    if (EFI_ERROR (MnpReceivePacket (MnpDeviceData))) {
+      break;
+    }
 
-  //
-  // Dispatch the DPC queued by the NotifyFunction of rx token's events.
-  //
-  DispatchDpc ();
+    //
+    // Dispatch the DPC queued by the NotifyFunction of rx token's events,
+    // so that the upper layers can recycle their rx tokens.
+    //
+    DispatchDpc ();
+  }
+
+  MnpAdjustPollInterval (MnpDeviceData, Batch);
 }
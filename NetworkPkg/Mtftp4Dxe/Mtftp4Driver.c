@@ -480,6 +480,7 @@ Mtftp4InitProtocol (
   Instance->Service = MtftpSb;
 
   InitializeListHead (&Instance->Blocks);
+  NetbufQueInit (&Instance->WrqWindow);
 }
 
 /**
@@ -67,6 +67,8 @@ Mtftp4CleanOperation (
     FreePool (Block);
   }
 
+  NetbufQueFlush (&Instance->WrqWindow);
+
   ZeroMem (&Instance->RequestOption, sizeof (MTFTP4_OPTION));
 
   Instance->Operation = 0;
@@ -115,6 +115,12 @@ struct _MTFTP4_PROTOCOL {
 
   UINT16                    WindowSize;
 
+  //
+  // Data blocks of a windowed upload which are sent but not acknowledged
+  // yet, kept for the retransmission of the blocks missed by the server.
+  //
+  NET_BUF_QUEUE             WrqWindow;
+
   //
   // Record the total received and saved block number.
   //
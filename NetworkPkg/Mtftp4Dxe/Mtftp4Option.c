@@ -467,13 +467,6 @@ Mtftp4ParseOption (
 
       MtftpOption->Exist |= MTFTP4_MCAST_EXIST;
     } else if (NetStringEqualNoCase (This->OptionStr, (UINT8 *)"windowsize")) {
-      if (Operation == EFI_MTFTP4_OPCODE_WRQ) {
-        //
-        // Currently, windowsize is not supported in the write operation.
-        //
-        return EFI_UNSUPPORTED;
-      }
-
       Value = NetStringToU32 (This->ValueStr);
 
       if (Value < 1) {
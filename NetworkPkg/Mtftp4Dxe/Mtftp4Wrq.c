@@ -110,9 +110,149 @@ Mtftp4WrqSendBlock (
     }
   }
 
+  //
+  // Keep the block until it is acknowledged if the server accepted a window,
+  // the data provided by PacketNeeded can't be requested again.
+  //
+  if (Instance->WindowSize > 1) {
+    NET_GET_REF (UdpPacket);
+    NetbufQueAppend (&Instance->WrqWindow, UdpPacket);
+  }
+
   return Mtftp4SendPacket (Instance, UdpPacket);
 }
 
+/**
+  Retransmit the data blocks of the window which are not acknowledged.
+
+  The server acknowledges the last block it received in sequence, so only
+  the blocks after it are sent again.
+
+  @param  Instance              The MTFTP upload session.
+
+  @retval EFI_SUCCESS           The blocks are retransmitted.
+  @retval Others                Failed to transmit the blocks.
+
+**/
+EFI_STATUS
+Mtftp4WrqResendWindow (
+  IN OUT MTFTP4_PROTOCOL  *Instance
+  )
+{
+  LIST_ENTRY  *Entry;
+  NET_BUF     *UdpPacket;
+  EFI_STATUS  Status;
+
+  NET_LIST_FOR_EACH (Entry, &Instance->WrqWindow.BufList) {
+    UdpPacket = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+
+    NET_GET_REF (UdpPacket);
+    Status = Mtftp4SendPacket (Instance, UdpPacket);
+
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Function to handle received ACK packet of a windowed upload, as defined by
+  RFC 7440.
+
+  The ACK acknowledges all the blocks up to its block number. The blocks of
+  the window after it were missed by the server, and are retransmitted.
+  The window is then filled with new blocks.
+
+  @param  Instance              The MTFTP upload session
+  @param  AckNum                The block number of the ACK
+  @param  Completed             Return whether the upload has finished.
+
+  @retval EFI_SUCCESS           The ACK is successfully processed.
+  @retval EFI_TFTP_ERROR        The block number loops back.
+  @retval Others                Failed to transmit the data packets.
+
+**/
+EFI_STATUS
+Mtftp4WrqHandleWindowAck (
+  IN     MTFTP4_PROTOCOL  *Instance,
+  IN     UINT16           AckNum,
+  OUT BOOLEAN             *Completed
+  )
+{
+  INTN        Expected;
+  UINT16      Acked;
+  UINT32      InFlight;
+  UINT64      BlockCounter;
+  EFI_STATUS  Status;
+
+  Expected = Mtftp4GetNextBlockNum (&Instance->Blocks);
+  ASSERT (Expected >= 0);
+
+  //
+  // The blocks [Expected, Expected + InFlight - 1] are sent but not
+  // acknowledged. Before the first block is sent, the server ACK0 is
+  // expected to start the transfer.
+  //
+  InFlight = Instance->WrqWindow.BufNum;
+  Acked    = (UINT16)(AckNum - (UINT16)Expected + 1);
+
+  if (((InFlight == 0) && (Acked != 1)) || ((InFlight != 0) && (Acked > InFlight))) {
+    return EFI_SUCCESS;
+  }
+
+  while (Acked-- > 0) {
+    Mtftp4RemoveBlockNum (&Instance->Blocks, (UINT16)Expected, *Completed, &BlockCounter);
+    Expected = (UINT16)(Expected + 1);
+
+    if (Instance->WrqWindow.BufNum > 0) {
+      NetbufFree (NetbufQueRemove (&Instance->WrqWindow));
+    }
+  }
+
+  Expected = Mtftp4GetNextBlockNum (&Instance->Blocks);
+
+  if (Expected < 0) {
+    //
+    // The block range is empty, see Mtftp4WrqHandleAck.
+    //
+    if (Instance->LastBlock == AckNum) {
+      ASSERT (Instance->LastBlock >= 1);
+      *Completed = TRUE;
+      return EFI_SUCCESS;
+    } else {
+      Mtftp4SendError (
+        Instance,
+        EFI_MTFTP4_ERRORCODE_REQUEST_DENIED,
+        (UINT8 *)"Block number rolls back, not supported, try blksize option"
+        );
+
+      return EFI_TFTP_ERROR;
+    }
+  }
+
+  //
+  // Retransmit the blocks missed by the server, which acknowledged a block
+  // before the end of the window, or acknowledged again the block before the
+  // window. Then send new blocks until the window is full or the last block
+  // is sent.
+  //
+  Status = Mtftp4WrqResendWindow (Instance);
+
+  while (!EFI_ERROR (Status) &&
+         (Instance->WrqWindow.BufNum < Instance->WindowSize) &&
+         (Instance->LastBlock == 0))
+  {
+    Status = Mtftp4WrqSendBlock (
+               Instance,
+               (UINT16)(Expected + Instance->WrqWindow.BufNum)
+               );
+  }
+
+  return Status;
+}
+
 /**
   Function to handle received ACK packet.
 
@@ -143,7 +283,12 @@ Mtftp4WrqHandleAck (
 
   *Completed = FALSE;
   AckNum     = NTOHS (Packet->Ack.Block[0]);
-  Expected   = Mtftp4GetNextBlockNum (&Instance->Blocks);
+
+  if (Instance->WindowSize > 1) {
+    return Mtftp4WrqHandleWindowAck (Instance, AckNum, Completed);
+  }
+
+  Expected = Mtftp4GetNextBlockNum (&Instance->Blocks);
 
   ASSERT (Expected >= 0);
 
@@ -218,10 +363,11 @@ Mtftp4WrqOackValid (
   }
 
   //
-  // Server can only specify a smaller block size to be used and
-  // return the timeout matches that requested.
+  // Server can only specify a smaller block size and window size to be used
+  // and return the timeout matches that requested.
   //
   if ((((Reply->Exist & MTFTP4_BLKSIZE_EXIST) != 0) && (Reply->BlkSize > Request->BlkSize)) ||
+      (((Reply->Exist & MTFTP4_WINDOWSIZE_EXIST) != 0) && (Reply->WindowSize > Request->WindowSize)) ||
       (((Reply->Exist & MTFTP4_TIMEOUT_EXIST) != 0) && (Reply->Timeout != Request->Timeout)))
   {
     return FALSE;
@@ -299,6 +445,10 @@ Mtftp4WrqHandleOack (
     Instance->Timeout = Reply.Timeout;
   }
 
+  if (Reply.WindowSize != 0) {
+    Instance->WindowSize = Reply.WindowSize;
+  }
+
   //
   // Build a bogus ACK0 packet then pass it to the Mtftp4WrqHandleAck,
   // which will start the transmission of the first data block.
@@ -178,6 +178,8 @@ Mtftp6DestroyInstance (
     FreePool (Block);
   }
 
+  NetbufQueFlush (&Instance->WrqWindow);
+
   FreePool (Instance);
 }
 
@@ -218,6 +220,7 @@ Mtftp6CreateInstance (
 
   InitializeListHead (&Mtftp6Ins->Link);
   InitializeListHead (&Mtftp6Ins->BlkList);
+  NetbufQueInit (&Mtftp6Ins->WrqWindow);
 
   *Instance = Mtftp6Ins;
 
@@ -75,6 +75,12 @@ struct _MTFTP6_INSTANCE {
 
   UINT16                    WindowSize;
 
+  //
+  // Data blocks of a windowed upload which are sent but not acknowledged
+  // yet, kept for the retransmission of the blocks missed by the server.
+  //
+  NET_BUF_QUEUE             WrqWindow;
+
   //
   // Record the total received and saved block number.
   //
@@ -213,13 +213,6 @@ Mtftp6ParseExtensionOption (
 
       ExtInfo->BitMap |= MTFTP6_OPT_MCAST_BIT;
     } else if (AsciiStriCmp ((CHAR8 *)Opt->OptionStr, "windowsize") == 0) {
-      if (Operation == EFI_MTFTP6_OPCODE_WRQ) {
-        //
-        // Currently, windowsize is not supported in the write operation.
-        //
-        return EFI_UNSUPPORTED;
-      }
-
       Value = (UINT32)AsciiStrDecimalToUintn ((CHAR8 *)Opt->ValueStr);
 
       if ((Value < 1)) {
@@ -943,6 +943,8 @@ Mtftp6OperationClean (
     FreePool (Block);
   }
 
+  NetbufQueFlush (&Instance->WrqWindow);
+
   //
   // Reinitialize the corresponding fields of the Mtftp6 operation.
   //
@@ -109,13 +109,169 @@ Mtftp6WrqSendBlock (
   }
 
   //
-  // Reset current retry count of the instance.
+  // Keep the block until it is acknowledged if the server accepted a window,
+  // the data provided by PacketNeeded can't be requested again.
   //
-  Instance->CurRetry = 0;
+  if (Instance->WindowSize > 1) {
+    NET_GET_REF (UdpPacket);
+    NetbufQueAppend (&Instance->WrqWindow, UdpPacket);
+  }
+
+  //
+  // Save the block for the retransmission on timeout, and reset current
+  // retry count of the instance.
+  //
+  if (Instance->LastPacket != NULL) {
+    NetbufFree (Instance->LastPacket);
+  }
+
+  Instance->LastPacket = UdpPacket;
+  Instance->CurRetry   = 0;
 
   return Mtftp6TransmitPacket (Instance, UdpPacket);
 }
 
+/**
+  Retransmit the data blocks of the window which are not acknowledged.
+
+  The server acknowledges the last block it received in sequence, so only
+  the blocks after it are sent again.
+
+  @param[in]  Instance              The pointer to the Mtftp6 instance.
+
+  @retval EFI_SUCCESS           The blocks are retransmitted.
+  @retval Others                Failed to transmit the blocks.
+
+**/
+EFI_STATUS
+Mtftp6WrqResendWindow (
+  IN MTFTP6_INSTANCE  *Instance
+  )
+{
+  LIST_ENTRY  *Entry;
+  NET_BUF     *UdpPacket;
+  EFI_STATUS  Status;
+
+  NET_LIST_FOR_EACH (Entry, &Instance->WrqWindow.BufList) {
+    UdpPacket = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+
+    Instance->CurRetry = 0;
+    Status             = Mtftp6TransmitPacket (Instance, UdpPacket);
+
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Function to handle received ACK packet of a windowed upload, as defined by
+  RFC 7440.
+
+  The ACK acknowledges all the blocks up to its block number. The blocks of
+  the window after it were missed by the server, and are retransmitted.
+  The window is then filled with new blocks.
+
+  @param[in]  Instance              The pointer to the Mtftp6 instance.
+  @param[in]  AckNum                The block number of the ACK.
+  @param[out] UdpPacket             The net buf of received packet.
+  @param[out] IsCompleted           If TRUE, the upload has been completed.
+                                    Otherwise, the upload has not been completed.
+
+  @retval EFI_SUCCESS           The ACK packet successfully processed.
+  @retval EFI_TFTP_ERROR        The block number loops back.
+  @retval Others                Failed to transmit the data packets.
+
+**/
+EFI_STATUS
+Mtftp6WrqHandleWindowAck (
+  IN  MTFTP6_INSTANCE  *Instance,
+  IN  UINT16           AckNum,
+  OUT NET_BUF          **UdpPacket,
+  OUT BOOLEAN          *IsCompleted
+  )
+{
+  INTN        Expected;
+  UINT16      Acked;
+  UINT32      InFlight;
+  UINT64      BlockCounter;
+  EFI_STATUS  Status;
+
+  Expected = Mtftp6GetNextBlockNum (&Instance->BlkList);
+  ASSERT (Expected >= 0);
+
+  //
+  // The blocks [Expected, Expected + InFlight - 1] are sent but not
+  // acknowledged. Before the first block is sent, the server ACK0 is
+  // expected to start the transfer.
+  //
+  InFlight = Instance->WrqWindow.BufNum;
+  Acked    = (UINT16)(AckNum - (UINT16)Expected + 1);
+
+  if (((InFlight == 0) && (Acked != 1)) || ((InFlight != 0) && (Acked > InFlight))) {
+    return EFI_SUCCESS;
+  }
+
+  while (Acked-- > 0) {
+    Mtftp6RemoveBlockNum (&Instance->BlkList, (UINT16)Expected, *IsCompleted, &BlockCounter);
+    Expected = (UINT16)(Expected + 1);
+
+    if (Instance->WrqWindow.BufNum > 0) {
+      NetbufFree (NetbufQueRemove (&Instance->WrqWindow));
+    }
+  }
+
+  Expected = Mtftp6GetNextBlockNum (&Instance->BlkList);
+
+  if ((Expected < 0) && (Instance->LastBlk == AckNum)) {
+    ASSERT (Instance->LastBlk >= 1);
+    *IsCompleted = TRUE;
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Free the receive buffer before send new packet since it might need
+  // reconfigure udpio.
+  //
+  NetbufFree (*UdpPacket);
+  *UdpPacket = NULL;
+
+  if (Expected < 0) {
+    //
+    // Send the Mtftp6 error message if block number rolls back.
+    //
+    Mtftp6SendError (
+      Instance,
+      EFI_MTFTP6_ERRORCODE_REQUEST_DENIED,
+      (UINT8 *)"Block number rolls back, not supported, try blksize option"
+      );
+
+    return EFI_TFTP_ERROR;
+  }
+
+  //
+  // Retransmit the blocks missed by the server, which acknowledged a block
+  // before the end of the window, or acknowledged again the block before the
+  // window. Then send new blocks until the window is full or the last block
+  // is sent.
+  //
+  Status = Mtftp6WrqResendWindow (Instance);
+
+  while (!EFI_ERROR (Status) &&
+         (Instance->WrqWindow.BufNum < Instance->WindowSize) &&
+         (Instance->LastBlk == 0))
+  {
+    Status = Mtftp6WrqSendBlock (
+               Instance,
+               (UINT16)(Expected + Instance->WrqWindow.BufNum)
+               );
+  }
+
+  return Status;
+}
+
 /**
   Function to handle received ACK packet. If the ACK number matches the
   expected block number, with more data pending, send the next
@@ -148,7 +304,12 @@ Mtftp6WrqHandleAck (
 
   *IsCompleted = FALSE;
   AckNum       = NTOHS (Packet->Ack.Block[0]);
-  Expected     = Mtftp6GetNextBlockNum (&Instance->BlkList);
+
+  if (Instance->WindowSize > 1) {
+    return Mtftp6WrqHandleWindowAck (Instance, AckNum, UdpPacket, IsCompleted);
+  }
+
+  Expected = Mtftp6GetNextBlockNum (&Instance->BlkList);
 
   ASSERT (Expected >= 0);
 
@@ -238,10 +399,11 @@ Mtftp6WrqOackValid (
   }
 
   //
-  // Server can only specify a smaller block size to be used and
-  // return the timeout matches that requested.
+  // Server can only specify a smaller block size and window size to be used
+  // and return the timeout matches that requested.
   //
   if ((((ReplyInfo->BitMap & MTFTP6_OPT_BLKSIZE_BIT) != 0) && (ReplyInfo->BlkSize > RequestInfo->BlkSize)) ||
+      (((ReplyInfo->BitMap & MTFTP6_OPT_WINDOWSIZE_BIT) != 0) && (ReplyInfo->WindowSize > RequestInfo->WindowSize)) ||
       (((ReplyInfo->BitMap & MTFTP6_OPT_TIMEOUT_BIT) != 0) && (ReplyInfo->Timeout != RequestInfo->Timeout))
       )
   {
@@ -342,6 +504,10 @@ Mtftp6WrqHandleOack (
     Instance->Timeout = ExtInfo.Timeout;
   }
 
+  if (ExtInfo.WindowSize != 0) {
+    Instance->WindowSize = ExtInfo.WindowSize;
+  }
+
   //
   // Build a bogus ACK0 packet then pass it to the Mtftp6WrqHandleAck,
   // which will start the transmission of the first data block.
@@ -0,0 +1,392 @@
+/** @file
+  Tests for TcpCongest.c.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/DebugLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include "../TcpMain.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define TEST_MSS       1460
+#define TEST_ISS       1000
+#define TEST_RTT_TICK  1
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// These are not directly under test - but required to compile
+////////////////////////////////////////////////////////////////////////
+
+UINT32  mTcpTick = 1000;
+
+static TCP_SEQNO  mRetransmitted[16];
+static UINTN      mRetransmitCount;
+
+INTN
+TcpRetransmit (
+  IN TCP_CB     *Tcb,
+  IN TCP_SEQNO  Seq
+  )
+{
+  if (mRetransmitCount < ARRAY_SIZE (mRetransmitted)) {
+    mRetransmitted[mRetransmitCount] = Seq;
+  }
+
+  mRetransmitCount++;
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////
+// TcpSackUpdate / TcpSackRetransmit Tests
+////////////////////////////////////////////////////////////////////////
+
+class TcpSackTest : public ::testing::Test {
+protected:
+  TCP_CB Tcb;
+  TCP_OPTION Option;
+
+  void
+  SetUp (
+    ) override
+  {
+    ZeroMem (&Tcb, sizeof (Tcb));
+    ZeroMem (&Option, sizeof (Option));
+
+    Tcb.SndMss = TEST_MSS;
+    Tcb.SndUna = TEST_ISS;
+    Tcb.SndNxt = TEST_ISS + 10 * TEST_MSS;
+    TcpSackClear (&Tcb);
+
+    mRetransmitCount = 0;
+  }
+
+  //
+  // Report the SACK of segments [First, Last) relative to the ISS.
+  //
+  void
+  AddBlock (
+    UINT32  First,
+    UINT32  Last
+    )
+  {
+    Option.Flag                      |= TCP_OPTION_RCVD_SACK;
+    Option.Sack[Option.SackNum].Left  = TEST_ISS + First * TEST_MSS;
+    Option.Sack[Option.SackNum].Right = TEST_ISS + Last * TEST_MSS;
+    Option.SackNum++;
+  }
+
+  void
+  Ack (
+    TCP_SEQNO  Ack
+    )
+  {
+    TcpSackUpdate (&Tcb, Ack, &Option);
+    ZeroMem (&Option, sizeof (Option));
+  }
+};
+
+// Reordered and overlapping blocks are merged into a sorted scoreboard
+TEST_F (TcpSackTest, ReorderedBlocksShouldMerge) {
+  AddBlock (6, 7);
+  AddBlock (2, 3);
+  Ack (TEST_ISS);
+
+  AddBlock (4, 5);
+  AddBlock (3, 4);
+  Ack (TEST_ISS);
+
+  AddBlock (5, 6);
+  Ack (TEST_ISS);
+
+  ASSERT_EQ (Tcb.SackNum, 1);
+  ASSERT_EQ (Tcb.SackBoard[0].Left, (UINT32)(TEST_ISS + 2 * TEST_MSS));
+  ASSERT_EQ (Tcb.SackBoard[0].Right, (UINT32)(TEST_ISS + 7 * TEST_MSS));
+}
+
+// The cumulative ACK trims the scoreboard
+TEST_F (TcpSackTest, CumulativeAckShouldTrimBlocks) {
+  AddBlock (2, 4);
+  AddBlock (6, 8);
+  Ack (TEST_ISS);
+
+  Ack (TEST_ISS + 3 * TEST_MSS);
+  ASSERT_EQ (Tcb.SackNum, 2);
+  ASSERT_EQ (Tcb.SackBoard[0].Left, (UINT32)(TEST_ISS + 3 * TEST_MSS));
+
+  Ack (TEST_ISS + 8 * TEST_MSS);
+  ASSERT_EQ (Tcb.SackNum, 0);
+}
+
+// Blocks below the cumulative ACK, beyond SndNxt or empty are ignored
+TEST_F (TcpSackTest, InvalidBlocksShouldBeIgnored) {
+  AddBlock (0, 1);
+  AddBlock (9, 11);
+  AddBlock (5, 5);
+  Ack (TEST_ISS + TEST_MSS);
+
+  ASSERT_EQ (Tcb.SackNum, 0);
+}
+
+// The scoreboard never overflows, the highest ranges are dropped
+TEST_F (TcpSackTest, FullScoreboardShouldDropHighest) {
+  UINT32  Index;
+
+  Tcb.SndNxt = TEST_ISS + 4 * TCP_SACK_BOARD_LEN * TEST_MSS;
+
+  for (Index = TCP_SACK_BOARD_LEN + 2; Index > 0; Index--) {
+    AddBlock (2 * Index + 1, 2 * Index + 2);
+    Ack (TEST_ISS);
+  }
+
+  ASSERT_EQ (Tcb.SackNum, TCP_SACK_BOARD_LEN);
+  ASSERT_EQ (Tcb.SackBoard[0].Left, (UINT32)(TEST_ISS + 3 * TEST_MSS));
+}
+
+// Each hole is retransmitted once per recovery
+TEST_F (TcpSackTest, HolesShouldBeRetransmittedOnce) {
+  TCP_SACK_BLOCK  Hole;
+
+  AddBlock (1, 3);
+  AddBlock (5, 6);
+  Ack (TEST_ISS);
+
+  ASSERT_TRUE (TcpSackNextHole (&Tcb, TEST_ISS, &Hole));
+  ASSERT_EQ (Hole.Left, (UINT32)TEST_ISS);
+  ASSERT_EQ (Hole.Right, (UINT32)(TEST_ISS + TEST_MSS));
+
+  ASSERT_TRUE (TcpSackRetransmit (&Tcb, Tcb.SndUna));
+  ASSERT_TRUE (TcpSackRetransmit (&Tcb, Tcb.SndUna));
+  ASSERT_TRUE (TcpSackRetransmit (&Tcb, Tcb.SndUna));
+  ASSERT_FALSE (TcpSackRetransmit (&Tcb, Tcb.SndUna));
+
+  ASSERT_EQ (mRetransmitCount, (UINTN)3);
+  ASSERT_EQ (mRetransmitted[0], (UINT32)TEST_ISS);
+  ASSERT_EQ (mRetransmitted[1], (UINT32)(TEST_ISS + 3 * TEST_MSS));
+  ASSERT_EQ (mRetransmitted[2], (UINT32)(TEST_ISS + 4 * TEST_MSS));
+}
+
+////////////////////////////////////////////////////////////////////////
+// TcpCongestOnAck / TcpCongestOnLoss Tests
+////////////////////////////////////////////////////////////////////////
+
+class TcpCongestTest : public ::testing::Test {
+protected:
+  TCP_CB Tcb;
+
+  void
+  SetUp (
+    ) override
+  {
+    mTcpTick = 1000;
+
+    ZeroMem (&Tcb, sizeof (Tcb));
+    Tcb.SndMss      = TEST_MSS;
+    Tcb.SndWndScale = TCP_OPTION_MAX_WS;
+    Tcb.SRtt        = TEST_RTT_TICK << TCP_RTT_SHIFT;
+    Tcb.CWnd        = 10 * TEST_MSS;
+    Tcb.Ssthresh    = 10 * TEST_MSS;
+  }
+
+  //
+  // Run a bulk transfer on a path of TEST_RTT_TICK round trip time,
+  // dropping a segment every LossInterval round trips, and return
+  // the number of bytes delivered.
+  //
+  UINT64
+  Run (
+    UINT8   Algo,
+    UINT32  Rounds,
+    UINT32  LossInterval
+    )
+  {
+    UINT64  Delivered;
+    UINT32  Round;
+    UINT32  Segment;
+    UINT32  Segments;
+
+    Tcb.CongestAlgo = Algo;
+    Delivered       = 0;
+
+    for (Round = 1; Round <= Rounds; Round++) {
+      Delivered += Tcb.CWnd;
+
+      if (Round % LossInterval == 0) {
+        Tcb.SndUna   = 0;
+        Tcb.SndNxt   = Tcb.CWnd;
+        Tcb.Ssthresh = TcpCongestOnLoss (&Tcb);
+        Tcb.CWnd     = Tcb.Ssthresh;
+      } else {
+        Segments = Tcb.CWnd / TEST_MSS;
+        for (Segment = 0; Segment < Segments; Segment++) {
+          TcpCongestOnAck (&Tcb);
+        }
+      }
+
+      mTcpTick += TEST_RTT_TICK;
+    }
+
+    return Delivered;
+  }
+};
+
+// Slow start doubles the window every round trip
+TEST_F (TcpCongestTest, SlowStartShouldDoubleWindow) {
+  UINT32  Index;
+
+  Tcb.Ssthresh = MAX_UINT32;
+  for (Index = 0; Index < 10; Index++) {
+    TcpCongestOnAck (&Tcb);
+  }
+
+  ASSERT_EQ (Tcb.CWnd, (UINT32)(20 * TEST_MSS));
+}
+
+// NewReno halves the flight size, CUBIC backs off by beta
+TEST_F (TcpCongestTest, LossShouldReduceByBeta) {
+  Tcb.SndUna = 0;
+  Tcb.SndNxt = 100 * TEST_MSS;
+
+  Tcb.CongestAlgo = TCP_CC_NEWRENO;
+  ASSERT_EQ (TcpCongestOnLoss (&Tcb), (UINT32)(50 * TEST_MSS));
+
+  Tcb.CongestAlgo = TCP_CC_CUBIC;
+  ASSERT_EQ (TcpCongestOnLoss (&Tcb), (UINT32)(70 * TEST_MSS));
+  ASSERT_EQ (Tcb.CubicWMax, (UINT32)(100 * TEST_MSS));
+
+  //
+  // The window didn't reach its last maximum, fast convergence
+  // lowers the maximum further.
+  //
+  Tcb.SndNxt = 90 * TEST_MSS;
+  TcpCongestOnLoss (&Tcb);
+  ASSERT_LT (Tcb.CubicWMax, (UINT32)(90 * TEST_MSS));
+}
+
+// The window is never reduced below two segments
+TEST_F (TcpCongestTest, LossShouldKeepTwoSegments) {
+  Tcb.SndUna = 0;
+  Tcb.SndNxt = TEST_MSS;
+
+  Tcb.CongestAlgo = TCP_CC_NEWRENO;
+  ASSERT_EQ (TcpCongestOnLoss (&Tcb), (UINT32)(2 * TEST_MSS));
+
+  Tcb.CongestAlgo = TCP_CC_CUBIC;
+  ASSERT_EQ (TcpCongestOnLoss (&Tcb), (UINT32)(2 * TEST_MSS));
+}
+
+// CUBIC recovers to the window of the last loss, then keeps probing
+TEST_F (TcpCongestTest, CubicShouldRecoverToLastMaximum) {
+  UINT32  Round;
+
+  Tcb.CongestAlgo = TCP_CC_CUBIC;
+  Tcb.SndUna      = 0;
+  Tcb.SndNxt      = 100 * TEST_MSS;
+  Tcb.Ssthresh    = TcpCongestOnLoss (&Tcb);
+  Tcb.CWnd        = Tcb.Ssthresh;
+
+  for (Round = 0; Round < 40; Round++) {
+    UINT32  Segments = Tcb.CWnd / TEST_MSS;
+
+    while (Segments-- > 0) {
+      TcpCongestOnAck (&Tcb);
+    }
+
+    mTcpTick += TEST_RTT_TICK;
+  }
+
+  ASSERT_GT (Tcb.CWnd, (UINT32)(100 * TEST_MSS));
+}
+
+// With periodic loss on a long path CUBIC delivers more than NewReno
+TEST_F (TcpCongestTest, CubicShouldOutperformNewRenoWithLoss) {
+  UINT64  Reno;
+  UINT64  Cubic;
+
+  Reno = Run (TCP_CC_NEWRENO, 1000, 100);
+
+  SetUp ();
+  Cubic = Run (TCP_CC_CUBIC, 1000, 100);
+
+  ASSERT_GT (Cubic, Reno);
+}
+
+////////////////////////////////////////////////////////////////////////
+// TcpTuneRcvBuffer Tests
+////////////////////////////////////////////////////////////////////////
+
+class TcpTuneRcvBufferTest : public ::testing::Test {
+protected:
+  TCP_CB Tcb;
+  SOCKET Sock;
+
+  void
+  SetUp (
+    ) override
+  {
+    mTcpTick = 1000;
+
+    ZeroMem (&Tcb, sizeof (Tcb));
+    ZeroMem (&Sock, sizeof (Sock));
+
+    Tcb.Sk           = &Sock;
+    Tcb.SRtt         = TEST_RTT_TICK << TCP_RTT_SHIFT;
+    Tcb.RcvNxt       = TEST_ISS;
+    Tcb.RcvSpaceSeq  = TEST_ISS;
+    Tcb.RcvSpaceTime = mTcpTick;
+    SET_RCV_BUFFSIZE (&Sock, TCP_RCV_BUF_SIZE);
+  }
+};
+
+// A peer filling the buffer each round trip doubles it up to the limit
+TEST_F (TcpTuneRcvBufferTest, FullWindowShouldGrowBuffer) {
+  UINT32  Round;
+  UINT32  BufSize;
+
+  for (Round = 0; Round < 32; Round++) {
+    BufSize     = GET_RCV_BUFFSIZE (&Sock);
+    Tcb.RcvNxt += BufSize;
+    mTcpTick   += TEST_RTT_TICK;
+    TcpTuneRcvBuffer (&Tcb);
+
+    if (BufSize < TcpRcvBufferLimit ()) {
+      ASSERT_GT (GET_RCV_BUFFSIZE (&Sock), BufSize);
+    }
+  }
+
+  ASSERT_EQ (GET_RCV_BUFFSIZE (&Sock), TcpRcvBufferLimit ());
+}
+
+// A slow peer doesn't grow the buffer
+TEST_F (TcpTuneRcvBufferTest, SlowPeerShouldKeepBuffer) {
+  UINT32  BufSize;
+
+  BufSize     = GET_RCV_BUFFSIZE (&Sock);
+  Tcb.RcvNxt += BufSize / 4;
+  mTcpTick   += TEST_RTT_TICK;
+  TcpTuneRcvBuffer (&Tcb);
+
+  ASSERT_EQ (GET_RCV_BUFFSIZE (&Sock), BufSize);
+}
+
+// A receive buffer sized by the application is never grown
+TEST_F (TcpTuneRcvBufferTest, FixedBufferShouldKeepSize) {
+  UINT32  BufSize;
+
+  TCP_SET_FLG (Tcb.CtrlFlag, TCP_CTRL_FIXED_RCVBUF);
+
+  BufSize     = GET_RCV_BUFFSIZE (&Sock);
+  Tcb.RcvNxt += BufSize;
+  mTcpTick   += TEST_RTT_TICK;
+  TcpTuneRcvBuffer (&Tcb);
+
+  ASSERT_EQ (GET_RCV_BUFFSIZE (&Sock), BufSize);
+}
@@ -218,6 +218,8 @@ SockSetTcpRxData (
     RcvdBytes               -= CopyBytes;
     OffSet                  += CopyBytes;
   }
+
+  Sock->CopiedBytes += OffSet;
 }
 
 /**
@@ -812,6 +814,17 @@ SockDestroy (
 {
   ASSERT (SockStream == Sock->Type);
 
+  //
+  // The received data is queued by reference and copied only once, to the
+  // application's buffer, so the copied bytes should track the received ones.
+  //
+  DEBUG (
+    (DEBUG_NET,
+     "SockDestroy: %Lu bytes received, %Lu bytes copied to the application\n",
+     Sock->RcvdBytes,
+     Sock->CopiedBytes)
+    );
+
   //
   // Flush the completion token buffered
   // by sock and rcv, snd buffer
@@ -1136,6 +1149,7 @@ SockDataRcvd (
   NET_GET_REF (NetBuffer);
 
   ((TCP_RSV_DATA *)(NetBuffer->ProtoData))->UrgLen = UrgLen;
+  Sock->RcvdBytes                                  += NetBuffer->TotalSize;
 
   NetbufQueAppend (Sock->RcvBuffer.DataQueue, NetBuffer);
 
@@ -472,6 +472,13 @@ struct _TCP_SOCKET {
   EFI_STATUS                  SockError;    ///< The error returned by low layer protocol
   BOOLEAN                     InDestroy;
 
+  //
+  // Receive path statistics: the data delivered by the low layer protocol,
+  // and the data copied from the receive buffer to the application.
+  //
+  UINT64                      RcvdBytes;
+  UINT64                      CopiedBytes;
+
   //
   // Fields used to manage the connection request
   //
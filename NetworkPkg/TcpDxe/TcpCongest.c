@@ -0,0 +1,438 @@
+/** @file
+  TCP congestion control, SACK scoreboard and receive buffer tuning.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpMain.h"
+
+/**
+  Get the limit the receive buffer may be grown to by auto-tuning.
+
+  @return The limit in bytes, 0 if auto-tuning is disabled.
+
+**/
+UINT32
+TcpRcvBufferLimit (
+  VOID
+  )
+{
+  return MIN (PcdGet32 (PcdTcpMaxReceiveBufferSize), TCP_RCV_BUF_SIZE_MAX);
+}
+
+/**
+  Grow the receive buffer if the peer filled more than half of it during
+  the last round trip, so the advertised window doesn't limit the throughput
+  of paths with a large bandwidth-delay product. A receive buffer size set
+  by the application is left alone.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpTuneRcvBuffer (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  UINT32  Rtt;
+  UINT32  Received;
+  UINT32  BufSize;
+  UINT32  Limit;
+
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_FIXED_RCVBUF)) {
+    return;
+  }
+
+  Rtt = MAX (Tcb->SRtt >> TCP_RTT_SHIFT, 1);
+  if (TCP_SUB_TIME (mTcpTick, Tcb->RcvSpaceTime) < Rtt) {
+    return;
+  }
+
+  Received = TCP_SUB_SEQ (Tcb->RcvNxt, Tcb->RcvSpaceSeq);
+  BufSize  = GET_RCV_BUFFSIZE (Tcb->Sk);
+  Limit    = TcpRcvBufferLimit ();
+
+  if ((Received > BufSize / 2) && (BufSize < Limit)) {
+    BufSize = (BufSize > Limit / 2) ? Limit : 2 * BufSize;
+    SET_RCV_BUFFSIZE (Tcb->Sk, BufSize);
+
+    DEBUG (
+      (DEBUG_NET,
+       "TcpTuneRcvBuffer: receive buffer of TCB %p grown to %d\n",
+       Tcb,
+       BufSize)
+      );
+  }
+
+  Tcb->RcvSpaceSeq  = Tcb->RcvNxt;
+  Tcb->RcvSpaceTime = mTcpTick;
+}
+
+/**
+  Forget all the SACK information received from the peer.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackClear (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  Tcb->SackNum = 0;
+  Tcb->HighRxt = Tcb->SndUna;
+}
+
+/**
+  Merge one block into the scoreboard, which is kept sorted and
+  without overlapping ranges. When the scoreboard is full, the
+  highest range is dropped.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Left     First sequence number of the block.
+  @param[in]       Right    Sequence number following the block.
+
+**/
+STATIC
+VOID
+TcpSackInsert (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Left,
+  IN     TCP_SEQNO  Right
+  )
+{
+  TCP_SACK_BLOCK  Board[TCP_SACK_BOARD_LEN + 1];
+  UINT8           Num;
+  UINT8           Index;
+  BOOLEAN         Inserted;
+
+  Num      = 0;
+  Inserted = FALSE;
+
+  for (Index = 0; Index < Tcb->SackNum; Index++) {
+    if (TCP_SEQ_LT (Tcb->SackBoard[Index].Right, Left)) {
+      Board[Num++] = Tcb->SackBoard[Index];
+    } else if (TCP_SEQ_GT (Tcb->SackBoard[Index].Left, Right)) {
+      if (!Inserted) {
+        Board[Num].Left  = Left;
+        Board[Num].Right = Right;
+        Num++;
+        Inserted = TRUE;
+      }
+
+      Board[Num++] = Tcb->SackBoard[Index];
+    } else {
+      //
+      // Overlapping or adjacent, extend the new block.
+      //
+      if (TCP_SEQ_LT (Tcb->SackBoard[Index].Left, Left)) {
+        Left = Tcb->SackBoard[Index].Left;
+      }
+
+      if (TCP_SEQ_GT (Tcb->SackBoard[Index].Right, Right)) {
+        Right = Tcb->SackBoard[Index].Right;
+      }
+    }
+  }
+
+  if (!Inserted) {
+    Board[Num].Left  = Left;
+    Board[Num].Right = Right;
+    Num++;
+  }
+
+  Tcb->SackNum = (UINT8)MIN (Num, TCP_SACK_BOARD_LEN);
+  CopyMem (Tcb->SackBoard, Board, Tcb->SackNum * sizeof (TCP_SACK_BLOCK));
+}
+
+/**
+  Update the scoreboard with the cumulative ACK and the SACK blocks
+  of an incoming segment.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack      The acknowledge sequence number of the segment.
+  @param[in]       Option   Pointer to the options of the segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB      *Tcb,
+  IN     TCP_SEQNO   Ack,
+  IN     TCP_OPTION  *Option
+  )
+{
+  UINT8  Index;
+  UINT8  Num;
+
+  //
+  // Drop what is now covered by the cumulative ACK.
+  //
+  Num = 0;
+  for (Index = 0; Index < Tcb->SackNum; Index++) {
+    if (TCP_SEQ_LEQ (Tcb->SackBoard[Index].Right, Ack)) {
+      continue;
+    }
+
+    Tcb->SackBoard[Num] = Tcb->SackBoard[Index];
+    if (TCP_SEQ_LT (Tcb->SackBoard[Num].Left, Ack)) {
+      Tcb->SackBoard[Num].Left = Ack;
+    }
+
+    Num++;
+  }
+
+  Tcb->SackNum = Num;
+
+  if (TCP_SEQ_LT (Tcb->HighRxt, Ack)) {
+    Tcb->HighRxt = Ack;
+  }
+
+  if (!TCP_FLG_ON (Option->Flag, TCP_OPTION_RCVD_SACK)) {
+    return;
+  }
+
+  //
+  // Only accept the blocks that are within the data in flight, this
+  // also ignores D-SACK blocks below the cumulative ACK.
+  //
+  for (Index = 0; Index < Option->SackNum; Index++) {
+    if (TCP_SEQ_LT (Option->Sack[Index].Left, Option->Sack[Index].Right) &&
+        TCP_SEQ_GT (Option->Sack[Index].Left, Ack) &&
+        TCP_SEQ_LEQ (Option->Sack[Index].Right, Tcb->SndNxt))
+    {
+      TcpSackInsert (Tcb, Option->Sack[Index].Left, Option->Sack[Index].Right);
+    }
+  }
+}
+
+/**
+  Find the first hole in the scoreboard at or after From. Only the
+  data below the highest SACKed sequence is considered lost.
+
+  @param[in]   Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]   From     The sequence number to search from.
+  @param[out]  Hole     The hole found.
+
+  @retval TRUE          A hole was found.
+  @retval FALSE         There is no hole at or after From.
+
+**/
+BOOLEAN
+TcpSackNextHole (
+  IN  TCP_CB          *Tcb,
+  IN  TCP_SEQNO       From,
+  OUT TCP_SACK_BLOCK  *Hole
+  )
+{
+  UINT8  Index;
+
+  for (Index = 0; Index < Tcb->SackNum; Index++) {
+    if (TCP_SEQ_LEQ (Tcb->SackBoard[Index].Right, From)) {
+      continue;
+    }
+
+    if (TCP_SEQ_LEQ (Tcb->SackBoard[Index].Left, From)) {
+      From = Tcb->SackBoard[Index].Right;
+      continue;
+    }
+
+    Hole->Left  = From;
+    Hole->Right = Tcb->SackBoard[Index].Left;
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/**
+  Retransmit the next hole the peer reported, starting from From or the
+  highest sequence already retransmitted in this recovery.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       From     The sequence number to search from.
+
+  @retval TRUE              A segment was retransmitted.
+  @retval FALSE             There is no hole left to retransmit.
+
+**/
+BOOLEAN
+TcpSackRetransmit (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  From
+  )
+{
+  TCP_SACK_BLOCK  Hole;
+
+  if (TCP_SEQ_LT (From, Tcb->HighRxt)) {
+    From = Tcb->HighRxt;
+  }
+
+  if (!TcpSackNextHole (Tcb, From, &Hole)) {
+    return FALSE;
+  }
+
+  if (TcpRetransmit (Tcb, Hole.Left) != 0) {
+    return FALSE;
+  }
+
+  Tcb->HighRxt = Hole.Left + MIN (TCP_SUB_SEQ (Hole.Right, Hole.Left), Tcb->SndMss);
+  return TRUE;
+}
+
+/**
+  Compute the integer cube root.
+
+  @param[in]  Value     The value, less than 2^63.
+
+  @return               The largest integer whose cube is not above Value.
+
+**/
+STATIC
+UINT32
+TcpCubeRoot (
+  IN UINT64  Value
+  )
+{
+  UINT32  Root;
+  UINT32  Try;
+  UINT32  Bit;
+
+  Root = 0;
+  for (Bit = 1 << 20; Bit != 0; Bit >>= 1) {
+    Try = Root | Bit;
+    if (MultU64x32 (MultU64x32 (Try, Try), Try) <= Value) {
+      Root = Try;
+    }
+  }
+
+  return Root;
+}
+
+/**
+  Grow the congestion window following RFC8312 in congestion avoidance.
+
+  Time is measured in TCP ticks of 200ms, so with C = 0.4 the window in
+  bytes at T ticks into the epoch is Origin + 2 * (T - K)^3 * SMSS / 625.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+STATIC
+VOID
+TcpCubicIncrease (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  UINT32  Mss;
+  UINT32  Time;
+  UINT32  Offset;
+  UINT64  Delta;
+  UINT32  Target;
+  UINT32  Increase;
+
+  Mss = Tcb->SndMss;
+
+  if (!Tcb->CubicEpochOn) {
+    Tcb->CubicEpochOn = TRUE;
+    Tcb->CubicEpoch   = mTcpTick;
+    Tcb->CubicWEst    = Tcb->CWnd;
+
+    if (Tcb->CWnd < Tcb->CubicWMax) {
+      Tcb->CubicK      = TcpCubeRoot (DivU64x32 (MultU64x32 (Tcb->CubicWMax - Tcb->CWnd, 625), 2 * Mss));
+      Tcb->CubicOrigin = Tcb->CubicWMax;
+    } else {
+      Tcb->CubicK      = 0;
+      Tcb->CubicOrigin = Tcb->CWnd;
+    }
+  }
+
+  //
+  // Aim at the window of one RTT ahead.
+  //
+  Time   = TCP_SUB_TIME (mTcpTick, Tcb->CubicEpoch) + (Tcb->SRtt >> TCP_RTT_SHIFT);
+  Offset = (Time > Tcb->CubicK) ? (Time - Tcb->CubicK) : (Tcb->CubicK - Time);
+  Offset = MIN (Offset, 1 << 12);
+  Delta  = DivU64x32 (MultU64x32 (MultU64x32 (MultU64x32 (Offset, Offset), Offset), 2 * Mss), 625);
+
+  if (Time < Tcb->CubicK) {
+    Target = (Delta < Tcb->CubicOrigin) ? (Tcb->CubicOrigin - (UINT32)Delta) : Mss;
+  } else {
+    Target = (UINT32)MIN (Tcb->CubicOrigin + Delta, MAX_UINT32 / 2);
+  }
+
+  //
+  // Never be slower than a standard AIMD flow would be, which
+  // grows by 3 * (1 - beta) / (1 + beta) SMSS each RTT.
+  //
+  Tcb->CubicWEst += MAX ((UINT32)DivU64x32 (MultU64x32 (MultU64x32 (Mss, Mss), 3 * (10 - TCP_CUBIC_BETA)), Tcb->CWnd) / (10 + TCP_CUBIC_BETA), 1);
+  Target          = MAX (Target, Tcb->CubicWEst);
+  Target          = MIN (Target, Tcb->CWnd + Tcb->CWnd / 2);
+
+  if (Target > Tcb->CWnd) {
+    Increase = (UINT32)DivU64x32 (MultU64x32 (Target - Tcb->CWnd, Mss), Tcb->CWnd);
+  } else {
+    Increase = Mss * Mss / Tcb->CWnd / 100;
+  }
+
+  Tcb->CWnd += MAX (Increase, 1);
+}
+
+/**
+  Open the congestion window for an ACK of new data, outside of recovery.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCongestOnAck (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  if (Tcb->CWnd < Tcb->Ssthresh) {
+    Tcb->CWnd += Tcb->SndMss;
+  } else if (Tcb->CongestAlgo == TCP_CC_CUBIC) {
+    TcpCubicIncrease (Tcb);
+  } else {
+    Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
+  }
+
+  Tcb->CWnd = MIN (Tcb->CWnd, TCP_MAX_WIN << Tcb->SndWndScale);
+}
+
+/**
+  Compute the slow start threshold after a loss is detected, and
+  reset the state of the congestion avoidance algorithm.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The new slow start threshold.
+
+**/
+UINT32
+TcpCongestOnLoss (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  UINT32  FlightSize;
+
+  FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
+
+  if (Tcb->CongestAlgo != TCP_CC_CUBIC) {
+    return MAX (FlightSize >> 1, (UINT32)(2 * Tcb->SndMss));
+  }
+
+  //
+  // Fast convergence: release bandwidth to new flows when the
+  // window stops reaching its previous maximum.
+  //
+  if (FlightSize < Tcb->CubicWMax) {
+    Tcb->CubicWMax = FlightSize / 20 * (10 + TCP_CUBIC_BETA);
+  } else {
+    Tcb->CubicWMax = FlightSize;
+  }
+
+  Tcb->CubicEpochOn = FALSE;
+
+  return MAX (FlightSize / 10 * TCP_CUBIC_BETA, (UINT32)(2 * Tcb->SndMss));
+}
@@ -563,6 +563,7 @@ TcpConfigurePcb (
   Tcb->Ssthresh = 0xffffffff;
 
   Tcb->CongestState = TCP_CONGEST_OPEN;
+  Tcb->CongestAlgo  = PcdGet8 (PcdTcpCongestionControl);
 
   Tcb->KeepAliveIdle   = TCP_KEEPALIVE_IDLE_MIN;
   Tcb->KeepAlivePeriod = TCP_KEEPALIVE_PERIOD;
@@ -703,6 +704,13 @@ TcpConfigurePcb (
     if (!Option->EnableWindowScaling) {
       TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_WS);
     }
+
+    //
+    // Don't auto-tune a receive buffer the application sized itself.
+    //
+    if (Option->ReceiveBufferSize != 0) {
+      TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_FIXED_RCVBUF);
+    }
   }
 
   //
@@ -492,6 +492,120 @@ TcpInput (
   IN UINT8           Version
   );
 
+//
+// Functions in TcpCongest.c
+//
+
+/**
+  Get the limit the receive buffer may be grown to by auto-tuning.
+
+  @return The limit in bytes, 0 if auto-tuning is disabled.
+
+**/
+UINT32
+TcpRcvBufferLimit (
+  VOID
+  );
+
+/**
+  Grow the receive buffer if the peer filled more than half of it during
+  the last round trip.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpTuneRcvBuffer (
+  IN OUT TCP_CB  *Tcb
+  );
+
+/**
+  Forget all the SACK information received from the peer.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackClear (
+  IN OUT TCP_CB  *Tcb
+  );
+
+/**
+  Update the scoreboard with the cumulative ACK and the SACK blocks
+  of an incoming segment.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack      The acknowledge sequence number of the segment.
+  @param[in]       Option   Pointer to the options of the segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB      *Tcb,
+  IN     TCP_SEQNO   Ack,
+  IN     TCP_OPTION  *Option
+  );
+
+/**
+  Find the first hole in the scoreboard at or after From.
+
+  @param[in]   Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]   From     The sequence number to search from.
+  @param[out]  Hole     The hole found.
+
+  @retval TRUE          A hole was found.
+  @retval FALSE         There is no hole at or after From.
+
+**/
+BOOLEAN
+TcpSackNextHole (
+  IN  TCP_CB          *Tcb,
+  IN  TCP_SEQNO       From,
+  OUT TCP_SACK_BLOCK  *Hole
+  );
+
+/**
+  Retransmit the next hole the peer reported, starting from From or the
+  highest sequence already retransmitted in this recovery.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       From     The sequence number to search from.
+
+  @retval TRUE              A segment was retransmitted.
+  @retval FALSE             There is no hole left to retransmit.
+
+**/
+BOOLEAN
+TcpSackRetransmit (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  From
+  );
+
+/**
+  Open the congestion window for an ACK of new data, outside of recovery.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCongestOnAck (
+  IN OUT TCP_CB  *Tcb
+  );
+
+/**
+  Compute the slow start threshold after a loss is detected, and
+  reset the state of the congestion avoidance algorithm.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The new slow start threshold.
+
+**/
+UINT32
+TcpCongestOnLoss (
+  IN OUT TCP_CB  *Tcb
+  );
+
 //
 // Functions in TcpTimer.c
 //
@@ -30,7 +30,9 @@ TcpSeqAcceptable (
 }
 
 /**
-  NewReno fast recovery defined in RFC3782.
+  NewReno fast recovery defined in RFC3782. When SACK is in use, the holes
+  reported by the peer are retransmitted as the duplicate ACKs arrive, so
+  several losses in one window are repaired within one round trip.
 
   @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
   @param[in]       Seg      Segment that triggers the fast recovery.
@@ -52,9 +54,7 @@ TcpFastRecover (
     //
     // Step 1A: Invoking fast retransmission.
     //
-    FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-
-    Tcb->Ssthresh = MAX (FlightSize >> 1, (UINT32)(2 * Tcb->SndMss));
+    Tcb->Ssthresh = TcpCongestOnLoss (Tcb);
     Tcb->Recover  = Tcb->SndNxt;
 
     Tcb->CongestState = TCP_CONGEST_RECOVER;
@@ -64,7 +64,8 @@ TcpFastRecover (
     // Step 2: Entering fast retransmission
     //
     TcpRetransmit (Tcb, Tcb->SndUna);
-    Tcb->CWnd = Tcb->Ssthresh + 3 * Tcb->SndMss;
+    Tcb->HighRxt = Tcb->SndUna + Tcb->SndMss;
+    Tcb->CWnd    = Tcb->Ssthresh + 3 * Tcb->SndMss;
 
     DEBUG (
       (DEBUG_NET,
@@ -88,6 +89,15 @@ TcpFastRecover (
     // by TcpToSendData
     //
     Tcb->CWnd += Tcb->SndMss;
+
+    //
+    // Each duplicated ACK means a segment has left the network,
+    // use it to repair the next hole reported by SACK.
+    //
+    if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SACK)) {
+      TcpSackRetransmit (Tcb, Tcb->SndUna);
+    }
+
     DEBUG (
       (DEBUG_NET,
        "TcpFastRecover: received another duplicated ACK (%d) for TCB %p\n",
@@ -119,9 +129,16 @@ TcpFastRecover (
       //
       // Step 5 - Partial ACK:
       // fast retransmit the first unacknowledge field
-      // , then deflate the CWnd
+      // , then deflate the CWnd. With SACK, skip the holes
+      // that have been retransmitted already.
       //
-      TcpRetransmit (Tcb, Seg->Ack);
+      if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SACK) || TCP_SEQ_GEQ (Seg->Ack, Tcb->HighRxt)) {
+        TcpRetransmit (Tcb, Seg->Ack);
+        Tcb->HighRxt = Seg->Ack + Tcb->SndMss;
+      } else {
+        TcpSackRetransmit (Tcb, Seg->Ack);
+      }
+
       Acked = TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna);
 
       //
@@ -563,6 +580,8 @@ TcpQueueData (
   Seg  = TCPSEG_NETBUF (Nbuf);
   Head = &Tcb->RcvQue;
 
+  Tcb->RcvSackSeq = Seg->Seq;
+
   //
   // Fast path to process normal case. That is,
   // no out-of-order segments are received.
@@ -1220,6 +1239,10 @@ TcpInput (
     TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
   }
 
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SACK)) {
+    TcpSackUpdate (Tcb, Seg->Ack, &Option);
+  }
+
   //
   // Count duplicate acks.
   //
@@ -1240,13 +1263,7 @@ TcpInput (
       (Tcb->CongestState == TCP_CONGEST_LOSS))
   {
     if (TCP_SEQ_GT (Seg->Ack, Tcb->SndUna)) {
-      if (Tcb->CWnd < Tcb->Ssthresh) {
-        Tcb->CWnd += Tcb->SndMss;
-      } else {
-        Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
-      }
-
-      Tcb->CWnd = MIN (Tcb->CWnd, TCP_MAX_WIN << Tcb->SndWndScale);
+      TcpCongestOnAck (Tcb);
     }
 
     if (Tcb->CongestState == TCP_CONGEST_LOSS) {
@@ -1498,6 +1515,8 @@ StepSix:
       goto RESET_THEN_DROP;
     }
 
+    TcpTuneRcvBuffer (Tcb);
+
     if (!IsListEmpty (&Tcb->RcvQue)) {
       TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_ACK_NOW);
     }
@@ -196,6 +196,9 @@ TcpInitTcbPeer (
 
   Tcb->RcvWl2 = Tcb->RcvNxt;
 
+  Tcb->RcvSpaceSeq  = Tcb->RcvNxt;
+  Tcb->RcvSpaceTime = mTcpTick;
+
   if (TCP_FLG_ON (Opt->Flag, TCP_OPTION_RCVD_WS) && !TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS)) {
     Tcb->SndWndScale = Opt->WndScale;
 
@@ -221,6 +224,12 @@ TcpInitTcbPeer (
     //
     Tcb->SndMss -= TCP_OPTION_TS_ALIGNED_LEN;
   }
+
+  if (TCP_FLG_ON (Opt->Flag, TCP_OPTION_RCVD_SACK_PERM)) {
+    TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_SACK);
+  }
+
+  TcpSackClear (Tcb);
 }
 
 /**
@@ -64,6 +64,100 @@ TcpPutUint32 (
   CopyMem (Buf, &Data, sizeof (UINT32));
 }
 
+/**
+  Put a SACK block in buffer.
+
+  @param[out] Buf             Pointer to the buffer.
+  @param[in]  Block           The block to put in the buffer.
+
+**/
+STATIC
+VOID
+TcpPutSackBlock (
+  OUT UINT8           *Buf,
+  IN  TCP_SACK_BLOCK  *Block
+  )
+{
+  TcpPutUint32 (Buf, Block->Left);
+  TcpPutUint32 (Buf + 4, Block->Right);
+}
+
+/**
+  Collect the blocks of out-of-order data held in the reassemble queue
+  for the SACK option. As RFC2018 requires, the first block reported
+  is the one that holds the most recently received segment, the rest
+  follow in ascending order.
+
+  @param[in]   Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[out]  Block   Array to store the blocks.
+  @param[in]   Max     The number of blocks that fit in Block.
+
+  @return              The number of blocks stored.
+
+**/
+STATIC
+UINT8
+TcpSackBuildBlocks (
+  IN  TCP_CB          *Tcb,
+  OUT TCP_SACK_BLOCK  *Block,
+  IN  UINT8           Max
+  )
+{
+  LIST_ENTRY      *Entry;
+  NET_BUF         *Node;
+  TCP_SEG         *Seg;
+  TCP_SACK_BLOCK  Run;
+  UINT8           Num;
+  UINTN           Pass;
+  BOOLEAN         Recent;
+
+  Num = 0;
+
+  for (Pass = 0; Pass < 2; Pass++) {
+    Entry = Tcb->RcvQue.ForwardLink;
+
+    while ((Entry != &Tcb->RcvQue) && (Num < Max)) {
+      Node      = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+      Seg       = TCPSEG_NETBUF (Node);
+      Run.Left  = Seg->Seq;
+      Run.Right = Seg->End;
+      Entry     = Entry->ForwardLink;
+
+      //
+      // Merge the segments that are contiguous into one block.
+      //
+      while (Entry != &Tcb->RcvQue) {
+        Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+        if (TCP_SEQ_GT (Seg->Seq, Run.Right)) {
+          break;
+        }
+
+        if (TCP_SEQ_GT (Seg->End, Run.Right)) {
+          Run.Right = Seg->End;
+        }
+
+        Entry = Entry->ForwardLink;
+      }
+
+      if (TCP_SEQ_LEQ (Run.Left, Tcb->RcvNxt) || (Run.Left == Run.Right)) {
+        continue;
+      }
+
+      Recent = (BOOLEAN)(TCP_SEQ_LEQ (Run.Left, Tcb->RcvSackSeq) && TCP_SEQ_LT (Tcb->RcvSackSeq, Run.Right));
+      if ((Pass == 0) == Recent) {
+        CopyMem (&Block[Num], &Run, sizeof (TCP_SACK_BLOCK));
+        Num++;
+
+        if (Pass == 0) {
+          break;
+        }
+      }
+    }
+  }
+
+  return Num;
+}
+
 /**
   Compute the window scale value according to the given buffer size.
 
@@ -84,6 +178,14 @@ TcpComputeScale (
 
   BufSize = GET_RCV_BUFFSIZE (Tcb->Sk);
 
+  //
+  // The scale is fixed once the connection is set up, so leave room
+  // for the receive buffer to grow by auto-tuning.
+  //
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_FIXED_RCVBUF)) {
+    BufSize = MAX (BufSize, TcpRcvBufferLimit ());
+  }
+
   Scale = 0;
   while ((Scale < TCP_OPTION_MAX_WS) && ((UINT32)(TCP_OPTION_MAX_WIN << Scale) < BufSize)) {
     Scale++;
@@ -160,6 +262,21 @@ TcpSynBuildOption (
     TcpPutUint32 (Data, TCP_OPTION_WS_FAST | TcpComputeScale (Tcb));
   }
 
+  //
+  // Build the SACK permitted option when doing active open
+  // or the peer has sent it to us.
+  //
+  if (!TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_ACK) ||
+      TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SACK)
+      )
+  {
+    Data = NetbufAllocSpace (Nbuf, sizeof (UINT32), NET_BUF_HEAD);
+    ASSERT (Data != NULL);
+
+    Len += sizeof (UINT32);
+    TcpPutUint32 (Data, TCP_OPTION_SACK_PERM_FAST);
+  }
+
   //
   // Build the MSS option.
   //
@@ -187,11 +304,16 @@ TcpBuildOption (
   IN NET_BUF  *Nbuf
   )
 {
-  UINT8   *Data;
-  UINT16  Len;
+  UINT8           *Data;
+  UINT16          Len;
+  UINT32          DataLen;
+  TCP_SACK_BLOCK  Block[TCP_SACK_MAX_BLOCK];
+  UINT8           Num;
+  UINT8           Index;
 
   ASSERT ((Tcb != NULL) && (Nbuf != NULL) && (Nbuf->Tcp == NULL));
-  Len = 0;
+  Len     = 0;
+  DataLen = Nbuf->TotalSize;
 
   //
   // Build the Timestamp option.
@@ -214,6 +336,40 @@ TcpBuildOption (
     TcpPutUint32 (Data + 8, Tcb->TsRecent);
   }
 
+  //
+  // Report the out-of-order data with the SACK option. It is only
+  // carried by segments without data, as SndMss doesn't leave room
+  // for it.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SACK) &&
+      (DataLen == 0) &&
+      !IsListEmpty (&Tcb->RcvQue) &&
+      !TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_RST)
+      )
+  {
+    Num = (UINT8)MIN (
+                   TCP_SACK_MAX_BLOCK,
+                   (TCP_OPTION_MAX_LEN - Len - sizeof (UINT32)) / TCP_OPTION_SACK_BLOCK_LEN
+                   );
+    Num = TcpSackBuildBlocks (Tcb, Block, Num);
+
+    if (Num != 0) {
+      Data = NetbufAllocSpace (
+               Nbuf,
+               sizeof (UINT32) + Num * TCP_OPTION_SACK_BLOCK_LEN,
+               NET_BUF_HEAD
+               );
+
+      ASSERT (Data != NULL);
+      Len += (UINT16)(sizeof (UINT32) + Num * TCP_OPTION_SACK_BLOCK_LEN);
+
+      TcpPutUint32 (Data, TCP_OPTION_SACK_FAST | (2 + Num * TCP_OPTION_SACK_BLOCK_LEN));
+      for (Index = 0; Index < Num; Index++) {
+        TcpPutSackBlock (Data + sizeof (UINT32) + Index * TCP_OPTION_SACK_BLOCK_LEN, &Block[Index]);
+      }
+    }
+  }
+
   return Len;
 }
 
@@ -239,6 +395,7 @@ TcpParseOption (
   UINT8  Cur;
   UINT8  Type;
   UINT8  Len;
+  UINT8  Index;
 
   ASSERT ((Tcp != NULL) && (Option != NULL));
 
@@ -311,6 +468,41 @@ TcpParseOption (
         Cur += TCP_OPTION_TS_LEN;
         break;
 
+      case TCP_OPTION_SACK_PERM:
+        if ((TotalLen - Cur < TCP_OPTION_SACK_PERM_LEN) || (Head[Cur + 1] != TCP_OPTION_SACK_PERM_LEN)) {
+          return -1;
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK_PERM);
+
+        Cur += TCP_OPTION_SACK_PERM_LEN;
+        break;
+
+      case TCP_OPTION_SACK:
+        if (TotalLen - Cur < 2) {
+          return -1;
+        }
+
+        Len = Head[Cur + 1];
+
+        if ((Len < 2 + TCP_OPTION_SACK_BLOCK_LEN) ||
+            ((Len - 2) % TCP_OPTION_SACK_BLOCK_LEN != 0) ||
+            (TotalLen - Cur < Len))
+        {
+          return -1;
+        }
+
+        Option->SackNum = (UINT8)MIN ((Len - 2) / TCP_OPTION_SACK_BLOCK_LEN, TCP_SACK_MAX_BLOCK);
+        for (Index = 0; Index < Option->SackNum; Index++) {
+          Option->Sack[Index].Left  = TcpGetUint32 (&Head[Cur + 2 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+          Option->Sack[Index].Right = TcpGetUint32 (&Head[Cur + 6 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK);
+
+        Cur = (UINT8)(Cur + Len);
+        break;
+
       case TCP_OPTION_NOP:
         Cur++;
         break;
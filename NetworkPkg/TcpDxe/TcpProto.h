@@ -51,6 +51,12 @@
 #define TCP_CONGEST_LOSS     2      ///< Retxmit because of retxmit time out.
 #define TCP_CONGEST_OPEN     3      ///< TCP is opening its congestion window.
 
+//
+// Congestion avoidance algorithms, selected by PcdTcpCongestionControl.
+//
+#define TCP_CC_NEWRENO  0           ///< RFC5681 additive increase.
+#define TCP_CC_CUBIC    1           ///< RFC8312 CUBIC window growth.
+
 //
 // TCP control flags
 //
@@ -69,6 +75,8 @@
 #define TCP_CTRL_TIMER_ON      0x1000   ///< At least one of the timer is on.
 #define TCP_CTRL_RTT_ON        0x2000   ///< The RTT measurement is on.
 #define TCP_CTRL_ACK_NOW       0x4000   ///< Send the ACK now, don't delay.
+#define TCP_CTRL_SACK          0x8000   ///< SACK is permitted by both ends.
+#define TCP_CTRL_FIXED_RCVBUF  0x10000  ///< Receive buffer size set by the application.
 
 //
 // Timer related values
@@ -110,6 +118,7 @@
 //
 #define TCP_RCV_BUF_SIZE          (2 * 1024 * 1024)
 #define TCP_RCV_BUF_SIZE_MIN      (8 * 1024)
+#define TCP_RCV_BUF_SIZE_MAX      (64 * 1024 * 1024)
 #define TCP_SND_BUF_SIZE          (2 * 1024 * 1024)
 #define TCP_SND_BUF_SIZE_MIN      (8 * 1024)
 #define TCP_BACKLOG               10
@@ -203,6 +212,25 @@
 
 #define TCP_MAX_WIN  0xFFFFU
 
+//
+// SACK related values
+//
+#define TCP_SACK_MAX_BLOCK  4       ///< Max SACK blocks carried by one option.
+#define TCP_SACK_BOARD_LEN  8       ///< Max SACKed ranges kept by the sender.
+
+//
+// CUBIC multiplicative decrease factor, in tenths.
+//
+#define TCP_CUBIC_BETA  7
+
+///
+/// A block of contiguous sequence space, as used by SACK.
+///
+typedef struct _TCP_SACK_BLOCK {
+  TCP_SEQNO    Left;  ///< First sequence number of the block.
+  TCP_SEQNO    Right; ///< Sequence number following the last byte of the block.
+} TCP_SACK_BLOCK;
+
 ///
 /// TCP segmentation data.
 ///
@@ -304,6 +332,32 @@ struct _TCP_CONTROL_BLOCK {
   UINT8               CongestState; ///< The current congestion state(RFC3782).
   UINT8               LossTimes;    ///< Number of retxmit timeouts in a row.
   TCP_SEQNO           LossRecover;  ///< Recover point for retxmit.
+  UINT8               CongestAlgo;  ///< TCP_CC_NEWRENO or TCP_CC_CUBIC.
+
+  //
+  // RFC2018 SACK. The scoreboard holds the ranges above SndUna
+  // the peer has reported, sorted and merged.
+  //
+  TCP_SACK_BLOCK      SackBoard[TCP_SACK_BOARD_LEN];
+  UINT8               SackNum;    ///< Number of valid ranges in SackBoard.
+  TCP_SEQNO           HighRxt;    ///< Highest sequence retransmitted in recovery.
+  TCP_SEQNO           RcvSackSeq; ///< Sequence of the last segment queued for reassembly.
+
+  //
+  // RFC8312 CUBIC state, in bytes and TCP ticks.
+  //
+  BOOLEAN             CubicEpochOn;  ///< A growth epoch has started.
+  UINT32              CubicEpoch;    ///< When the current growth epoch started.
+  UINT32              CubicK;        ///< Time to grow back to CubicOrigin.
+  UINT32              CubicOrigin;   ///< Window the cubic function centres on.
+  UINT32              CubicWMax;     ///< Window just before the last reduction.
+  UINT32              CubicWEst;     ///< Window an AIMD flow would have reached.
+
+  //
+  // Receive buffer auto-tuning.
+  //
+  TCP_SEQNO           RcvSpaceSeq;  ///< RcvNxt when the measurement started.
+  UINT32              RcvSpaceTime; ///< When the measurement started.
 
   //
   // RFC7323
@@ -74,6 +74,14 @@ TlsConfigurationSetData (
       Status = EFI_UNSUPPORTED;
   }
 
+  //
+  // The configuration is part of the key of the cached sessions. If it
+  // can't be recorded, the session cache is not used by this instance.
+  //
+  if (!EFI_ERROR (Status) && !Sha256HashAll (Data, DataSize, Instance->ConfigDigest[DataType])) {
+    Instance->ConfigDigestValid = FALSE;
+  }
+
   gBS->RestoreTPL (OldTpl);
   return Status;
 }
@@ -30,6 +30,10 @@ TlsCleanInstance (
       TlsFree (Instance->TlsConn);
     }
 
+    if (Instance->ServerName != NULL) {
+      FreePool (Instance->ServerName);
+    }
+
     FreePool (Instance);
   }
 }
@@ -67,7 +71,8 @@ TlsCreateInstance (
   CopyMem (&TlsInstance->Tls, &mTlsProtocol, sizeof (TlsInstance->Tls));
   CopyMem (&TlsInstance->TlsConfig, &mTlsConfigurationProtocol, sizeof (TlsInstance->TlsConfig));
 
-  TlsInstance->TlsSessionState = EfiTlsSessionNotStarted;
+  TlsInstance->TlsSessionState   = EfiTlsSessionNotStarted;
+  TlsInstance->ConfigDigestValid = TRUE;
 
   *Instance = TlsInstance;
 
@@ -86,6 +91,8 @@ TlsCleanService (
   )
 {
   if (Service != NULL) {
+    TlsSessionCacheFlush (Service);
+
     if (Service->TlsCtx != NULL) {
       TlsCtxFree (Service->TlsCtx);
     }
@@ -132,6 +139,7 @@ TlsCreateService (
   TlsService->TlsChildrenNum = 0;
   InitializeListHead (&TlsService->TlsChildrenList);
   TlsService->ImageHandle = Image;
+  InitializeListHead (&TlsService->SessionCache);
 
   *Service = TlsService;
 
@@ -483,6 +491,16 @@ TlsServiceBindingDestroyChild (
   RemoveEntryList (&TlsInstance->Link);
   TlsService->TlsChildrenNum--;
 
+  //
+  // Store the session again, it may have been updated with a session ticket
+  // after the handshake.
+  //
+  if ((TlsInstance->TlsSessionState == EfiTlsSessionDataTransferring) ||
+      (TlsInstance->TlsSessionState == EfiTlsSessionClosing))
+  {
+    TlsSessionCacheStore (TlsInstance);
+  }
+
   gBS->RestoreTPL (OldTpl);
 
   TlsCleanInstance (TlsInstance);
@@ -54,6 +54,19 @@ struct _TLS_SERVICE {
   // created for the connections.
   //
   VOID                            *TlsCtx;
+
+  //
+  // Resumable sessions of the earlier client connections, shared by all the
+  // children. The most recently stored session is at the head.
+  //
+  LIST_ENTRY                      SessionCache;
+  UINTN                           SessionCacheNum;
+
+  //
+  // Handshake statistics.
+  //
+  UINTN                           FullHandshakes;
+  UINTN                           ResumedHandshakes;
 };
 
 struct _TLS_INSTANCE {
@@ -75,6 +88,17 @@ struct _TLS_INSTANCE {
   // per established connection.
   //
   VOID                              *TlsConn;
+
+  //
+  // Server name and flags set through EfiTlsVerifyHost, and digests of the
+  // data set through the TLS configuration protocol. Together with the
+  // verify method, they are the key to find a cached session to resume.
+  //
+  CHAR8                             *ServerName;
+  UINT32                            VerifyHostFlags;
+  UINT8                             ConfigDigest[EfiTlsConfigDataTypeMaximum][SHA256_DIGEST_SIZE];
+  BOOLEAN                           ConfigDigestValid;
+  BOOLEAN                           SessionSet;
 };
 
 #define TLS_SERVICE_FROM_THIS(a)   \
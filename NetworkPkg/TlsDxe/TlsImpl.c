@@ -348,3 +348,213 @@ ERROR:
 
   return Status;
 }
+
+/**
+  Remove an entry from the session cache and release it.
+
+  @param[in]  Service             The TLS service data.
+  @param[in]  Entry               The session cache entry.
+
+**/
+STATIC
+VOID
+TlsSessionCacheRemove (
+  IN     TLS_SERVICE              *Service,
+  IN     TLS_SESSION_CACHE_ENTRY  *Entry
+  )
+{
+  RemoveEntryList (&Entry->Link);
+  Service->SessionCacheNum--;
+
+  TlsSessionFree (Entry->Session);
+  FreePool (Entry->ServerName);
+  FreePool (Entry);
+}
+
+/**
+  Get the key of the session cache entries the TLS instance may resume or store.
+
+  @param[in]   TlsInstance        The pointer to the TLS instance.
+  @param[out]  Key                The key of the TLS instance.
+
+  @retval TRUE                    The TLS instance may use the session cache.
+  @retval FALSE                   The TLS instance is not a client with a
+                                  verified peer, or its configuration is unknown.
+**/
+STATIC
+BOOLEAN
+TlsSessionCacheGetKey (
+  IN     TLS_INSTANCE           *TlsInstance,
+  OUT    TLS_SESSION_CACHE_KEY  *Key
+  )
+{
+  if ((TlsInstance->ServerName == NULL) || !TlsInstance->ConfigDigestValid ||
+      (TlsGetConnectionEnd (TlsInstance->TlsConn) != EfiTlsClient))
+  {
+    return FALSE;
+  }
+
+  ZeroMem (Key, sizeof (TLS_SESSION_CACHE_KEY));
+  Key->VerifyMethod    = TlsGetVerify (TlsInstance->TlsConn);
+  Key->VerifyHostFlags = TlsInstance->VerifyHostFlags;
+  CopyMem (Key->ConfigDigest, TlsInstance->ConfigDigest, sizeof (Key->ConfigDigest));
+
+  //
+  // The session of an unverified peer must not be offered to a client that
+  // verifies its peer, since the resumed handshake skips the verification.
+  //
+  return (BOOLEAN)((Key->VerifyMethod & EFI_TLS_VERIFY_PEER) != 0);
+}
+
+/**
+  Offer a cached session of the same server to the TLS instance, so that the
+  handshake can be abbreviated.
+
+  The session is looked up by SessionId if it is not NULL, otherwise by the
+  server name of the instance. Either way, it must have been established with
+  the same verify method, host verification flags and configuration data.
+  Only the sessions of verified peers are cached.
+
+  @param[in]  TlsInstance         The pointer to the TLS instance.
+  @param[in]  SessionId           The ID of the session to resume. Optional.
+
+  @retval EFI_SUCCESS             A cached session is set to the TLS instance.
+  @retval EFI_NOT_FOUND           No cached session matches.
+  @retval Others                  Other errors as indicated.
+**/
+EFI_STATUS
+TlsSessionCacheResume (
+  IN     TLS_INSTANCE        *TlsInstance,
+  IN     EFI_TLS_SESSION_ID  *SessionId  OPTIONAL
+  )
+{
+  EFI_STATUS               Status;
+  LIST_ENTRY               *Link;
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+  TLS_SESSION_CACHE_KEY    Key;
+
+  if (!TlsSessionCacheGetKey (TlsInstance, &Key)) {
+    return EFI_NOT_FOUND;
+  }
+
+  NET_LIST_FOR_EACH (Link, &TlsInstance->Service->SessionCache) {
+    Entry = NET_LIST_USER_STRUCT (Link, TLS_SESSION_CACHE_ENTRY, Link);
+
+    if ((AsciiStrCmp (Entry->ServerName, TlsInstance->ServerName) != 0) ||
+        (CompareMem (&Entry->Key, &Key, sizeof (Key)) != 0))
+    {
+      continue;
+    }
+
+    if (SessionId != NULL) {
+      if ((SessionId->Length == 0) || (Entry->SessionId.Length != SessionId->Length) ||
+          (CompareMem (Entry->SessionId.Data, SessionId->Data, SessionId->Length) != 0))
+      {
+        continue;
+      }
+    }
+
+    Status = TlsSetSession (TlsInstance->TlsConn, Entry->Session);
+    if (!EFI_ERROR (Status)) {
+      TlsInstance->SessionSet = TRUE;
+    }
+
+    return Status;
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Store the session of the TLS instance in the session cache of its service,
+  replacing the earlier session of the same server and configuration. The
+  session is only stored if the peer was verified.
+
+  @param[in]  TlsInstance         The pointer to the TLS instance.
+
+**/
+VOID
+TlsSessionCacheStore (
+  IN     TLS_INSTANCE  *TlsInstance
+  )
+{
+  EFI_STATUS               Status;
+  TLS_SERVICE              *Service;
+  LIST_ENTRY               *Link;
+  LIST_ENTRY               *Next;
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+  TLS_SESSION_CACHE_ENTRY  *Cached;
+  VOID                     *Session;
+  TLS_SESSION_CACHE_KEY    Key;
+
+  Service = TlsInstance->Service;
+
+  if (!TlsSessionCacheGetKey (TlsInstance, &Key)) {
+    return;
+  }
+
+  //
+  // A TLS 1.2 session is resumable once the handshake is done. A session ticket
+  // may arrive later, so the session is stored again when the child is destroyed.
+  //
+  Status = TlsGetSession (TlsInstance->TlsConn, &Session);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  Entry = AllocateZeroPool (sizeof (TLS_SESSION_CACHE_ENTRY));
+  if (Entry == NULL) {
+    TlsSessionFree (Session);
+    return;
+  }
+
+  Entry->ServerName = AllocateCopyPool (AsciiStrSize (TlsInstance->ServerName), TlsInstance->ServerName);
+  if (Entry->ServerName == NULL) {
+    TlsSessionFree (Session);
+    FreePool (Entry);
+    return;
+  }
+
+  CopyMem (&Entry->Key, &Key, sizeof (Key));
+  Entry->Session          = Session;
+  Entry->SessionId.Length = MAX_TLS_SESSION_ID_LENGTH;
+  Status                  = TlsGetSessionId (TlsInstance->TlsConn, Entry->SessionId.Data, &Entry->SessionId.Length);
+  if (EFI_ERROR (Status) || (Entry->SessionId.Length > MAX_TLS_SESSION_ID_LENGTH)) {
+    Entry->SessionId.Length = 0;
+  }
+
+  //
+  // Keep only the latest session of each server and configuration.
+  //
+  NET_LIST_FOR_EACH_SAFE (Link, Next, &Service->SessionCache) {
+    Cached = NET_LIST_USER_STRUCT (Link, TLS_SESSION_CACHE_ENTRY, Link);
+    if ((AsciiStrCmp (Cached->ServerName, Entry->ServerName) == 0) &&
+        (CompareMem (&Cached->Key, &Entry->Key, sizeof (Key)) == 0))
+    {
+      TlsSessionCacheRemove (Service, Cached);
+    }
+  }
+
+  InsertHeadList (&Service->SessionCache, &Entry->Link);
+  Service->SessionCacheNum++;
+
+  if (Service->SessionCacheNum > TLS_SESSION_CACHE_SIZE) {
+    TlsSessionCacheRemove (Service, NET_LIST_TAIL (&Service->SessionCache, TLS_SESSION_CACHE_ENTRY, Link));
+  }
+}
+
+/**
+  Release all the sessions in the session cache of the TLS service.
+
+  @param[in]  Service             The TLS service data.
+
+**/
+VOID
+TlsSessionCacheFlush (
+  IN     TLS_SERVICE  *Service
+  )
+{
+  while (!IsListEmpty (&Service->SessionCache)) {
+    TlsSessionCacheRemove (Service, NET_LIST_HEAD (&Service->SessionCache, TLS_SESSION_CACHE_ENTRY, Link));
+  }
+}
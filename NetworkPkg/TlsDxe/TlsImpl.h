@@ -39,6 +39,78 @@ extern EFI_SERVICE_BINDING_PROTOCOL    mTlsServiceBinding;
 extern EFI_TLS_PROTOCOL                mTlsProtocol;
 extern EFI_TLS_CONFIGURATION_PROTOCOL  mTlsConfigurationProtocol;
 
+///
+/// Maximum number of sessions kept for resumption, one per server.
+///
+#define TLS_SESSION_CACHE_SIZE  16
+
+///
+/// The configuration a session was established with. A session is only
+/// offered to a connection with the same configuration.
+///
+typedef struct {
+  UINT32    VerifyMethod;
+  UINT32    VerifyHostFlags;
+  UINT8     ConfigDigest[EfiTlsConfigDataTypeMaximum][SHA256_DIGEST_SIZE];
+} TLS_SESSION_CACHE_KEY;
+
+///
+/// A resumable session of an earlier client connection.
+///
+typedef struct {
+  LIST_ENTRY               Link;
+  CHAR8                    *ServerName;
+  TLS_SESSION_CACHE_KEY    Key;
+  EFI_TLS_SESSION_ID       SessionId;
+  VOID                     *Session;
+} TLS_SESSION_CACHE_ENTRY;
+
+/**
+  Offer a cached session of the same server to the TLS instance, so that the
+  handshake can be abbreviated.
+
+  The session is looked up by SessionId if it is not NULL, otherwise by the
+  server name of the instance. Either way, it must have been established with
+  the same verify method, host verification flags and configuration data.
+  Only the sessions of verified peers are cached.
+
+  @param[in]  TlsInstance         The pointer to the TLS instance.
+  @param[in]  SessionId           The ID of the session to resume. Optional.
+
+  @retval EFI_SUCCESS             A cached session is set to the TLS instance.
+  @retval EFI_NOT_FOUND           No cached session matches.
+  @retval Others                  Other errors as indicated.
+**/
+EFI_STATUS
+TlsSessionCacheResume (
+  IN     TLS_INSTANCE        *TlsInstance,
+  IN     EFI_TLS_SESSION_ID  *SessionId  OPTIONAL
+  );
+
+/**
+  Store the session of the TLS instance in the session cache of its service,
+  replacing the earlier session of the same server and configuration. The
+  session is only stored if the peer was verified.
+
+  @param[in]  TlsInstance         The pointer to the TLS instance.
+
+**/
+VOID
+TlsSessionCacheStore (
+  IN     TLS_INSTANCE  *TlsInstance
+  );
+
+/**
+  Release all the sessions in the session cache of the TLS service.
+
+  @param[in]  Service             The TLS service data.
+
+**/
+VOID
+TlsSessionCacheFlush (
+  IN     TLS_SERVICE  *Service
+  );
+
 /**
   Encrypt the message listed in fragment.
 
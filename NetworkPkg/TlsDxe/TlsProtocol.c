@@ -192,6 +192,25 @@ TlsSetSessionData (
       }
 
       Status = TlsSetServerName (Instance->TlsConn, Instance->Service->TlsCtx, TlsVerifyHost->HostName);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+
+      //
+      // The server name and flags are part of the key to find a cached
+      // session to resume.
+      //
+      if (Instance->ServerName != NULL) {
+        FreePool (Instance->ServerName);
+      }
+
+      Instance->VerifyHostFlags = TlsVerifyHost->Flags;
+      Instance->ServerName      = AllocateCopyPool (AsciiStrSize (TlsVerifyHost->HostName), TlsVerifyHost->HostName);
+      if (Instance->ServerName == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        goto ON_EXIT;
+      }
+
       break;
     case EfiTlsSessionID:
       if (DataSize != sizeof (EFI_TLS_SESSION_ID)) {
@@ -199,11 +218,26 @@ TlsSetSessionData (
         goto ON_EXIT;
       }
 
-      Status = TlsSetSessionId (
-                 Instance->TlsConn,
-                 ((EFI_TLS_SESSION_ID *)Data)->Data,
-                 ((EFI_TLS_SESSION_ID *)Data)->Length
-                 );
+      //
+      // Resume the cached session with this ID if there is one. Setting the ID
+      // alone doesn't carry the secrets needed to resume the session.
+      //
+      Status = TlsSessionCacheResume (Instance, (EFI_TLS_SESSION_ID *)Data);
+      if (Status == EFI_NOT_FOUND) {
+        Status = TlsSetSessionId (
+                   Instance->TlsConn,
+                   ((EFI_TLS_SESSION_ID *)Data)->Data,
+                   ((EFI_TLS_SESSION_ID *)Data)->Length
+                   );
+        if (!EFI_ERROR (Status)) {
+          //
+          // Don't let the session cached for the server name replace the
+          // ID the caller has chosen.
+          //
+          Instance->SessionSet = TRUE;
+        }
+      }
+
       break;
     case EfiTlsSessionState:
       if (DataSize != sizeof (EFI_TLS_SESSION_STATE)) {
@@ -488,6 +522,14 @@ TlsBuildResponsePacket (
   if ((RequestBuffer == NULL) && (RequestSize == 0)) {
     switch (Instance->TlsSessionState) {
       case EfiTlsSessionNotStarted:
+        //
+        // Offer the cached session of the same server, unless the caller has
+        // chosen one through EfiTlsSessionID.
+        //
+        if (!Instance->SessionSet) {
+          TlsSessionCacheResume (Instance, NULL);
+        }
+
         //
         // ClientHello.
         //
@@ -579,6 +621,26 @@ TlsBuildResponsePacket (
 
       if (!TlsInHandshake (Instance->TlsConn)) {
         Instance->TlsSessionState = EfiTlsSessionDataTransferring;
+
+        if (TlsSessionReused (Instance->TlsConn)) {
+          Instance->Service->ResumedHandshakes++;
+        } else {
+          Instance->Service->FullHandshakes++;
+        }
+
+        DEBUG ((
+          DEBUG_INFO,
+          "TlsDxe: Handshake done (%a), %Lu full, %Lu resumed\n",
+          TlsSessionReused (Instance->TlsConn) ? "resumed" : "full",
+          (UINT64)Instance->Service->FullHandshakes,
+          (UINT64)Instance->Service->ResumedHandshakes
+          ));
+
+        //
+        // Cache the session right away, so that the parallel connections to
+        // the same server can resume it.
+        //
+        TlsSessionCacheStore (Instance);
       }
     } else {
       //
@@ -970,6 +970,7 @@ EfiPxeBcMtftp (
                  Filename,
                  Overwrite,
                  BlockSize,
+                 (WindowSize > 1) ? &WindowSize : NULL,
                  BufferPtr,
                  BufferSize
                  );
@@ -335,6 +335,7 @@ PxeBcMtftp6ReadFile (
   @param[in]       Filename       Pointer to boot file name.
   @param[in]       Overwrite      Indicate whether with overwrite attribute.
   @param[in]       BlockSize      Pointer to required block size.
+  @param[in]       WindowSize     Pointer to required window size.
   @param[in]       BufferPtr      Pointer to buffer.
   @param[in, out]  BufferSize     Pointer to buffer size.
 
@@ -350,15 +351,17 @@ PxeBcMtftp6WriteFile (
   IN     UINT8                   *Filename,
   IN     BOOLEAN                 Overwrite,
   IN     UINTN                   *BlockSize,
+  IN     UINTN                   *WindowSize,
   IN     UINT8                   *BufferPtr,
   IN OUT UINT64                  *BufferSize
   )
 {
   EFI_MTFTP6_PROTOCOL  *Mtftp6;
   EFI_MTFTP6_TOKEN     Token;
-  EFI_MTFTP6_OPTION    ReqOpt[1];
+  EFI_MTFTP6_OPTION    ReqOpt[2];
   UINT32               OptCnt;
-  UINT8                OptBuf[128];
+  UINT8                BlksizeBuf[10];
+  UINT8                WindowsizeBuf[10];
   EFI_STATUS           Status;
 
   Mtftp6                    = Private->Mtftp6;
@@ -371,9 +374,16 @@ PxeBcMtftp6WriteFile (
   }
 
   if (BlockSize != NULL) {
-    ReqOpt[0].OptionStr = (UINT8 *)mMtftpOptions[PXE_MTFTP_OPTION_BLKSIZE_INDEX];
-    ReqOpt[0].ValueStr  = OptBuf;
-    PxeBcUintnToAscDec (*BlockSize, ReqOpt[0].ValueStr, PXE_MTFTP_OPTBUF_MAXNUM_INDEX);
+    ReqOpt[OptCnt].OptionStr = (UINT8 *)mMtftpOptions[PXE_MTFTP_OPTION_BLKSIZE_INDEX];
+    ReqOpt[OptCnt].ValueStr  = BlksizeBuf;
+    PxeBcUintnToAscDec (*BlockSize, ReqOpt[OptCnt].ValueStr, sizeof (BlksizeBuf));
+    OptCnt++;
+  }
+
+  if (WindowSize != NULL) {
+    ReqOpt[OptCnt].OptionStr = (UINT8 *)mMtftpOptions[PXE_MTFTP_OPTION_WINDOWSIZE_INDEX];
+    ReqOpt[OptCnt].ValueStr  = WindowsizeBuf;
+    PxeBcUintnToAscDec (*WindowSize, ReqOpt[OptCnt].ValueStr, sizeof (WindowsizeBuf));
     OptCnt++;
   }
 
@@ -810,6 +820,7 @@ PxeBcMtftp4ReadFile (
   @param[in]       Filename       Pointer to boot file name.
   @param[in]       Overwrite      Indicates whether to use the overwrite attribute.
   @param[in]       BlockSize      Pointer to required block size.
+  @param[in]       WindowSize     Pointer to required window size.
   @param[in]       BufferPtr      Pointer to buffer.
   @param[in, out]  BufferSize     Pointer to buffer size.
 
@@ -825,15 +836,17 @@ PxeBcMtftp4WriteFile (
   IN     UINT8                   *Filename,
   IN     BOOLEAN                 Overwrite,
   IN     UINTN                   *BlockSize,
+  IN     UINTN                   *WindowSize,
   IN     UINT8                   *BufferPtr,
   IN OUT UINT64                  *BufferSize
   )
 {
   EFI_MTFTP4_PROTOCOL  *Mtftp4;
   EFI_MTFTP4_TOKEN     Token;
-  EFI_MTFTP4_OPTION    ReqOpt[1];
+  EFI_MTFTP4_OPTION    ReqOpt[2];
   UINT32               OptCnt;
-  UINT8                OptBuf[128];
+  UINT8                BlksizeBuf[10];
+  UINT8                WindowsizeBuf[10];
   EFI_STATUS           Status;
 
   Mtftp4                    = Private->Mtftp4;
@@ -846,9 +859,16 @@ PxeBcMtftp4WriteFile (
   }
 
   if (BlockSize != NULL) {
-    ReqOpt[0].OptionStr = (UINT8 *)mMtftpOptions[PXE_MTFTP_OPTION_BLKSIZE_INDEX];
-    ReqOpt[0].ValueStr  = OptBuf;
-    PxeBcUintnToAscDec (*BlockSize, ReqOpt[0].ValueStr, PXE_MTFTP_OPTBUF_MAXNUM_INDEX);
+    ReqOpt[OptCnt].OptionStr = (UINT8 *)mMtftpOptions[PXE_MTFTP_OPTION_BLKSIZE_INDEX];
+    ReqOpt[OptCnt].ValueStr  = BlksizeBuf;
+    PxeBcUintnToAscDec (*BlockSize, ReqOpt[OptCnt].ValueStr, sizeof (BlksizeBuf));
+    OptCnt++;
+  }
+
+  if (WindowSize != NULL) {
+    ReqOpt[OptCnt].OptionStr = (UINT8 *)mMtftpOptions[PXE_MTFTP_OPTION_WINDOWSIZE_INDEX];
+    ReqOpt[OptCnt].ValueStr  = WindowsizeBuf;
+    PxeBcUintnToAscDec (*WindowSize, ReqOpt[OptCnt].ValueStr, sizeof (WindowsizeBuf));
     OptCnt++;
   }
 
@@ -1076,6 +1096,7 @@ PxeBcTftpReadFile (
   @param[in]       Filename       Pointer to boot file name.
   @param[in]       Overwrite      Indicate whether with overwrite attribute.
   @param[in]       BlockSize      Pointer to required block size.
+  @param[in]       WindowSize     Pointer to required window size.
   @param[in]       BufferPtr      Pointer to buffer.
   @param[in, out]  BufferSize     Pointer to buffer size.
 
@@ -1091,6 +1112,7 @@ PxeBcTftpWriteFile (
   IN     UINT8               *Filename,
   IN     BOOLEAN             Overwrite,
   IN     UINTN               *BlockSize,
+  IN     UINTN               *WindowSize,
   IN     UINT8               *BufferPtr,
   IN OUT UINT64              *BufferSize
   )
@@ -1102,6 +1124,7 @@ PxeBcTftpWriteFile (
              Filename,
              Overwrite,
              BlockSize,
+             WindowSize,
              BufferPtr,
              BufferSize
              );
@@ -1112,6 +1135,7 @@ PxeBcTftpWriteFile (
              Filename,
              Overwrite,
              BlockSize,
+             WindowSize,
              BufferPtr,
              BufferSize
              );
@@ -83,6 +83,7 @@ PxeBcTftpReadFile (
   @param[in]       Filename       Pointer to boot file name.
   @param[in]       Overwrite      Indicates whether to use an overwrite attribute.
   @param[in]       BlockSize      Pointer to required block size.
+  @param[in]       WindowSize     Pointer to required window size.
   @param[in]       BufferPtr      Pointer to buffer.
   @param[in, out]  BufferSize     Pointer to buffer size.
 
@@ -98,6 +99,7 @@ PxeBcTftpWriteFile (
   IN     UINT8               *Filename,
   IN     BOOLEAN             Overwrite,
   IN     UINTN               *BlockSize,
+  IN     UINTN               *WindowSize,
   IN     UINT8               *BufferPtr,
   IN OUT UINT64              *BufferSize
   );
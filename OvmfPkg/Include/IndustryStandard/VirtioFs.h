@@ -180,6 +180,7 @@ typedef enum {
   VirtioFsFuseOpReleaseDir  = 29,
   VirtioFsFuseOpFsyncDir    = 30,
   VirtioFsFuseOpCreate      = 35,
+  VirtioFsFuseOpBatchForget = 42,
   VirtioFsFuseOpReadDirPlus = 44,
   VirtioFsFuseOpRename2     = 45,
 } VIRTIO_FS_FUSE_OPCODE;
@@ -251,6 +252,20 @@ typedef struct {
   UINT64    NumberOfLookups;
 } VIRTIO_FS_FUSE_FORGET_REQUEST;
 
+//
+// Headers for VirtioFsFuseOpBatchForget. The request header is followed by
+// Count VIRTIO_FS_FUSE_FORGET_ONE elements.
+//
+typedef struct {
+  UINT32    Count;
+  UINT32    Dummy;
+} VIRTIO_FS_FUSE_BATCH_FORGET_REQUEST;
+
+typedef struct {
+  UINT64    NodeId;
+  UINT64    NumberOfLookups;
+} VIRTIO_FS_FUSE_FORGET_ONE;
+
 //
 // Headers for VirtioFsFuseOpGetAttr (VIRTIO_FS_FUSE_GETATTR_RESPONSE is also
 // for VirtioFsFuseOpSetAttr).
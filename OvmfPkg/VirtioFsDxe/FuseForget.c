@@ -6,6 +6,8 @@
   SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
+#include <Library/MemoryAllocationLib.h> // AllocatePool()
+
 #include "VirtioFsDxe.h"
 
 /**
@@ -88,3 +90,118 @@ VirtioFsFuseForget (
   Status = VirtioFsSgListsSubmit (VirtioFs, &ReqSgList, NULL);
   return Status;
 }
+
+/**
+  Make the Virtio Filesystem device drop one reference count from each of
+  several NodeIds that the driver looked up by filename.
+
+  Send a single FUSE_BATCH_FORGET request to the Virtio Filesystem device for
+  this, rather than one FUSE_FORGET request per NodeId. Like FUSE_FORGET,
+  FUSE_BATCH_FORGET doesn't elicit a response.
+
+  The function may only be called after VirtioFsFuseInitSession() returns
+  successfully and before VirtioFsUninit() is called.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device to send the
+                           FUSE_BATCH_FORGET request to. On output, the FUSE
+                           request counter "VirtioFs->RequestId" will have
+                           been incremented, unless NumNodes is zero.
+
+  @param[in] NumNodes      The number of elements in NodeIds.
+
+  @param[in] NodeIds       The inode numbers that the client learned by way of
+                           lookup, and that the server should now un-reference
+                           exactly once each.
+
+  @retval EFI_SUCCESS           The FUSE_BATCH_FORGET request has been
+                                submitted, or NumNodes is zero.
+
+  @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
+
+  @return                       Error codes propagated from
+                                VirtioFsSgListsValidate(),
+                                VirtioFsFuseNewRequest(),
+                                VirtioFsSgListsSubmit().
+**/
+EFI_STATUS
+VirtioFsFuseBatchForget (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINTN      NumNodes,
+  IN     UINT64     *NodeIds
+  )
+{
+  VIRTIO_FS_FUSE_REQUEST               CommonReq;
+  VIRTIO_FS_FUSE_BATCH_FORGET_REQUEST  BatchForgetReq;
+  VIRTIO_FS_FUSE_FORGET_ONE            *ForgetOne;
+  VIRTIO_FS_IO_VECTOR                  ReqIoVec[3];
+  VIRTIO_FS_SCATTER_GATHER_LIST        ReqSgList;
+  EFI_STATUS                           Status;
+  UINTN                                Idx;
+
+  if (NumNodes == 0) {
+    return EFI_SUCCESS;
+  }
+
+  if (NumNodes > MAX_UINT32 / sizeof *ForgetOne) {
+    return EFI_UNSUPPORTED;
+  }
+
+  ForgetOne = AllocatePool (NumNodes * sizeof *ForgetOne);
+  if (ForgetOne == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Set up the scatter-gather list (note: only request).
+  //
+  ReqIoVec[0].Buffer = &CommonReq;
+  ReqIoVec[0].Size   = sizeof CommonReq;
+  ReqIoVec[1].Buffer = &BatchForgetReq;
+  ReqIoVec[1].Size   = sizeof BatchForgetReq;
+  ReqIoVec[2].Buffer = ForgetOne;
+  ReqIoVec[2].Size   = NumNodes * sizeof *ForgetOne;
+  ReqSgList.IoVec    = ReqIoVec;
+  ReqSgList.NumVec   = ARRAY_SIZE (ReqIoVec);
+
+  //
+  // Validate the scatter-gather list (request only); calculate the total
+  // transfer size.
+  //
+  Status = VirtioFsSgListsValidate (VirtioFs, &ReqSgList, NULL);
+  if (EFI_ERROR (Status)) {
+    goto FreeForgetOne;
+  }
+
+  //
+  // Populate the common request header.
+  //
+  Status = VirtioFsFuseNewRequest (
+             VirtioFs,
+             &CommonReq,
+             ReqSgList.TotalSize,
+             VirtioFsFuseOpBatchForget,
+             0
+             );
+  if (EFI_ERROR (Status)) {
+    goto FreeForgetOne;
+  }
+
+  //
+  // Populate the FUSE_BATCH_FORGET-specific fields.
+  //
+  BatchForgetReq.Count = (UINT32)NumNodes;
+  BatchForgetReq.Dummy = 0;
+  for (Idx = 0; Idx < NumNodes; Idx++) {
+    ForgetOne[Idx].NodeId          = NodeIds[Idx];
+    ForgetOne[Idx].NumberOfLookups = 1;
+  }
+
+  //
+  // Submit the request. There's not going to be a response.
+  //
+  Status = VirtioFsSgListsSubmit (VirtioFs, &ReqSgList, NULL);
+
+FreeForgetOne:
+  FreePool (ForgetOne);
+  return Status;
+}
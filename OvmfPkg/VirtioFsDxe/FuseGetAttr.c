@@ -6,6 +6,8 @@
   SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
+#include <Library/BaseLib.h> // MultU64x32()
+
 #include "VirtioFsDxe.h"
 
 /**
@@ -26,6 +28,11 @@
   @param[out] FuseAttr     The VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE object
                            describing the properties of the inode.
 
+  @param[out] AttrTimeout  On success, the period, in 100ns units, for which
+                           the Virtio Filesystem device permits FuseAttr to be
+                           cached. Zero means FuseAttr must not be cached. May
+                           be NULL if the caller does not cache FuseAttr.
+
   @retval EFI_SUCCESS  FuseAttr has been filled in.
 
   @return              The "errno" value mapped to an EFI_STATUS code, if the
@@ -39,7 +46,8 @@ EFI_STATUS
 VirtioFsFuseGetAttr (
   IN OUT VIRTIO_FS                        *VirtioFs,
   IN     UINT64                           NodeId,
-  OUT VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  *FuseAttr
+  OUT VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  *FuseAttr,
+  OUT UINT64                              *AttrTimeout OPTIONAL
   )
 {
   VIRTIO_FS_FUSE_REQUEST           CommonReq;
@@ -124,5 +132,19 @@ VirtioFsFuseGetAttr (
     Status = VirtioFsErrnoToEfiStatus (CommonResp.Error);
   }
 
-  return Status;
+  if (EFI_ERROR (Status) || (AttrTimeout == NULL)) {
+    return Status;
+  }
+
+  //
+  // Convert the validity period to 100ns units, saturating on overflow.
+  //
+  if (GetAttrResp.AttrValid > DivU64x32 (MAX_UINT64, 10000000) - 1) {
+    *AttrTimeout = MAX_UINT64;
+  } else {
+    *AttrTimeout = MultU64x32 (GetAttrResp.AttrValid, 10000000) +
+                   MIN (GetAttrResp.AttrValidNsec, 999999999) / 100;
+  }
+
+  return EFI_SUCCESS;
 }
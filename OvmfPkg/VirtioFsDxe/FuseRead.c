@@ -6,8 +6,22 @@
   SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
+#include <Library/MemoryAllocationLib.h> // AllocatePool()
+
 #include "VirtioFsDxe.h"
 
+//
+// The buffers of a single FUSE_READ request-response exchange, within a batch
+// of exchanges submitted by VirtioFsFuseReadFileMultiple().
+//
+typedef struct {
+  VIRTIO_FS_FUSE_REQUEST         CommonReq;
+  VIRTIO_FS_FUSE_READ_REQUEST    ReadReq;
+  VIRTIO_FS_IO_VECTOR            ReqIoVec[2];
+  VIRTIO_FS_FUSE_RESPONSE        CommonResp;
+  VIRTIO_FS_IO_VECTOR            RespIoVec[2];
+} VIRTIO_FS_FUSE_READ_SLOT;
+
 /**
   Read a chunk from a regular file or a directory stream, by sending the
   FUSE_READ / FUSE_READDIRPLUS request to the Virtio Filesystem device.
@@ -203,3 +217,205 @@ VirtioFsFuseReadFileOrDir (
   *Size = (UINT32)TailBufferFill;
   return EFI_SUCCESS;
 }
+
+/**
+  Read a range of a regular file, keeping several FUSE_READ requests in flight
+  at the same time.
+
+  The range is split into chunks of at most "VirtioFs->MaxWrite" bytes, and up
+  to VIRTIO_FS_MAX_PIPELINE_DEPTH chunks at a time are submitted to the Virtio
+  Filesystem device together, with VirtioFsSgListsSubmitMultiple(). The device
+  may serve the chunks of such a batch concurrently.
+
+  The function may only be called after VirtioFsFuseInitSession() returns
+  successfully and before VirtioFsUninit() is called.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device to send the FUSE_READ
+                           requests to. On output, the FUSE request counter
+                           "VirtioFs->RequestId" will have been incremented
+                           once per request sent.
+
+  @param[in] NodeId        The inode number of the regular file to read from.
+
+  @param[in] FuseHandle    The open handle to the regular file to read from.
+
+  @param[in] Offset        The absolute file position at which to start
+                           reading.
+
+  @param[in,out] Size      On input, the number of bytes to read. On output,
+                           the number of bytes read contiguously from Offset,
+                           which is smaller than the value on input if EOF was
+                           reached, or if an error occurred.
+
+  @param[out] Data         Buffer to read the bytes from the regular file into.
+                           The caller is responsible for providing room for (at
+                           least) as many bytes in Data as Size is on input.
+
+  @retval EFI_SUCCESS           Read successful. The caller is responsible for
+                                checking Size to learn the actual byte count
+                                transferred.
+
+  @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
+
+  @return                       The "errno" value mapped to an EFI_STATUS code,
+                                if the Virtio Filesystem device explicitly
+                                reported an error. Size reports the bytes
+                                transferred before the failed chunk.
+
+  @return                       Error codes propagated from
+                                VirtioFsSgListsValidate(),
+                                VirtioFsFuseNewRequest(),
+                                VirtioFsSgListsSubmitMultiple(),
+                                VirtioFsFuseCheckResponse().
+**/
+EFI_STATUS
+VirtioFsFuseReadFileMultiple (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId,
+  IN     UINT64     FuseHandle,
+  IN     UINT64     Offset,
+  IN OUT UINTN      *Size,
+  OUT VOID          *Data
+  )
+{
+  VIRTIO_FS_FUSE_READ_SLOT       *Slots;
+  VIRTIO_FS_FUSE_READ_SLOT       *Slot;
+  VIRTIO_FS_SCATTER_GATHER_LIST  ReqSgList[VIRTIO_FS_MAX_PIPELINE_DEPTH];
+  VIRTIO_FS_SCATTER_GATHER_LIST  RespSgList[VIRTIO_FS_MAX_PIPELINE_DEPTH];
+  UINTN                          Depth;
+  UINTN                          NumChunks;
+  UINTN                          Idx;
+  UINTN                          Transferred;
+  UINTN                          Queued;
+  UINTN                          ChunkSize;
+  UINTN                          TailBufferFill;
+  EFI_STATUS                     Status;
+
+  Slots = AllocatePool (VIRTIO_FS_MAX_PIPELINE_DEPTH * sizeof *Slots);
+  if (Slots == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Each FUSE_READ exchange takes four descriptors on the request queue.
+  //
+  Depth = MAX (1, MIN (VIRTIO_FS_MAX_PIPELINE_DEPTH, VirtioFs->QueueSize / 4));
+
+  Status      = EFI_SUCCESS;
+  Transferred = 0;
+  while (Transferred < *Size) {
+    //
+    // Set up the next batch of chunks.
+    //
+    Queued = 0;
+    for (NumChunks = 0;
+         NumChunks < Depth && Transferred + Queued < *Size;
+         NumChunks++)
+    {
+      Slot      = &Slots[NumChunks];
+      ChunkSize = MIN ((UINTN)VirtioFs->MaxWrite, *Size - Transferred - Queued);
+
+      Slot->ReqIoVec[0].Buffer    = &Slot->CommonReq;
+      Slot->ReqIoVec[0].Size      = sizeof Slot->CommonReq;
+      Slot->ReqIoVec[1].Buffer    = &Slot->ReadReq;
+      Slot->ReqIoVec[1].Size      = sizeof Slot->ReadReq;
+      ReqSgList[NumChunks].IoVec  = Slot->ReqIoVec;
+      ReqSgList[NumChunks].NumVec = ARRAY_SIZE (Slot->ReqIoVec);
+
+      Slot->RespIoVec[0].Buffer    = &Slot->CommonResp;
+      Slot->RespIoVec[0].Size      = sizeof Slot->CommonResp;
+      Slot->RespIoVec[1].Buffer    = (UINT8 *)Data + Transferred + Queued;
+      Slot->RespIoVec[1].Size      = ChunkSize;
+      RespSgList[NumChunks].IoVec  = Slot->RespIoVec;
+      RespSgList[NumChunks].NumVec = ARRAY_SIZE (Slot->RespIoVec);
+
+      Status = VirtioFsSgListsValidate (
+                 VirtioFs,
+                 &ReqSgList[NumChunks],
+                 &RespSgList[NumChunks]
+                 );
+      if (EFI_ERROR (Status)) {
+        goto FreeSlots;
+      }
+
+      Status = VirtioFsFuseNewRequest (
+                 VirtioFs,
+                 &Slot->CommonReq,
+                 ReqSgList[NumChunks].TotalSize,
+                 VirtioFsFuseOpRead,
+                 NodeId
+                 );
+      if (EFI_ERROR (Status)) {
+        goto FreeSlots;
+      }
+
+      Slot->ReadReq.FileHandle = FuseHandle;
+      Slot->ReadReq.Offset     = Offset + Transferred + Queued;
+      Slot->ReadReq.Size       = (UINT32)ChunkSize;
+      Slot->ReadReq.ReadFlags  = 0;
+      Slot->ReadReq.LockOwner  = 0;
+      Slot->ReadReq.Flags      = 0;
+      Slot->ReadReq.Padding    = 0;
+
+      Queued += ChunkSize;
+    }
+
+    Status = VirtioFsSgListsSubmitMultiple (
+               VirtioFs,
+               NumChunks,
+               ReqSgList,
+               RespSgList
+               );
+    if (EFI_ERROR (Status)) {
+      goto FreeSlots;
+    }
+
+    //
+    // Consume the responses in file order. Stop the batch at the first short
+    // chunk; the next batch restarts right after the data actually read. A
+    // chunk that returns no data at all means EOF.
+    //
+    for (Idx = 0; Idx < NumChunks; Idx++) {
+      Slot   = &Slots[Idx];
+      Status = VirtioFsFuseCheckResponse (
+                 &RespSgList[Idx],
+                 Slot->CommonReq.Unique,
+                 &TailBufferFill
+                 );
+      if (EFI_ERROR (Status)) {
+        if (Status == EFI_DEVICE_ERROR) {
+          DEBUG ((
+            DEBUG_ERROR,
+            "%a: Label=\"%s\" NodeId=%Lu FuseHandle=%Lu "
+            "Offset=0x%Lx Size=0x%x Errno=%d\n",
+            __func__,
+            VirtioFs->Label,
+            NodeId,
+            FuseHandle,
+            Slot->ReadReq.Offset,
+            Slot->ReadReq.Size,
+            Slot->CommonResp.Error
+            ));
+          Status = VirtioFsErrnoToEfiStatus (Slot->CommonResp.Error);
+        }
+
+        goto FreeSlots;
+      }
+
+      if (TailBufferFill == 0) {
+        goto FreeSlots;
+      }
+
+      Transferred += TailBufferFill;
+      if (TailBufferFill < Slot->ReadReq.Size) {
+        break;
+      }
+    }
+  }
+
+FreeSlots:
+  FreePool (Slots);
+
+  *Size = Transferred;
+  return Status;
+}
@@ -6,8 +6,23 @@
   SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
+#include <Library/MemoryAllocationLib.h> // AllocatePool()
+
 #include "VirtioFsDxe.h"
 
+//
+// The buffers of a single FUSE_WRITE request-response exchange, within a batch
+// of exchanges submitted by VirtioFsFuseWriteMultiple().
+//
+typedef struct {
+  VIRTIO_FS_FUSE_REQUEST           CommonReq;
+  VIRTIO_FS_FUSE_WRITE_REQUEST     WriteReq;
+  VIRTIO_FS_IO_VECTOR              ReqIoVec[3];
+  VIRTIO_FS_FUSE_RESPONSE          CommonResp;
+  VIRTIO_FS_FUSE_WRITE_RESPONSE    WriteResp;
+  VIRTIO_FS_IO_VECTOR              RespIoVec[2];
+} VIRTIO_FS_FUSE_WRITE_SLOT;
+
 /**
   Write a chunk to a regular file, by sending the FUSE_WRITE request to the
   Virtio Filesystem device.
@@ -168,3 +183,215 @@ VirtioFsFuseWrite (
   *Size = WriteResp.Size;
   return EFI_SUCCESS;
 }
+
+/**
+  Write a range of a regular file, keeping several FUSE_WRITE requests in
+  flight at the same time.
+
+  The range is split into chunks of at most "VirtioFs->MaxWrite" bytes, and up
+  to VIRTIO_FS_MAX_PIPELINE_DEPTH chunks at a time are submitted to the Virtio
+  Filesystem device together, with VirtioFsSgListsSubmitMultiple(). The device
+  may serve the chunks of such a batch concurrently.
+
+  If the device writes a chunk only partially, the rest of the range is
+  written again starting right after the data actually written; the chunks
+  that followed the short chunk in the same batch are written once more.
+
+  The function may only be called after VirtioFsFuseInitSession() returns
+  successfully and before VirtioFsUninit() is called.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device to send the FUSE_WRITE
+                           requests to. On output, the FUSE request counter
+                           "VirtioFs->RequestId" will have been incremented
+                           once per request sent.
+
+  @param[in] NodeId        The inode number of the regular file to write to.
+
+  @param[in] FuseHandle    The open handle to the regular file to write to.
+
+  @param[in] Offset        The absolute file position at which to start
+                           writing.
+
+  @param[in,out] Size      On input, the number of bytes to write. On output,
+                           the number of bytes written contiguously from
+                           Offset, which is smaller than the value on input
+                           only if an error occurred.
+
+  @param[in] Data          The buffer to write to the regular file.
+
+  @retval EFI_SUCCESS           All bytes have been written.
+
+  @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
+
+  @retval EFI_DEVICE_ERROR      The Virtio Filesystem device reported writing
+                                no bytes, or more bytes than requested, for a
+                                chunk.
+
+  @return                       The "errno" value mapped to an EFI_STATUS code,
+                                if the Virtio Filesystem device explicitly
+                                reported an error. Size reports the bytes
+                                transferred before the failed chunk.
+
+  @return                       Error codes propagated from
+                                VirtioFsSgListsValidate(),
+                                VirtioFsFuseNewRequest(),
+                                VirtioFsSgListsSubmitMultiple(),
+                                VirtioFsFuseCheckResponse().
+**/
+EFI_STATUS
+VirtioFsFuseWriteMultiple (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId,
+  IN     UINT64     FuseHandle,
+  IN     UINT64     Offset,
+  IN OUT UINTN      *Size,
+  IN     VOID       *Data
+  )
+{
+  VIRTIO_FS_FUSE_WRITE_SLOT      *Slots;
+  VIRTIO_FS_FUSE_WRITE_SLOT      *Slot;
+  VIRTIO_FS_SCATTER_GATHER_LIST  ReqSgList[VIRTIO_FS_MAX_PIPELINE_DEPTH];
+  VIRTIO_FS_SCATTER_GATHER_LIST  RespSgList[VIRTIO_FS_MAX_PIPELINE_DEPTH];
+  UINTN                          Depth;
+  UINTN                          NumChunks;
+  UINTN                          Idx;
+  UINTN                          Transferred;
+  UINTN                          Queued;
+  UINTN                          ChunkSize;
+  EFI_STATUS                     Status;
+
+  Slots = AllocatePool (VIRTIO_FS_MAX_PIPELINE_DEPTH * sizeof *Slots);
+  if (Slots == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Each FUSE_WRITE exchange takes five descriptors on the request queue.
+  //
+  Depth = MAX (1, MIN (VIRTIO_FS_MAX_PIPELINE_DEPTH, VirtioFs->QueueSize / 5));
+
+  Status      = EFI_SUCCESS;
+  Transferred = 0;
+  while (Transferred < *Size) {
+    //
+    // Set up the next batch of chunks.
+    //
+    Queued = 0;
+    for (NumChunks = 0;
+         NumChunks < Depth && Transferred + Queued < *Size;
+         NumChunks++)
+    {
+      Slot      = &Slots[NumChunks];
+      ChunkSize = MIN ((UINTN)VirtioFs->MaxWrite, *Size - Transferred - Queued);
+
+      Slot->ReqIoVec[0].Buffer    = &Slot->CommonReq;
+      Slot->ReqIoVec[0].Size      = sizeof Slot->CommonReq;
+      Slot->ReqIoVec[1].Buffer    = &Slot->WriteReq;
+      Slot->ReqIoVec[1].Size      = sizeof Slot->WriteReq;
+      Slot->ReqIoVec[2].Buffer    = (UINT8 *)Data + Transferred + Queued;
+      Slot->ReqIoVec[2].Size      = ChunkSize;
+      ReqSgList[NumChunks].IoVec  = Slot->ReqIoVec;
+      ReqSgList[NumChunks].NumVec = ARRAY_SIZE (Slot->ReqIoVec);
+
+      Slot->RespIoVec[0].Buffer    = &Slot->CommonResp;
+      Slot->RespIoVec[0].Size      = sizeof Slot->CommonResp;
+      Slot->RespIoVec[1].Buffer    = &Slot->WriteResp;
+      Slot->RespIoVec[1].Size      = sizeof Slot->WriteResp;
+      RespSgList[NumChunks].IoVec  = Slot->RespIoVec;
+      RespSgList[NumChunks].NumVec = ARRAY_SIZE (Slot->RespIoVec);
+
+      Status = VirtioFsSgListsValidate (
+                 VirtioFs,
+                 &ReqSgList[NumChunks],
+                 &RespSgList[NumChunks]
+                 );
+      if (EFI_ERROR (Status)) {
+        goto FreeSlots;
+      }
+
+      Status = VirtioFsFuseNewRequest (
+                 VirtioFs,
+                 &Slot->CommonReq,
+                 ReqSgList[NumChunks].TotalSize,
+                 VirtioFsFuseOpWrite,
+                 NodeId
+                 );
+      if (EFI_ERROR (Status)) {
+        goto FreeSlots;
+      }
+
+      Slot->WriteReq.FileHandle = FuseHandle;
+      Slot->WriteReq.Offset     = Offset + Transferred + Queued;
+      Slot->WriteReq.Size       = (UINT32)ChunkSize;
+      Slot->WriteReq.WriteFlags = 0;
+      Slot->WriteReq.LockOwner  = 0;
+      Slot->WriteReq.Flags      = 0;
+      Slot->WriteReq.Padding    = 0;
+
+      Queued += ChunkSize;
+    }
+
+    Status = VirtioFsSgListsSubmitMultiple (
+               VirtioFs,
+               NumChunks,
+               ReqSgList,
+               RespSgList
+               );
+    if (EFI_ERROR (Status)) {
+      goto FreeSlots;
+    }
+
+    //
+    // Consume the responses in file order. Stop the batch at the first short
+    // chunk; the next batch restarts right after the data actually written.
+    //
+    for (Idx = 0; Idx < NumChunks; Idx++) {
+      Slot   = &Slots[Idx];
+      Status = VirtioFsFuseCheckResponse (
+                 &RespSgList[Idx],
+                 Slot->CommonReq.Unique,
+                 NULL
+                 );
+      if (EFI_ERROR (Status)) {
+        if (Status == EFI_DEVICE_ERROR) {
+          DEBUG ((
+            DEBUG_ERROR,
+            "%a: Label=\"%s\" NodeId=%Lu FuseHandle=%Lu "
+            "Offset=0x%Lx Size=0x%x Errno=%d\n",
+            __func__,
+            VirtioFs->Label,
+            NodeId,
+            FuseHandle,
+            Slot->WriteReq.Offset,
+            Slot->WriteReq.Size,
+            Slot->CommonResp.Error
+            ));
+          Status = VirtioFsErrnoToEfiStatus (Slot->CommonResp.Error);
+        }
+
+        goto FreeSlots;
+      }
+
+      if ((Slot->WriteResp.Size == 0) ||
+          (Slot->WriteResp.Size > Slot->WriteReq.Size))
+      {
+        //
+        // Progress should have been made, within the chunk.
+        //
+        Status = EFI_DEVICE_ERROR;
+        goto FreeSlots;
+      }
+
+      Transferred += Slot->WriteResp.Size;
+      if (Slot->WriteResp.Size < Slot->WriteReq.Size) {
+        break;
+      }
+    }
+  }
+
+FreeSlots:
+  FreePool (Slots);
+
+  *Size = Transferred;
+  return Status;
+}
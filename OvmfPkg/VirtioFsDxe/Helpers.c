@@ -6,11 +6,12 @@
   SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
-#include <Library/BaseLib.h>             // StrLen()
-#include <Library/BaseMemoryLib.h>       // CopyMem()
-#include <Library/MemoryAllocationLib.h> // AllocatePool()
-#include <Library/TimeBaseLib.h>         // EpochToEfiTime()
-#include <Library/VirtioLib.h>           // Virtio10WriteFeatures()
+#include <Library/BaseLib.h>                  // StrLen()
+#include <Library/BaseMemoryLib.h>            // CopyMem()
+#include <Library/MemoryAllocationLib.h>      // AllocatePool()
+#include <Library/TimeBaseLib.h>              // EpochToEfiTime()
+#include <Library/UefiBootServicesTableLib.h> // gBS
+#include <Library/VirtioLib.h>                // Virtio10WriteFeatures()
 
 #include "VirtioFsDxe.h"
 
@@ -752,6 +753,286 @@ Unmap:
   return Status;
 }
 
+/**
+  Submit several validated pairs of (request buffer list, response buffer list)
+  to the Virtio Filesystem device at once, and wait until the device has
+  processed all of them.
+
+  The descriptor chains of all pairs are placed on the request queue back to
+  back, and the device is notified only once. The device is free to process
+  the requests concurrently, and to complete them in any order.
+
+  On input, each pair of VIRTIO_FS_SCATTER_GATHER_LIST objects must have been
+  validated together, using the VirtioFsSgListsValidate() function. On output,
+  the IO Vectors are updated like in VirtioFsSgListsSubmit().
+
+  The function may only be called after VirtioFsInit() returns successfully and
+  before VirtioFsUninit() is called.
+
+  @param[in,out] VirtioFs         The Virtio Filesystem device that the
+                                  request-response exchanges should now be
+                                  submitted to.
+
+  @param[in] NumRequests          The number of elements in RequestSgLists and
+                                  ResponseSgLists. At most
+                                  VIRTIO_FS_MAX_PIPELINE_DEPTH.
+
+  @param[in,out] RequestSgLists   The scatter-gather lists that describe the
+                                  request parts of the exchanges.
+
+  @param[in,out] ResponseSgLists  The scatter-gather lists that describe the
+                                  response parts of the exchanges. Each
+                                  request must elicit a response.
+
+  @retval EFI_SUCCESS            All transfers complete. The caller should
+                                 investigate the
+                                 VIRTIO_FS_IO_VECTOR.Transferred fields in
+                                 ResponseSgLists, like after
+                                 VirtioFsSgListsSubmit().
+
+  @retval EFI_INVALID_PARAMETER  NumRequests is zero, or larger than
+                                 VIRTIO_FS_MAX_PIPELINE_DEPTH.
+
+  @retval EFI_UNSUPPORTED        The descriptor chains of all exchanges do not
+                                 fit on the virtio queue together.
+
+  @retval EFI_DEVICE_ERROR       The Virtio Filesystem device reported
+                                 populating more response bytes than the
+                                 TotalSize of the corresponding response list,
+                                 or it reported an unknown descriptor chain as
+                                 used.
+
+  @return                        Error codes propagated from
+                                 VirtioMapAllBytesInSharedBuffer(),
+                                 VirtioFs->Virtio->SetQueueNotify(), or
+                                 VirtioFs->Virtio->UnmapSharedBuffer().
+**/
+EFI_STATUS
+VirtioFsSgListsSubmitMultiple (
+  IN OUT VIRTIO_FS                      *VirtioFs,
+  IN     UINTN                          NumRequests,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  *RequestSgLists,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  *ResponseSgLists
+  )
+{
+  UINT16                          HeadDescIdx[VIRTIO_FS_MAX_PIPELINE_DEPTH];
+  BOOLEAN                         Completed[VIRTIO_FS_MAX_PIPELINE_DEPTH];
+  VIRTIO_FS_SCATTER_GATHER_LIST   *SgList;
+  VIRTIO_FS_IO_VECTOR             *IoVec;
+  UINTN                           ReqIdx;
+  UINTN                           ListId;
+  UINTN                           IoVecIdx;
+  UINTN                           DescriptorsNeeded;
+  EFI_STATUS                      Status;
+  DESC_INDICES                    Indices;
+  UINT16                          NextAvailIdx;
+  UINT16                          LastUsedIdx;
+  UINTN                           PollPeriodUsecs;
+  volatile CONST VRING_USED_ELEM  *UsedElem;
+  UINT32                          TotalBytesWrittenByDevice;
+
+  if ((NumRequests == 0) || (NumRequests > VIRTIO_FS_MAX_PIPELINE_DEPTH)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  DescriptorsNeeded = 0;
+  for (ReqIdx = 0; ReqIdx < NumRequests; ReqIdx++) {
+    DescriptorsNeeded += RequestSgLists[ReqIdx].NumVec +
+                         ResponseSgLists[ReqIdx].NumVec;
+  }
+
+  if (DescriptorsNeeded > VirtioFs->QueueSize) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Map all IO Vectors.
+  //
+  Status = EFI_SUCCESS;
+  for (ReqIdx = 0; ReqIdx < NumRequests && !EFI_ERROR (Status); ReqIdx++) {
+    for (ListId = 0; ListId < 2 && !EFI_ERROR (Status); ListId++) {
+      SgList = (ListId == 0) ? &RequestSgLists[ReqIdx] : &ResponseSgLists[ReqIdx];
+      for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
+        IoVec  = &SgList->IoVec[IoVecIdx];
+        Status = VirtioMapAllBytesInSharedBuffer (
+                   VirtioFs->Virtio,
+                   (ListId == 0) ?
+                   VirtioOperationBusMasterRead :
+                   VirtioOperationBusMasterWrite,
+                   IoVec->Buffer,
+                   IoVec->Size,
+                   &IoVec->MappedAddress,
+                   &IoVec->Mapping
+                   );
+        if (EFI_ERROR (Status)) {
+          break;
+        }
+
+        IoVec->Mapped = TRUE;
+      }
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    goto Unmap;
+  }
+
+  //
+  // Compose the descriptor chains back to back, remembering the head of each.
+  //
+  VirtioPrepare (&VirtioFs->Ring, &Indices);
+  for (ReqIdx = 0; ReqIdx < NumRequests; ReqIdx++) {
+    HeadDescIdx[ReqIdx] = Indices.NextDescIdx;
+    Completed[ReqIdx]   = FALSE;
+
+    for (ListId = 0; ListId < 2; ListId++) {
+      SgList = (ListId == 0) ? &RequestSgLists[ReqIdx] : &ResponseSgLists[ReqIdx];
+      for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
+        UINT16  Flags;
+
+        IoVec = &SgList->IoVec[IoVecIdx];
+        Flags = (ListId == 0) ? 0 : VRING_DESC_F_WRITE;
+        //
+        // Set VRING_DESC_F_NEXT on all except the last descriptor of the
+        // chain.
+        //
+        if ((ListId == 0) || (IoVecIdx < SgList->NumVec - 1)) {
+          Flags |= VRING_DESC_F_NEXT;
+        }
+
+        VirtioAppendDesc (
+          &VirtioFs->Ring,
+          IoVec->MappedAddress,
+          (UINT32)IoVec->Size,
+          Flags,
+          &Indices
+          );
+      }
+    }
+  }
+
+  //
+  // Publish all heads on the Available Ring at once, then notify the device.
+  //
+  NextAvailIdx = *VirtioFs->Ring.Avail.Idx;
+  LastUsedIdx  = NextAvailIdx;
+  for (ReqIdx = 0; ReqIdx < NumRequests; ReqIdx++) {
+    VirtioFs->Ring.Avail.Ring[NextAvailIdx++ % VirtioFs->Ring.QueueSize] =
+      HeadDescIdx[ReqIdx] % VirtioFs->Ring.QueueSize;
+  }
+
+  MemoryFence ();
+  *VirtioFs->Ring.Avail.Idx = NextAvailIdx;
+
+  MemoryFence ();
+  Status = VirtioFs->Virtio->SetQueueNotify (
+                               VirtioFs->Virtio,
+                               VIRTIO_FS_REQUEST_QUEUE
+                               );
+  if (EFI_ERROR (Status)) {
+    goto Unmap;
+  }
+
+  //
+  // Wait until the device has used all descriptor chains. Keep slowing down
+  // until we reach a poll period of slightly above 1 ms, like VirtioFlush().
+  //
+  PollPeriodUsecs = 1;
+  MemoryFence ();
+  while (*VirtioFs->Ring.Used.Idx != NextAvailIdx) {
+    gBS->Stall (PollPeriodUsecs);
+
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
+
+    MemoryFence ();
+  }
+
+  MemoryFence ();
+
+  //
+  // The device may have completed the requests in any order. Match each used
+  // element to its request by the head descriptor index, and update the
+  // transfer sizes in the IO Vectors.
+  //
+  for ( ; LastUsedIdx != NextAvailIdx; LastUsedIdx++) {
+    UsedElem = &VirtioFs->Ring.Used.UsedElem[LastUsedIdx %
+                                             VirtioFs->Ring.QueueSize];
+    for (ReqIdx = 0; ReqIdx < NumRequests; ReqIdx++) {
+      if (!Completed[ReqIdx] &&
+          (UsedElem->Id == HeadDescIdx[ReqIdx] % VirtioFs->Ring.QueueSize))
+      {
+        break;
+      }
+    }
+
+    if ((ReqIdx == NumRequests) ||
+        (UsedElem->Len > ResponseSgLists[ReqIdx].TotalSize))
+    {
+      Status = EFI_DEVICE_ERROR;
+      goto Unmap;
+    }
+
+    Completed[ReqIdx] = TRUE;
+
+    SgList = &RequestSgLists[ReqIdx];
+    for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
+      SgList->IoVec[IoVecIdx].Transferred = SgList->IoVec[IoVecIdx].Size;
+    }
+
+    TotalBytesWrittenByDevice = UsedElem->Len;
+    SgList                    = &ResponseSgLists[ReqIdx];
+    for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
+      IoVec              = &SgList->IoVec[IoVecIdx];
+      IoVec->Transferred = MIN (
+                             (UINTN)TotalBytesWrittenByDevice,
+                             IoVec->Size
+                             );
+      TotalBytesWrittenByDevice -= (UINT32)IoVec->Transferred;
+    }
+  }
+
+Unmap:
+  //
+  // Unmap all mapped IO Vectors on both the success and the error paths, in
+  // reverse order of mapping.
+  //
+  ReqIdx = NumRequests;
+  while (ReqIdx > 0) {
+    --ReqIdx;
+    ListId = 2;
+    while (ListId > 0) {
+      --ListId;
+      SgList   = (ListId == 0) ? &RequestSgLists[ReqIdx] : &ResponseSgLists[ReqIdx];
+      IoVecIdx = SgList->NumVec;
+      while (IoVecIdx > 0) {
+        EFI_STATUS  UnmapStatus;
+
+        --IoVecIdx;
+        IoVec = &SgList->IoVec[IoVecIdx];
+        if (!IoVec->Mapped) {
+          continue;
+        }
+
+        UnmapStatus = VirtioFs->Virtio->UnmapSharedBuffer (
+                                          VirtioFs->Virtio,
+                                          IoVec->Mapping
+                                          );
+        IoVec->Mapped        = FALSE;
+        IoVec->MappedAddress = 0;
+        IoVec->Mapping       = NULL;
+
+        if (!EFI_ERROR (Status) && EFI_ERROR (UnmapStatus)) {
+          Status = UnmapStatus;
+        }
+      }
+    }
+  }
+
+  return Status;
+}
+
 /**
   Set up the fields of a new VIRTIO_FS_FUSE_REQUEST object.
 
@@ -2523,3 +2804,105 @@ VirtioFsGetFuseModeUpdate (
   *Update = TRUE;
   return EFI_SUCCESS;
 }
+
+/**
+  Fetch the attributes of the file that a VIRTIO_FS_FILE refers to, serving
+  them from the attribute cache of the VIRTIO_FS_FILE while the validity
+  period that the Virtio Filesystem device reported for them lasts.
+
+  @param[in,out] VirtioFsFile  The VIRTIO_FS_FILE to fetch the attributes of.
+                               On successful return, the attribute cache of
+                               VirtioFsFile may have been refreshed.
+
+  @param[out] FuseAttr         The VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE object
+                               describing the properties of the file.
+
+  @retval EFI_SUCCESS  FuseAttr has been filled in.
+
+  @return              Error codes propagated from VirtioFsFuseGetAttr().
+**/
+EFI_STATUS
+VirtioFsFileGetAttr (
+  IN OUT VIRTIO_FS_FILE                   *VirtioFsFile,
+  OUT VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  *FuseAttr
+  )
+{
+  EFI_STATUS  Status;
+  UINT64      AttrTimeout;
+
+  if (VirtioFsFile->CachedAttrValid &&
+      (gBS->CheckEvent (VirtioFsFile->CachedAttrTimer) == EFI_NOT_READY))
+  {
+    CopyMem (FuseAttr, &VirtioFsFile->CachedAttr, sizeof *FuseAttr);
+    return EFI_SUCCESS;
+  }
+
+  VirtioFsFile->CachedAttrValid = FALSE;
+
+  Status = VirtioFsFuseGetAttr (
+             VirtioFsFile->OwnerFs,
+             VirtioFsFile->NodeId,
+             FuseAttr,
+             &AttrTimeout
+             );
+  if (EFI_ERROR (Status) || (AttrTimeout == 0)) {
+    return Status;
+  }
+
+  //
+  // Failing to set up the cache is not an error; the attributes will just be
+  // fetched again next time.
+  //
+  if (VirtioFsFile->CachedAttrTimer == NULL) {
+    Status = gBS->CreateEvent (
+                    EVT_TIMER,
+                    TPL_CALLBACK,
+                    NULL,
+                    NULL,
+                    &VirtioFsFile->CachedAttrTimer
+                    );
+    if (EFI_ERROR (Status)) {
+      VirtioFsFile->CachedAttrTimer = NULL;
+      return EFI_SUCCESS;
+    }
+  }
+
+  Status = gBS->SetTimer (
+                  VirtioFsFile->CachedAttrTimer,
+                  TimerRelative,
+                  AttrTimeout
+                  );
+  if (!EFI_ERROR (Status)) {
+    CopyMem (&VirtioFsFile->CachedAttr, FuseAttr, sizeof *FuseAttr);
+    VirtioFsFile->CachedAttrValid = TRUE;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Drop the cached attributes of all open VIRTIO_FS_FILE objects that refer to
+  a particular inode. Call this function after modifying the inode.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device that the inode lives
+                           on.
+
+  @param[in] NodeId        The inode number whose cached attributes should be
+                           dropped.
+**/
+VOID
+VirtioFsInvalidateAttr (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId
+  )
+{
+  LIST_ENTRY      *Entry;
+  VIRTIO_FS_FILE  *VirtioFsFile;
+
+  BASE_LIST_FOR_EACH (Entry, &VirtioFs->OpenFiles) {
+    VirtioFsFile = VIRTIO_FS_FILE_FROM_OPEN_FILES_ENTRY (Entry);
+    if (VirtioFsFile->NodeId == NodeId) {
+      VirtioFsFile->CachedAttrValid = FALSE;
+    }
+  }
+}
@@ -6,8 +6,9 @@
   SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
-#include <Library/BaseLib.h>             // RemoveEntryList()
-#include <Library/MemoryAllocationLib.h> // FreePool()
+#include <Library/BaseLib.h>                  // RemoveEntryList()
+#include <Library/MemoryAllocationLib.h>      // FreePool()
+#include <Library/UefiBootServicesTableLib.h> // gBS
 
 #include "VirtioFsDxe.h"
 
@@ -75,6 +76,10 @@ VirtioFsSimpleFileClose (
     FreePool (VirtioFsFile->FileInfoArray);
   }
 
+  if (VirtioFsFile->CachedAttrTimer != NULL) {
+    gBS->CloseEvent (VirtioFsFile->CachedAttrTimer);
+  }
+
   FreePool (VirtioFsFile);
   return EFI_SUCCESS;
 }
@@ -6,8 +6,9 @@
   SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
-#include <Library/BaseLib.h>             // RemoveEntryList()
-#include <Library/MemoryAllocationLib.h> // FreePool()
+#include <Library/BaseLib.h>                  // RemoveEntryList()
+#include <Library/MemoryAllocationLib.h>      // FreePool()
+#include <Library/UefiBootServicesTableLib.h> // gBS
 
 #include "VirtioFsDxe.h"
 
@@ -111,6 +112,10 @@ VirtioFsSimpleFileDelete (
     FreePool (VirtioFsFile->FileInfoArray);
   }
 
+  if (VirtioFsFile->CachedAttrTimer != NULL) {
+    gBS->CloseEvent (VirtioFsFile->CachedAttrTimer);
+  }
+
   FreePool (VirtioFsFile);
   return Status;
 }
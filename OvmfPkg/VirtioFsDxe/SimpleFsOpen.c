@@ -60,7 +60,8 @@ OpenRootDirectory (
     Status = VirtioFsFuseGetAttr (
                VirtioFs,
                VIRTIO_FS_FUSE_ROOT_DIR_NODE_ID,
-               &FuseAttr
+               &FuseAttr,
+               NULL
                );
     if (EFI_ERROR (Status)) {
       return Status;
@@ -557,6 +558,8 @@ VirtioFsSimpleFileOpen (
   NewVirtioFsFile->SingleFileInfoSize     = 0;
   NewVirtioFsFile->NumFileInfo            = 0;
   NewVirtioFsFile->NextFileInfo           = 0;
+  NewVirtioFsFile->CachedAttrValid        = FALSE;
+  NewVirtioFsFile->CachedAttrTimer        = NULL;
 
   //
   // One more file is now open for the filesystem.
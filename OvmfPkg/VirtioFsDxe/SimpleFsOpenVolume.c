@@ -82,6 +82,8 @@ VirtioFsOpenVolume (
   VirtioFsFile->SingleFileInfoSize     = 0;
   VirtioFsFile->NumFileInfo            = 0;
   VirtioFsFile->NextFileInfo           = 0;
+  VirtioFsFile->CachedAttrValid        = FALSE;
+  VirtioFsFile->CachedAttrTimer        = NULL;
 
   //
   // One more file open for the filesystem.
@@ -79,6 +79,8 @@ RefillFileInfoCache (
   UINT64                          DirStreamCookie;
   UINT64                          CacheEndsAtCookie;
   UINTN                           NumFileInfo;
+  UINT64                          *ForgetNodeIds;
+  UINTN                           NumForget;
 
   //
   // Allocate a DirentBuf that can receive at least
@@ -125,6 +127,21 @@ RefillFileInfoCache (
     goto FreeDirentBuf;
   }
 
+  //
+  // Allocate room for collecting the NodeIds that the directory entries carry,
+  // so that we can make the Virtio Filesystem device forget them in batches,
+  // rather than one by one.
+  //
+  ForgetNodeIds = AllocatePool (
+                    VIRTIO_FS_FILE_MAX_FILE_INFO * sizeof *ForgetNodeIds
+                    );
+  if (ForgetNodeIds == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto FreeFileInfoArray;
+  }
+
+  NumForget = 0;
+
   //
   // Pick up reading the directory stream where the previous cache ended.
   //
@@ -152,7 +169,7 @@ RefillFileInfoCache (
                   DirentBuf              // Data
                   );
     if (EFI_ERROR (Status)) {
-      goto FreeFileInfoArray;
+      goto ForgetNodes;
     }
 
     if (Remaining == 0) {
@@ -185,7 +202,7 @@ RefillFileInfoCache (
         // supported by the filesystem -- proved acceptable above.
         //
         Status = EFI_PROTOCOL_ERROR;
-        goto FreeFileInfoArray;
+        goto ForgetNodes;
       }
 
       if (DirentSize > Remaining) {
@@ -195,7 +212,7 @@ RefillFileInfoCache (
         // Filesystem device is supposed to send complete entries only.
         //
         Status = EFI_PROTOCOL_ERROR;
-        goto FreeFileInfoArray;
+        goto ForgetNodes;
       }
 
       if (Dirent->Namelen > FilesysAttr.Namelen) {
@@ -206,7 +223,7 @@ RefillFileInfoCache (
         // the next alignment bucket. Should never happen.
         //
         Status = EFI_PROTOCOL_ERROR;
-        goto FreeFileInfoArray;
+        goto ForgetNodes;
       }
 
       //
@@ -245,7 +262,11 @@ RefillFileInfoCache (
       // Virtio Filesystem device reports their NodeId fields as zero.)
       //
       if (Dirent->NodeResp.NodeId != 0) {
-        VirtioFsFuseForget (VirtioFs, Dirent->NodeResp.NodeId);
+        ForgetNodeIds[NumForget++] = Dirent->NodeResp.NodeId;
+        if (NumForget == VIRTIO_FS_FILE_MAX_FILE_INFO) {
+          VirtioFsFuseBatchForget (VirtioFs, NumForget, ForgetNodeIds);
+          NumForget = 0;
+        }
       }
 
       //
@@ -263,7 +284,7 @@ RefillFileInfoCache (
       // supposed to send complete entries only.
       //
       Status = EFI_PROTOCOL_ERROR;
-      goto FreeFileInfoArray;
+      goto ForgetNodes;
     }
 
     //
@@ -272,6 +293,9 @@ RefillFileInfoCache (
     //
   } while (NumFileInfo < VIRTIO_FS_FILE_MAX_FILE_INFO);
 
+  VirtioFsFuseBatchForget (VirtioFs, NumForget, ForgetNodeIds);
+  FreePool (ForgetNodeIds);
+
   //
   // Commit the results. (Note that the result may be an empty cache.)
   //
@@ -288,6 +312,10 @@ RefillFileInfoCache (
   FreePool (DirentBuf);
   return EFI_SUCCESS;
 
+ForgetNodes:
+  VirtioFsFuseBatchForget (VirtioFs, NumForget, ForgetNodeIds);
+  FreePool (ForgetNodeIds);
+
 FreeFileInfoArray:
   FreePool (FileInfoArray);
 
@@ -377,43 +405,29 @@ ReadRegularFile (
   EFI_STATUS                          Status;
   VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  FuseAttr;
   UINTN                               Transferred;
-  UINTN                               Left;
 
   VirtioFs = VirtioFsFile->OwnerFs;
   //
   // The UEFI spec forbids reads that start beyond the end of the file.
   //
-  Status = VirtioFsFuseGetAttr (VirtioFs, VirtioFsFile->NodeId, &FuseAttr);
+  Status = VirtioFsFileGetAttr (VirtioFsFile, &FuseAttr);
   if (EFI_ERROR (Status) || (VirtioFsFile->FilePosition > FuseAttr.Size)) {
     return EFI_DEVICE_ERROR;
   }
 
-  Status      = EFI_SUCCESS;
-  Transferred = 0;
-  Left        = *BufferSize;
-  while (Left > 0) {
-    UINT32  ReadSize;
-
-    //
-    // FUSE_READ cannot express a >=4GB buffer size.
-    //
-    ReadSize = (UINT32)MIN ((UINTN)MAX_UINT32, Left);
-    Status   = VirtioFsFuseReadFileOrDir (
-                 VirtioFs,
-                 VirtioFsFile->NodeId,
-                 VirtioFsFile->FuseHandle,
-                 FALSE,                                  // IsDir
-                 VirtioFsFile->FilePosition + Transferred,
-                 &ReadSize,
-                 (UINT8 *)Buffer + Transferred
-                 );
-    if (EFI_ERROR (Status) || (ReadSize == 0)) {
-      break;
-    }
-
-    Transferred += ReadSize;
-    Left        -= ReadSize;
-  }
+  //
+  // Split the read into FUSE_READ requests that the Virtio Filesystem device
+  // may serve concurrently.
+  //
+  Transferred = *BufferSize;
+  Status      = VirtioFsFuseReadFileMultiple (
+                  VirtioFs,
+                  VirtioFsFile->NodeId,
+                  VirtioFsFile->FuseHandle,
+                  VirtioFsFile->FilePosition,
+                  &Transferred,
+                  Buffer
+                  );
 
   *BufferSize                 = Transferred;
   VirtioFsFile->FilePosition += Transferred;
@@ -383,7 +383,12 @@ UpdateAttributes (
   // Fetch the current attributes first, so we can build the difference between
   // them and NewFileInfo.
   //
-  Status = VirtioFsFuseGetAttr (VirtioFs, VirtioFsFile->NodeId, &FuseAttr);
+  Status = VirtioFsFuseGetAttr (
+             VirtioFs,
+             VirtioFsFile->NodeId,
+             &FuseAttr,
+             NULL
+             );
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -457,6 +462,7 @@ UpdateAttributes (
              UpdateMtime    ? &Mtime    : NULL,
              UpdateMode     ? &Mode     : NULL
              );
+  VirtioFsInvalidateAttr (VirtioFs, VirtioFsFile->NodeId);
   return Status;
 }
 
@@ -20,7 +20,6 @@ VirtioFsSimpleFileWrite (
   VIRTIO_FS       *VirtioFs;
   EFI_STATUS      Status;
   UINTN           Transferred;
-  UINTN           Left;
 
   VirtioFsFile = VIRTIO_FS_FILE_FROM_SIMPLE_FILE (This);
   VirtioFs     = VirtioFsFile->OwnerFs;
@@ -33,38 +32,24 @@ VirtioFsSimpleFileWrite (
     return EFI_ACCESS_DENIED;
   }
 
-  Status      = EFI_SUCCESS;
-  Transferred = 0;
-  Left        = *BufferSize;
-  while (Left > 0) {
-    UINT32  WriteSize;
-
-    //
-    // Honor the write buffer size limit.
-    //
-    WriteSize = (UINT32)MIN ((UINTN)VirtioFs->MaxWrite, Left);
-    Status    = VirtioFsFuseWrite (
+  //
+  // Split the write into FUSE_WRITE requests that honor the write buffer size
+  // limit, and that the Virtio Filesystem device may serve concurrently.
+  //
+  Transferred = *BufferSize;
+  Status      = VirtioFsFuseWriteMultiple (
                   VirtioFs,
                   VirtioFsFile->NodeId,
                   VirtioFsFile->FuseHandle,
-                  VirtioFsFile->FilePosition + Transferred,
-                  &WriteSize,
-                  (UINT8 *)Buffer + Transferred
+                  VirtioFsFile->FilePosition,
+                  &Transferred,
+                  Buffer
                   );
-    if (!EFI_ERROR (Status) && (WriteSize == 0)) {
-      //
-      // Progress should have been made.
-      //
-      Status = EFI_DEVICE_ERROR;
-    }
-
-    if (EFI_ERROR (Status)) {
-      break;
-    }
 
-    Transferred += WriteSize;
-    Left        -= WriteSize;
-  }
+  //
+  // The file size and timestamps may have changed.
+  //
+  VirtioFsInvalidateAttr (VirtioFs, VirtioFsFile->NodeId);
 
   *BufferSize                 = Transferred;
   VirtioFsFile->FilePosition += Transferred;
@@ -51,6 +51,14 @@
 //
 #define VIRTIO_FS_FILE_MAX_FILE_INFO  256
 
+//
+// Maximum number of FUSE_READ / FUSE_WRITE requests that are kept in flight
+// on the request queue at the same time, when a single EFI_FILE_PROTOCOL
+// Read() or Write() call is split into VIRTIO_FS.MaxWrite sized chunks. The
+// actual depth may be lower, if the request queue is too small.
+//
+#define VIRTIO_FS_MAX_PIPELINE_DEPTH  16
+
 //
 // Filesystem label encoded in UCS-2, transformed from the UTF-8 representation
 // in "VIRTIO_FS_CONFIG.Tag", and NUL-terminated. Only the printable ASCII code
@@ -173,6 +181,17 @@ typedef struct {
   UINTN    SingleFileInfoSize;
   UINTN    NumFileInfo;
   UINTN    NextFileInfo;
+  //
+  // The attributes of the file, cached from the most recent FUSE_GETATTR
+  // request. The Virtio Filesystem device tells us for how long the
+  // attributes remain valid; CachedAttrTimer is armed with that period, and
+  // the cached attributes are discarded once the timer has expired, or when
+  // the file is modified through any VIRTIO_FS_FILE that refers to the same
+  // NodeId.
+  //
+  VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE    CachedAttr;
+  BOOLEAN                               CachedAttrValid;
+  EFI_EVENT                             CachedAttrTimer;
 } VIRTIO_FS_FILE;
 
 #define VIRTIO_FS_FILE_FROM_SIMPLE_FILE(SimpleFileReference) \
@@ -217,6 +236,14 @@ VirtioFsSgListsSubmit (
   IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  *ResponseSgList OPTIONAL
   );
 
+EFI_STATUS
+VirtioFsSgListsSubmitMultiple (
+  IN OUT VIRTIO_FS                      *VirtioFs,
+  IN     UINTN                          NumRequests,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  *RequestSgLists,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  *ResponseSgLists
+  );
+
 EFI_STATUS
 VirtioFsFuseNewRequest (
   IN OUT VIRTIO_FS              *VirtioFs,
@@ -307,6 +334,18 @@ VirtioFsGetFuseModeUpdate (
   OUT UINT32            *Mode
   );
 
+EFI_STATUS
+VirtioFsFileGetAttr (
+  IN OUT VIRTIO_FS_FILE                   *VirtioFsFile,
+  OUT VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  *FuseAttr
+  );
+
+VOID
+VirtioFsInvalidateAttr (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId
+  );
+
 //
 // Wrapper functions for FUSE commands (primitives).
 //
@@ -326,11 +365,19 @@ VirtioFsFuseForget (
   IN     UINT64     NodeId
   );
 
+EFI_STATUS
+VirtioFsFuseBatchForget (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINTN      NumNodes,
+  IN     UINT64     *NodeIds
+  );
+
 EFI_STATUS
 VirtioFsFuseGetAttr (
   IN OUT VIRTIO_FS                        *VirtioFs,
   IN     UINT64                           NodeId,
-  OUT VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  *FuseAttr
+  OUT VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  *FuseAttr,
+  OUT UINT64                              *AttrTimeout OPTIONAL
   );
 
 EFI_STATUS
@@ -378,6 +425,16 @@ VirtioFsFuseReadFileOrDir (
   OUT VOID          *Data
   );
 
+EFI_STATUS
+VirtioFsFuseReadFileMultiple (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId,
+  IN     UINT64     FuseHandle,
+  IN     UINT64     Offset,
+  IN OUT UINTN      *Size,
+  OUT VOID          *Data
+  );
+
 EFI_STATUS
 VirtioFsFuseWrite (
   IN OUT VIRTIO_FS  *VirtioFs,
@@ -388,6 +445,16 @@ VirtioFsFuseWrite (
   IN     VOID       *Data
   );
 
+EFI_STATUS
+VirtioFsFuseWriteMultiple (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId,
+  IN     UINT64     FuseHandle,
+  IN     UINT64     Offset,
+  IN OUT UINTN      *Size,
+  IN     VOID       *Data
+  );
+
 EFI_STATUS
 VirtioFsFuseStatFs (
   IN OUT VIRTIO_FS                    *VirtioFs,
@@ -15,6 +15,78 @@
 
 #include "VirtioNet.h"
 
+/**
+  Reclaim all transmit descriptor chains that the hypervisor reports
+  completed.
+
+  The descriptor chains are returned to the free stack at once, so that
+  VirtioNetTransmit() can reuse them, while the caller buffers are queued on
+  TxDoneBuf, to be handed back one by one by VirtioNetGetStatus().
+
+  @param[in,out] Dev        The VNET_DEV driver instance.
+  @param[in]     TxCurUsed  The used ring index last read from the device.
+
+  @retval EFI_SUCCESS       All completed descriptor chains have been
+                            reclaimed.
+  @retval EFI_DEVICE_ERROR  The internal state of the driver is corrupt.
+**/
+STATIC
+EFI_STATUS
+VirtioNetReclaimTx (
+  IN OUT VNET_DEV  *Dev,
+  IN     UINT16    TxCurUsed
+  )
+{
+  EFI_STATUS            Status;
+  UINT16                UsedElemIdx;
+  UINT32                DescIdx;
+  EFI_PHYSICAL_ADDRESS  DeviceAddress;
+  VOID                  *Buffer;
+
+  while (Dev->TxLastUsed != TxCurUsed) {
+    //
+    // fetch the next descriptor among those that the hypervisor reports
+    // completed
+    //
+    ASSERT (Dev->TxCurPending > 0);
+    ASSERT (Dev->TxCurPending + Dev->TxDoneCount <= Dev->TxMaxPending);
+
+    UsedElemIdx = Dev->TxLastUsed++ % Dev->TxRing.QueueSize;
+    DescIdx     = Dev->TxRing.Used.UsedElem[UsedElemIdx].Id;
+    ASSERT (DescIdx < (UINT32)(2 * Dev->TxMaxPending - 1));
+
+    //
+    // get the device address that has been enqueued for the caller's
+    // transmit buffer
+    //
+    DeviceAddress = Dev->TxRing.Desc[DescIdx + 1].Addr;
+
+    //
+    // now this descriptor can be used again to enqueue a transmit buffer
+    //
+    Dev->TxFreeStack[--Dev->TxCurPending] = (UINT16)DescIdx;
+
+    //
+    // Unmap the device address and perform the reverse mapping to find the
+    // caller buffer address.
+    //
+    Status = VirtioNetUnmapTxBuf (Dev, &Buffer, DeviceAddress);
+    if (EFI_ERROR (Status)) {
+      //
+      // VirtioNetUnmapTxBuf should never fail, if we have reached here
+      // that means our internal state has been corrupted
+      //
+      ASSERT (FALSE);
+      return EFI_DEVICE_ERROR;
+    }
+
+    Dev->TxDoneBuf[(Dev->TxDoneFirst + Dev->TxDoneCount++) %
+                   Dev->TxMaxPending] = Buffer;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Reads the current interrupt status and recycled transmit buffer status from
   a network interface.
@@ -59,7 +131,6 @@ VirtioNetGetStatus (
   EFI_STATUS            Status;
   UINT16                RxCurUsed;
   UINT16                TxCurUsed;
-  EFI_PHYSICAL_ADDRESS  DeviceAddress;
 
   if (This == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -115,55 +186,28 @@ VirtioNetGetStatus (
       ASSERT (Dev->TxCurPending > 0);
       *InterruptStatus |= EFI_SIMPLE_NETWORK_TRANSMIT_INTERRUPT;
     }
+
+    if (Dev->TxDoneCount > 0) {
+      *InterruptStatus |= EFI_SIMPLE_NETWORK_TRANSMIT_INTERRUPT;
+    }
   }
 
   if (TxBuf != NULL) {
-    if (Dev->TxLastUsed == TxCurUsed) {
+    //
+    // reclaim everything the hypervisor has completed since the last call,
+    // then hand back the oldest completed buffer
+    //
+    Status = VirtioNetReclaimTx (Dev, TxCurUsed);
+    if (EFI_ERROR (Status)) {
+      goto Exit;
+    }
+
+    if (Dev->TxDoneCount == 0) {
       *TxBuf = NULL;
     } else {
-      UINT16  UsedElemIdx;
-      UINT32  DescIdx;
-
-      //
-      // fetch the first descriptor among those that the hypervisor reports
-      // completed
-      //
-      ASSERT (Dev->TxCurPending > 0);
-      ASSERT (Dev->TxCurPending <= Dev->TxMaxPending);
-
-      UsedElemIdx = Dev->TxLastUsed++ % Dev->TxRing.QueueSize;
-      DescIdx     = Dev->TxRing.Used.UsedElem[UsedElemIdx].Id;
-      ASSERT (DescIdx < (UINT32)(2 * Dev->TxMaxPending - 1));
-
-      //
-      // get the device address that has been enqueued for the caller's
-      // transmit buffer
-      //
-      DeviceAddress = Dev->TxRing.Desc[DescIdx + 1].Addr;
-
-      //
-      // now this descriptor can be used again to enqueue a transmit buffer
-      //
-      Dev->TxFreeStack[--Dev->TxCurPending] = (UINT16)DescIdx;
-
-      //
-      // Unmap the device address and perform the reverse mapping to find the
-      // caller buffer address.
-      //
-      Status = VirtioNetUnmapTxBuf (
-                 Dev,
-                 TxBuf,
-                 DeviceAddress
-                 );
-      if (EFI_ERROR (Status)) {
-        //
-        // VirtioNetUnmapTxBuf should never fail, if we have reached here
-        // that means our internal state has been corrupted
-        //
-        ASSERT (FALSE);
-        Status = EFI_DEVICE_ERROR;
-        goto Exit;
-      }
+      *TxBuf           = Dev->TxDoneBuf[Dev->TxDoneFirst];
+      Dev->TxDoneFirst = (UINT16)((Dev->TxDoneFirst + 1) % Dev->TxMaxPending);
+      --Dev->TxDoneCount;
     }
   }
 
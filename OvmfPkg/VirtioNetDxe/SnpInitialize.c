@@ -133,6 +133,8 @@ ReleaseQueue:
   - fully populate the TX queue with a static pattern of virtio descriptor
     chains,
   - tracking of heads of free descriptor chains from the above,
+  - a queue of completed TX buffers, reclaimed from the used ring in batches
+    and handed back one by one by VirtioNetGetStatus(),
   - one common virtio-net request header (never modified by the host) for all
     pending TX packets,
   - select polling over TX interrupt.
@@ -141,7 +143,8 @@ ReleaseQueue:
                            EfiSimpleNetworkInitialized state.
 
   @retval EFI_OUT_OF_RESOURCES  Failed to allocate the stack to track the heads
-                                of free descriptor chains or failed to init
+                                of free descriptor chains, failed to allocate
+                                the completed TX buffer queue or failed to init
                                 TxBufCollection.
   @return                       Status codes from VIRTIO_DEVICE_PROTOCOL.
                                 AllocateSharedPages() or
@@ -174,13 +177,24 @@ VirtioNetInitTx (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  Dev->TxDoneFirst = 0;
+  Dev->TxDoneCount = 0;
+  Dev->TxDoneBuf   = AllocatePool (
+                       Dev->TxMaxPending *
+                       sizeof *Dev->TxDoneBuf
+                       );
+  if (Dev->TxDoneBuf == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto FreeTxFreeStack;
+  }
+
   Dev->TxBufCollection = OrderedCollectionInit (
                            VirtioNetTxBufMapInfoCompare,
                            VirtioNetTxBufDeviceAddressCompare
                            );
   if (Dev->TxBufCollection == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
-    goto FreeTxFreeStack;
+    goto FreeTxDoneBuf;
   }
 
   //
@@ -214,9 +228,10 @@ VirtioNetInitTx (
 
   //
   // In VirtIo 1.0, the NumBuffers field is mandatory. In 0.9.5, it depends on
-  // VIRTIO_NET_F_MRG_RXBUF, which we never negotiate.
+  // VIRTIO_NET_F_MRG_RXBUF, which applies to both directions.
   //
-  TxSharedReqSize = (Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) ?
+  TxSharedReqSize = ((Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) &&
+                     !Dev->RxMergeable) ?
                     sizeof (Dev->TxSharedReq->V0_9_5) :
                     sizeof *Dev->TxSharedReq;
 
@@ -277,6 +292,9 @@ FreeTxSharedReqBuffer:
 UninitTxBufCollection:
   OrderedCollectionUninit (Dev->TxBufCollection);
 
+FreeTxDoneBuf:
+  FreePool (Dev->TxDoneBuf);
+
 FreeTxFreeStack:
   FreePool (Dev->TxFreeStack);
 
@@ -294,7 +312,8 @@ FreeTxFreeStack:
     packet data into,
   - select polling over RX interrupt,
   - fully populate the RX queue with a static pattern of virtio descriptor
-    chains.
+    chains; with VIRTIO_NET_F_MRG_RXBUF, each chain is a single descriptor
+    that receives both the virtio-net request header and the packet data.
 
   @param[in,out] Dev       The VNET_DEV driver instance about to enter the
                            EfiSimpleNetworkInitialized state.
@@ -321,14 +340,17 @@ VirtioNetInitRx (
   UINTN                 NumBytes;
   EFI_PHYSICAL_ADDRESS  RxBufDeviceAddress;
   VOID                  *RxBuffer;
+  UINT16                DescPerPkt;
 
   //
   // In VirtIo 1.0, the NumBuffers field is mandatory. In 0.9.5, it depends on
-  // VIRTIO_NET_F_MRG_RXBUF, which we never negotiate.
+  // VIRTIO_NET_F_MRG_RXBUF.
   //
-  VirtioNetReqSize = (Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) ?
+  VirtioNetReqSize = ((Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) &&
+                      !Dev->RxMergeable) ?
                      sizeof (VIRTIO_NET_REQ) :
                      sizeof (VIRTIO_1_0_NET_REQ);
+  Dev->RxReqSize = (UINT16)VirtioNetReqSize;
 
   //
   // For each incoming packet we must supply two descriptors:
@@ -336,14 +358,25 @@ VirtioNetInitRx (
   // - the recipient for the network data (which consists of Ethernet header
   //   and Ethernet payload).
   //
+  // With mergeable receive buffers, the header is placed at the start of the
+  // first buffer, so one descriptor per packet suffices. Every buffer is
+  // still large enough for a full frame, hence the host will normally use a
+  // single buffer per packet.
+  //
   RxBufSize = VirtioNetReqSize +
               (Dev->Snm.MediaHeaderSize + Dev->Snm.MaxPacketSize);
+  DescPerPkt = Dev->RxMergeable ? 1 : 2;
 
   //
-  // Limit the number of pending RX packets if the queue is big. The division
-  // by two is due to the above "two descriptors per packet" trait.
+  // Limit the number of pending RX packets if the queue is big. The host
+  // drops packets whenever it runs out of receive buffers, so keep as many
+  // posted as the queue allows, up to VNET_MAX_RX_PENDING.
   //
-  RxAlwaysPending = (UINT16)MIN (Dev->RxRing.QueueSize / 2, VNET_MAX_PENDING);
+  RxAlwaysPending = (UINT16)MIN (
+                              Dev->RxRing.QueueSize / DescPerPkt,
+                              VNET_MAX_RX_PENDING
+                              );
+  Dev->RxMaxPending = RxAlwaysPending;
 
   //
   // The RxBuf is shared between guest and hypervisor, use
@@ -408,6 +441,14 @@ VirtioNetInitRx (
     //
     // virtio-0.9.5, 2.4.1.1 Placing Buffers into the Descriptor Table
     //
+    if (Dev->RxMergeable) {
+      Dev->RxRing.Desc[DescIdx].Addr  = RxBufDeviceAddress;
+      Dev->RxRing.Desc[DescIdx].Len   = (UINT32)RxBufSize;
+      Dev->RxRing.Desc[DescIdx].Flags = VRING_DESC_F_WRITE;
+      RxBufDeviceAddress             += Dev->RxRing.Desc[DescIdx++].Len;
+      continue;
+    }
+
     Dev->RxRing.Desc[DescIdx].Addr  = RxBufDeviceAddress;
     Dev->RxRing.Desc[DescIdx].Len   = (UINT32)VirtioNetReqSize;
     Dev->RxRing.Desc[DescIdx].Flags = VRING_DESC_F_WRITE | VRING_DESC_F_NEXT;
@@ -557,8 +598,18 @@ VirtioNetInitialize (
     !!(Features & VIRTIO_NET_F_STATUS)
     );
 
+  //
+  // VIRTIO_NET_F_MRG_RXBUF lets us post one descriptor per receive buffer,
+  // doubling the number of frames the host can queue to us. With
+  // VIRTIO_NET_F_GUEST_CSUM, the host may skip checksumming frames it
+  // forwards; VirtioNetReceive() then completes the checksum for the SNP
+  // client, which expects fully formed frames.
+  //
   Features &= VIRTIO_NET_F_MAC | VIRTIO_NET_F_STATUS | VIRTIO_F_VERSION_1 |
-              VIRTIO_F_IOMMU_PLATFORM;
+              VIRTIO_F_IOMMU_PLATFORM | VIRTIO_NET_F_MRG_RXBUF |
+              VIRTIO_NET_F_GUEST_CSUM;
+  Dev->RxMergeable = (BOOLEAN)((Features & VIRTIO_NET_F_MRG_RXBUF) != 0);
+  Dev->RxGuestCsum = (BOOLEAN)((Features & VIRTIO_NET_F_GUEST_CSUM) != 0);
 
   //
   // In virtio-1.0, feature negotiation is expected to complete before queue
@@ -15,6 +15,71 @@
 
 #include "VirtioNet.h"
 
+/**
+  Complete a partial checksum that the host left to the guest
+  (VIRTIO_NET_HDR_F_NEEDS_CSUM).
+
+  The host has stored the checksum of the pseudo-header in the checksum field
+  already; the field is folded together with the rest of the packet, starting
+  at CsumStart.
+
+  @param[in,out] Packet      The received frame, including the media header.
+  @param[in]     PacketSize  The size of Packet in bytes.
+  @param[in]     CsumStart   Offset in Packet where checksumming starts.
+  @param[in]     CsumOffset  Offset of the checksum field, relative to
+                             CsumStart.
+
+  @retval EFI_SUCCESS       The checksum field has been filled in.
+  @retval EFI_DEVICE_ERROR  The checksum location does not fit in Packet.
+**/
+STATIC
+EFI_STATUS
+VirtioNetCompleteChecksum (
+  IN OUT UINT8   *Packet,
+  IN     UINTN   PacketSize,
+  IN     UINT16  CsumStart,
+  IN     UINT16  CsumOffset
+  )
+{
+  UINT32  Sum;
+  UINTN   Idx;
+  UINT8   *Field;
+
+  if ((CsumStart >= PacketSize) ||
+      (PacketSize - CsumStart < sizeof (UINT16)) ||
+      (CsumOffset > PacketSize - CsumStart - sizeof (UINT16)))
+  {
+    return EFI_DEVICE_ERROR;
+  }
+
+  Sum = 0;
+  for (Idx = CsumStart; Idx + 1 < PacketSize; Idx += 2) {
+    Sum += ((UINT32)Packet[Idx] << 8) | Packet[Idx + 1];
+  }
+
+  if (Idx < PacketSize) {
+    Sum += (UINT32)Packet[Idx] << 8;
+  }
+
+  while ((Sum >> 16) != 0) {
+    Sum = (Sum & 0xFFFF) + (Sum >> 16);
+  }
+
+  Sum = ~Sum & 0xFFFF;
+
+  //
+  // A zero UDP checksum means "no checksum"; transmit the equivalent 0xFFFF.
+  //
+  if (Sum == 0) {
+    Sum = 0xFFFF;
+  }
+
+  Field    = Packet + CsumStart + CsumOffset;
+  Field[0] = (UINT8)(Sum >> 8);
+  Field[1] = (UINT8)Sum;
+  return EFI_SUCCESS;
+}
+
 /**
   Receives a packet from a network interface.
 
@@ -76,6 +141,12 @@ VirtioNetReceive (
   UINT16      AvailIdx;
   EFI_STATUS  NotifyStatus;
   UINTN       RxBufOffset;
+  UINT16      NumBuffers;
+  UINT16      BufIdx;
+  UINT32      BufLen;
+  UINT8       *BufPtr;
+
+  VIRTIO_1_0_NET_REQ  *RxReq;
 
   if ((This == NULL) || (BufferSize == NULL) || (Buffer == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -109,16 +180,46 @@ VirtioNetReceive (
   UsedElemIdx = Dev->RxLastUsed % Dev->RxRing.QueueSize;
   DescIdx     = Dev->RxRing.Used.UsedElem[UsedElemIdx].Id;
   RxLen       = Dev->RxRing.Used.UsedElem[UsedElemIdx].Len;
+  RxReq       = (VIRTIO_1_0_NET_REQ *)(Dev->RxBuf +
+                                       (UINTN)(Dev->RxRing.Desc[DescIdx].Addr -
+                                               Dev->RxBufDeviceBase));
 
   //
   // the virtio-net request header must be complete; we skip it
   //
-  ASSERT (RxLen >= Dev->RxRing.Desc[DescIdx].Len);
-  RxLen -= Dev->RxRing.Desc[DescIdx].Len;
-  //
-  // the host must not have filled in more data than requested
-  //
-  ASSERT (RxLen <= Dev->RxRing.Desc[DescIdx + 1].Len);
+  ASSERT (RxLen >= Dev->RxReqSize);
+  RxLen -= Dev->RxReqSize;
+
+  NumBuffers = 1;
+  if (Dev->RxMergeable) {
+    //
+    // The host may have spread the packet over several buffers; the header in
+    // the first one says how many. Wait until all of them have been used.
+    //
+    NumBuffers = RxReq->NumBuffers;
+    if ((NumBuffers == 0) || (NumBuffers > Dev->RxMaxPending)) {
+      NumBuffers = 1;
+      Status     = EFI_DEVICE_ERROR;
+      goto RecycleDesc; // drop malformed packet
+    }
+
+    if ((UINT16)(RxCurUsed - Dev->RxLastUsed) < NumBuffers) {
+      Status = EFI_NOT_READY;
+      goto Exit;
+    }
+
+    ASSERT (RxLen <= Dev->RxRing.Desc[DescIdx].Len - Dev->RxReqSize);
+    for (BufIdx = 1; BufIdx < NumBuffers; ++BufIdx) {
+      UsedElemIdx = (UINT16)(Dev->RxLastUsed + BufIdx) %
+                    Dev->RxRing.QueueSize;
+      RxLen += Dev->RxRing.Used.UsedElem[UsedElemIdx].Len;
+    }
+  } else {
+    //
+    // the host must not have filled in more data than requested
+    //
+    ASSERT (RxLen <= Dev->RxRing.Desc[DescIdx + 1].Len);
+  }
 
   OrigBufferSize = *BufferSize;
   *BufferSize    = RxLen;
@@ -137,10 +238,50 @@ VirtioNetReceive (
     *HeaderSize = Dev->Snm.MediaHeaderSize;
   }
 
-  RxBufOffset = (UINTN)(Dev->RxRing.Desc[DescIdx + 1].Addr -
-                        Dev->RxBufDeviceBase);
-  RxPtr = Dev->RxBuf + RxBufOffset;
-  CopyMem (Buffer, RxPtr, RxLen);
+  //
+  // gather the packet data from the buffer(s) the host has used
+  //
+  BufPtr = Buffer;
+  for (BufIdx = 0; BufIdx < NumBuffers; ++BufIdx) {
+    UsedElemIdx = (UINT16)(Dev->RxLastUsed + BufIdx) % Dev->RxRing.QueueSize;
+    DescIdx     = Dev->RxRing.Used.UsedElem[UsedElemIdx].Id;
+    BufLen      = Dev->RxRing.Used.UsedElem[UsedElemIdx].Len;
+    if (!Dev->RxMergeable) {
+      RxBufOffset = (UINTN)(Dev->RxRing.Desc[DescIdx + 1].Addr -
+                            Dev->RxBufDeviceBase);
+      BufLen -= Dev->RxReqSize;
+    } else {
+      RxBufOffset = (UINTN)(Dev->RxRing.Desc[DescIdx].Addr -
+                            Dev->RxBufDeviceBase);
+      if (BufIdx == 0) {
+        RxBufOffset += Dev->RxReqSize;
+        BufLen      -= Dev->RxReqSize;
+      }
+
+      ASSERT (BufLen <= Dev->RxRing.Desc[DescIdx].Len);
+    }
+
+    CopyMem (BufPtr, Dev->RxBuf + RxBufOffset, BufLen);
+    BufPtr += BufLen;
+  }
+
+  ASSERT ((UINTN)(BufPtr - (UINT8 *)Buffer) == RxLen);
+
+  if (Dev->RxGuestCsum &&
+      ((RxReq->V0_9_5.Flags & VIRTIO_NET_HDR_F_NEEDS_CSUM) != 0))
+  {
+    Status = VirtioNetCompleteChecksum (
+               Buffer,
+               RxLen,
+               RxReq->V0_9_5.CsumStart,
+               RxReq->V0_9_5.CsumOffset
+               );
+    if (EFI_ERROR (Status)) {
+      goto RecycleDesc; // drop packet with bogus checksum location
+    }
+  }
+
+  RxPtr = Buffer;
 
   if (DestAddr != NULL) {
     CopyMem (DestAddr, RxPtr, SIZE_OF_VNET (Mac));
@@ -163,23 +304,36 @@ VirtioNetReceive (
   Status = EFI_SUCCESS;
 
 RecycleDesc:
-  ++Dev->RxLastUsed;
-
   //
   // virtio-0.9.5, 2.4.1 Supplying Buffers to The Device
   //
-  AvailIdx                                                   = *Dev->RxRing.Avail.Idx;
-  Dev->RxRing.Avail.Ring[AvailIdx++ % Dev->RxRing.QueueSize] =
-    (UINT16)DescIdx;
+  AvailIdx = *Dev->RxRing.Avail.Idx;
+  for (BufIdx = 0; BufIdx < NumBuffers; ++BufIdx) {
+    UsedElemIdx                                                = Dev->RxLastUsed++ % Dev->RxRing.QueueSize;
+    Dev->RxRing.Avail.Ring[AvailIdx++ % Dev->RxRing.QueueSize] =
+      (UINT16)Dev->RxRing.Used.UsedElem[UsedElemIdx].Id;
+  }
 
   MemoryFence ();
   *Dev->RxRing.Avail.Idx = AvailIdx;
 
+  //
+  // Notifying the host costs an exit to the hypervisor, so only do it when
+  // the host is running low on receive buffers. The used index is re-read
+  // after publishing the new available index: if the host has consumed all
+  // buffers it had, only the ones just recycled are outstanding, and the
+  // notification below is guaranteed to happen.
+  //
   MemoryFence ();
-  NotifyStatus = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
-  if (!EFI_ERROR (Status)) {
-    // earlier error takes precedence
-    Status = NotifyStatus;
+  RxCurUsed = *Dev->RxRing.Used.Idx;
+  if (((*Dev->RxRing.Used.Flags & VRING_USED_F_NO_NOTIFY) == 0) &&
+      ((UINT16)(AvailIdx - RxCurUsed) <= MAX (NumBuffers, Dev->RxMaxPending / 2)))
+  {
+    NotifyStatus = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
+    if (!EFI_ERROR (Status)) {
+      // earlier error takes precedence
+      Status = NotifyStatus;
+    }
   }
 
 Exit:
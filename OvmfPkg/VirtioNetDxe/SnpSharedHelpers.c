@@ -80,6 +80,7 @@ VirtioNetShutdownTx (
 
   OrderedCollectionUninit (Dev->TxBufCollection);
 
+  FreePool (Dev->TxDoneBuf);
   FreePool (Dev->TxFreeStack);
 }
 
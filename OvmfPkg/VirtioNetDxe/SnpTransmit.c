@@ -101,10 +101,11 @@ VirtioNetTransmit (
   }
 
   //
-  // check if we have room for transmission
+  // check if we have room for transmission; completed buffers that have not
+  // been handed back by VirtioNetGetStatus() yet count as pending
   //
-  ASSERT (Dev->TxCurPending <= Dev->TxMaxPending);
-  if (Dev->TxCurPending == Dev->TxMaxPending) {
+  ASSERT (Dev->TxCurPending + Dev->TxDoneCount <= Dev->TxMaxPending);
+  if (Dev->TxCurPending + Dev->TxDoneCount == Dev->TxMaxPending) {
     Status = EFI_NOT_READY;
     goto Exit;
   }
@@ -173,8 +174,15 @@ VirtioNetTransmit (
   MemoryFence ();
   *Dev->TxRing.Avail.Idx = AvailIdx;
 
+  //
+  // virtio-0.9.5, 2.4.1.4 Notifying the Device: the host sets
+  // VRING_USED_F_NO_NOTIFY while it is still working through the queue, so
+  // back-to-back transmissions need no further (expensive) notification.
+  //
   MemoryFence ();
-  Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_TX);
+  if ((*Dev->TxRing.Used.Flags & VRING_USED_F_NO_NOTIFY) == 0) {
+    Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_TX);
+  }
 
 Exit:
   gBS->RestoreTPL (OldTpl);
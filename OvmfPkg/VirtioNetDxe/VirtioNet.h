@@ -26,7 +26,8 @@
 //
 // maximum number of pending packets, separately for each direction
 //
-#define VNET_MAX_PENDING  64
+#define VNET_MAX_PENDING     64
+#define VNET_MAX_RX_PENDING  256
 
 //
 // State diagram:
@@ -84,6 +85,10 @@ typedef struct {
   UINTN                          RxBufNrPages;    // VirtioNetInitRx
   EFI_PHYSICAL_ADDRESS           RxBufDeviceBase; // VirtioNetInitRx
   VOID                           *RxBufMap;       // VirtioNetInitRx
+  UINT16                         RxMaxPending;    // VirtioNetInitRx
+  UINT16                         RxReqSize;       // VirtioNetInitRx
+  BOOLEAN                        RxMergeable;     // VirtioNetInitialize
+  BOOLEAN                        RxGuestCsum;     // VirtioNetInitialize
 
   VRING                          TxRing;           // VirtioNetInitRing
   VOID                           *TxRingMap;       // VirtioRingMap and
@@ -95,6 +100,9 @@ typedef struct {
   VOID                           *TxSharedReqMap;  // VirtioNetInitTx
   UINT16                         TxLastUsed;       // VirtioNetInitTx
   ORDERED_COLLECTION             *TxBufCollection; // VirtioNetInitTx
+  VOID                           **TxDoneBuf;      // VirtioNetInitTx
+  UINT16                         TxDoneFirst;      // VirtioNetInitTx
+  UINT16                         TxDoneCount;      // VirtioNetInitTx
 } VNET_DEV;
 
 //